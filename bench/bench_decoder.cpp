@@ -0,0 +1,272 @@
+#include <unistd.h>
+
+#include <charconv>
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string_view>
+#include <vector>
+
+#include "market_data/market_by_price.h"
+#include "market_data/shared_book.h"
+#include "market_data/shared_bus.h"
+#include "processors/checksum.h"
+#include "processors/packet_processor.h"
+#include "processors/pcap_buffer.h"
+#include "simba_decoder/decimal.h"
+#include "simba_decoder/simba_decoder.h"
+#include "test_vectors.h"
+
+namespace {
+
+// Runs the callable for the given number of iterations and reports the
+// throughput of the stage, so regressions of the hardened paths stand out.
+template <typename Callable>
+void run_benchmark(std::string_view name, size_t bytes_per_iteration,
+                   size_t iterations, Callable &&callable) {
+  const auto start = std::chrono::steady_clock::now();
+  for (size_t iteration = 0; iteration < iterations; ++iteration) {
+    callable();
+  }
+  const auto elapsed = std::chrono::duration<double>(
+                           std::chrono::steady_clock::now() - start)
+                           .count();
+
+  const double bytes = static_cast<double>(bytes_per_iteration * iterations);
+  std::cout << std::left << std::setw(32) << name << std::right << std::fixed
+            << std::setprecision(1) << std::setw(10)
+            << bytes / elapsed / (1024 * 1024) << " MB/s" << std::setw(14)
+            << elapsed * 1e9 / static_cast<double>(iterations) << " ns/iter"
+            << std::endl;
+}
+
+}  // namespace
+
+int main() {
+  using namespace task;
+
+  // the handlers read the instrument and the price, like most consumers
+  int64_t field_sink{0};
+  simba::decoder::MessageHandlers handlers;
+  handlers.order_update_handler =
+      [&field_sink](simba::types::OrderUpdateView order_update) {
+        field_sink += order_update.security_id() +
+                      order_update.md_entry_px().mantissa();
+      };
+  handlers.order_execution_handler =
+      [&field_sink](simba::types::OrderExecutionView order_execution) {
+        field_sink += order_execution.security_id() +
+                      order_execution.last_px().mantissa();
+      };
+  simba::decoder::SIMBADecoder decoder{handlers};
+
+  constexpr size_t ITERATIONS = 1'000'000;
+  const auto &payload = tests::TEST_ORDER_EXECUTION_DATA;
+  run_benchmark("simba_decoder/decode_message", payload.size(), ITERATIONS,
+                [&] { decoder.decode_message(payload); });
+
+  // the same fields from a copy of every message into its packed struct
+  simba::decoder::MessageHandlers copy_handlers;
+  copy_handlers.order_update_handler =
+      [&field_sink](simba::types::OrderUpdateView order_update) {
+        const auto message = order_update.to_message();
+        field_sink += message.security_id + message.md_entry_px.mantissa();
+      };
+  copy_handlers.order_execution_handler =
+      [&field_sink](simba::types::OrderExecutionView order_execution) {
+        const auto message = order_execution.to_message();
+        field_sink += message.security_id + message.last_px.mantissa();
+      };
+  simba::decoder::SIMBADecoder copy_decoder{copy_handlers};
+  run_benchmark("simba_decoder/copy_messages", payload.size(), ITERATIONS,
+                [&] { copy_decoder.decode_message(payload); });
+
+  auto handler = [&decoder](std::span<const std::byte> udp_payload) {
+    decoder.decode_message(udp_payload);
+  };
+  processors::PacketProcessor processor(handler);
+  const auto frame = tests::make_udp_frame(payload);
+  run_benchmark("packet_processor/process_packet", frame.size(), ITERATIONS,
+                [&] { processor.process_packet(frame); });
+
+  constexpr size_t BATCH_PACKETS = 64;
+  const std::vector<processors::PacketView> batch(BATCH_PACKETS, frame);
+  run_benchmark("packet_processor/process_batch", frame.size() * BATCH_PACKETS,
+                ITERATIONS / BATCH_PACKETS,
+                [&] { processor.process_batch(batch); });
+
+  // cost of the optional validation: the same batch with checksums verified
+  const auto checked_frame = tests::add_checksums(frame);
+  const std::vector<processors::PacketView> checked_batch(BATCH_PACKETS,
+                                                          checked_frame);
+  processors::PacketProcessor validating_processor(
+      handler, transport_layer::ValidationConfig{.verify_checksums = true});
+  run_benchmark("packet_processor/verified_batch",
+                checked_frame.size() * BATCH_PACKETS,
+                ITERATIONS / BATCH_PACKETS,
+                [&] { validating_processor.process_batch(checked_batch); });
+
+  // raw one's complement sum over 1MB, per implementation
+  const std::vector<std::byte> block(1024 * 1024, std::byte{0x5A});
+  uint16_t checksum_sink{0};
+  run_benchmark("checksum/scalar", block.size(), 1000, [&] {
+    checksum_sink ^=
+        transport_layer::detail::ones_complement_sum_scalar(block, checksum_sink);
+  });
+  if (transport_layer::detail::avx2_supported()) {
+    run_benchmark("checksum/avx2", block.size(), 1000, [&] {
+      checksum_sink ^=
+          transport_layer::detail::ones_complement_sum_avx2(block, checksum_sink);
+    });
+  }
+
+  // exact price text against the double conversion it replaced
+  simba::types::Decimal5 price{9'882'850'000};
+  char price_text[32];
+  size_t text_size{0};
+  run_benchmark("decimal5/to_chars", sizeof(price), ITERATIONS, [&] {
+    price += simba::types::Decimal5{1};
+    text_size += static_cast<size_t>(
+        price.to_chars(price_text, price_text + sizeof(price_text)) -
+        price_text);
+  });
+  run_benchmark("decimal5/double_to_chars", sizeof(price), ITERATIONS, [&] {
+    price += simba::types::Decimal5{1};
+    text_size += static_cast<size_t>(
+        std::to_chars(price_text, price_text + sizeof(price_text),
+                      price.to_double())
+            .ptr -
+        price_text);
+  });
+
+  // market-by-price: 4096 orders added then deleted around the best prices,
+  // against the same levels in a std::map
+  std::vector<simba::types::OrderUpdate> book_updates;
+  std::mt19937 generator{1};
+  using simba::types::MDUpdateAction;
+  for (const auto action : {MDUpdateAction::New, MDUpdateAction::Delete}) {
+    for (int64_t id = 0; id < 4096; ++id) {
+      auto &update = book_updates.emplace_back();
+      update.md_entry_id = id;
+      update.md_update_action = action;
+      update.md_entry_type = id % 2 == 0 ? simba::types::MDEntryType::Bid
+                                         : simba::types::MDEntryType::Offer;
+      // 100 ticks of 10 units on each side of 98500
+      const auto ticks = static_cast<int64_t>(generator() % 100);
+      update.md_entry_px = simba::types::Decimal5::from_units(
+          id % 2 == 0 ? 98'500 - ticks * 10 : 98'510 + ticks * 10);
+      update.md_entry_size = 1 + id % 7;
+    }
+  }
+  for (size_t update = 4096; update < book_updates.size(); ++update) {
+    // a deletion carries the price and the side of its order
+    const auto &order = book_updates[update - 4096];
+    book_updates[update].md_entry_px = order.md_entry_px;
+    book_updates[update].md_entry_type = order.md_entry_type;
+    book_updates[update].md_entry_size = order.md_entry_size;
+  }
+  market_data::MarketByPrice market_by_price(
+      10, [&field_sink](const market_data::DepthUpdate &update) {
+        field_sink += update.volume;
+      });
+  size_t next_update{0};
+  run_benchmark("market_by_price/order_update",
+                sizeof(simba::types::OrderUpdate), ITERATIONS, [&] {
+                  market_by_price.on_order_update(
+                      simba::types::OrderUpdateView{book_updates[next_update]},
+                      next_update);
+                  next_update = (next_update + 1) % book_updates.size();
+                });
+  std::map<simba::types::Decimal5, market_data::PriceLevel> map_levels[2];
+  run_benchmark("market_by_price/map_levels",
+                sizeof(simba::types::OrderUpdate), ITERATIONS, [&] {
+                  const auto &update = book_updates[next_update];
+                  auto &levels = map_levels[update.md_entry_id % 2];
+                  auto &level = levels[update.md_entry_px];
+                  if (update.md_update_action == MDUpdateAction::New) {
+                    level.volume += update.md_entry_size;
+                    ++level.orders;
+                  } else if (--level.orders == 0) {
+                    levels.erase(update.md_entry_px);
+                  } else {
+                    level.volume -= update.md_entry_size;
+                  }
+                  field_sink += levels.begin()->second.volume;
+                  next_update = (next_update + 1) % book_updates.size();
+                });
+
+  // shared book: the same updates published to a segment, then the reads of
+  // a slot of 10 levels per side
+  const auto segment = "/bench_shared_book_" + std::to_string(::getpid());
+  {
+    market_data::SharedBookPublisher publisher(segment, 10, 16);
+    market_data::SharedBookReader reader(segment);
+    run_benchmark("shared_book/publish", sizeof(simba::types::OrderUpdate),
+                  ITERATIONS, [&] {
+                    publisher.on_order_update(
+                        simba::types::OrderUpdateView{
+                            book_updates[next_update]},
+                        next_update);
+                    next_update = (next_update + 1) % book_updates.size();
+                  });
+    const auto slot = reader.find(book_updates.front().security_id);
+    market_data::SharedBookSnapshot snapshot;
+    run_benchmark("shared_book/read", 20 * sizeof(market_data::PriceLevel),
+                  ITERATIONS, [&] {
+                    reader.read(slot.value_or(0), snapshot);
+                    field_sink += snapshot.version;
+                  });
+  }
+  market_data::SharedBookPublisher::remove(segment);
+
+  // shared bus: the same updates broadcast, each polled back by a reader
+  const auto bus = "/bench_shared_bus_" + std::to_string(::getpid());
+  {
+    market_data::SharedBusWriter writer(bus);
+    market_data::SharedBusReader reader(bus);
+    market_data::BusEvent event;
+    run_benchmark("shared_bus/publish_poll",
+                  sizeof(simba::types::OrderUpdate), ITERATIONS, [&] {
+                    writer.publish(
+                        simba::types::OrderUpdateView{
+                            book_updates[next_update]},
+                        next_update, 0);
+                    field_sink += reader.poll(event).value_or(0);
+                    next_update = (next_update + 1) % book_updates.size();
+                  });
+  }
+  market_data::SharedBusWriter::remove(bus);
+
+  // PCAPBuffer framing over a temporary capture of ~64MB
+  const auto capture_path =
+      std::filesystem::temp_directory_path() /
+      ("bench_pcap_buffer_" + std::to_string(::getpid()) + ".pcap");
+  const auto capture = tests::make_pcap_file(
+      std::vector<std::vector<std::byte>>(64 * 1024 * 1024 / frame.size(), frame));
+  {
+    std::ofstream file(capture_path, std::ios::binary);
+    file.write(reinterpret_cast<const char *>(capture.data()),
+               static_cast<std::streamsize>(capture.size()));
+  }
+  run_benchmark("pcap_buffer/start_buffering", capture.size(), 1, [&] {
+    std::ifstream file(capture_path, std::ios::binary);
+    file.seekg(sizeof(pcap::types::pcap_hdr_t));
+    processors::mt_buffer::PCAPBuffer pcap_buffer(
+        file, capture.size(), sizeof(pcap::types::pcap_hdr_t));
+    pcap_buffer.start_buffering();
+    pcap_buffer.thread().join();
+    while (auto batch = pcap_buffer.next_batch()) {
+      processor.process_batch(batch->packets);
+    }
+  });
+  std::filesystem::remove(capture_path);
+
+  std::cout << "field sink: " << field_sink
+            << ", price text: " << text_size << std::endl;
+  return 0;
+}
@@ -0,0 +1,1362 @@
+// Generates the C++ types of an SBE message schema: the packed structs of
+// the messages, their flyweight views, the enums, the sets and the template
+// id dispatch. Run at build time, see lib/CMakeLists.txt:
+//
+//   sbe_codegen <schema.xml> <output.h> [namespace]
+//
+// The messages are versioned as in SBE: a version appends fields to the
+// blocks (sinceVersion), so the layout of each version is a prefix of the
+// next one. The dispatch is templated on the layout version, a decoder is
+// instantiated per version instead of testing it field by field.
+//
+// Only the subset of SBE used by the SIMBA schemas is supported: simple
+// types, char arrays, enums, sets, composites of primitives, decimals with
+// a constant exponent of -5, and repeating groups of fixed-size fields
+// (no nested groups, no var data). Anything else is rejected, so that a
+// schema update fails the build instead of producing a wrong layout.
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <optional>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+constexpr std::string_view DEFAULT_NAMESPACE = "task::simba::types";
+
+// --- XML ---------------------------------------------------------------
+
+struct Element {
+  std::string name;  // without the namespace prefix
+  std::map<std::string, std::string> attributes;
+  std::string text;
+  std::vector<Element> children;
+
+  [[nodiscard]] const std::string &attribute(const std::string &key) const {
+    const auto found = attributes.find(key);
+    if (found == attributes.end()) {
+      throw std::runtime_error("<" + name + "> without " + key);
+    }
+    return found->second;
+  }
+
+  [[nodiscard]] std::optional<std::string> optional_attribute(
+      const std::string &key) const {
+    const auto found = attributes.find(key);
+    if (found == attributes.end()) {
+      return std::nullopt;
+    }
+    return found->second;
+  }
+};
+
+// Just enough XML for the schemas: elements, attributes, text, comments
+// and the prolog. No DTD, no CDATA.
+class XmlParser {
+ public:
+  explicit XmlParser(std::string_view document) : document_(document) {}
+
+  Element parse() {
+    skip_misc();
+    auto root = parse_element();
+    skip_misc();
+    if (position_ != document_.size()) {
+      fail("content after the root element");
+    }
+    return root;
+  }
+
+ private:
+  [[noreturn]] void fail(const std::string &what) const {
+    const auto line =
+        std::count(document_.begin(), document_.begin() + position_, '\n') + 1;
+    throw std::runtime_error("XML line " + std::to_string(line) + ": " + what);
+  }
+
+  bool starts_with(std::string_view prefix) const {
+    return document_.substr(position_, prefix.size()) == prefix;
+  }
+
+  void skip_past(std::string_view terminator) {
+    const auto end = document_.find(terminator, position_);
+    if (end == std::string_view::npos) {
+      fail("unterminated " + std::string(terminator));
+    }
+    position_ = end + terminator.size();
+  }
+
+  void skip_spaces() {
+    while (position_ < document_.size() &&
+           std::isspace(static_cast<unsigned char>(document_[position_]))) {
+      ++position_;
+    }
+  }
+
+  // Whitespace, comments and processing instructions
+  void skip_misc() {
+    for (;;) {
+      skip_spaces();
+      if (starts_with("<!--")) {
+        skip_past("-->");
+      } else if (starts_with("<?")) {
+        skip_past("?>");
+      } else {
+        return;
+      }
+    }
+  }
+
+  std::string parse_name() {
+    const size_t first = position_;
+    while (position_ < document_.size()) {
+      const char c = document_[position_];
+      if (!std::isalnum(static_cast<unsigned char>(c)) && c != '_' &&
+          c != ':' && c != '-' && c != '.') {
+        break;
+      }
+      ++position_;
+    }
+    if (position_ == first) {
+      fail("expected a name");
+    }
+    return std::string(document_.substr(first, position_ - first));
+  }
+
+  static std::string local_name(const std::string &name) {
+    const auto colon = name.find(':');
+    return colon == std::string::npos ? name : name.substr(colon + 1);
+  }
+
+  std::string decode(std::string_view text) const {
+    static const std::pair<std::string_view, char> ENTITIES[] = {
+        {"&lt;", '<'},
+        {"&gt;", '>'},
+        {"&amp;", '&'},
+        {"&quot;", '"'},
+        {"&apos;", '\''}};
+    std::string decoded;
+    size_t index = 0;
+    while (index < text.size()) {
+      if (text[index] != '&') {
+        decoded += text[index++];
+        continue;
+      }
+      const auto entity = std::find_if(
+          std::begin(ENTITIES), std::end(ENTITIES), [&](const auto &entry) {
+            return text.substr(index, entry.first.size()) == entry.first;
+          });
+      if (entity == std::end(ENTITIES)) {
+        fail("unsupported entity");
+      }
+      decoded += entity->second;
+      index += entity->first.size();
+    }
+    return decoded;
+  }
+
+  Element parse_element() {
+    if (!starts_with("<")) {
+      fail("expected an element");
+    }
+    ++position_;
+    Element element;
+    const std::string tag = parse_name();
+    element.name = local_name(tag);
+
+    for (;;) {
+      skip_spaces();
+      if (starts_with("/>")) {
+        position_ += 2;
+        return element;
+      }
+      if (starts_with(">")) {
+        ++position_;
+        break;
+      }
+      const std::string key = parse_name();
+      skip_spaces();
+      if (!starts_with("=")) {
+        fail("expected = after " + key);
+      }
+      ++position_;
+      skip_spaces();
+      if (position_ >= document_.size() ||
+          (document_[position_] != '"' && document_[position_] != '\'')) {
+        fail("expected a quoted value for " + key);
+      }
+      const char quote = document_[position_++];
+      const auto end = document_.find(quote, position_);
+      if (end == std::string_view::npos) {
+        fail("unterminated value of " + key);
+      }
+      element.attributes[local_name(key)] =
+          decode(document_.substr(position_, end - position_));
+      position_ = end + 1;
+    }
+
+    for (;;) {
+      const size_t first = position_;
+      const auto next = document_.find('<', position_);
+      if (next == std::string_view::npos) {
+        fail("unterminated <" + tag + ">");
+      }
+      element.text += decode(document_.substr(first, next - first));
+      position_ = next;
+      if (starts_with("<!--")) {
+        skip_past("-->");
+      } else if (starts_with("<?")) {
+        skip_past("?>");
+      } else if (starts_with("</")) {
+        position_ += 2;
+        if (parse_name() != tag) {
+          fail("mismatched </" + tag + ">");
+        }
+        skip_spaces();
+        if (!starts_with(">")) {
+          fail("expected >");
+        }
+        ++position_;
+        return element;
+      } else {
+        element.children.push_back(parse_element());
+      }
+    }
+  }
+
+  std::string_view document_;
+  size_t position_{0};
+};
+
+std::string trim(std::string_view text) {
+  const auto first = text.find_first_not_of(" \t\r\n");
+  if (first == std::string_view::npos) {
+    return {};
+  }
+  const auto last = text.find_last_not_of(" \t\r\n");
+  return std::string(text.substr(first, last - first + 1));
+}
+
+size_t to_size(const std::string &text) {
+  size_t parsed = 0;
+  try {
+    parsed = std::stoul(text);
+  } catch (const std::exception &) {
+    throw std::runtime_error("Invalid number " + text);
+  }
+  return parsed;
+}
+
+// --- Schema ------------------------------------------------------------
+
+struct Primitive {
+  std::string_view cpp;
+  size_t size;
+  // the bounds of the integers, the SBE default null values
+  std::string_view min;
+  std::string_view max;
+};
+
+const std::map<std::string, Primitive, std::less<>> PRIMITIVES = {
+    {"char", {"char", 1, "0", "127"}},
+    {"int8", {"int8_t", 1, "-128", "127"}},
+    {"uint8", {"uint8_t", 1, "0", "255"}},
+    {"int16", {"int16_t", 2, "-32768", "32767"}},
+    {"uint16", {"uint16_t", 2, "0", "65535"}},
+    {"int32", {"int32_t", 4, "-2147483648", "2147483647"}},
+    {"uint32", {"uint32_t", 4, "0", "4294967295"}},
+    {"int64", {"int64_t", 8, "-9223372036854775808", "9223372036854775807"}},
+    {"uint64", {"uint64_t", 8, "0", "18446744073709551615"}},
+    {"float", {"float", 4, "", ""}},
+    {"double", {"double", 8, "", ""}}};
+
+enum class TypeKind { Primitive, Chars, Enum, Set, Decimal, Composite };
+
+struct Type {
+  TypeKind kind{TypeKind::Primitive};
+  std::string cpp;  // C++ type of the field, the element type of Chars
+  size_t size{0};
+  size_t length{1};  // Chars only
+  std::string description;
+  // C++ expression of the null value of optional types, also the value of
+  // the field when absent from an older version
+  std::string null_value;
+};
+
+struct Field {
+  std::string name;
+  std::string member;
+  Type type;
+  size_t offset{0};
+  uint16_t since_version{0};
+  std::string description;
+};
+
+struct Group {
+  std::string name;
+  std::string member;
+  std::string dimension;  // C++ name of the dimension composite
+  size_t block_length{0};
+  std::vector<Field> fields;
+  std::string description;
+};
+
+struct Message {
+  std::string name;
+  uint16_t id{0};
+  uint16_t since_version{0};
+  size_t block_length{0};
+  std::vector<Field> fields;
+  std::vector<Group> groups;
+  std::string description;
+};
+
+struct EnumValue {
+  std::string name;
+  std::string literal;
+  std::string description;
+};
+
+struct Enum {
+  std::string name;
+  std::string underlying;
+  std::vector<EnumValue> values;
+};
+
+struct SetChoice {
+  std::string name;
+  size_t bit{0};
+  std::string description;
+};
+
+struct Set {
+  std::string name;
+  std::string underlying;
+  std::vector<SetChoice> choices;
+};
+
+struct Composite {
+  std::string name;  // C++ name
+  std::vector<Field> fields;
+  size_t size{0};
+  std::string description;
+};
+
+struct Schema {
+  std::string package;
+  uint16_t id{0};
+  uint16_t version{0};
+  std::vector<Enum> enums;
+  std::vector<Set> sets;
+  std::vector<Composite> composites;
+  std::map<std::string, Type> types;  // by schema name
+  std::vector<Message> messages;
+};
+
+// MDEntryID -> md_entry_id, NoMDEntries -> no_md_entries
+std::string snake_case(std::string_view name) {
+  std::string snake;
+  for (size_t index = 0; index < name.size(); ++index) {
+    const auto c = static_cast<unsigned char>(name[index]);
+    if (std::isupper(c) && index > 0) {
+      const auto previous = static_cast<unsigned char>(name[index - 1]);
+      const bool next_lower =
+          index + 1 < name.size() &&
+          std::islower(static_cast<unsigned char>(name[index + 1]));
+      if (std::islower(previous) || std::isdigit(previous) ||
+          (std::isupper(previous) && next_lower)) {
+        snake += '_';
+      }
+    }
+    snake += static_cast<char>(std::tolower(c));
+  }
+  return snake;
+}
+
+// messageHeader -> MessageHeader
+std::string pascal_case(std::string_view name) {
+  std::string pascal(name);
+  if (!pascal.empty()) {
+    pascal[0] = static_cast<char>(
+        std::toupper(static_cast<unsigned char>(pascal[0])));
+  }
+  return pascal;
+}
+
+const Primitive &primitive(const std::string &name) {
+  const auto found = PRIMITIVES.find(name);
+  if (found == PRIMITIVES.end()) {
+    throw std::runtime_error("Unsupported primitive type " + name);
+  }
+  return found->second;
+}
+
+bool is_constant(const Element &element) {
+  return element.optional_attribute("presence") == "constant";
+}
+
+// The nullValue of an optional type, or the SBE default one
+std::string null_expression(const Primitive &encoding,
+                            const std::optional<std::string> &null_value) {
+  const std::string cpp(encoding.cpp);
+  if (encoding.min.empty()) {
+    return "std::numeric_limits<" + cpp + ">::quiet_NaN()";
+  }
+  if (cpp == "char" && !null_value) {
+    return "'\\0'";
+  }
+  const auto value = null_value.value_or(
+      std::string(encoding.min == "0" ? encoding.max : encoding.min));
+  if (value == encoding.max) {
+    return "std::numeric_limits<" + cpp + ">::max()";
+  }
+  if (value == encoding.min) {
+    return "std::numeric_limits<" + cpp + ">::min()";
+  }
+  return "static_cast<" + cpp + ">(" + value +
+         (encoding.min == "0" ? "ULL" : "LL") + ")";
+}
+
+uint16_t since_version(const Element &element) {
+  return static_cast<uint16_t>(
+      to_size(element.optional_attribute("sinceVersion").value_or("0")));
+}
+
+Type simple_type(const Element &element) {
+  const auto &encoding = primitive(element.attribute("primitiveType"));
+  const size_t length = to_size(element.optional_attribute("length")
+                                    .value_or("1"));
+  Type type;
+  type.cpp = encoding.cpp;
+  type.size = encoding.size * length;
+  type.description = element.optional_attribute("description").value_or("");
+  if (element.optional_attribute("presence") == "optional") {
+    type.null_value =
+        null_expression(encoding, element.optional_attribute("nullValue"));
+  }
+  if (length != 1) {
+    if (encoding.cpp != "char") {
+      throw std::runtime_error("Arrays of " + std::string(encoding.cpp) +
+                               " are not supported");
+    }
+    type.kind = TypeKind::Chars;
+    type.length = length;
+  }
+  return type;
+}
+
+void add_enum(Schema &schema, const Element &element) {
+  Enum parsed;
+  parsed.name = element.attribute("name");
+  const auto &encoding_type = element.attribute("encodingType");
+  // the encoding may also name a simple type of the schema
+  const auto simple = schema.types.find(encoding_type);
+  parsed.underlying = simple != schema.types.end()
+                          ? simple->second.cpp
+                          : std::string(primitive(encoding_type).cpp);
+  const size_t size = simple != schema.types.end()
+                          ? simple->second.size
+                          : primitive(encoding_type).size;
+  for (const auto &child : element.children) {
+    if (child.name != "validValue") {
+      continue;
+    }
+    const auto value = trim(child.text);
+    EnumValue entry{child.attribute("name"), value,
+                    child.optional_attribute("description").value_or("")};
+    if (parsed.underlying == "char") {
+      if (value.size() != 1) {
+        throw std::runtime_error("Invalid char value of " + parsed.name);
+      }
+      entry.literal = "'" + value + "'";
+    }
+    parsed.values.push_back(std::move(entry));
+  }
+  schema.types[parsed.name] = {TypeKind::Enum, parsed.name, size, 1, "",
+                               ""};
+  schema.enums.push_back(std::move(parsed));
+}
+
+void add_set(Schema &schema, const Element &element) {
+  Set parsed;
+  parsed.name = element.attribute("name");
+  const auto &encoding = primitive(element.attribute("encodingType"));
+  parsed.underlying = encoding.cpp;
+  for (const auto &child : element.children) {
+    if (child.name != "choice") {
+      continue;
+    }
+    SetChoice choice{child.attribute("name"), to_size(trim(child.text)),
+                     child.optional_attribute("description").value_or("")};
+    if (choice.bit >= encoding.size * 8) {
+      throw std::runtime_error("Choice " + choice.name + " out of " +
+                               parsed.name);
+    }
+    parsed.choices.push_back(std::move(choice));
+  }
+  schema.types[parsed.name] = {TypeKind::Set, parsed.name, encoding.size, 1,
+                               "", ""};
+  schema.sets.push_back(std::move(parsed));
+}
+
+void add_composite(Schema &schema, const Element &element) {
+  const auto &name = element.attribute("name");
+  const auto description =
+      element.optional_attribute("description").value_or("");
+
+  // mantissa + constant exponent: the fixed-point Decimal5 of decimal.h
+  const auto mantissa = std::find_if(
+      element.children.begin(), element.children.end(),
+      [](const Element &child) {
+        return child.optional_attribute("name") == "mantissa";
+      });
+  const auto exponent = std::find_if(
+      element.children.begin(), element.children.end(),
+      [](const Element &child) {
+        return child.optional_attribute("name") == "exponent";
+      });
+  if (mantissa != element.children.end() &&
+      exponent != element.children.end()) {
+    if (!is_constant(*exponent) || trim(exponent->text) != "-5" ||
+        mantissa->attribute("primitiveType") != "int64") {
+      throw std::runtime_error("Only int64 decimals with a constant exponent "
+                               "of -5 are supported: " + name);
+    }
+    schema.types[name] = {
+        TypeKind::Decimal, "Decimal5", 8, 1, description,
+        mantissa->optional_attribute("presence") == "optional"
+            ? "Decimal5::null()"
+            : ""};
+    return;
+  }
+
+  Composite composite;
+  composite.name = pascal_case(name);
+  composite.description = description;
+  for (const auto &child : element.children) {
+    if (child.name != "type") {
+      throw std::runtime_error("Unsupported <" + child.name + "> in " + name);
+    }
+    if (is_constant(child)) {
+      continue;
+    }
+    Field field;
+    field.name = child.attribute("name");
+    field.member = snake_case(field.name);
+    field.type = simple_type(child);
+    field.offset = composite.size;
+    composite.size += field.type.size;
+    composite.fields.push_back(std::move(field));
+  }
+  schema.types[name] = {TypeKind::Composite, composite.name, composite.size,
+                        1, description, ""};
+  schema.composites.push_back(std::move(composite));
+}
+
+void parse_types(Schema &schema, const Element &types) {
+  for (const auto &element : types.children) {
+    if (element.name == "type") {
+      if (is_constant(element)) {
+        throw std::runtime_error("Constant types are not supported: " +
+                                 element.attribute("name"));
+      }
+      schema.types[element.attribute("name")] = simple_type(element);
+    } else if (element.name == "enum") {
+      add_enum(schema, element);
+    } else if (element.name == "set") {
+      add_set(schema, element);
+    } else if (element.name == "composite") {
+      add_composite(schema, element);
+    } else {
+      throw std::runtime_error("Unsupported <" + element.name + ">");
+    }
+  }
+}
+
+// The fields of a block, laid out in order (or at their explicit offsets)
+std::vector<Field> parse_fields(const Schema &schema, const Element &block,
+                                size_t &size) {
+  std::vector<Field> fields;
+  size = 0;
+  for (const auto &child : block.children) {
+    if (child.name != "field") {
+      continue;
+    }
+    Field field;
+    field.name = child.attribute("name");
+    field.member = snake_case(field.name);
+    const auto &type_name = child.attribute("type");
+    const auto type = schema.types.find(type_name);
+    if (type != schema.types.end()) {
+      field.type = type->second;
+    } else {
+      field.type.cpp = primitive(type_name).cpp;
+      field.type.size = primitive(type_name).size;
+    }
+    if (const auto offset = child.optional_attribute("offset")) {
+      field.offset = to_size(*offset);
+      if (field.offset < size) {
+        throw std::runtime_error("Overlapping field " + field.name);
+      }
+    } else {
+      field.offset = size;
+    }
+    field.description = child.optional_attribute("description").value_or("");
+    field.since_version = since_version(child);
+    // a newer version appends its fields to the block
+    if (!fields.empty() && field.since_version < fields.back().since_version) {
+      throw std::runtime_error("Field " + field.name +
+                               " precedes the fields of a newer version");
+    }
+    size = field.offset + field.type.size;
+    fields.push_back(std::move(field));
+  }
+  return fields;
+}
+
+size_t declared_block_length(const Element &element, size_t size,
+                             const std::string &name) {
+  const auto declared = element.optional_attribute("blockLength");
+  const size_t block_length = declared ? to_size(*declared) : size;
+  if (block_length < size) {
+    throw std::runtime_error("blockLength of " + name +
+                             " smaller than its fields");
+  }
+  return block_length;
+}
+
+Message parse_message(const Schema &schema, const Element &element) {
+  Message message;
+  message.name = element.attribute("name");
+  message.id = static_cast<uint16_t>(to_size(element.attribute("id")));
+  message.since_version = since_version(element);
+  message.description =
+      element.optional_attribute("description").value_or("");
+  size_t size = 0;
+  message.fields = parse_fields(schema, element, size);
+  message.block_length = declared_block_length(element, size, message.name);
+
+  for (const auto &child : element.children) {
+    if (child.name == "data") {
+      throw std::runtime_error("Var data is not supported: " + message.name);
+    }
+    if (child.name != "group") {
+      continue;
+    }
+    if (std::any_of(child.children.begin(), child.children.end(),
+                    [](const Element &entry) {
+                      return entry.name != "field";
+                    })) {
+      throw std::runtime_error("Nested groups are not supported: " +
+                               message.name);
+    }
+    // an older decoder could not find the fields past the group
+    if (since_version(child) > message.since_version) {
+      throw std::runtime_error("Groups of a newer version are not supported: " +
+                               message.name);
+    }
+    Group group;
+    group.name = child.attribute("name");
+    group.member = snake_case(group.name);
+    group.description = child.optional_attribute("description").value_or("");
+    const auto dimension = schema.types.find(
+        child.optional_attribute("dimensionType").value_or("groupSize"));
+    if (dimension == schema.types.end() ||
+        dimension->second.kind != TypeKind::Composite) {
+      throw std::runtime_error("Unknown dimension of " + group.name);
+    }
+    group.dimension = dimension->second.cpp;
+    group.fields = parse_fields(schema, child, size);
+    group.block_length = declared_block_length(child, size, group.name);
+    message.groups.push_back(std::move(group));
+  }
+  return message;
+}
+
+Schema parse_schema(const Element &root) {
+  if (root.name != "messageSchema") {
+    throw std::runtime_error("Not an SBE schema: <" + root.name + ">");
+  }
+  if (root.optional_attribute("byteOrder").value_or("littleEndian") !=
+      "littleEndian") {
+    throw std::runtime_error("Only little endian schemas are supported");
+  }
+  Schema schema;
+  schema.package = root.optional_attribute("package").value_or("");
+  schema.id = static_cast<uint16_t>(to_size(root.attribute("id")));
+  schema.version =
+      static_cast<uint16_t>(to_size(root.optional_attribute("version")
+                                        .value_or("0")));
+  for (const auto &child : root.children) {
+    if (child.name == "types") {
+      parse_types(schema, child);
+    }
+  }
+  for (const auto &child : root.children) {
+    if (child.name == "message") {
+      schema.messages.push_back(parse_message(schema, child));
+    }
+  }
+  const auto header = schema.types.find("messageHeader");
+  if (header == schema.types.end() || header->second.size != 8) {
+    throw std::runtime_error("Expected the 8 bytes messageHeader composite");
+  }
+  return schema;
+}
+
+// --- C++ ---------------------------------------------------------------
+
+std::string single_line(std::string_view text) {
+  std::string line;
+  for (const char c : text) {
+    line += (c == '\n' || c == '\r') ? ' ' : c;
+  }
+  return trim(line);
+}
+
+// The text as // lines wrapped at 80 columns
+std::string comment(std::string_view indent, std::string_view text) {
+  constexpr size_t COLUMNS = 80;
+  std::istringstream words{std::string(text)};
+  std::string lines;
+  std::string line;
+  std::string word;
+  while (words >> word) {
+    if (!line.empty() &&
+        indent.size() + 3 + line.size() + 1 + word.size() > COLUMNS) {
+      lines += std::string(indent) + "// " + line + '\n';
+      line.clear();
+    }
+    line += (line.empty() ? "" : " ") + word;
+  }
+  if (!line.empty()) {
+    lines += std::string(indent) + "// " + line + '\n';
+  }
+  return lines;
+}
+
+// The expression printing a field of the struct in to_string()
+std::string printable(const Field &field, const std::string &scope) {
+  switch (field.type.kind) {
+    case TypeKind::Chars:
+      // up to the first NUL
+      return "std::string_view(" + field.member + ", std::find(" +
+             field.member + ", std::end(" + field.member + "), '\\0'))";
+    case TypeKind::Enum:
+      // the member to_string() hides the free ones
+      return scope + "::to_string(" + field.member + ")";
+    case TypeKind::Composite:
+      return field.member + ".to_string()";
+    case TypeKind::Primitive:
+      if (field.type.cpp == "int8_t" || field.type.cpp == "uint8_t") {
+        return "static_cast<int>(" + field.member + ")";
+      }
+      [[fallthrough]];
+    default:
+      return field.member;
+  }
+}
+
+// Optional fields start null: copied from the shorter block of an older
+// version, the fields it lacks read as null
+std::string member_declaration(const Field &field) {
+  if (field.type.kind == TypeKind::Chars) {
+    return field.type.cpp + " " + field.member + "[" +
+           std::to_string(field.type.length) + "]{};";
+  }
+  return field.type.cpp + " " + field.member + "{" + field.type.null_value +
+         "};";
+}
+
+// The versions changing the layout: the schema, then those adding messages
+// or fields
+std::set<uint16_t> layout_versions(const Schema &schema) {
+  std::set<uint16_t> versions{0};
+  for (const auto &message : schema.messages) {
+    versions.insert(message.since_version);
+    for (const auto &field : message.fields) {
+      versions.insert(field.since_version);
+    }
+    for (const auto &group : message.groups) {
+      for (const auto &field : group.fields) {
+        versions.insert(field.since_version);
+      }
+    }
+  }
+  return versions;
+}
+
+class Generator {
+ public:
+  Generator(const Schema &schema, std::string source, std::string scope)
+      : schema_(schema),
+        source_(std::move(source)),
+        namespace_(std::move(scope)),
+        scope_(namespace_.substr(namespace_.find_last_of(':') + 1)) {}
+
+  std::string generate() {
+    prologue();
+    for (const auto &entry : schema_.enums) {
+      enumeration(entry);
+    }
+    for (const auto &set : schema_.sets) {
+      bit_set(set);
+    }
+    for (const auto &composite : schema_.composites) {
+      structure(composite.name, composite.description, composite.fields,
+                composite.size, {}, "");
+    }
+    for (const auto &message : schema_.messages) {
+      message_struct(message);
+    }
+    for (const auto &message : schema_.messages) {
+      message_view(message);
+    }
+    dispatch();
+    out_ << "}  // namespace " << namespace_ << '\n';
+    return out_.str();
+  }
+
+ private:
+  void prologue() {
+    out_ << "// Generated by sbe_codegen from " << source_
+         << ", do not edit.\n"
+            "#pragma once\n\n"
+            "#include <algorithm>\n"
+            "#include <array>\n"
+            "#include <cstddef>\n"
+            "#include <cstdint>\n"
+            "#include <cstring>\n"
+            "#include <functional>\n"
+            "#include <limits>\n"
+            "#include <optional>\n"
+            "#include <ostream>\n"
+            "#include <sstream>\n"
+            "#include <string>\n"
+            "#include <string_view>\n"
+            "#include <type_traits>\n\n"
+            "#include \"simba_decoder/decimal.h\"\n"
+            "#include \"simba_decoder/sbe_views.h\"\n\n";
+    out_ << "namespace " << namespace_ << " {\n\n";
+    if (namespace_ != DEFAULT_NAMESPACE) {
+      for (const auto *name :
+           {"BlockView", "Decimal5", "GroupView", "skip_group"}) {
+        out_ << "using " << DEFAULT_NAMESPACE << "::" << name << ";\n";
+      }
+      out_ << '\n';
+    }
+    out_ << "// " << schema_.package << '\n';
+    out_ << "inline constexpr uint16_t SCHEMA_ID = " << schema_.id << ";\n";
+    out_ << "inline constexpr uint16_t SCHEMA_VERSION = " << schema_.version
+         << ";\n\n";
+  }
+
+  void enumeration(const Enum &entry) {
+    out_ << "enum class " << entry.name << " : " << entry.underlying
+         << " {\n";
+    for (const auto &value : entry.values) {
+      out_ << "  " << value.name << " = " << value.literal << ",";
+      if (!value.description.empty() && value.description != value.name) {
+        out_ << "  // " << single_line(value.description);
+      }
+      out_ << '\n';
+    }
+    out_ << "};\n\n";
+    out_ << "constexpr std::string_view to_string(" << entry.name
+         << " value) noexcept {\n"
+            "  switch (value) {\n";
+    for (const auto &value : entry.values) {
+      out_ << "    case " << entry.name << "::" << value.name << ":\n"
+           << "      return \"" << value.name << "\";\n";
+    }
+    out_ << "  }\n"
+            "  // never throw on values coming from a corrupted capture\n"
+            "  return \"UNKNOWN\";\n"
+            "}\n\n";
+  }
+
+  // A value holding the raw bits, with a test per choice. The unknown
+  // choices of a newer version are kept as is, and printed with the rest.
+  void bit_set(const Set &set) {
+    const auto &bits = set.underlying;
+    out_ << "// The choices of the " << set.name << " bit set\n";
+    out_ << "class " << set.name << " {\n public:\n";
+    for (const auto &choice : set.choices) {
+      if (!choice.description.empty()) {
+        out_ << comment("  ", choice.description);
+      }
+      out_ << "  static constexpr " << bits << " " << choice.name << " = "
+           << bits << "{1} << " << choice.bit << ";\n";
+    }
+    out_ << "\n  constexpr " << set.name << "() noexcept = default;\n"
+         << "  constexpr explicit " << set.name << "(" << bits
+         << " bits) noexcept : bits_(bits) {}\n\n"
+         << "  [[nodiscard]] constexpr " << bits
+         << " bits() const noexcept { return bits_; }\n\n"
+         << "  // Whether all the choices of mask are set\n"
+         << "  [[nodiscard]] constexpr bool has(" << bits
+         << " mask) const noexcept {\n"
+         << "    return (bits_ & mask) == mask;\n  }\n";
+    for (const auto &choice : set.choices) {
+      out_ << "\n";
+      if (!choice.description.empty()) {
+        out_ << comment("  ", choice.description);
+      }
+      out_ << "  [[nodiscard]] constexpr bool " << snake_case(choice.name)
+           << "() const noexcept {\n    return has(" << choice.name
+           << ");\n  }\n";
+    }
+    out_ << "\n  friend constexpr bool operator==(" << set.name << ", "
+         << set.name << ") noexcept = default;\n\n"
+         << " private:\n  " << bits << " bits_{0};\n};\n"
+         << "static_assert(sizeof(" << set.name << ") == sizeof(" << bits
+         << "));\n\n"
+         << "// The raw bits, as on the wire\n"
+         << "inline std::ostream &operator<<(std::ostream &stream, "
+         << set.name << " value) {\n"
+         << "  return stream << value.bits();\n}\n\n";
+  }
+
+  // A packed struct with the wire layout of the block. Nested declarations
+  // (the entries of the groups) go first, they take no space.
+  void structure(const std::string &name, const std::string &description,
+                 const std::vector<Field> &fields, size_t block_length,
+                 const std::string &nested, const std::string &constants,
+                 const std::string &indent = "") {
+    if (!description.empty() && description != name) {
+      out_ << comment(indent, description);
+    }
+    if (indent.empty()) {
+      out_ << "#pragma pack(push, 1)\n";
+    }
+    out_ << indent << "struct " << name << " {\n";
+    out_ << constants << nested;
+    size_t offset = 0;
+    for (const auto &field : fields) {
+      if (field.offset > offset) {
+        out_ << indent << "  std::byte reserved_" << offset << "["
+             << field.offset - offset << "]{};\n";
+      }
+      if (!field.description.empty()) {
+        out_ << comment(indent + "  ", field.name + ": " + field.description);
+      }
+      out_ << indent << "  " << member_declaration(field) << '\n';
+      offset = field.offset + field.type.size;
+    }
+    if (!fields.empty() && block_length > offset) {
+      out_ << indent << "  std::byte reserved_" << offset << "["
+           << block_length - offset << "]{};\n";
+    }
+
+    // the nested declarations and the constants end with a blank line
+    if (!fields.empty() || (nested.empty() && constants.empty())) {
+      out_ << '\n';
+    }
+    out_ << indent << "  [[nodiscard]] std::string to_string() const {\n"
+         << indent << "    std::stringstream sstream;\n"
+         << indent << "    sstream << \"" << name << "(\"";
+    for (size_t index = 0; index < fields.size(); ++index) {
+      const std::string label = indent + "    sstream << \"" +
+                                (index == 0 ? "" : ", ") +
+                                fields[index].member + ": \"";
+      const std::string value = printable(fields[index], scope_);
+      out_ << ";\n" << label;
+      if (label.size() + 4 + value.size() + 1 > 80) {
+        out_ << '\n' << indent << "            ";
+      } else {
+        out_ << ' ';
+      }
+      out_ << "<< " << value;
+    }
+    out_ << ";\n"
+         << indent << "    sstream << \")\";\n"
+         << indent << "    return sstream.str();\n"
+         << indent << "  }\n"
+         << indent << "};\n";
+    if (indent.empty()) {
+      out_ << "#pragma pack(pop)\n";
+    }
+    layout_checks(name, fields, block_length, indent);
+  }
+
+  void layout_checks(const std::string &name, const std::vector<Field> &fields,
+                     size_t block_length, const std::string &indent) {
+    // nested structs are checked with their message
+    const std::string qualified =
+        indent.empty() ? name : current_message_ + "::" + name;
+    auto &checks = indent.empty() ? out_ : deferred_checks_;
+    if (fields.empty()) {
+      checks << "static_assert(std::is_empty_v<" << qualified << ">);\n";
+    } else {
+      checks << "static_assert(sizeof(" << qualified << ") == " << block_length
+             << ");\n";
+      for (const auto &field : fields) {
+        checks << "static_assert(offsetof(" << qualified << ", "
+               << field.member << ") == " << field.offset << ");\n";
+      }
+    }
+    checks << "static_assert(std::is_trivially_copyable_v<" << qualified
+           << ">);\n";
+    if (indent.empty()) {
+      out_ << deferred_checks_.str() << '\n';
+      deferred_checks_.str({});
+    }
+  }
+
+  // The end of the fields known to each version: the block of an older
+  // version is shorter, a shorter one is malformed
+  static std::string min_block_length(const std::vector<Field> &fields,
+                                      const std::string &indent) {
+    std::map<uint16_t, size_t> ends{{0, 0}};
+    for (const auto &field : fields) {
+      ends[field.since_version] = field.offset + field.type.size;
+    }
+    std::ostringstream function;
+    function << indent << "static constexpr size_t min_block_length(";
+    if (ends.size() == 1) {
+      function << '\n'
+               << indent
+               << "    [[maybe_unused]] uint16_t version) noexcept {\n"
+               << indent << "  return " << ends.begin()->second << ";\n";
+    } else {
+      function << "uint16_t version) noexcept {\n";
+      size_t end = 0;
+      for (auto &[since, since_end] : ends) {
+        // a version without fields ends with the previous one
+        end = since_end = std::max(end, since_end);
+      }
+      for (auto since = ends.rbegin(); since != std::prev(ends.rend());
+           ++since) {
+        function << indent << "  if (version >= " << since->first << ") {\n"
+                 << indent << "    return " << since->second << ";\n"
+                 << indent << "  }\n";
+      }
+      function << indent << "  return " << ends.begin()->second << ";\n";
+    }
+    function << indent << "}\n\n";
+    return function.str();
+  }
+
+  void message_struct(const Message &message) {
+    current_message_ = message.name;
+    std::ostringstream constants;
+    constants << "  static constexpr uint16_t TEMPLATE_ID = " << message.id
+              << ";\n"
+              << "  static constexpr uint16_t SINCE_VERSION = "
+              << message.since_version << ";\n"
+              << "  static constexpr uint16_t BLOCK_LENGTH = "
+              << message.block_length << ";\n\n"
+              << min_block_length(message.fields, "  ");
+
+    // the entries of the groups, declared inside the message
+    std::ostringstream root;
+    root.swap(out_);
+    for (const auto &group : message.groups) {
+      structure(group.name, group.description, group.fields,
+                group.block_length, "",
+                "    static constexpr uint16_t BLOCK_LENGTH = " +
+                    std::to_string(group.block_length) + ";\n\n" +
+                    min_block_length(group.fields, "    "),
+                "  ");
+      out_ << '\n';
+    }
+    root.swap(out_);
+    structure(message.name, message.description, message.fields,
+              message.block_length, root.str(), constants.str());
+  }
+
+  void accessors(const std::vector<Field> &fields, const std::string &indent) {
+    for (const auto &field : fields) {
+      out_ << '\n';
+      if (!field.description.empty()) {
+        out_ << comment(indent, field.name + ": " + field.description);
+      }
+      if (field.type.kind == TypeKind::Chars) {
+        out_ << indent << "[[nodiscard]] std::string_view " << field.member
+             << "() const noexcept {\n"
+             << indent << "  return chars<" << field.offset << ", "
+             << field.type.length << ">();\n";
+      } else {
+        out_ << indent << "[[nodiscard]] " << field.type.cpp << " "
+             << field.member << "() const noexcept {\n"
+             << indent << "  return field<" << field.type.cpp << ", "
+             << field.offset << ">(" << field.type.null_value << ");\n";
+      }
+      out_ << indent << "}\n";
+    }
+  }
+
+  void common_members(const std::string &view, const std::string &message,
+                      bool empty, const std::string &indent) {
+    out_ << indent << "using BlockView::BlockView;\n";
+    if (!empty) {
+      out_ << '\n'
+           << indent << "// Views a decoded message\n"
+           << indent << "explicit " << view << "("
+           << (indent.size() + view.size() + message.size() + 35 > 80
+                   ? "\n" + indent + "    "
+                   : "")
+           << "const " << message << " &message) noexcept\n"
+           << indent << "    : BlockView(reinterpret_cast<const std::byte *>"
+              "(&message),\n"
+           << indent << "                sizeof(message)) {}\n";
+    }
+  }
+
+  void conversions(const std::string &message, bool empty,
+                   const std::string &indent) {
+    out_ << '\n'
+         << indent << "[[nodiscard]] " << message
+         << " to_message() const noexcept {\n"
+         << indent << "  return "
+         << (empty ? "{}" : "copy<" + message + ">()") << ";\n"
+         << indent << "}\n\n"
+         << indent << "[[nodiscard]] std::string to_string() const {\n"
+         << indent << "  return to_message().to_string();\n"
+         << indent << "}\n";
+  }
+
+  void message_view(const Message &message) {
+    const std::string view = message.name + "View";
+    if (!message.description.empty() && message.description != message.name) {
+      out_ << comment("", message.description);
+    }
+    out_ << "class " << view << " : public BlockView {\n"
+         << " public:\n";
+    for (const auto &group : message.groups) {
+      const std::string entry = group.name + "View";
+      out_ << "  class " << entry << " : public BlockView {\n"
+           << "   public:\n";
+      common_members(entry, message.name + "::" + group.name,
+                     group.fields.empty(), "    ");
+      accessors(group.fields, "    ");
+      conversions(message.name + "::" + group.name, group.fields.empty(),
+                  "    ");
+      out_ << "  };\n"
+           << "  using " << group.name << "Group = GroupView<" << entry
+           << ", " << group.dimension << ">;\n\n";
+    }
+    common_members(view, message.name, message.fields.empty(), "  ");
+    accessors(message.fields, "  ");
+
+    // each group starts where the previous one ends
+    std::string start = "data() + block_length()";
+    for (const auto &group : message.groups) {
+      out_ << '\n';
+      if (!group.description.empty()) {
+        out_ << comment("  ", group.name + ": " + group.description);
+      }
+      out_ << "  [[nodiscard]] " << group.name << "Group " << group.member
+           << "() const noexcept {\n"
+           << "    return " << group.name << "Group{" << start
+           << "};\n"
+           << "  }\n";
+      start = group.member + "().limit()";
+    }
+    conversions(message.name, message.fields.empty(), "  ");
+
+    out_ << "\n  // The root block and the groups\n"
+            "  [[nodiscard]] size_t size_bytes() const noexcept {\n";
+    if (message.groups.empty()) {
+      out_ << "    return block_length();\n";
+    } else {
+      out_ << "    return static_cast<size_t>(" << message.groups.back().member
+           << "().limit() - data());\n";
+    }
+    out_ << "  }\n\n"
+            "  // Bytes of the message starting at message, std::nullopt if "
+            "a block is\n"
+            "  // shorter than the fields of Version or the groups overrun "
+            "size\n"
+            "  template <uint16_t Version = SCHEMA_VERSION>\n"
+            "  [[nodiscard]] static std::optional<size_t> wire_size(\n"
+            "      [[maybe_unused]] const std::byte *message, "
+            "size_t block_length,\n"
+            "      size_t size) noexcept {\n"
+            "    size_t offset = block_length;\n"
+            "    if (offset > size ||\n"
+            "        block_length < "
+         << message.name
+         << "::min_block_length(Version)) {\n"
+            "      return std::nullopt;\n"
+            "    }\n";
+    for (const auto &group : message.groups) {
+      out_ << "    constexpr size_t " << group.member << "_block =\n"
+           << "        " << message.name << "::" << group.name
+           << "::min_block_length(Version);\n"
+           << "    if (!skip_group<" << group.dimension
+           << ">(message, size, offset, " << group.member << "_block)) {\n"
+              "      return std::nullopt;\n"
+              "    }\n";
+    }
+    out_ << "    return offset;\n"
+            "  }\n"
+            "};\n\n";
+  }
+
+  void dispatch() {
+    const auto versions = layout_versions(schema_);
+    out_ << "// Calls visitor with the std::integral_constant of the layout "
+            "version of\n"
+            "// the schema version: the last one adding messages or fields, "
+            "the newer\n"
+            "// versions only append what the layout skips. false for "
+            "another schema.\n"
+            "template <typename Visitor>\n"
+            "constexpr bool visit_version(uint16_t schema_id,\n"
+            "                             "
+         << (versions.size() == 1 ? "[[maybe_unused]] " : "")
+         << "uint16_t version,\n"
+            "                             Visitor &&visitor) {\n"
+            "  if (schema_id != SCHEMA_ID) {\n"
+            "    return false;\n"
+            "  }\n";
+    for (auto version = versions.rbegin();
+         version != std::prev(versions.rend()); ++version) {
+      out_ << "  if (version >= " << *version << ") {\n"
+           << "    visitor(std::integral_constant<uint16_t, " << *version
+           << ">{});\n"
+           << "    return true;\n"
+           << "  }\n";
+    }
+    out_ << "  visitor(std::integral_constant<uint16_t, 0>{});\n"
+            "  return true;\n"
+            "}\n\n";
+
+    out_ << "// Calls visitor with the std::type_identity of the view of the "
+            "template,\n"
+            "// false for the templates unknown to the Version of the "
+            "schema\n"
+            "template <uint16_t Version = SCHEMA_VERSION, typename Visitor>\n"
+            "constexpr bool visit_template(uint16_t template_id, "
+            "Visitor &&visitor) {\n"
+            "  switch (template_id) {\n";
+    for (const auto &message : schema_.messages) {
+      const auto visit = "visitor(std::type_identity<" + message.name +
+                         "View>{});\n";
+      out_ << "    case " << message.name << "::TEMPLATE_ID:\n";
+      if (message.since_version == 0) {
+        out_ << "      " << visit << "      return true;\n";
+        continue;
+      }
+      out_ << "      if constexpr (Version >= " << message.name
+           << "::SINCE_VERSION) {\n"
+           << "        " << visit << "        return true;\n"
+           << "      } else {\n"
+           << "        return false;\n"
+           << "      }\n";
+    }
+    out_ << "    default:\n"
+            "      return false;\n"
+            "  }\n"
+            "}\n\n";
+
+    out_ << "// Calls visitor with the view of the message\n"
+            "template <uint16_t Version = SCHEMA_VERSION, typename Visitor>\n"
+            "constexpr bool visit_message(uint16_t template_id, "
+            "const std::byte *message,\n"
+            "                             size_t block_length, "
+            "Visitor &&visitor) {\n"
+            "  return visit_template<Version>(\n"
+            "      template_id, [&]<typename View>(std::type_identity<View>) "
+            "{\n"
+            "        visitor(View{message, block_length});\n"
+            "      });\n"
+            "}\n\n";
+
+    out_ << "// The template ids of the schema, in its order\n"
+            "inline constexpr std::array<uint16_t, "
+         << schema_.messages.size() << "> TEMPLATE_IDS{";
+    for (size_t index = 0; index < schema_.messages.size(); ++index) {
+      out_ << (index == 0 ? "\n    " : ",\n    ")
+           << schema_.messages[index].name << "::TEMPLATE_ID";
+    }
+    out_ << "};\n\n"
+            "// Position of the template id in TEMPLATE_IDS, "
+            "TEMPLATE_IDS.size() for an\n"
+            "// id outside the schema: a dense index for the tables by "
+            "template\n"
+            "constexpr size_t template_index(uint16_t template_id) {\n"
+            "  switch (template_id) {\n";
+    for (size_t index = 0; index < schema_.messages.size(); ++index) {
+      out_ << "    case " << schema_.messages[index].name
+           << "::TEMPLATE_ID:\n"
+           << "      return " << index << ";\n";
+    }
+    out_ << "    default:\n"
+            "      return TEMPLATE_IDS.size();\n"
+            "  }\n"
+            "}\n\n";
+
+    out_ << "// One handler per template, the views point into the UDP "
+            "payload and are\n"
+            "// only valid during the call: use to_message() to keep a "
+            "message\n"
+            "struct MessageHandlers {\n";
+    for (const auto &message : schema_.messages) {
+      out_ << "  std::function<void(" << message.name << "View)> "
+           << snake_case(message.name) << "_handler;\n";
+    }
+    for (const auto &message : schema_.messages) {
+      const auto handler = snake_case(message.name) + "_handler";
+      out_ << "\n  void operator()(" << message.name
+           << "View message) const {\n"
+           << "    if (" << handler << ") {\n"
+           << "      " << handler << "(message);\n"
+           << "    }\n"
+           << "  }\n";
+    }
+    out_ << "};\n\n";
+  }
+
+  const Schema &schema_;
+  std::string source_;
+  std::ostringstream out_{};
+  std::ostringstream deferred_checks_{};
+  std::string current_message_{};
+  std::string namespace_;
+  // the innermost namespace, qualifying the free to_string() of the enums
+  std::string scope_;
+};
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  if (argc != 3 && argc != 4) {
+    std::cerr << "Usage: " << argv[0]
+              << " <schema.xml> <output.h> [namespace]\n";
+    return 2;
+  }
+  try {
+    std::ifstream input(argv[1], std::ios::binary);
+    if (!input) {
+      throw std::runtime_error(std::string("Cannot open ") + argv[1]);
+    }
+    std::stringstream document;
+    document << input.rdbuf();
+
+    const auto schema = parse_schema(XmlParser(document.str()).parse());
+    std::string source(argv[1]);
+    source = source.substr(source.find_last_of("/\\") + 1);
+    const auto header =
+        Generator(schema, source,
+                  argc == 4 ? argv[3] : std::string(DEFAULT_NAMESPACE))
+            .generate();
+
+    std::ofstream output(argv[2], std::ios::binary | std::ios::trunc);
+    output << header;
+    if (!output) {
+      throw std::runtime_error(std::string("Cannot write ") + argv[2]);
+    }
+  } catch (const std::exception &error) {
+    std::cerr << "sbe_codegen: " << error.what() << '\n';
+    return 1;
+  }
+  return 0;
+}
@@ -1,22 +1,291 @@
+#include <chrono>
+#include <csignal>
 #include <cstring>
 #include <filesystem>
 #include <fstream>
+#include <functional>
 #include <iostream>
 #include <span>
 #include <vector>
 
 #include "dimcli/cli.h"
-#include "processors/pcap_processor.h"
+#include "logging/logger.h"
+#include "market_data/bar_aggregator.h"
+#include "market_data/bbo_tracker.h"
+#include "market_data/market_by_price.h"
+#include "market_data/record_writer.h"
+#include "market_data/shared_book.h"
+#include "market_data/shared_bus.h"
+#include "metrics/metrics_exporter.h"
+#include "processors/capture_processor.h"
+#include "processors/capture_sources.h"
+#include "processors/checkpoint.h"
+#include "processors/follow_source.h"
+#include "processors/multicast_receiver.h"
+#include "processors/pcap_merger.h"
+#include "processors/raw_socket_source.h"
 #include "simba_decoder/simba_decoder.h"
 #include "simba_decoder/simba_types.h"
 
+namespace {
+// The clocks of the datagram being decoded, set while a source is decoded
+struct Clocks {
+  std::function<uint64_t()> capture;
+  std::function<uint64_t()> transact;
+  // the bars and the depth updates are timed by the exchange
+  bool exchange{false};
+
+  // Time of the trade being decoded, for the bars and the depth updates
+  [[nodiscard]] uint64_t trade() const {
+    return exchange ? transact() : capture();
+  }
+};
+
+// Saves a Checkpoint of a single capture file every `every` packets, the
+// run starts at the one it resumes
+struct Checkpointing {
+  std::filesystem::path path;
+  uint64_t every{0};
+  task::processors::Checkpoint start{};
+  // saves the state of the consumers of the messages into the checkpoint
+  std::function<void(task::processors::Checkpoint &)> save_state;
+  size_t saved{0};
+};
+
+// Key of an output file in a Checkpoint
+std::string output_key(const std::string &path) {
+  return std::filesystem::absolute(path).lexically_normal().string();
+}
+
+// Cuts an output of the run that saved the checkpoint back to its size at
+// the checkpoint, for the resumed run to append to it. Throws
+// std::runtime_error when the checkpoint has no such output or the file is
+// shorter.
+void resume_output(const task::processors::Checkpoint &checkpoint,
+                   const std::string &path) {
+  const auto found = checkpoint.outputs.find(output_key(path));
+  if (found == checkpoint.outputs.end()) {
+    throw std::runtime_error("No " + path + " output to resume");
+  }
+  if (std::filesystem::file_size(path) < found->second) {
+    throw std::runtime_error(path + ": shorter than at the checkpoint");
+  }
+  std::filesystem::resize_file(path, found->second);
+}
+
+task::processors::live::MulticastReceiver *live_receiver{nullptr};
+task::processors::live::RawSocketSource *live_capture{nullptr};
+task::processors::FollowSource *followed_capture{nullptr};
+
+void stop_live_receiver(int) {
+  if (live_receiver != nullptr) {
+    live_receiver->stop();
+  }
+  if (live_capture != nullptr) {
+    live_capture->stop();
+  }
+  if (followed_capture != nullptr) {
+    followed_capture->stop();
+  }
+}
+
+// Decodes the frames of the source until it is finished, for a live
+// interface until SIGINT/SIGTERM
+template <task::processors::PacketSource Source>
+void decode_source(Source &source,
+                   const task::simba::decoder::MessageHandlers &handlers,
+                   const std::vector<task::processors::FeedRoute> &feeds,
+                   task::transport_layer::ValidationConfig validation,
+                   Clocks &clocks, Checkpointing *checkpointing = nullptr) {
+  task::processors::CaptureProcessor processor(source, handlers, feeds,
+                                               validation);
+  clocks.capture = [&processor] { return processor.capture_time_ns(); };
+  clocks.transact = [&processor] { return processor.transact_time_ns(); };
+  if (checkpointing != nullptr &&
+      !checkpointing->start.sequence_numbers.empty()) {
+    processor.restore_sequence_numbers(checkpointing->start.sequence_numbers);
+  }
+  processor.start();
+  if (checkpointing == nullptr) {
+    processor.run();
+  } else {
+    uint64_t last_packet{0};
+    processor.run([&] {
+      if (processor.packets_processed() - last_packet <
+          checkpointing->every) {
+        return;
+      }
+      last_packet = processor.packets_processed();
+      task::processors::Checkpoint checkpoint;
+      checkpoint.capture = checkpointing->start.capture;
+      checkpoint.capture_size = checkpointing->start.capture_size;
+      checkpoint.file_offset =
+          checkpointing->start.file_offset + processor.bytes_processed();
+      checkpoint.packets = checkpointing->start.packets + last_packet;
+      checkpoint.sequence_numbers = processor.sequence_numbers();
+      checkpointing->save_state(checkpoint);
+      checkpoint.save(checkpointing->path);
+      ++checkpointing->saved;
+    });
+  }
+  processor.stop();
+  clocks.capture = nullptr;
+  clocks.transact = nullptr;
+}
+
+// A single file is read ahead by a producer thread, mapped in memory or
+// decompressed on the fly; several files are merged by timestamp. Only a
+// single uncompressed file is checkpointed: the offset of a record is not
+// enough to resume a merge or a decompression.
+void decode_files(const std::vector<std::string> &inputs, bool memory_map,
+                  const task::simba::decoder::MessageHandlers &handlers,
+                  const std::vector<task::processors::FeedRoute> &feeds,
+                  task::transport_layer::ValidationConfig validation,
+                  Clocks &clocks, Checkpointing *checkpointing) {
+  using namespace task::processors;
+
+  const auto files = list_captures(inputs);
+  const bool compressed = CompressedFileSource::is_compressed(files.front());
+  if (checkpointing != nullptr && (files.size() > 1 || compressed)) {
+    throw std::runtime_error("--checkpoint needs a single uncompressed file");
+  }
+  if (checkpointing != nullptr) {
+    // a resumed checkpoint must belong to the same capture
+    auto &start = checkpointing->start;
+    const auto capture = std::filesystem::canonical(files.front()).string();
+    const auto capture_size = std::filesystem::file_size(files.front());
+    if (!start.capture.empty() &&
+        (start.capture != capture || start.capture_size != capture_size)) {
+      throw std::runtime_error(checkpointing->path.string() +
+                               ": saved for " + start.capture + " of " +
+                               std::to_string(start.capture_size) +
+                               " bytes, not " + capture + " of " +
+                               std::to_string(capture_size) + " bytes");
+    }
+    start.capture = capture;
+    start.capture_size = capture_size;
+  }
+  const size_t offset = checkpointing != nullptr
+                            ? checkpointing->start.file_offset
+                            : PCAPFile::HEADER_SIZE;
+  if (files.size() > 1) {
+    MergedSource source(files);
+    decode_source(source, handlers, feeds, validation, clocks);
+  } else if (compressed) {
+    CompressedFileSource source(files.front());
+    decode_source(source, handlers, feeds, validation, clocks);
+  } else if (memory_map) {
+    MappedFileSource source(files.front(), offset);
+    decode_source(source, handlers, feeds, validation, clocks, checkpointing);
+  } else {
+    FileSource source(files.front(), offset);
+    decode_source(source, handlers, feeds, validation, clocks, checkpointing);
+  }
+}
+
+// Decodes the live feeds until SIGINT/SIGTERM, the kernel already stripped
+// the Ethernet/IP/UDP headers so datagrams go straight to the decoder
+void decode_live(task::processors::live::ReceiverConfig config,
+                 const task::simba::decoder::MessageHandlers &handlers,
+                 Clocks &clocks) {
+  using namespace task::processors::live;
+
+  task::simba::decoder::SIMBADecoder decoder(handlers);
+  // the kernel receive time, or the time of the handler without it
+  uint64_t receive_time_ns{0};
+  clocks.transact = [&decoder] {
+    const auto &header = decoder.incremental_header();
+    return header ? header->transact_time : 0;
+  };
+  clocks.capture = [&receive_time_ns] {
+    if (receive_time_ns != 0) {
+      return receive_time_ns;
+    }
+    const auto now = std::chrono::system_clock::now().time_since_epoch();
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(now).count());
+  };
+  MulticastReceiver receiver(config);
+  live_receiver = &receiver;
+  std::signal(SIGINT, stop_live_receiver);
+  std::signal(SIGTERM, stop_live_receiver);
+
+  uint64_t total_latency_ns{0};
+  size_t timestamped_datagrams{0};
+  const size_t datagrams = receiver.run([&](const Datagram &datagram) {
+    receive_time_ns = datagram.timestamp_ns;
+    decoder.decode_message(datagram.payload);
+    if (datagram.timestamp_ns != 0) {
+      const auto now = std::chrono::system_clock::now().time_since_epoch();
+      total_latency_ns +=
+          std::chrono::duration_cast<std::chrono::nanoseconds>(now).count() -
+          datagram.timestamp_ns;
+      ++timestamped_datagrams;
+    }
+  });
+  live_receiver = nullptr;
+  clocks.capture = nullptr;
+  clocks.transact = nullptr;
+
+  task::logging::log(task::logging::Level::Info,
+                     "[LIVE] - Total number of datagrams received: {}, "
+                     "malformed: {}, truncated: {}",
+                     datagrams, decoder.malformed_packets(),
+                     receiver.datagrams_truncated());
+  if (timestamped_datagrams > 0) {
+    task::logging::log(task::logging::Level::Info,
+                       "[LIVE] - Average kernel to handler latency: {} ns",
+                       total_latency_ns / timestamped_datagrams);
+  }
+}
+}  // namespace
+
 int main(int argc, char *argv[]) {
   Dim::Cli cli;
 
   cli.helpNoArgs();
 
-  auto &pcap_file_path =
-      cli.opt<std::string>("file").desc("PCAP file to analyze");
+  auto &pcap_file_paths =
+      cli.optVec<std::string>("file")
+          .desc("PCAP file or directory of files to analyze, can be repeated; "
+                "several files are merged by capture timestamp");
+  auto &multicast_groups =
+      cli.optVec<std::string>("mcast")
+          .desc("Live mode: multicast group address:port, can be repeated");
+  auto &interface_address =
+      cli.opt<std::string>("interface", "0.0.0.0")
+          .desc("Live mode: local interface address joining the groups");
+  auto &busy_poll_usec =
+      cli.opt<int>("busy-poll", 0).desc("Live mode: SO_BUSY_POLL in usec");
+  auto &kernel_timestamps = cli.opt<bool>("timestamps").desc(
+      "Live mode: report the latency from the SO_TIMESTAMPNS timestamps");
+  auto &capture_interface =
+      cli.opt<std::string>("capture-interface")
+          .desc("Live mode: decodes the Ethernet frames of this interface "
+                "(e.g. eth0) like a capture, needs CAP_NET_RAW");
+  auto &memory_map = cli.opt<bool>("mmap").desc(
+      "Maps a single uncompressed file in memory instead of reading it with a "
+      "producer thread");
+  auto &follow = cli.opt<bool>("follow").desc(
+      "Follows the --file capture as it is written, then the next captures "
+      "of its directory, until SIGINT/SIGTERM");
+  auto &metrics_json_path = cli.opt<std::string>("metrics-json").desc(
+      "Appends the pipeline metrics as JSON lines to this file");
+  auto &metrics_prometheus_path =
+      cli.opt<std::string>("metrics-prometheus")
+          .desc("Writes the pipeline metrics in Prometheus text format");
+  auto &metrics_interval_ms =
+      cli.opt<int>("metrics-interval", 1000).desc("Metrics export period (ms)");
+  auto &feeds =
+      cli.optVec<std::string>("feed")
+          .desc("Decodes only this feed, name=address:port[,address:port], "
+                "can be repeated; traffic is accounted per feed");
+  auto &verify_checksums = cli.opt<bool>("verify-checksums").desc(
+      "Verifies the IPv4 and UDP checksums, reports invalid packets per flow");
+  auto &drop_invalid = cli.opt<bool>("drop-invalid").desc(
+      "With --verify-checksums, does not decode packets with a bad checksum");
+  auto &verbose = cli.opt<bool>("verbose").desc(
+      "Also logs the per-batch progress (debug level)");
   auto &out_csv_path = cli.opt<std::string>("?out-orders-csv")
                            .desc("Decoded CSV output for incremental stream");
 
@@ -24,50 +293,582 @@ int main(int argc, char *argv[]) {
       cli.opt<std::string>("?out-book")
           .desc("Decoded OrderBook for order book snapshot");
 
+  auto &bars_spec =
+      cli.opt<std::string>("bars").desc(
+          "Aggregates the trades in OHLCV/VWAP bars per instrument: "
+          "time:<n>{ns,us,ms,s,m,h}, volume:<contracts> or tick:<trades>");
+  auto &bars_clock =
+      cli.opt<std::string>("bars-clock", "capture")
+          .desc("Clock of the trades for the time bars, and of the depth "
+                "updates")
+          .choice("capture", "capture", "Capture timestamp of the frames")
+          .choice("transact", "transact",
+                  "Exchange TransactTime of the SIMBA packets");
+  auto &out_bars_path =
+      cli.opt<std::string>("out-bars", "bars.csv").desc("Bar output file");
+  auto &bars_binary = cli.opt<bool>("bars-binary").desc(
+      "Writes the bars as raw 72-byte records instead of CSV");
+  auto &out_volume_profile_path =
+      cli.opt<std::string>("out-volume-profile")
+          .desc("With --bars, writes the volume traded per instrument and "
+                "price to this CSV file");
+  auto &book_depth =
+      cli.opt<int>("depth", 0).desc(
+          "Maintains the market-by-price book of each instrument from the "
+          "order updates and writes the changes of its N best levels per "
+          "side");
+  auto &out_depth_path =
+      cli.opt<std::string>("out-depth", "depth.csv").desc("Depth output file");
+  auto &depth_binary = cli.opt<bool>("depth-binary").desc(
+      "Writes the depth updates as raw 40-byte records instead of CSV");
+  auto &depth_conflate = cli.opt<bool>("depth-conflate").desc(
+      "Reports the depth and the BBO once per exchange transaction (MDFlags "
+      "EndOfTransaction) instead of after every order update");
+  auto &out_bbo_path =
+      cli.opt<std::string>("out-bbo").desc(
+          "Writes the changes of the best bid and offer of each instrument "
+          "to this file, as raw 56-byte records");
+  auto &shm_book_name =
+      cli.opt<std::string>("shm-book").desc(
+          "Publishes the best levels of each instrument to this POSIX shared "
+          "memory segment, read with SharedBookReader");
+  auto &shm_depth = cli.opt<int>("shm-depth", 10)
+                        .desc("Levels per side of --shm-book");
+  auto &shm_bus_name =
+      cli.opt<std::string>("shm-bus").desc(
+          "Broadcasts the decoded order updates and executions to this POSIX "
+          "shared memory ring, followed with SharedBusReader");
+  auto &shm_bus_capacity =
+      cli.opt<int>("shm-bus-capacity", 64 * 1024)
+          .desc("Events kept in the --shm-bus ring, a power of two");
+  auto &checkpoint_path =
+      cli.opt<std::string>("checkpoint").desc(
+          "Saves the position of the decoding, the --depth and --out-bbo "
+          "books and the open --bars to this file every --checkpoint-every "
+          "packets, removed once the capture is decoded");
+  auto &checkpoint_every = cli.opt<int>("checkpoint-every", 1'000'000)
+                               .desc("Packets between two checkpoints");
+  auto &resume = cli.opt<bool>("resume").desc(
+      "Restarts from the --checkpoint file left by a run that did not "
+      "finish and carries on its outputs, from the start of the capture "
+      "without one");
+
   if (!cli.parse(argc, argv)) {
     return cli.printError(std::cerr);
   }
 
-  std::optional<std::ofstream> decoded_stream_csv{std::nullopt};
-  if (out_csv_path) {
-    std::filesystem::path decoded_csv_file(*out_csv_path);
-    decoded_stream_csv = std::ofstream(decoded_csv_file.string());
+  std::optional<task::market_data::BarConfig> bar_config;
+  if (!bars_spec->empty()) {
+    try {
+      bar_config = task::market_data::BarConfig::parse(*bars_spec);
+    } catch (const std::exception &error) {
+      cli.fail(Dim::kExitUsage, error.what());
+      return cli.printError(std::cerr);
+    }
   }
 
-  std::optional<std::ofstream> output_book_file_stream{std::nullopt};
-  if (out_snapshot_log_path) {
-    std::filesystem::path output_book_file(*out_snapshot_log_path);
-    output_book_file_stream = std::ofstream(output_book_file.string());
+  if (*book_depth < 0 || *book_depth > 255) {
+    cli.fail(Dim::kExitUsage, "--depth must be between 0 and 255");
+    return cli.printError(std::cerr);
+  }
+  if (*shm_depth < 1 || *shm_depth > 255) {
+    cli.fail(Dim::kExitUsage, "--shm-depth must be between 1 and 255");
+    return cli.printError(std::cerr);
+  }
+  if (*checkpoint_every < 1) {
+    cli.fail(Dim::kExitUsage, "--checkpoint-every must be positive");
+    return cli.printError(std::cerr);
+  }
+  if (*resume && checkpoint_path->empty()) {
+    cli.fail(Dim::kExitUsage, "--resume needs --checkpoint");
+    return cli.printError(std::cerr);
+  }
+  // the segment is reset when it is created: readers would see the book of
+  // the packets after the checkpoint only
+  if (*resume && !shm_book_name->empty()) {
+    cli.fail(Dim::kExitUsage, "--resume cannot publish a --shm-book");
+    return cli.printError(std::cerr);
+  }
+  if (!checkpoint_path->empty() &&
+      (!multicast_groups->empty() || !capture_interface->empty() || *follow)) {
+    cli.fail(Dim::kExitUsage, "--checkpoint needs complete capture files");
+    return cli.printError(std::cerr);
+  }
+  if (*follow && pcap_file_paths->size() != 1) {
+    cli.fail(Dim::kExitUsage, "--follow needs a single --file");
+    return cli.printError(std::cerr);
   }
 
-  cli.action([&pcap_file_path, &decoded_stream_csv,
-              &output_book_file_stream](Dim::Cli &) {
+  cli.action([&](Dim::Cli &) {
+    if (*verbose) {
+      task::logging::set_level(task::logging::Level::Debug);
+    }
+    std::optional<task::metrics::MetricsExporter> metrics_exporter;
+    if (!metrics_json_path->empty() || !metrics_prometheus_path->empty()) {
+      task::metrics::ExporterConfig config;
+      if (!metrics_json_path->empty()) {
+        config.json_lines_path = *metrics_json_path;
+      }
+      if (!metrics_prometheus_path->empty()) {
+        config.prometheus_path = *metrics_prometheus_path;
+      }
+      config.interval = std::chrono::milliseconds(*metrics_interval_ms);
+      metrics_exporter.emplace(std::move(config));
+    }
+
+    std::vector<std::string> output_paths;
+    if (out_csv_path) {
+      output_paths.push_back(*out_csv_path);
+    }
+    if (out_snapshot_log_path) {
+      output_paths.push_back(*out_snapshot_log_path);
+    }
+    if (bar_config) {
+      output_paths.push_back(*out_bars_path);
+    }
+    if (*book_depth > 0) {
+      output_paths.push_back(*out_depth_path);
+    }
+    if (!out_bbo_path->empty()) {
+      output_paths.push_back(*out_bbo_path);
+    }
+    // the outputs of a resumed run carry on those of the run that died
+    std::optional<task::processors::Checkpoint> resumed;
+    if (*resume) {
+      try {
+        resumed = task::processors::Checkpoint::load(*checkpoint_path);
+        if (resumed) {
+          for (const auto &path : output_paths) {
+            resume_output(*resumed, path);
+          }
+        }
+      } catch (const std::exception &error) {
+        task::logging::log(task::logging::Level::Error, "{}", error.what());
+        cli.fail(1, error.what());
+        return false;
+      }
+      if (!resumed) {
+        task::logging::log(task::logging::Level::Info,
+                           "[CHECKPOINT] - No checkpoint in {}, starting "
+                           "from the first packet",
+                           *checkpoint_path);
+      }
+    }
+    const auto output_mode = [&resumed](bool binary) {
+      return std::ios::out |
+             (binary ? std::ios::binary : std::ios::openmode{}) |
+             (resumed ? std::ios::app : std::ios::trunc);
+    };
+
+    std::optional<std::ofstream> decoded_stream_csv{std::nullopt};
+    if (out_csv_path) {
+      decoded_stream_csv = std::ofstream(*out_csv_path, output_mode(false));
+    }
+    std::optional<std::ofstream> output_book_file_stream{std::nullopt};
+    if (out_snapshot_log_path) {
+      output_book_file_stream =
+          std::ofstream(*out_snapshot_log_path, output_mode(false));
+    }
+
     task::simba::decoder::MessageHandlers handlers;
     if (decoded_stream_csv) {
       handlers.order_execution_handler =
           [&decoded_stream_csv](
-              const task::simba::types::OrderExecution &order_execution) {
-            *decoded_stream_csv << "ORDER_EXECUTION, "
-                                << order_execution.to_csv_string() << std::endl;
+              task::simba::types::OrderExecutionView order_execution) {
+            *decoded_stream_csv
+                << "ORDER_EXECUTION, "
+                << task::simba::types::to_csv_string(
+                       order_execution.to_message())
+                << std::endl;
           };
       handlers.order_update_handler =
           [&decoded_stream_csv](
-              const task::simba::types::OrderUpdate &order_update) {
-            *decoded_stream_csv << "ORDER_UPDATE, "
-                                << order_update.to_csv_string() << std::endl;
+              task::simba::types::OrderUpdateView order_update) {
+            *decoded_stream_csv
+                << "ORDER_UPDATE, "
+                << task::simba::types::to_csv_string(order_update.to_message())
+                << std::endl;
           };
     }
 
+    Clocks clocks;
+    clocks.exchange = *bars_clock == "transact";
+    std::ofstream bars_stream;
+    std::optional<task::market_data::BarAggregator> bar_aggregator;
+    if (bar_config) {
+      bars_stream.open(*out_bars_path, output_mode(*bars_binary));
+      if (!*bars_binary && !resumed) {
+        bars_stream << task::market_data::Bar::CSV_HEADER << '\n';
+      }
+      bar_aggregator.emplace(
+          *bar_config,
+          [&bars_stream, binary = *bars_binary](
+              const task::market_data::Bar &bar) {
+            if (binary) {
+              bars_stream.write(reinterpret_cast<const char *>(&bar),
+                                sizeof(bar));
+            } else {
+              bars_stream << bar.to_csv_string() << '\n';
+            }
+          },
+          !out_volume_profile_path->empty());
+      handlers.order_execution_handler =
+          [&bar_aggregator, &clocks,
+           csv_handler = std::move(handlers.order_execution_handler)](
+              task::simba::types::OrderExecutionView order_execution) {
+            if (csv_handler) {
+              csv_handler(order_execution);
+            }
+            bar_aggregator->on_trade(order_execution, clocks.trade());
+          };
+      // the end of a transaction may be flagged on an order update
+      handlers.order_update_handler =
+          [&bar_aggregator,
+           csv_handler = std::move(handlers.order_update_handler)](
+              task::simba::types::OrderUpdateView order_update) {
+            if (csv_handler) {
+              csv_handler(order_update);
+            }
+            bar_aggregator->on_order_update(order_update);
+          };
+    }
+    std::ofstream depth_stream;
+    std::optional<task::market_data::MarketByPrice> market_by_price;
+    if (*book_depth > 0) {
+      depth_stream.open(*out_depth_path, output_mode(*depth_binary));
+      if (!*depth_binary && !resumed) {
+        depth_stream << task::market_data::DepthUpdate::CSV_HEADER << '\n';
+      }
+      market_by_price.emplace(
+          static_cast<size_t>(*book_depth),
+          [&depth_stream, binary = *depth_binary](
+              const task::market_data::DepthUpdate &update) {
+            if (binary) {
+              depth_stream.write(reinterpret_cast<const char *>(&update),
+                                 sizeof(update));
+            } else {
+              depth_stream << update.to_csv_string() << '\n';
+            }
+          },
+          task::market_data::MarketByPrice::DEFAULT_WINDOW, *depth_conflate);
+      handlers.order_update_handler =
+          [&market_by_price, &clocks,
+           previous = std::move(handlers.order_update_handler)](
+              task::simba::types::OrderUpdateView order_update) {
+            if (previous) {
+              previous(order_update);
+            }
+            market_by_price->on_order_update(order_update, clocks.trade());
+          };
+      handlers.order_execution_handler =
+          [&market_by_price, &clocks,
+           previous = std::move(handlers.order_execution_handler)](
+              task::simba::types::OrderExecutionView order_execution) {
+            if (previous) {
+              previous(order_execution);
+            }
+            market_by_price->on_order_execution(order_execution,
+                                                clocks.trade());
+          };
+    }
+    std::optional<
+        task::market_data::RecordWriter<task::market_data::BboUpdate>>
+        bbo_writer;
+    std::optional<task::market_data::BboTracker> bbo_tracker;
+    if (!out_bbo_path->empty()) {
+      try {
+        bbo_writer.emplace(
+            *out_bbo_path,
+            task::market_data::RecordWriter<
+                task::market_data::BboUpdate>::DEFAULT_BUFFER_RECORDS,
+            resumed.has_value());
+      } catch (const std::exception &error) {
+        task::logging::log(task::logging::Level::Error, "{}", error.what());
+        cli.fail(1, error.what());
+        return false;
+      }
+      bbo_tracker.emplace(
+          [&bbo_writer](const task::market_data::BboUpdate &update) {
+            bbo_writer->write(update);
+          },
+          *depth_conflate);
+      handlers.order_update_handler =
+          [&bbo_tracker, &clocks,
+           previous = std::move(handlers.order_update_handler)](
+              task::simba::types::OrderUpdateView order_update) {
+            if (previous) {
+              previous(order_update);
+            }
+            bbo_tracker->on_order_update(order_update, clocks.capture(),
+                                         clocks.transact());
+          };
+      handlers.order_execution_handler =
+          [&bbo_tracker, &clocks,
+           previous = std::move(handlers.order_execution_handler)](
+              task::simba::types::OrderExecutionView order_execution) {
+            if (previous) {
+              previous(order_execution);
+            }
+            bbo_tracker->on_order_execution(order_execution, clocks.capture(),
+                                            clocks.transact());
+          };
+    }
+    std::optional<task::market_data::SharedBookPublisher> shared_book;
+    if (!shm_book_name->empty()) {
+      try {
+        shared_book.emplace(
+            *shm_book_name, static_cast<size_t>(*shm_depth),
+            task::market_data::SharedBookPublisher::DEFAULT_CAPACITY,
+            *depth_conflate);
+      } catch (const std::exception &error) {
+        task::logging::log(task::logging::Level::Error, "{}", error.what());
+        cli.fail(1, error.what());
+        return false;
+      }
+      handlers.order_update_handler =
+          [&shared_book, &clocks,
+           previous = std::move(handlers.order_update_handler)](
+              task::simba::types::OrderUpdateView order_update) {
+            if (previous) {
+              previous(order_update);
+            }
+            shared_book->on_order_update(order_update, clocks.trade());
+          };
+      handlers.order_execution_handler =
+          [&shared_book, &clocks,
+           previous = std::move(handlers.order_execution_handler)](
+              task::simba::types::OrderExecutionView order_execution) {
+            if (previous) {
+              previous(order_execution);
+            }
+            shared_book->on_order_execution(order_execution, clocks.trade());
+          };
+    }
+    std::optional<task::market_data::SharedBusWriter> shared_bus;
+    if (!shm_bus_name->empty()) {
+      try {
+        shared_bus.emplace(*shm_bus_name,
+                           static_cast<size_t>(*shm_bus_capacity));
+      } catch (const std::exception &error) {
+        task::logging::log(task::logging::Level::Error, "{}", error.what());
+        cli.fail(1, error.what());
+        return false;
+      }
+      handlers.order_update_handler =
+          [&shared_bus, &clocks,
+           previous = std::move(handlers.order_update_handler)](
+              task::simba::types::OrderUpdateView order_update) {
+            if (previous) {
+              previous(order_update);
+            }
+            shared_bus->publish(order_update, clocks.capture(),
+                                clocks.transact());
+          };
+      handlers.order_execution_handler =
+          [&shared_bus, &clocks,
+           previous = std::move(handlers.order_execution_handler)](
+              task::simba::types::OrderExecutionView order_execution) {
+            if (previous) {
+              previous(order_execution);
+            }
+            shared_bus->publish(order_execution, clocks.capture(),
+                                clocks.transact());
+          };
+    }
+    // the bars still open when the stream ends
+    const auto flush_bars = [&] {
+      if (shared_bus) {
+        task::logging::log(task::logging::Level::Info,
+                           "[BUS] - {} events published to {}",
+                           shared_bus->published(), *shm_bus_name);
+      }
+      if (shared_book) {
+        shared_book->flush();
+        task::logging::log(task::logging::Level::Info,
+                           "[SHM] - {} slot writes to {}, {} instruments "
+                           "dropped",
+                           shared_book->commits(), *shm_book_name,
+                           shared_book->dropped_instruments());
+      }
+      if (bbo_tracker) {
+        bbo_tracker->flush();
+        bbo_writer->flush();
+        task::logging::log(task::logging::Level::Info,
+                           "[BBO] - {} instruments, {} updates",
+                           bbo_tracker->book().instruments(),
+                           bbo_tracker->updates());
+      }
+      if (market_by_price) {
+        market_by_price->flush();
+        task::logging::log(
+            task::logging::Level::Info,
+            "[DEPTH] - {} instruments, {} orders resting, {} updates, {} "
+            "transactions, {} unknown orders",
+            market_by_price->instruments(), market_by_price->orders(),
+            market_by_price->updates(), market_by_price->transactions(),
+            market_by_price->unknown_orders());
+      }
+      if (!bar_aggregator) {
+        return;
+      }
+      bar_aggregator->flush();
+      task::logging::log(task::logging::Level::Info,
+                         "[BARS] - {} trades of {} instruments, {} bars",
+                         bar_aggregator->trades(),
+                         bar_aggregator->instruments(),
+                         bar_aggregator->bars());
+      if (!out_volume_profile_path->empty()) {
+        std::ofstream profile(*out_volume_profile_path);
+        bar_aggregator->write_volume_profile(profile);
+      }
+    };
+
     if (output_book_file_stream) {
       handlers.order_book_snapshot_handler =
           [&output_book_file_stream](
-              const task::simba::types::OrderBookSnapshot &book) {
-            *output_book_file_stream << book.to_string() << std::endl;
+              task::simba::types::OrderBookSnapshotView book) {
+            *output_book_file_stream
+                << task::simba::types::SnapshotBook(book).to_string()
+                << std::endl;
+          };
+    }
+
+    if (!multicast_groups->empty()) {
+      task::processors::live::ReceiverConfig config;
+      for (const auto &group : *multicast_groups) {
+        config.groups.push_back(
+            task::processors::live::Endpoint::parse(group));
+      }
+      config.interface_address = *interface_address;
+      config.busy_poll_usec = *busy_poll_usec;
+      config.kernel_timestamps = *kernel_timestamps;
+      decode_live(std::move(config), handlers, clocks);
+      flush_bars();
+      return true;
+    }
+
+    std::optional<Checkpointing> checkpointing;
+    if (!checkpoint_path->empty()) {
+      checkpointing.emplace();
+      checkpointing->path = *checkpoint_path;
+      checkpointing->every = static_cast<uint64_t>(*checkpoint_every);
+      checkpointing->start.file_offset =
+          task::processors::PCAPFile::HEADER_SIZE;
+      checkpointing->save_state =
+          [&](task::processors::Checkpoint &checkpoint) {
+            if (decoded_stream_csv) {
+              decoded_stream_csv->flush();
+            }
+            if (output_book_file_stream) {
+              output_book_file_stream->flush();
+            }
+            bars_stream.flush();
+            depth_stream.flush();
+            if (bbo_writer) {
+              bbo_writer->flush();
+            }
+            for (const auto &path : output_paths) {
+              checkpoint.outputs[output_key(path)] =
+                  std::filesystem::file_size(path);
+            }
+            if (market_by_price) {
+              market_by_price->save(checkpoint.states["depth"]);
+            }
+            if (bbo_tracker) {
+              bbo_tracker->save(checkpoint.states["bbo"]);
+            }
+            if (bar_aggregator) {
+              bar_aggregator->save(checkpoint.states["bars"]);
+            }
           };
     }
+    if (checkpointing && resumed) {
+      // a consumer without a state was not enabled in the run that saved it
+      const auto state = [&](const std::string &name) {
+        const auto found = resumed->states.find(name);
+        if (found == resumed->states.end()) {
+          throw std::runtime_error(*checkpoint_path + ": no " + name +
+                                   " state to resume");
+        }
+        return std::span<const std::byte>(found->second);
+      };
+      try {
+        if (market_by_price) {
+          market_by_price->restore(state("depth"));
+        }
+        if (bbo_tracker) {
+          bbo_tracker->restore(state("bbo"));
+        }
+        if (bar_aggregator) {
+          bar_aggregator->restore(state("bars"));
+        }
+      } catch (const std::exception &error) {
+        task::logging::log(task::logging::Level::Error, "{}", error.what());
+        cli.fail(1, error.what());
+        return false;
+      }
+      std::string sequence_numbers;
+      for (const auto sequence_number : resumed->sequence_numbers) {
+        sequence_numbers += (sequence_numbers.empty() ? "" : ", ") +
+                            std::to_string(sequence_number);
+      }
+      task::logging::log(task::logging::Level::Info,
+                         "[CHECKPOINT] - Resuming after {} packets, at "
+                         "offset {}, last sequence numbers: {}",
+                         resumed->packets, resumed->file_offset,
+                         sequence_numbers);
+      checkpointing->start = std::move(*resumed);
+    }
 
-    task::processors::PCAPProcessor pcap_processor(
-        std::string(pcap_file_path->c_str()), handlers);
+    std::vector<task::processors::FeedRoute> feed_routes;
+    for (const auto &feed : *feeds) {
+      feed_routes.push_back(task::processors::FeedRoute::parse(feed));
+    }
+    task::transport_layer::ValidationConfig validation;
+    validation.verify_checksums = *verify_checksums;
+    validation.drop_invalid = *drop_invalid;
+    try {
+      if (!capture_interface->empty()) {
+        task::processors::live::RawSocketSource source(*capture_interface);
+        live_capture = &source;
+        std::signal(SIGINT, stop_live_receiver);
+        std::signal(SIGTERM, stop_live_receiver);
+        decode_source(source, handlers, feed_routes, validation, clocks);
+        live_capture = nullptr;
+        task::logging::log(task::logging::Level::Info,
+                           "[LIVE] - Frames truncated: {}",
+                           source.frames_truncated());
+      } else if (*follow) {
+        task::processors::FollowSource source(pcap_file_paths->front());
+        followed_capture = &source;
+        std::signal(SIGINT, stop_live_receiver);
+        std::signal(SIGTERM, stop_live_receiver);
+        decode_source(source, handlers, feed_routes, validation, clocks);
+        followed_capture = nullptr;
+        task::logging::log(task::logging::Level::Info,
+                           "[FOLLOW] - {} captures followed, up to {}",
+                           source.files(), source.path().string());
+      } else {
+        decode_files(*pcap_file_paths, *memory_map, handlers, feed_routes,
+                     validation, clocks,
+                     checkpointing ? &*checkpointing : nullptr);
+      }
+      flush_bars();
+      if (checkpointing) {
+        // the capture is decoded: nothing left to resume
+        std::filesystem::remove(checkpointing->path);
+        task::logging::log(task::logging::Level::Info,
+                           "[CHECKPOINT] - {} checkpoints saved to {}",
+                           checkpointing->saved, *checkpoint_path);
+      }
+    } catch (const std::exception &error) {
+      live_capture = nullptr;
+      followed_capture = nullptr;
+      task::logging::log(task::logging::Level::Error, "{}", error.what());
+      task::logging::flush();
+      cli.fail(1, error.what());
+      return false;
+    }
     return true;
   });
 
@@ -0,0 +1,192 @@
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "dimcli/cli.h"
+#include "logging/logger.h"
+#include "processors/packet_processor.h"
+#include "processors/pcap_buffer.h"
+#include "processors/pcap_file.h"
+#include "processors/replay_pacer.h"
+#include "processors/udp_sender.h"
+
+namespace {
+// 16MB batches read ahead of the sender: a paced replay sleeps most of the
+// time, the capture is not loaded in memory meanwhile
+constexpr size_t READ_AHEAD_BATCHES = 4;
+constexpr size_t CONSUMER_BUFFERING_TIME{500};
+
+// Prints the achieved rate once per REPORT_INTERVAL_NS
+class RateReport {
+ public:
+  explicit RateReport(const task::processors::live::UDPSender &sender)
+      : sender_(sender), last_report_ns_(now()) {}
+
+  void update() {
+    const uint64_t current_ns = now();
+    if (current_ns - last_report_ns_ >= REPORT_INTERVAL_NS) {
+      print("rate", current_ns - last_report_ns_, sender_.datagrams_sent(),
+            sender_.bytes_sent());
+    }
+  }
+
+  void summary(uint64_t elapsed_ns, uint64_t max_lateness_ns) {
+    last_datagrams_ = last_bytes_ = 0;
+    print("total", elapsed_ns, sender_.datagrams_sent(), sender_.bytes_sent());
+    task::logging::log(
+        task::logging::Level::Info,
+        "[PCAP_REPLAY] sent {} datagrams ({} bytes), max pacing lateness {} ns",
+        sender_.datagrams_sent(), sender_.bytes_sent(), max_lateness_ns);
+  }
+
+ private:
+  static uint64_t now() { return task::processors::live::ReplayPacer::now(); }
+
+  void print(std::string_view label, uint64_t interval_ns, size_t datagrams,
+             size_t bytes) {
+    const double seconds = static_cast<double>(interval_ns) / 1e9;
+    task::logging::log(
+        task::logging::Level::Info, "[PCAP_REPLAY] {}: {} datagrams/s, {} Mbit/s",
+        label, static_cast<uint64_t>((datagrams - last_datagrams_) / seconds),
+        static_cast<double>(bytes - last_bytes_) * 8 / seconds / 1e6);
+    last_report_ns_ += interval_ns;
+    last_datagrams_ = datagrams;
+    last_bytes_ = bytes;
+  }
+
+  const task::processors::live::UDPSender &sender_;
+  uint64_t last_report_ns_{0};
+  size_t last_datagrams_{0};
+  size_t last_bytes_{0};
+
+  static constexpr uint64_t REPORT_INTERVAL_NS = 1'000'000'000;
+};
+
+// Sends the UDP payloads of the capture, paced by its timestamps
+void replay(const std::string &pcap_file_path,
+            const std::vector<std::string> &destinations,
+            const std::string &interface_address, int ttl, double speed) {
+  using namespace task::processors;
+
+  live::SenderConfig config;
+  for (const auto &destination : destinations) {
+    config.destinations.push_back(live::Endpoint::parse(destination));
+  }
+  config.interface_address = interface_address;
+  config.ttl = ttl;
+  live::UDPSender sender(config);
+
+  auto pcap_file = open_pcap_file(pcap_file_path);
+  mt_buffer::PCAPBuffer pcap_buffer(pcap_file.stream, pcap_file.file_size,
+                                    PCAPFile::HEADER_SIZE,
+                                    READ_AHEAD_BATCHES);
+
+  auto handler = [&sender](std::span<const std::byte> udp_payload) {
+    sender.send(udp_payload);
+  };
+
+  live::ReplayPacer pacer(std::max(speed, 0.0));
+  RateReport report(sender);
+  uint64_t max_lateness_ns{0};
+
+  const auto replay_batch = [&](auto &processor,
+                                const mt_buffer::BufferedPackets &batch) {
+    if (!pacer.is_paced()) {
+      processor.process_batch(batch.packets, batch.headers,
+                              pcap_file.header.magic_number);
+      report.update();
+      return;
+    }
+    for (size_t index = 0; index < batch.number_packets; ++index) {
+      const uint64_t capture_time_ns = task::pcap::types::to_nanoseconds(
+          batch.headers[index], pcap_file.header.magic_number);
+      const uint64_t deadline = pacer.deadline(capture_time_ns);
+      // send what is due before waiting for the next packet
+      if (deadline > live::ReplayPacer::now()) {
+        sender.flush();
+      }
+      // a packet already late is measured as well: its backlog is the
+      // lateness that matters
+      max_lateness_ns = std::max(max_lateness_ns, pacer.wait_until(deadline));
+      processor.process_packet(batch.packets[index], capture_time_ns);
+      report.update();
+    }
+  };
+
+  const uint64_t start_ns = live::ReplayPacer::now();
+  // the link layer is resolved once for the whole file
+  const auto replay_file = [&]<typename LinkLayer>(LinkLayer) {
+    PacketProcessor<decltype(handler), LinkLayer> processor(handler);
+    pcap_buffer.start_buffering();
+    try {
+      while (true) {
+        // read the flag first: once finished, an empty queue stays empty
+        const bool is_finished = pcap_buffer.is_finished();
+        if (auto batch = pcap_buffer.next_batch()) {
+          replay_batch(processor, *batch);
+        } else if (is_finished) {
+          break;
+        } else {
+          std::this_thread::sleep_for(
+              std::chrono::microseconds(CONSUMER_BUFFERING_TIME));
+        }
+      }
+    } catch (...) {
+      // a send failed: the producer is joined before the error is reported
+      pcap_buffer.stop();
+      throw;
+    }
+    pcap_buffer.thread().join();
+  };
+  if (!task::transport_layer::visit_link_type(pcap_file.header.network,
+                                              replay_file)) {
+    throw std::runtime_error("unsupported link type " +
+                             std::to_string(pcap_file.header.network));
+  }
+  sender.flush();
+
+  report.summary(live::ReplayPacer::now() - start_ns, max_lateness_ns);
+}
+}  // namespace
+
+int main(int argc, char *argv[]) {
+  Dim::Cli cli;
+
+  cli.helpNoArgs();
+
+  auto &pcap_file_path =
+      cli.opt<std::string>("file").desc("PCAP file to replay");
+  auto &destinations =
+      cli.optVec<std::string>("destination")
+          .desc("address:port receiving the UDP payloads, can be repeated");
+  auto &interface_address =
+      cli.opt<std::string>("interface")
+          .desc("Local interface address for the outgoing multicast");
+  auto &ttl = cli.opt<int>("ttl", 1).desc("Multicast time to live");
+  auto &speed = cli.opt<double>("speed", 1.0).desc(
+      "Pace multiplier of the capture timestamps, 0 sends as fast as "
+      "possible");
+
+  cli.action([&](Dim::Cli &) {
+    try {
+      replay(*pcap_file_path, *destinations, *interface_address, *ttl,
+             *speed);
+    } catch (const std::exception &error) {
+      task::logging::log(task::logging::Level::Error, "{}", error.what());
+      task::logging::flush();
+      cli.fail(1, error.what());
+      return false;
+    }
+    return true;
+  });
+
+  cli.exec(static_cast<size_t>(argc), argv);
+  return cli.exitCode();
+}
+
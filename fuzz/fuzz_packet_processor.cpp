@@ -0,0 +1,45 @@
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "processors/packet_processor.h"
+#include "simba_decoder/simba_decoder.h"
+
+// Feeds arbitrary link-layer frames through the Ethernet/IP/UDP parsing of
+// PacketProcessor, packet by packet and as a batch, and then into the SIMBA
+// decoder. The checksum validation runs on the same frame.
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+  using namespace task;
+
+  static simba::decoder::MessageHandlers handlers = [] {
+    simba::decoder::MessageHandlers message_handlers;
+    message_handlers.order_update_handler =
+        [](simba::types::OrderUpdateView) {};
+    message_handlers.order_execution_handler =
+        [](simba::types::OrderExecutionView) {};
+    message_handlers.order_book_snapshot_handler =
+        [](simba::types::OrderBookSnapshotView) {};
+    return message_handlers;
+  }();
+
+  simba::decoder::SIMBADecoder decoder{handlers};
+  auto handler = [&decoder](std::span<const std::byte> udp_payload) {
+    decoder.decode_message(udp_payload);
+  };
+  processors::PacketProcessor processor(handler);
+  const processors::PacketView frame{reinterpret_cast<const std::byte *>(data),
+                                     size};
+  processor.process_packet(frame);
+
+  // the same frame twice, so the batch path also prefetches and compacts
+  const processors::PacketView batch[] = {frame, frame};
+  const size_t parsed = processor.parse_batch(batch).size();
+  if (parsed != 0 && parsed != 2) {
+    __builtin_trap();
+  }
+
+  processors::PacketProcessor validating_processor(
+      handler, transport_layer::ValidationConfig{.verify_checksums = true});
+  validating_processor.process_batch(batch);
+  return 0;
+}
@@ -0,0 +1,77 @@
+#include <unistd.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+#include "processors/capture_processor.h"
+#include "processors/capture_sources.h"
+#include "processors/packet_processor.h"
+#include "processors/pcap_buffer.h"
+#include "processors/pcap_types.h"
+#include "simba_decoder/simba_decoder.h"
+
+// Treats the input as a whole PCAP file: the producer thread of PCAPBuffer
+// frames the records and every buffered packet is decoded. Malformed record
+// headers must stop the buffering, never crash or hang it. The same bytes
+// then go through MemorySource and CaptureProcessor, which frame them in place.
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+  using namespace task;
+
+  static const std::filesystem::path capture_path =
+      std::filesystem::temp_directory_path() /
+      ("fuzz_pcap_buffer_" + std::to_string(::getpid()) + ".pcap");
+  {
+    std::ofstream capture(capture_path, std::ios::binary | std::ios::trunc);
+    capture.write(reinterpret_cast<const char *>(data),
+                  static_cast<std::streamsize>(size));
+  }
+
+  std::ifstream pcap_file(capture_path, std::ios::binary);
+  const size_t header_size =
+      std::min(size, sizeof(pcap::types::pcap_hdr_t));
+  pcap_file.seekg(static_cast<std::streamoff>(header_size));
+
+  simba::decoder::SIMBADecoder decoder{simba::decoder::MessageHandlers{}};
+  auto handler = [&decoder](std::span<const std::byte> udp_payload) {
+    decoder.decode_message(udp_payload);
+  };
+
+  processors::mt_buffer::PCAPBuffer pcap_buffer(pcap_file, size, header_size);
+  pcap_buffer.start_buffering();
+  pcap_buffer.thread().join();
+
+  // frames are decoded with the link type of the global header, unknown
+  // types fall back to Ethernet
+  pcap::types::pcap_hdr_t header{};
+  if (header_size > 0) {
+    std::memcpy(&header, data, header_size);
+  }
+  const auto drain = [&]<typename LinkLayer>(LinkLayer) {
+    processors::PacketProcessor<decltype(handler), LinkLayer> processor(
+        handler);
+    while (auto batch = pcap_buffer.next_batch()) {
+      processor.process_batch(batch->packets);
+    }
+  };
+  if (!transport_layer::visit_link_type(header.network, drain)) {
+    drain(transport_layer::EthernetLink{});
+  }
+
+  try {
+    processors::MemorySource source(
+        {reinterpret_cast<const std::byte *>(data), size});
+    processors::CaptureProcessor processor(source,
+                                           simba::decoder::MessageHandlers{});
+    processor.start();
+    processor.run();
+    processor.stop();
+  } catch (const std::runtime_error &) {
+    // bad magic number or link type, rejected before any frame is read
+  }
+  return 0;
+}
@@ -0,0 +1,42 @@
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "simba_decoder/simba_decoder.h"
+#include "simba_decoder/simba_types.h"
+
+// Feeds arbitrary UDP payloads to the SIMBA decoder. Every handler renders
+// the decoded message, so corrupted enum values are exercised as well.
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+  using namespace task::simba;
+
+  static decoder::MessageHandlers handlers = [] {
+    decoder::MessageHandlers message_handlers;
+    message_handlers.order_update_handler =
+        [](types::OrderUpdateView order_update) {
+          (void)types::to_csv_string(order_update.to_message());
+        };
+    message_handlers.order_execution_handler =
+        [](types::OrderExecutionView order_execution) {
+          (void)types::to_csv_string(order_execution.to_message());
+        };
+    message_handlers.order_book_snapshot_handler =
+        [](types::OrderBookSnapshotView snapshot) {
+          (void)types::SnapshotBook(snapshot).to_string();
+        };
+    message_handlers.best_prices_handler = [](types::BestPricesView prices) {
+      for (const auto entry : prices.no_md_entries()) {
+        (void)entry.to_string();
+      }
+    };
+    message_handlers.logout_handler = [](types::LogoutView logout) {
+      (void)logout.to_string();
+    };
+    return message_handlers;
+  }();
+
+  decoder::SIMBADecoder simba_decoder{handlers};
+  simba_decoder.decode_message(
+      std::span<const std::byte>{reinterpret_cast<const std::byte *>(data), size});
+  return 0;
+}
@@ -0,0 +1,48 @@
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "test_vectors.h"
+
+// Writes the seed corpus of each fuzz target, derived from the unit test
+// vectors, into <output directory>/<target name>/.
+int main(int argc, char *argv[]) {
+  using namespace task::tests;
+
+  if (argc != 2) {
+    std::cerr << "usage: " << argv[0] << " <output directory>" << std::endl;
+    return 1;
+  }
+  const std::filesystem::path output{argv[1]};
+
+  const auto write_seed = [&output](const std::string &target,
+                                    const std::string &name,
+                                    const std::vector<std::byte> &bytes) {
+    std::filesystem::create_directories(output / target);
+    std::ofstream seed(output / target / name, std::ios::binary);
+    seed.write(reinterpret_cast<const char *>(bytes.data()),
+               static_cast<std::streamsize>(bytes.size()));
+  };
+
+  const std::vector<std::pair<std::string, std::vector<std::byte>>> payloads{
+      {"order_update", TEST_ORDER_UPDATE_DATA},
+      {"order_execution", TEST_ORDER_EXECUTION_DATA}};
+
+  std::vector<std::vector<std::byte>> frames;
+  for (const auto &[name, payload] : payloads) {
+    write_seed("fuzz_simba_decoder", name, payload);
+    frames.push_back(make_udp_frame(payload));
+    write_seed("fuzz_packet_processor", name, frames.back());
+    write_seed("fuzz_pcap_buffer", name + ".pcap", make_pcap_file({frames.back()}));
+  }
+  write_seed("fuzz_pcap_buffer", "capture.pcap", make_pcap_file(frames));
+  write_seed("fuzz_pcap_buffer", "vlan_capture.pcap",
+             make_pcap_file({add_vlan_tags(frames.front(), {0x88A8, 0x8100})}));
+  write_seed("fuzz_pcap_buffer", "fragments_capture.pcap",
+             make_pcap_file(fragment_frame(frames.back(), 256)));
+  write_seed("fuzz_pcap_buffer", "sll2_capture.pcap",
+             make_pcap_file({to_linux_cooked_frame(frames.front(), 2)}, 276));
+  return 0;
+}
@@ -0,0 +1,305 @@
+#include "market_data/bar_aggregator.h"
+
+#include <algorithm>
+#include <charconv>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+#include "market_data/saved_state.h"
+
+namespace task::market_data {
+
+namespace {
+constexpr std::pair<std::string_view, uint64_t> TIME_UNITS[] = {
+    {"ns", 1},
+    {"us", 1'000},
+    {"ms", 1'000'000},
+    {"s", 1'000'000'000},
+    {"m", 60'000'000'000},
+    {"h", 3'600'000'000'000}};
+}  // namespace
+
+BarConfig BarConfig::parse(std::string_view spec) {
+  const auto invalid = [spec] {
+    return std::runtime_error(
+        "Invalid bars, expected time:<n>{ns,us,ms,s,m,h}, volume:<n> or "
+        "tick:<n> - " +
+        std::string(spec));
+  };
+  const auto separator = spec.find(':');
+  if (separator == std::string_view::npos) {
+    throw invalid();
+  }
+  const auto kind = spec.substr(0, separator);
+  const auto value = spec.substr(separator + 1);
+
+  BarConfig config;
+  const auto [end, error] =
+      std::from_chars(value.data(), value.data() + value.size(), config.size);
+  const std::string_view unit(end, value.data() + value.size() - end);
+  if (error != std::errc{} || config.size == 0) {
+    throw invalid();
+  }
+
+  if (kind == "time") {
+    config.kind = BarKind::Time;
+    const auto match =
+        std::find_if(std::begin(TIME_UNITS), std::end(TIME_UNITS),
+                     [unit](const auto &entry) { return entry.first == unit; });
+    if (match == std::end(TIME_UNITS) ||
+        config.size > UINT64_MAX / 2 / match->second) {
+      throw invalid();
+    }
+    config.size *= match->second;
+  } else if (kind == "volume" && unit.empty()) {
+    config.kind = BarKind::Volume;
+  } else if (kind == "tick" && unit.empty()) {
+    config.kind = BarKind::Tick;
+  } else {
+    throw invalid();
+  }
+  return config;
+}
+
+std::string Bar::to_csv_string() const {
+  std::stringstream sstream;
+  sstream << security_id;
+  sstream << ", " << open_time_ns;
+  sstream << ", " << close_time_ns;
+
+  sstream << ", " << open;
+  sstream << ", " << high;
+  sstream << ", " << low;
+  sstream << ", " << close;
+  sstream << ", " << vwap;
+
+  sstream << ", " << volume;
+  sstream << ", " << trades;
+  return sstream.str();
+}
+
+BarAggregator::BarAggregator(BarConfig config, BarHandler on_bar,
+                             bool volume_profile)
+    : config_(config),
+      on_bar_(std::move(on_bar)),
+      volume_profile_(volume_profile) {
+  if (config_.size == 0) {
+    throw std::runtime_error("Bar size must be positive");
+  }
+}
+
+void BarAggregator::on_trade(simba::types::OrderExecutionView execution,
+                             uint64_t time_ns) {
+  add_trade(execution, time_ns);
+  if (execution.md_flags().end_of_transaction()) {
+    end_transaction();
+  }
+}
+
+void BarAggregator::on_order_update(simba::types::OrderUpdateView update) {
+  if (update.md_flags().end_of_transaction()) {
+    end_transaction();
+  }
+}
+
+void BarAggregator::add_trade(simba::types::OrderExecutionView execution,
+                              uint64_t time_ns) {
+  const Decimal5 price = execution.last_px();
+  const int64_t volume = execution.last_qty();
+  if (price.is_null() || volume <= 0) {
+    return;
+  }
+  if (time_ns >= next_close_ns_) {
+    close_expired(time_ns);
+  }
+
+  const uint32_t index = slot(execution.security_id());
+  // the other leg of a trade of the transaction
+  if (is_counted(index, execution.trade_id())) {
+    return;
+  }
+  ++trades_;
+
+  auto &state = states_[index];
+
+  auto &bar = state.bar;
+  if (bar.trades == 0) {
+    bar.open_time_ns = config_.kind == BarKind::Time
+                           ? time_ns - time_ns % config_.size
+                           : time_ns;
+    bar.open = bar.high = bar.low = price;
+    if (config_.kind == BarKind::Time) {
+      next_close_ns_ =
+          std::min(next_close_ns_, bar.open_time_ns + config_.size);
+    }
+  }
+  bar.high = std::max(bar.high, price);
+  bar.low = std::min(bar.low, price);
+  bar.close = price;
+  // the clocks of merged feeds are not strictly ordered
+  bar.close_time_ns = std::max(bar.close_time_ns, time_ns);
+  bar.volume += volume;
+  ++bar.trades;
+  state.vwap.add(price, volume);
+
+  if (volume_profile_) {
+    profiles_[index][price] += volume;
+  }
+
+  if ((config_.kind == BarKind::Volume &&
+       static_cast<uint64_t>(bar.volume) >= config_.size) ||
+      (config_.kind == BarKind::Tick && bar.trades >= config_.size)) {
+    close_bar(state);
+  }
+}
+
+bool BarAggregator::is_counted(uint32_t index, int64_t trade_id) {
+  auto &trade_ids = states_[index].transaction_trade_ids;
+  // a handful of trades per transaction: a linear scan
+  if (std::find(trade_ids.begin(), trade_ids.end(), trade_id) !=
+      trade_ids.end()) {
+    return true;
+  }
+  if (trade_ids.empty()) {
+    transaction_slots_.push_back(index);
+  } else if (trade_ids.size() == MAX_TRANSACTION_TRADES) {
+    trade_ids.erase(trade_ids.begin());
+  }
+  trade_ids.push_back(trade_id);
+  return false;
+}
+
+void BarAggregator::end_transaction() {
+  for (const auto index : transaction_slots_) {
+    states_[index].transaction_trade_ids.clear();
+  }
+  transaction_slots_.clear();
+}
+
+void BarAggregator::flush() {
+  for (auto &state : states_) {
+    if (state.bar.trades > 0) {
+      close_bar(state);
+    }
+  }
+  next_close_ns_ = UINT64_MAX;
+}
+
+void BarAggregator::write_volume_profile(std::ostream &stream) const {
+  std::vector<std::pair<int32_t, uint32_t>> instruments(slots_.begin(),
+                                                        slots_.end());
+  std::sort(instruments.begin(), instruments.end());
+  for (const auto &[security_id, index] : instruments) {
+    if (index >= profiles_.size()) {
+      continue;
+    }
+    for (const auto &[price, volume] : profiles_[index]) {
+      stream << security_id << ", " << price << ", " << volume << '\n';
+    }
+  }
+}
+
+void BarAggregator::save(std::vector<std::byte> &state) const {
+  append_state(state, config_.kind);
+  append_state(state, config_.size);
+  append_state(state, static_cast<uint8_t>(volume_profile_));
+  append_state(state, static_cast<uint32_t>(states_.size()));
+  append_state(state, next_close_ns_);
+  for (size_t index = 0; index < states_.size(); ++index) {
+    const auto &instrument = states_[index];
+    append_state(state, instrument.bar);
+    append_state(state, instrument.vwap);
+    const auto &trade_ids = instrument.transaction_trade_ids;
+    append_state(state, static_cast<uint32_t>(trade_ids.size()));
+    for (const auto trade_id : trade_ids) {
+      append_state(state, trade_id);
+    }
+    if (volume_profile_) {
+      append_state(state, static_cast<uint64_t>(profiles_[index].size()));
+      for (const auto &[price, volume] : profiles_[index]) {
+        append_state(state, price.mantissa());
+        append_state(state, volume);
+      }
+    }
+  }
+}
+
+void BarAggregator::restore(std::span<const std::byte> state) {
+  if (!states_.empty()) {
+    throw std::runtime_error("The aggregator must be empty to be restored");
+  }
+  if (take_state<BarKind>(state) != config_.kind ||
+      take_state<uint64_t>(state) != config_.size ||
+      (take_state<uint8_t>(state) != 0) != volume_profile_) {
+    throw std::runtime_error("The aggregator state was saved for other bars");
+  }
+  const auto instruments = take_state<uint32_t>(state);
+  next_close_ns_ = take_state<uint64_t>(state);
+  for (uint32_t index = 0; index < instruments; ++index) {
+    const auto bar = take_state<Bar>(state);
+    // the slots are assigned again in the same order
+    if (slot(bar.security_id) != index) {
+      throw std::runtime_error("Corrupted aggregator state");
+    }
+    auto &instrument = states_[index];
+    instrument.bar = bar;
+    instrument.vwap = take_state<simba::types::VWAPAccumulator>(state);
+    const auto trade_ids = take_state<uint32_t>(state);
+    if (trade_ids > MAX_TRANSACTION_TRADES) {
+      throw std::runtime_error("Corrupted aggregator state");
+    }
+    for (uint32_t trade = 0; trade < trade_ids; ++trade) {
+      is_counted(index, take_state<int64_t>(state));
+    }
+    if (volume_profile_) {
+      const auto prices = take_state<uint64_t>(state);
+      for (uint64_t price = 0; price < prices; ++price) {
+        const Decimal5 level{take_state<int64_t>(state)};
+        profiles_[index][level] = take_state<int64_t>(state);
+      }
+    }
+  }
+  if (!state.empty()) {
+    throw std::runtime_error("Corrupted aggregator state");
+  }
+}
+
+uint32_t BarAggregator::slot(int32_t security_id) {
+  const auto [entry, inserted] = slots_.try_emplace(
+      security_id, static_cast<uint32_t>(states_.size()));
+  if (inserted) {
+    states_.emplace_back().bar.security_id = security_id;
+    if (volume_profile_) {
+      profiles_.emplace_back();
+    }
+  }
+  return entry->second;
+}
+
+void BarAggregator::close_bar(InstrumentState &state) {
+  state.bar.vwap = state.vwap.vwap();
+  on_bar_(state.bar);
+  ++bars_;
+
+  state.bar = Bar{.security_id = state.bar.security_id};
+  state.vwap.reset();
+}
+
+void BarAggregator::close_expired(uint64_t time_ns) {
+  // once per interval: the bars of every instrument end together
+  next_close_ns_ = UINT64_MAX;
+  for (auto &state : states_) {
+    if (state.bar.trades == 0) {
+      continue;
+    }
+    const uint64_t close_ns = state.bar.open_time_ns + config_.size;
+    if (close_ns <= time_ns) {
+      close_bar(state);
+    } else {
+      next_close_ns_ = std::min(next_close_ns_, close_ns);
+    }
+  }
+}
+
+}  // namespace task::market_data
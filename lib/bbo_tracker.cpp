@@ -0,0 +1,122 @@
+#include "market_data/bbo_tracker.h"
+
+#include <sstream>
+#include <stdexcept>
+
+#include "market_data/saved_state.h"
+
+namespace task::market_data {
+
+std::string BboUpdate::to_csv_string() const {
+  std::stringstream sstream;
+  sstream << security_id;
+  sstream << ", " << capture_time_ns;
+  sstream << ", " << transact_time_ns;
+
+  sstream << ", " << bid_price;
+  sstream << ", " << bid_volume;
+  sstream << ", " << offer_price;
+  sstream << ", " << offer_volume;
+  return sstream.str();
+}
+
+BboTracker::BboTracker(BboHandler on_update, bool conflate)
+    : on_update_(std::move(on_update)),
+      book_(
+          1, [this](const DepthUpdate &update) { on_depth(update); },
+          MarketByPrice::DEFAULT_WINDOW, conflate) {}
+
+void BboTracker::on_order_update(simba::types::OrderUpdateView update,
+                                 uint64_t capture_time_ns,
+                                 uint64_t transact_time_ns) {
+  transact_time_ns_ = transact_time_ns;
+  book_.on_order_update(update, capture_time_ns);
+  publish();
+}
+
+void BboTracker::on_order_execution(
+    simba::types::OrderExecutionView execution, uint64_t capture_time_ns,
+    uint64_t transact_time_ns) {
+  transact_time_ns_ = transact_time_ns;
+  book_.on_order_execution(execution, capture_time_ns);
+  publish();
+}
+
+void BboTracker::flush() {
+  book_.flush();
+  publish();
+}
+
+void BboTracker::save(std::vector<std::byte> &state) const {
+  std::vector<std::byte> book;
+  book_.save(book);
+  append_state(state, static_cast<uint64_t>(book.size()));
+  state.insert(state.end(), book.begin(), book.end());
+  append_state(state, transact_time_ns_);
+  // reported after every message: nothing is pending between two
+  append_state(state, static_cast<uint32_t>(tops_.size()));
+  for (const auto &top : tops_) {
+    append_state(state, top.bbo);
+  }
+}
+
+void BboTracker::restore(std::span<const std::byte> state) {
+  if (!tops_.empty()) {
+    throw std::runtime_error("The tracker must be empty to be restored");
+  }
+  const auto book_size = take_state<uint64_t>(state);
+  if (book_size > state.size()) {
+    throw std::runtime_error("Truncated state");
+  }
+  book_.restore(state.first(book_size));
+  state = state.subspan(book_size);
+  transact_time_ns_ = take_state<uint64_t>(state);
+  const auto tops = take_state<uint32_t>(state);
+  for (uint32_t index = 0; index < tops; ++index) {
+    auto &top = tops_.emplace_back();
+    top.bbo = take_state<BboUpdate>(state);
+    if (!slots_.try_emplace(top.bbo.security_id, index).second) {
+      throw std::runtime_error("Corrupted tracker state");
+    }
+  }
+  if (!state.empty()) {
+    throw std::runtime_error("Corrupted tracker state");
+  }
+}
+
+void BboTracker::on_depth(const DepthUpdate &update) {
+  const auto [entry, inserted] = slots_.try_emplace(
+      update.security_id, static_cast<uint32_t>(tops_.size()));
+  if (inserted) {
+    auto &top = tops_.emplace_back();
+    top.bbo.security_id = update.security_id;
+  }
+  auto &top = tops_[entry->second];
+  const bool bid = update.side == MDEntryType::Bid;
+  auto &price = bid ? top.bbo.bid_price : top.bbo.offer_price;
+  auto &volume = bid ? top.bbo.bid_volume : top.bbo.offer_volume;
+  // only the number of orders of the level changed
+  if (price == update.price && volume == update.volume) {
+    return;
+  }
+  price = update.price;
+  volume = update.volume;
+  top.bbo.capture_time_ns = update.time_ns;
+  top.bbo.transact_time_ns = transact_time_ns_;
+  if (!top.changed) {
+    top.changed = true;
+    changed_.push_back(entry->second);
+  }
+}
+
+void BboTracker::publish() {
+  for (const auto slot : changed_) {
+    auto &top = tops_[slot];
+    top.changed = false;
+    on_update_(top.bbo);
+    ++updates_;
+  }
+  changed_.clear();
+}
+
+}  // namespace task::market_data
@@ -0,0 +1,367 @@
+#include "processors/capture_sources.h"
+
+#include <fcntl.h>
+#include <poll.h>
+#include <spawn.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+#include "logging/logger.h"
+#include "metrics/metrics.h"
+
+extern char **environ;
+
+namespace task::processors {
+
+namespace {
+void check_offset(size_t offset, size_t size) {
+  if (offset < PCAPFile::HEADER_SIZE || offset > size) {
+    throw std::runtime_error("Offset " + std::to_string(offset) +
+                             " out of the capture");
+  }
+}
+}  // namespace
+
+FileSource::FileSource(const std::filesystem::path &path, size_t offset)
+    : file_(open_pcap_file(path)) {
+  logging::log(logging::Level::Info, "FILE NAME > {}", path.string());
+  logging::log(logging::Level::Info, "FILE SIZE > {} bytes", file_.file_size);
+  check_pcap_header(file_.header);
+  check_offset(offset, file_.file_size);
+  file_.stream.seekg(static_cast<std::streamoff>(offset));
+  buffer_ = std::make_unique<mt_buffer::PCAPBuffer>(
+      file_.stream, file_.file_size, offset, READ_AHEAD_BATCHES);
+}
+
+FileSource::~FileSource() { stop(); }
+
+void FileSource::start() {
+  if (!is_started_ && !is_finished_) {
+    buffer_->start_buffering();
+    is_started_ = true;
+  }
+}
+
+std::optional<PacketBatch> FileSource::next_batch() {
+  if (!is_started_ || is_finished_) {
+    return std::nullopt;
+  }
+  // read the flag first: once finished, the last batches are still queued
+  const bool is_producer_finished = buffer_->is_finished();
+  batch_ = buffer_->next_batch();
+  if (!batch_) {
+    is_finished_ = is_producer_finished;
+    return std::nullopt;
+  }
+  return PacketBatch{batch_->packets, batch_->headers};
+}
+
+void FileSource::stop() {
+  if (is_started_) {
+    buffer_->stop();
+    is_started_ = false;
+  }
+  is_finished_ = true;
+}
+
+MergedSource::MergedSource(const std::vector<std::filesystem::path> &files)
+    : merger_(files) {
+  logging::log(logging::Level::Info, "FILES > {} captures merged by timestamp",
+               files.size());
+  logging::log(logging::Level::Info, "FILES SIZE > {} bytes",
+               merger_.total_size());
+  // every file goes through the same checks, they share the link type
+  const auto headers = merger_.headers();
+  if (headers.empty()) {
+    throw std::runtime_error("No capture to process");
+  }
+  for (const auto &header : headers) {
+    check_pcap_header(header);
+  }
+  link_type_ = headers.front().network;
+}
+
+std::optional<PacketBatch> MergedSource::next_batch() {
+  if (is_finished_) {
+    return std::nullopt;
+  }
+  const auto &merged = merger_.next_batch();
+  if (merged.packets.empty()) {
+    is_finished_ = true;
+    return std::nullopt;
+  }
+  return PacketBatch{merged.packets, merged.headers};
+}
+
+namespace {
+std::span<const std::byte> records_of(std::span<const std::byte> capture,
+                                      size_t offset) {
+  if (capture.size() < PCAPFile::HEADER_SIZE) {
+    throw std::runtime_error(
+        ErrorMessage::ERROR_CANNOT_READ_PCAP_HEADER.data());
+  }
+  check_offset(offset, capture.size());
+  return capture.subspan(offset);
+}
+}  // namespace
+
+MemorySource::MemorySource(std::span<const std::byte> capture, size_t offset)
+    : framer_(records_of(capture, offset)) {
+  std::memcpy(&header_, capture.data(), sizeof(header_));
+  check_pcap_header(header_);
+}
+
+std::optional<PacketBatch> MemorySource::next_batch() {
+  if (is_finished_) {
+    return std::nullopt;
+  }
+  packets_.clear();
+  headers_.clear();
+  if (framer_.frame(BATCH_PACKETS, packets_, headers_) == 0) {
+    if (!framer_.remaining().empty()) {
+      logging::log(logging::Level::Error,
+                   "Corrupted or truncated record, {} bytes left unread",
+                   framer_.remaining().size());
+    }
+    is_finished_ = true;
+    return std::nullopt;
+  }
+  metrics::add(metrics::Counter::PacketsFramed, packets_.size());
+  return PacketBatch{packets_, headers_};
+}
+
+MappedFileSource::MappedFileSource(const std::filesystem::path &path,
+                                   size_t offset) {
+  const int descriptor = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (descriptor < 0) {
+    throw std::runtime_error(path.string() + ": " + std::strerror(errno));
+  }
+  struct stat status {};
+  if (::fstat(descriptor, &status) < 0 || status.st_size == 0) {
+    ::close(descriptor);
+    throw std::runtime_error(ErrorMessage::ERROR_MSG_ZERO_SIZE.data());
+  }
+  size_ = static_cast<size_t>(status.st_size);
+  mapping_ = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, descriptor, 0);
+  ::close(descriptor);
+  if (mapping_ == MAP_FAILED) {
+    mapping_ = nullptr;
+    throw std::runtime_error(path.string() + ": " + std::strerror(errno));
+  }
+  // the kernel reads ahead aggressively and drops the pages behind
+  ::madvise(mapping_, size_, MADV_SEQUENTIAL);
+
+  logging::log(logging::Level::Info, "FILE NAME > {}", path.string());
+  logging::log(logging::Level::Info, "FILE SIZE > {} bytes", size_);
+  try {
+    memory_.emplace(
+        std::span<const std::byte>(static_cast<const std::byte *>(mapping_),
+                                   size_),
+        offset);
+  } catch (...) {
+    ::munmap(mapping_, size_);
+    throw;
+  }
+}
+
+MappedFileSource::~MappedFileSource() {
+  if (mapping_ != nullptr) {
+    ::munmap(mapping_, size_);
+  }
+}
+
+namespace {
+const char *decompressor_for(const std::filesystem::path &path) {
+  const auto extension = path.extension();
+  if (extension == ".gz") {
+    return "gzip";
+  }
+  if (extension == ".zst") {
+    return "zstd";
+  }
+  if (extension == ".xz") {
+    return "xz";
+  }
+  if (extension == ".lz4") {
+    return "lz4";
+  }
+  return nullptr;
+}
+}  // namespace
+
+bool CompressedFileSource::is_compressed(const std::filesystem::path &path) {
+  return decompressor_for(path) != nullptr;
+}
+
+CompressedFileSource::CompressedFileSource(const std::filesystem::path &path) {
+  const char *decompressor = decompressor_for(path);
+  if (decompressor == nullptr) {
+    throw std::runtime_error("Unsupported compression: " + path.string());
+  }
+  if (!std::filesystem::is_regular_file(path)) {
+    throw std::runtime_error(path.string() + ": " + std::strerror(ENOENT));
+  }
+
+  int pipe_ends[2];
+  if (::pipe2(pipe_ends, O_CLOEXEC) < 0) {
+    throw std::runtime_error(std::string("Cannot create a pipe: ") +
+                             std::strerror(errno));
+  }
+  // absolute: the path cannot be mistaken for an option
+  const std::string file = std::filesystem::absolute(path).string();
+  std::string program{decompressor}, options{"-dc"};
+  char *arguments[] = {program.data(), options.data(),
+                       const_cast<char *>(file.c_str()), nullptr};
+  posix_spawn_file_actions_t actions;
+  posix_spawn_file_actions_init(&actions);
+  posix_spawn_file_actions_adddup2(&actions, pipe_ends[1], STDOUT_FILENO);
+  const int error = ::posix_spawnp(&decompressor_, decompressor, &actions,
+                                   nullptr, arguments, environ);
+  posix_spawn_file_actions_destroy(&actions);
+  ::close(pipe_ends[1]);
+  pipe_ = pipe_ends[0];
+  if (error != 0) {
+    decompressor_ = -1;
+    stop();
+    throw std::runtime_error(std::string("Cannot start ") + decompressor +
+                             ": " + std::strerror(error));
+  }
+  logging::log(logging::Level::Info, "{} - decompressing {} with {}",
+               log_prefix_, path.string(), decompressor);
+
+  try {
+    if (!read_exactly(reinterpret_cast<std::byte *>(&header_),
+                      sizeof(header_))) {
+      throw std::runtime_error(
+          ErrorMessage::ERROR_CANNOT_READ_PCAP_HEADER.data());
+    }
+    check_pcap_header(header_);
+  } catch (...) {
+    stop();
+    throw;
+  }
+  for (auto &buffer : buffers_) {
+    buffer.reset(new std::byte[CHUNK_SIZE]);
+  }
+}
+
+CompressedFileSource::~CompressedFileSource() { stop(); }
+
+std::optional<PacketBatch> CompressedFileSource::next_batch() {
+  if (is_finished_) {
+    return std::nullopt;
+  }
+  // the views of the previous batch point into the current buffer: the
+  // record cut at its end moves to the start of the other one
+  std::byte *chunk = buffers_[current_ ^ 1].get();
+  const size_t carried = carry_.size();
+  if (carried > 0) {
+    std::memcpy(chunk, carry_.data(), carried);
+  }
+  current_ ^= 1;
+  const size_t read = end_of_stream_ ? 0
+                                     : read_available(chunk + carried,
+                                                      CHUNK_SIZE - carried);
+
+  CaptureFramer framer({chunk, carried + read});
+  packets_.clear();
+  headers_.clear();
+  framer.frame(std::numeric_limits<size_t>::max(), packets_, headers_);
+  carry_ = framer.remaining();
+  if (!packets_.empty()) {
+    metrics::add(metrics::Counter::PacketsFramed, packets_.size());
+    return PacketBatch{packets_, headers_};
+  }
+
+  if (end_of_stream_) {
+    if (!carry_.empty()) {
+      logging::log(logging::Level::Error,
+                   "{} - truncated record at the end of the stream, {} bytes",
+                   log_prefix_, carry_.size());
+    }
+    if (const int status = wait_decompressor(); status != 0) {
+      logging::log(logging::Level::Error,
+                   "{} - the decompressor exited with status {}", log_prefix_,
+                   status);
+    }
+    stop();
+  } else if (carry_.size() == CHUNK_SIZE) {
+    logging::log(logging::Level::Error,
+                 "{} - corrupted record larger than {} bytes, stop reading",
+                 log_prefix_, CHUNK_SIZE);
+    stop();
+  }
+  return std::nullopt;
+}
+
+void CompressedFileSource::stop() {
+  if (pipe_ >= 0) {
+    // a decompressor still writing gets SIGPIPE
+    ::close(pipe_);
+    pipe_ = -1;
+  }
+  wait_decompressor();
+  is_finished_ = true;
+}
+
+size_t CompressedFileSource::read_available(std::byte *data, size_t size) {
+  size_t filled{0};
+  while (filled < size) {
+    // waits only while nothing was read
+    pollfd readable{pipe_, POLLIN, 0};
+    if (::poll(&readable, 1, filled == 0 ? POLL_TIMEOUT_MS : 0) <= 0) {
+      break;
+    }
+    const ssize_t bytes = ::read(pipe_, data + filled, size - filled);
+    if (bytes < 0 && errno == EINTR) {
+      continue;
+    }
+    if (bytes <= 0) {
+      if (bytes < 0) {
+        logging::log(logging::Level::Error, "{} - cannot read the pipe: {}",
+                     log_prefix_, std::strerror(errno));
+      }
+      end_of_stream_ = true;
+      break;
+    }
+    filled += static_cast<size_t>(bytes);
+  }
+  metrics::add(metrics::Counter::BytesRead, filled);
+  return filled;
+}
+
+bool CompressedFileSource::read_exactly(std::byte *data, size_t size) {
+  size_t filled{0};
+  while (filled < size) {
+    const ssize_t bytes = ::read(pipe_, data + filled, size - filled);
+    if (bytes < 0 && errno == EINTR) {
+      continue;
+    }
+    if (bytes <= 0) {
+      return false;
+    }
+    filled += static_cast<size_t>(bytes);
+  }
+  return true;
+}
+
+int CompressedFileSource::wait_decompressor() {
+  if (decompressor_ <= 0) {
+    return 0;
+  }
+  int status{0};
+  while (::waitpid(decompressor_, &status, 0) < 0 && errno == EINTR) {
+  }
+  decompressor_ = -1;
+  return WIFEXITED(status) ? WEXITSTATUS(status) : 128 + WTERMSIG(status);
+}
+
+}  // namespace task::processors
@@ -0,0 +1,141 @@
+#include "processors/checkpoint.h"
+
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+namespace task::processors {
+
+namespace {
+template <typename T>
+void write(std::ostream &stream, const T &value) {
+  static_assert(std::is_trivially_copyable_v<T>);
+  stream.write(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+template <typename T>
+bool read(std::istream &stream, T &value) {
+  static_assert(std::is_trivially_copyable_v<T>);
+  return static_cast<bool>(
+      stream.read(reinterpret_cast<char *>(&value), sizeof(value)));
+}
+
+// size then bytes
+template <typename Bytes>
+void write_bytes(std::ostream &stream, const Bytes &bytes) {
+  write(stream, static_cast<uint64_t>(bytes.size()));
+  stream.write(reinterpret_cast<const char *>(bytes.data()),
+               static_cast<std::streamsize>(bytes.size()));
+}
+
+// The size is checked against the remaining bytes of the file before
+// anything is allocated
+template <typename Bytes>
+bool read_bytes(std::istream &stream, uint64_t remaining, Bytes &bytes) {
+  uint64_t size{0};
+  if (!read(stream, size) || size > remaining - sizeof(size)) {
+    return false;
+  }
+  bytes.resize(size);
+  return static_cast<bool>(
+      stream.read(reinterpret_cast<char *>(bytes.data()),
+                  static_cast<std::streamsize>(size)));
+}
+}  // namespace
+
+void Checkpoint::save(const std::filesystem::path &path) const {
+  auto partial = path;
+  partial += ".tmp";
+  {
+    std::ofstream stream(partial, std::ios::binary | std::ios::trunc);
+    write(stream, MAGIC);
+    write(stream, LAYOUT);
+    write(stream, static_cast<uint32_t>(sequence_numbers.size()));
+    write(stream, file_offset);
+    write(stream, packets);
+    write(stream, capture_size);
+    write_bytes(stream, capture);
+    for (const auto sequence_number : sequence_numbers) {
+      write(stream, sequence_number);
+    }
+    write(stream, static_cast<uint32_t>(outputs.size()));
+    for (const auto &[output, size] : outputs) {
+      write_bytes(stream, output);
+      write(stream, size);
+    }
+    write(stream, static_cast<uint32_t>(states.size()));
+    for (const auto &[name, state] : states) {
+      write_bytes(stream, name);
+      write_bytes(stream, state);
+    }
+    stream.flush();
+    if (!stream) {
+      throw std::runtime_error(partial.string() + ": cannot write");
+    }
+  }
+  std::error_code error;
+  std::filesystem::rename(partial, path, error);
+  if (error) {
+    throw std::runtime_error(path.string() + ": " + error.message());
+  }
+}
+
+std::optional<Checkpoint> Checkpoint::load(
+    const std::filesystem::path &path) {
+  std::ifstream stream(path, std::ios::binary);
+  if (!stream) {
+    if (!std::filesystem::exists(path)) {
+      return std::nullopt;
+    }
+    throw std::runtime_error(path.string() + ": cannot read");
+  }
+
+  Checkpoint checkpoint;
+  uint64_t magic{0};
+  uint32_t layout{0};
+  uint32_t feeds{0};
+  uint32_t outputs{0};
+  uint32_t states{0};
+  bool whole = read(stream, magic) && magic == MAGIC &&
+               read(stream, layout) && layout == LAYOUT &&
+               read(stream, feeds) && read(stream, checkpoint.file_offset) &&
+               read(stream, checkpoint.packets) &&
+               read(stream, checkpoint.capture_size);
+  // the sizes are checked against the file before anything is allocated
+  const uint64_t size = std::filesystem::file_size(path);
+  const auto remaining = [&stream, size] {
+    return size - static_cast<uint64_t>(stream.tellg());
+  };
+  whole = whole && read_bytes(stream, remaining(), checkpoint.capture) &&
+          remaining() >= feeds * sizeof(uint32_t);
+  checkpoint.sequence_numbers.resize(whole ? feeds : 0);
+  for (auto &sequence_number : checkpoint.sequence_numbers) {
+    whole = whole && read(stream, sequence_number);
+  }
+  whole = whole && read(stream, outputs);
+  for (uint32_t index = 0; whole && index < outputs; ++index) {
+    std::string output;
+    uint64_t output_size{0};
+    whole = read_bytes(stream, remaining(), output) &&
+            read(stream, output_size) &&
+            checkpoint.outputs.emplace(std::move(output), output_size).second;
+  }
+  whole = whole && read(stream, states);
+  for (uint32_t index = 0; whole && index < states; ++index) {
+    std::string name;
+    std::vector<std::byte> state;
+    whole = read_bytes(stream, remaining(), name) &&
+            read_bytes(stream, remaining(), state) &&
+            checkpoint.states.emplace(std::move(name), std::move(state))
+                .second;
+  }
+  if (!whole || remaining() != 0) {
+    throw std::runtime_error(path.string() + ": not a whole checkpoint");
+  }
+  return checkpoint;
+}
+
+}  // namespace task::processors
@@ -0,0 +1,118 @@
+#include "processors/checksum.h"
+
+#include <cstring>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+namespace task::transport_layer {
+
+namespace {
+// The one's complement sum does not depend on the byte order (RFC 1071
+// 2.B): the words are summed as they sit in memory, little endian, and the
+// folded result is swapped back once.
+constexpr uint16_t swap_bytes(uint16_t value) noexcept {
+  return static_cast<uint16_t>((value << 8) | (value >> 8));
+}
+
+constexpr uint16_t fold(uint64_t sum) noexcept {
+  sum = (sum & 0xFFFFFFFF) + (sum >> 32);
+  sum = (sum & 0xFFFFFFFF) + (sum >> 32);
+  sum = (sum & 0xFFFF) + (sum >> 16);
+  sum = (sum & 0xFFFF) + (sum >> 16);
+  return static_cast<uint16_t>(sum);
+}
+
+// Sums the bytes left after the wide loops, in memory order
+uint64_t sum_tail(const std::byte *data, size_t size, uint64_t sum) noexcept {
+  for (; size >= 4; data += 4, size -= 4) {
+    uint32_t word;
+    std::memcpy(&word, data, sizeof(word));
+    sum += word;
+  }
+  if (size >= 2) {
+    uint16_t word;
+    std::memcpy(&word, data, sizeof(word));
+    sum += word;
+    data += 2;
+    size -= 2;
+  }
+  if (size == 1) {
+    // the high byte of a big-endian word, the low one in memory order
+    sum += std::to_integer<uint8_t>(*data);
+  }
+  return sum;
+}
+
+using SumFunction = uint16_t (*)(std::span<const std::byte>, uint16_t) noexcept;
+
+SumFunction resolve() noexcept {
+  return detail::avx2_supported() ? detail::ones_complement_sum_avx2
+                                  : detail::ones_complement_sum_scalar;
+}
+}  // namespace
+
+uint16_t ones_complement_sum(std::span<const std::byte> data,
+                             uint16_t initial) noexcept {
+  static const SumFunction implementation = resolve();
+  return implementation(data, initial);
+}
+
+namespace detail {
+
+uint16_t ones_complement_sum_scalar(std::span<const std::byte> data,
+                                    uint16_t initial) noexcept {
+  const std::byte *bytes = data.data();
+  size_t size = data.size();
+  // 32-bit words into a 64-bit accumulator: no carry handling in the loop
+  uint64_t sum = swap_bytes(initial);
+  for (; size >= 16; bytes += 16, size -= 16) {
+    uint32_t words[4];
+    std::memcpy(words, bytes, sizeof(words));
+    sum += uint64_t{words[0]} + words[1] + words[2] + words[3];
+  }
+  return swap_bytes(fold(sum_tail(bytes, size, sum)));
+}
+
+#if defined(__x86_64__)
+__attribute__((target("avx2"))) uint16_t ones_complement_sum_avx2(
+    std::span<const std::byte> data, uint16_t initial) noexcept {
+  const std::byte *bytes = data.data();
+  size_t size = data.size();
+  uint64_t sum = swap_bytes(initial);
+
+  // 16-bit words widened into 32-bit lanes: a lane takes two words per
+  // iteration, so it is flushed before it can overflow
+  constexpr size_t FLUSH_ITERATIONS = 1 << 14;
+  const __m256i zero = _mm256_setzero_si256();
+  while (size >= 32) {
+    __m256i lanes = _mm256_setzero_si256();
+    for (size_t iteration = 0; iteration < FLUSH_ITERATIONS && size >= 32;
+         ++iteration, bytes += 32, size -= 32) {
+      const __m256i words =
+          _mm256_loadu_si256(reinterpret_cast<const __m256i *>(bytes));
+      lanes = _mm256_add_epi32(lanes, _mm256_unpacklo_epi16(words, zero));
+      lanes = _mm256_add_epi32(lanes, _mm256_unpackhi_epi16(words, zero));
+    }
+    alignas(32) uint32_t lane_sums[8];
+    _mm256_store_si256(reinterpret_cast<__m256i *>(lane_sums), lanes);
+    for (const uint32_t lane_sum : lane_sums) {
+      sum += lane_sum;
+    }
+  }
+  return swap_bytes(fold(sum_tail(bytes, size, sum)));
+}
+
+bool avx2_supported() noexcept { return __builtin_cpu_supports("avx2"); }
+#else
+uint16_t ones_complement_sum_avx2(std::span<const std::byte> data,
+                                  uint16_t initial) noexcept {
+  return ones_complement_sum_scalar(data, initial);
+}
+
+bool avx2_supported() noexcept { return false; }
+#endif
+
+}  // namespace detail
+}  // namespace task::transport_layer
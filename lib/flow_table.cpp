@@ -0,0 +1,90 @@
+#include "processors/flow_table.h"
+
+#include <arpa/inet.h>
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace task::processors {
+
+FeedRoute FeedRoute::parse(std::string_view route) {
+  const auto separator = route.find('=');
+  if (separator == std::string_view::npos || separator == 0) {
+    throw std::runtime_error(
+        "Invalid feed, expected name=address:port[,address:port] - " +
+        std::string(route));
+  }
+
+  FeedRoute parsed{std::string(route.substr(0, separator))};
+  auto destinations = route.substr(separator + 1);
+  while (!destinations.empty()) {
+    const auto comma = destinations.find(',');
+    parsed.destinations.push_back(
+        live::Endpoint::parse(destinations.substr(0, comma)));
+    destinations = comma == std::string_view::npos
+                       ? std::string_view{}
+                       : destinations.substr(comma + 1);
+  }
+  if (parsed.destinations.empty()) {
+    throw std::runtime_error("Feed without destinations - " +
+                             std::string(route));
+  }
+  return parsed;
+}
+
+FlowTable::FlowTable(const std::vector<FeedRoute> &routes) {
+  std::vector<std::pair<uint64_t, size_t>> entries;
+  for (const auto &route : routes) {
+    // routes sharing a name add destinations to the same feed
+    auto feed = static_cast<size_t>(
+        std::find(names_.begin(), names_.end(), route.name) - names_.begin());
+    if (feed == names_.size()) {
+      names_.push_back(route.name);
+    }
+    for (const auto &destination : route.destinations) {
+      const uint32_t address = ntohl(live::to_in_addr(destination.address).s_addr);
+      entries.emplace_back(to_key(address, destination.port), feed);
+    }
+  }
+  stats_.resize(names_.size());
+  destinations_.resize(names_.size());
+
+  std::sort(entries.begin(), entries.end());
+  for (size_t index = 0; index < entries.size(); ++index) {
+    if (index > 0 && entries[index].first == entries[index - 1].first) {
+      if (entries[index].second == entries[index - 1].second) {
+        continue;
+      }
+      throw std::runtime_error("Destination routed to two feeds: " +
+                               names_[entries[index - 1].second] + " and " +
+                               names_[entries[index].second]);
+    }
+    keys_.push_back(entries[index].first);
+    key_feeds_.push_back(entries[index].second);
+    ++destinations_[entries[index].second];
+  }
+}
+
+size_t FlowTable::find(const transport_layer::FlowKey &flow) noexcept {
+  const uint64_t key = to_key(flow.destination_address, flow.destination_port);
+  if (key == last_key_) {
+    return last_feed_;
+  }
+  const auto match = std::lower_bound(keys_.begin(), keys_.end(), key);
+  last_key_ = key;
+  last_feed_ = match != keys_.end() && *match == key
+                   ? key_feeds_[static_cast<size_t>(match - keys_.begin())]
+                   : NO_FEED;
+  return last_feed_;
+}
+
+size_t FlowTable::route(
+    const transport_layer::UDPDatagramView &datagram) noexcept {
+  const size_t feed = find(datagram.flow);
+  auto &stats = feed == NO_FEED ? unrouted_ : stats_[feed];
+  ++stats.datagrams;
+  stats.bytes += datagram.payload.size();
+  return feed;
+}
+
+}  // namespace task::processors
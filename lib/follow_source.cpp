@@ -0,0 +1,233 @@
+#include "processors/follow_source.h"
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+
+#include "logging/logger.h"
+#include "metrics/metrics.h"
+#include "processors/pcap_file.h"
+#include "processors/pcap_merger.h"
+
+namespace task::processors {
+
+namespace {
+std::filesystem::path directory_of(const std::filesystem::path &path) {
+  return path.has_parent_path() ? path.parent_path()
+                                : std::filesystem::path{"."};
+}
+}  // namespace
+
+FollowSource::FollowSource(const std::filesystem::path &path)
+    : path_(std::filesystem::is_directory(path)
+                ? list_captures({path.string()}).front()
+                : path) {
+  if (!open(path_)) {
+    throw std::runtime_error(
+        ErrorMessage::ERROR_CANNOT_READ_PCAP_HEADER.data());
+  }
+  // the events of the files of the directory: appends and new captures
+  inotify_ = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (inotify_ >= 0 &&
+      ::inotify_add_watch(inotify_, directory_of(path_).c_str(),
+                          IN_MODIFY | IN_CREATE | IN_MOVED_TO) < 0) {
+    ::close(inotify_);
+    inotify_ = -1;
+  }
+  if (inotify_ < 0) {
+    logging::log(logging::Level::Warning,
+                 "{} - inotify unavailable ({}), polling {}", log_prefix_,
+                 std::strerror(errno), directory_of(path_).string());
+  }
+  for (auto &buffer : buffers_) {
+    buffer.reset(new std::byte[CHUNK_SIZE]);
+  }
+}
+
+FollowSource::~FollowSource() {
+  if (file_ >= 0) {
+    ::close(file_);
+  }
+  if (inotify_ >= 0) {
+    ::close(inotify_);
+  }
+}
+
+std::optional<PacketBatch> FollowSource::next_batch() {
+  if (is_finished()) {
+    return std::nullopt;
+  }
+  // the next capture, its global header not written yet
+  if (file_ < 0) {
+    if (!open(*next_)) {
+      wait();
+      return std::nullopt;
+    }
+    next_.reset();
+  }
+
+  // the views of the previous batch point into the current buffer: the
+  // record cut at its end moves to the start of the other one
+  std::byte *chunk = buffers_[current_ ^ 1].get();
+  const size_t carried = carry_.size();
+  if (carried > 0) {
+    std::memcpy(chunk, carry_.data(), carried);
+  }
+  current_ ^= 1;
+  const size_t read = read_available(chunk + carried, CHUNK_SIZE - carried);
+
+  CaptureFramer framer({chunk, carried + read});
+  packets_.clear();
+  headers_.clear();
+  framer.frame(std::numeric_limits<size_t>::max(), packets_, headers_);
+  carry_ = framer.remaining();
+  if (!packets_.empty()) {
+    timeout_ms_ = MIN_TIMEOUT_MS;
+    metrics::add(metrics::Counter::PacketsFramed, packets_.size());
+    return PacketBatch{packets_, headers_};
+  }
+  if (carry_.size() == CHUNK_SIZE) {
+    logging::log(logging::Level::Error,
+                 "{} - corrupted record larger than {} bytes, stop reading",
+                 log_prefix_, CHUNK_SIZE);
+    stop();
+    return std::nullopt;
+  }
+
+  if (read == 0) {
+    // the writer created the next capture before this read found the end
+    // of the current one: it is whole
+    if (next_) {
+      roll_over();
+      return std::nullopt;
+    }
+    if (directory_changed_) {
+      directory_changed_ = false;
+      next_ = next_capture();
+      if (next_) {
+        // read once more, the writer may have appended in between
+        return std::nullopt;
+      }
+    }
+  }
+  wait();
+  return std::nullopt;
+}
+
+bool FollowSource::open(const std::filesystem::path &path) {
+  const int descriptor = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (descriptor < 0) {
+    throw std::runtime_error(path.string() + ": " + std::strerror(errno));
+  }
+  pcap::types::pcap_hdr_t header{};
+  if (::read(descriptor, &header, sizeof(header)) !=
+      static_cast<ssize_t>(sizeof(header))) {
+    ::close(descriptor);
+    return false;
+  }
+  try {
+    check_pcap_header(header);
+    if (files_ > 0 && header.network != header_.network) {
+      throw std::runtime_error(
+          "Captures with different link types: " + path_.string() + " (" +
+          std::to_string(header_.network) + ") and " + path.string() + " (" +
+          std::to_string(header.network) + ")");
+    }
+  } catch (...) {
+    ::close(descriptor);
+    throw;
+  }
+  file_ = descriptor;
+  header_ = header;
+  path_ = path;
+  ++files_;
+  logging::log(logging::Level::Info, "FILE NAME > {}", path.string());
+  return true;
+}
+
+std::optional<std::filesystem::path> FollowSource::next_capture() const {
+  // the order of list_captures, among the files of the same directory
+  const auto name = path_.filename();
+  std::optional<std::filesystem::path> next;
+  std::error_code error;
+  for (const auto &entry :
+       std::filesystem::directory_iterator(directory_of(path_), error)) {
+    const auto candidate = entry.path().filename();
+    if (entry.is_regular_file(error) &&
+        !candidate.string().starts_with('.') && name < candidate &&
+        (!next || candidate < next->filename())) {
+      next = entry.path();
+    }
+  }
+  return next;
+}
+
+void FollowSource::roll_over() {
+  if (!carry_.empty()) {
+    logging::log(logging::Level::Error,
+                 "{} - truncated record at the end of {}, {} bytes",
+                 log_prefix_, path_.string(), carry_.size());
+    carry_ = {};
+  }
+  logging::log(logging::Level::Info, "{} - {} read to its end, rolling over",
+               log_prefix_, path_.string());
+  ::close(file_);
+  file_ = -1;
+  if (open(*next_)) {
+    next_.reset();
+  }
+}
+
+void FollowSource::wait() {
+  pollfd events{inotify_, POLLIN, 0};
+  // a negative descriptor is ignored: a plain sleep without inotify
+  if (::poll(&events, 1, timeout_ms_) <= 0) {
+    timeout_ms_ = std::min(2 * timeout_ms_, MAX_TIMEOUT_MS);
+    directory_changed_ = directory_changed_ || inotify_ < 0;
+    return;
+  }
+  alignas(inotify_event) std::byte buffer[4096];
+  ssize_t bytes{0};
+  while ((bytes = ::read(inotify_, buffer, sizeof(buffer))) > 0) {
+    for (ssize_t offset = 0; offset < bytes;) {
+      const auto *event =
+          reinterpret_cast<const inotify_event *>(buffer + offset);
+      if (event->mask & (IN_CREATE | IN_MOVED_TO | IN_Q_OVERFLOW)) {
+        directory_changed_ = true;
+      }
+      offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+    }
+  }
+  timeout_ms_ = MIN_TIMEOUT_MS;
+}
+
+size_t FollowSource::read_available(std::byte *data, size_t size) {
+  size_t filled{0};
+  while (filled < size) {
+    const ssize_t bytes = ::read(file_, data + filled, size - filled);
+    if (bytes < 0 && errno == EINTR) {
+      continue;
+    }
+    if (bytes <= 0) {
+      if (bytes < 0) {
+        logging::log(logging::Level::Error, "{} - cannot read {}: {}",
+                     log_prefix_, path_.string(), std::strerror(errno));
+      }
+      break;
+    }
+    filled += static_cast<size_t>(bytes);
+  }
+  metrics::add(metrics::Counter::BytesRead, filled);
+  return filled;
+}
+
+}  // namespace task::processors
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace task::logging {
+
+enum class Level : uint8_t { Debug = 0, Info, Warning, Error };
+
+// Messages below the level are discarded before building any record
+void set_level(Level level) noexcept;
+Level level() noexcept;
+
+// Wraps a string literal: the record stores the pointer, the text is only
+// read, and formatted, by the drain thread. Placeholders are {} and {:x}.
+struct Format {
+  template <size_t N>
+  consteval Format(const char (&format)[N]) : text(format) {}
+
+  const char *text;
+};
+
+// Lets a log site through at most once per interval, counting the messages
+// suppressed in between
+class RateLimiter {
+ public:
+  explicit RateLimiter(std::chrono::nanoseconds interval)
+      : interval_ns_(static_cast<uint64_t>(interval.count())) {}
+
+  bool allow(uint64_t now_ns, uint64_t &suppressed) noexcept;
+
+ private:
+  uint64_t interval_ns_{0};
+  std::atomic<uint64_t> last_ns_{0};
+  std::atomic<uint64_t> suppressed_{0};
+};
+
+struct Argument {
+  enum class Type : uint8_t { Int, UInt, Double, String };
+
+  Type type{Type::Int};
+  union {
+    int64_t int_value;
+    uint64_t uint_value;
+    double double_value;
+    struct {
+      uint16_t offset;
+      uint16_t length;
+    } string;
+  };
+};
+
+// Fixed-size binary record: the arguments are stored raw, strings are copied
+// (and truncated) into the inline text buffer
+struct LogRecord {
+  static constexpr size_t MAX_ARGUMENTS = 6;
+  static constexpr size_t TEXT_SIZE = 120;
+
+  uint64_t timestamp_ns{0};
+  const char *format{nullptr};
+  uint64_t suppressed{0};
+  Level level{Level::Info};
+  uint8_t argument_count{0};
+  uint16_t text_size{0};
+  std::array<Argument, MAX_ARGUMENTS> arguments{};
+  std::array<char, TEXT_SIZE> text{};
+
+  void add(std::string_view value) noexcept;
+
+  template <std::integral Value>
+  void add(Value value) noexcept;
+
+  template <std::floating_point Value>
+  void add(Value value) noexcept;
+};
+
+template <typename Value>
+concept Loggable = std::integral<Value> || std::floating_point<Value> ||
+                   std::convertible_to<const Value &, std::string_view>;
+
+// Formats the record the way the drain thread writes it, without newline
+std::string format_record(const LogRecord &record);
+
+// Enqueues the record for the drain thread, never blocks: when the queue is
+// full the record is dropped and counted
+void submit(const LogRecord &record) noexcept;
+
+uint64_t now_ns() noexcept;
+
+template <Loggable... Arguments>
+void log(Level level, Format format, const Arguments &...arguments);
+
+template <Loggable... Arguments>
+void log(RateLimiter &limiter, Level level, Format format,
+         const Arguments &...arguments);
+
+// Blocks until every record submitted so far has been written
+void flush();
+
+size_t dropped_records() noexcept;
+
+}  // namespace task::logging
+
+#include "logging/logger.hpp"
@@ -0,0 +1,74 @@
+#include "logging/logger.h"
+
+namespace task::logging {
+
+template <std::integral Value>
+void LogRecord::add(Value value) noexcept {
+  if (argument_count == MAX_ARGUMENTS) {
+    return;
+  }
+  auto &argument = arguments[argument_count++];
+  if constexpr (std::is_signed_v<Value>) {
+    argument.type = Argument::Type::Int;
+    argument.int_value = value;
+  } else {
+    argument.type = Argument::Type::UInt;
+    argument.uint_value = value;
+  }
+}
+
+template <std::floating_point Value>
+void LogRecord::add(Value value) noexcept {
+  if (argument_count == MAX_ARGUMENTS) {
+    return;
+  }
+  auto &argument = arguments[argument_count++];
+  argument.type = Argument::Type::Double;
+  argument.double_value = static_cast<double>(value);
+}
+
+namespace detail {
+template <Loggable... Arguments>
+void log_record(Level level, uint64_t timestamp_ns, uint64_t suppressed,
+                Format format, const Arguments &...arguments) {
+  LogRecord record;
+  record.timestamp_ns = timestamp_ns;
+  record.format = format.text;
+  record.suppressed = suppressed;
+  record.level = level;
+  (
+      [&record](const auto &argument) {
+        using Value = std::decay_t<decltype(argument)>;
+        if constexpr (std::integral<Value> || std::floating_point<Value>) {
+          record.add(argument);
+        } else {
+          record.add(std::string_view(argument));
+        }
+      }(arguments),
+      ...);
+  submit(record);
+}
+}  // namespace detail
+
+template <Loggable... Arguments>
+void log(Level level, Format format, const Arguments &...arguments) {
+  if (level < logging::level()) {
+    return;
+  }
+  detail::log_record(level, now_ns(), 0, format, arguments...);
+}
+
+template <Loggable... Arguments>
+void log(RateLimiter &limiter, Level level, Format format,
+         const Arguments &...arguments) {
+  if (level < logging::level()) {
+    return;
+  }
+  const uint64_t timestamp_ns = now_ns();
+  uint64_t suppressed{0};
+  if (limiter.allow(timestamp_ns, suppressed)) {
+    detail::log_record(level, timestamp_ns, suppressed, format, arguments...);
+  }
+}
+
+}  // namespace task::logging
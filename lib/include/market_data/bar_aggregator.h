@@ -0,0 +1,150 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <ostream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include "simba_decoder/decimal.h"
+#include "simba_decoder/simba_types.h"
+
+namespace task::market_data {
+
+using simba::types::Decimal5;
+
+// What closes a bar: the end of its time interval, a traded volume or a
+// number of trades
+enum class BarKind : uint8_t { Time, Volume, Tick };
+
+struct BarConfig {
+  BarKind kind{BarKind::Time};
+  // nanoseconds, contracts or trades
+  uint64_t size{60'000'000'000};
+
+  // Parses "time:<n>{ns,us,ms,s,m,h}", "volume:<contracts>" or
+  // "tick:<trades>", throws std::runtime_error on malformed specs
+  static BarConfig parse(std::string_view spec);
+};
+
+// One closed bar, also the record of the binary output: 72 bytes in host
+// byte order, prices as Decimal5 mantissas.
+struct Bar {
+  // start of the interval for time bars, first trade otherwise
+  uint64_t open_time_ns{0};
+  // last trade
+  uint64_t close_time_ns{0};
+  Decimal5 open{};
+  Decimal5 high{};
+  Decimal5 low{};
+  Decimal5 close{};
+  Decimal5 vwap{};
+  int64_t volume{0};
+  int32_t security_id{0};
+  uint32_t trades{0};
+
+  static constexpr std::string_view CSV_HEADER =
+      "security_id, open_time_ns, close_time_ns, open, high, low, close, "
+      "vwap, volume, trades";
+
+  [[nodiscard]] std::string to_csv_string() const;
+};
+static_assert(sizeof(Bar) == 72);
+static_assert(std::is_trivially_copyable_v<Bar>);
+
+// Builds OHLCV/VWAP bars per instrument from the OrderExecution messages.
+// An execution is reported once per side of the trade: the legs share the
+// TradeID and only the first one is counted. The legs of a trade are not
+// always back to back (a sweep may report every passive leg, then every
+// aggressive one), so the TradeIDs are kept per instrument until the end of
+// the exchange transaction. The state of the instruments lives in flat
+// arrays indexed by a slot assigned on their first trade.
+//
+// Bars are closed by the trades: a volume or tick bar by the trade reaching
+// its size (trades are not split, the last one may overshoot), a time bar by
+// the first trade of any instrument past the end of its interval. flush()
+// closes the bars still open at the end of the stream.
+class BarAggregator {
+ public:
+  using BarHandler = std::function<void(const Bar &)>;
+
+  // With volume_profile, the volume traded at each price is also kept per
+  // instrument for the whole stream. Throws std::runtime_error on a zero
+  // bar size.
+  BarAggregator(BarConfig config, BarHandler on_bar,
+                bool volume_profile = false);
+
+  // time_ns is the clock of the trade (capture or exchange time). Executions
+  // without a price or a volume are ignored.
+  void on_trade(simba::types::OrderExecutionView execution, uint64_t time_ns);
+
+  // Only its EndOfTransaction flag matters: a transaction may end on an
+  // order update
+  void on_order_update(simba::types::OrderUpdateView update);
+
+  // Closes the open bars, in slot order
+  void flush();
+
+  // "security_id, price, volume" rows sorted by instrument and price
+  void write_volume_profile(std::ostream &stream) const;
+
+  // Appends the state of the aggregator to state: the open bars, the
+  // TradeIDs of the current transaction and the volume profile, e.g. for a
+  // Checkpoint
+  void save(std::vector<std::byte> &state) const;
+
+  // Rebuilds the aggregator from a state saved with the same bars, without
+  // closing anything. Throws std::runtime_error when state is not such a
+  // state, or the aggregator is not empty.
+  void restore(std::span<const std::byte> state);
+
+  [[nodiscard]] size_t trades() const noexcept { return trades_; }
+
+  [[nodiscard]] size_t bars() const noexcept { return bars_; }
+
+  [[nodiscard]] size_t instruments() const noexcept { return states_.size(); }
+
+ private:
+  struct InstrumentState {
+    simba::types::VWAPAccumulator vwap{};
+    Bar bar{};  // open while bar.trades > 0
+    // TradeIDs counted in the current transaction
+    std::vector<int64_t> transaction_trade_ids{};
+  };
+
+  // A transaction without its EndOfTransaction flag forgets its oldest
+  // TradeIDs beyond this
+  static constexpr size_t MAX_TRANSACTION_TRADES = 256;
+
+  void add_trade(simba::types::OrderExecutionView execution, uint64_t time_ns);
+  // Whether the trade was already counted in the transaction, remembering it
+  bool is_counted(uint32_t index, int64_t trade_id);
+  void end_transaction();
+  uint32_t slot(int32_t security_id);
+  void close_bar(InstrumentState &state);
+  void close_expired(uint64_t time_ns);
+
+  BarConfig config_;
+  BarHandler on_bar_;
+  bool volume_profile_;
+
+  std::unordered_map<int32_t, uint32_t> slots_{};
+  std::vector<InstrumentState> states_{};
+  // slots with TradeIDs in the current transaction
+  std::vector<uint32_t> transaction_slots_{};
+  // per slot, only with the volume profile on
+  std::vector<std::map<Decimal5, int64_t>> profiles_{};
+
+  // time bars: end of the earliest open interval
+  uint64_t next_close_ns_{UINT64_MAX};
+  size_t trades_{0};
+  size_t bars_{0};
+};
+
+}  // namespace task::market_data
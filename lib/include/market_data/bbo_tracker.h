@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include "market_data/market_by_price.h"
+#include "simba_decoder/decimal.h"
+#include "simba_decoder/simba_types.h"
+
+namespace task::market_data {
+
+// The best bid and offer of an instrument after a change, also the record
+// of the binary output: 56 bytes in host byte order, prices as Decimal5
+// mantissas. An empty side has a null price and no volume.
+struct BboUpdate {
+  uint64_t capture_time_ns{0};
+  // TransactTime of the packet, 0 out of the incremental stream
+  uint64_t transact_time_ns{0};
+  Decimal5 bid_price{Decimal5::null()};
+  int64_t bid_volume{0};
+  Decimal5 offer_price{Decimal5::null()};
+  int64_t offer_volume{0};
+  int32_t security_id{0};
+  uint8_t reserved[4]{};
+
+  static constexpr std::string_view CSV_HEADER =
+      "security_id, capture_time_ns, transact_time_ns, bid_price, "
+      "bid_volume, offer_price, offer_volume";
+
+  [[nodiscard]] std::string to_csv_string() const;
+};
+static_assert(sizeof(BboUpdate) == 56);
+static_assert(std::is_trivially_copyable_v<BboUpdate>);
+
+// Reports the changes of the top of the book of each instrument: a
+// MarketByPrice of depth 1 keeps the levels, and its updates of the two
+// sides are merged into one BboUpdate per instrument and per message (per
+// transaction with conflate). A change deeper in the book reports nothing.
+class BboTracker {
+ public:
+  using BboHandler = std::function<void(const BboUpdate &)>;
+
+  explicit BboTracker(BboHandler on_update, bool conflate = false);
+
+  BboTracker(const BboTracker &) = delete;
+  BboTracker &operator=(const BboTracker &) = delete;
+
+  void on_order_update(simba::types::OrderUpdateView update,
+                       uint64_t capture_time_ns, uint64_t transact_time_ns);
+
+  void on_order_execution(simba::types::OrderExecutionView execution,
+                          uint64_t capture_time_ns, uint64_t transact_time_ns);
+
+  // Reports the changes of a transaction cut by the end of the stream
+  void flush();
+
+  // Appends the state of the tracker to state: its book and the best bid
+  // and offer last reported, e.g. for a Checkpoint
+  void save(std::vector<std::byte> &state) const;
+
+  // Rebuilds the tracker from a saved state, without reporting anything.
+  // Throws std::runtime_error when state is not such a state, or the
+  // tracker is not empty.
+  void restore(std::span<const std::byte> state);
+
+  [[nodiscard]] const MarketByPrice &book() const noexcept { return book_; }
+
+  [[nodiscard]] size_t updates() const noexcept { return updates_; }
+
+ private:
+  struct Top {
+    BboUpdate bbo;
+    bool changed{false};
+  };
+
+  void on_depth(const DepthUpdate &update);
+  // Reports the instruments whose top changed
+  void publish();
+
+  BboHandler on_update_;
+  MarketByPrice book_;
+  std::unordered_map<int32_t, uint32_t> slots_{};
+  std::vector<Top> tops_{};
+  std::vector<uint32_t> changed_{};
+  uint64_t transact_time_ns_{0};
+  size_t updates_{0};
+};
+
+}  // namespace task::market_data
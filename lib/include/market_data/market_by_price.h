@@ -0,0 +1,242 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include "simba_decoder/decimal.h"
+#include "simba_decoder/simba_types.h"
+
+namespace task::market_data {
+
+using simba::types::Decimal5;
+using simba::types::MDEntryType;
+
+// The orders resting at one price
+struct PriceLevel {
+  Decimal5 price{Decimal5::null()};
+  int64_t volume{0};
+  uint32_t orders{0};
+
+  [[nodiscard]] bool empty() const noexcept { return orders == 0; }
+
+  friend bool operator==(const PriceLevel &, const PriceLevel &) = default;
+};
+
+// A change of one of the best levels of a side, also the record of the
+// binary output: 40 bytes in host byte order. The level now at depth (0 is
+// the best price), a null price when the side has fewer levels.
+struct DepthUpdate {
+  uint64_t time_ns{0};
+  Decimal5 price{Decimal5::null()};
+  int64_t volume{0};
+  int32_t security_id{0};
+  uint32_t orders{0};
+  uint8_t depth{0};
+  MDEntryType side{MDEntryType::Bid};
+  uint8_t reserved[6]{};
+
+  static constexpr std::string_view CSV_HEADER =
+      "security_id, time_ns, side, depth, price, volume, orders";
+
+  [[nodiscard]] std::string to_csv_string() const;
+};
+static_assert(sizeof(DepthUpdate) == 40);
+static_assert(std::is_trivially_copyable_v<DepthUpdate>);
+
+// The price levels of one side of a book. Prices move by a tick, so the
+// levels around the best price live in a dense array indexed by their
+// distance to it in ticks: adding an order to a level is an array access,
+// and the next best level after a removal is a short forward scan. The tick
+// is not on the wire, it is the greatest common divisor of the differences
+// between the prices seen. The levels out of the window, or off the grid,
+// fall back to an ordered map. The window follows the best price when it
+// moves past its edge.
+class PriceLadder {
+ public:
+  // bids are sorted by decreasing price, offers by increasing price. Throws
+  // std::runtime_error on an empty window.
+  PriceLadder(bool bids, size_t window);
+
+  // A new order at price
+  void insert(Decimal5 price, int64_t volume) { apply(price, volume, 1); }
+
+  // An order leaving the level of price, removed with its last order
+  void erase(Decimal5 price, int64_t volume) { apply(price, -volume, -1); }
+
+  // The volume of an order of the level changed by delta
+  void modify(Decimal5 price, int64_t delta) { apply(price, delta, 0); }
+
+  // Copies the best levels into levels, empty ones past the last level of
+  // the side. Returns the number of levels copied.
+  size_t top(std::span<PriceLevel> levels) const;
+
+  // Whether price comes after other on this side
+  [[nodiscard]] bool worse(Decimal5 price, Decimal5 other) const noexcept {
+    return key(price) > key(other);
+  }
+
+  [[nodiscard]] size_t size() const noexcept { return levels_; }
+
+  // Levels out of the dense window
+  [[nodiscard]] size_t sparse_levels() const noexcept {
+    return sparse_.size();
+  }
+
+  // The inferred tick, null until two prices were seen
+  [[nodiscard]] Decimal5 tick() const noexcept {
+    return tick_ == 0 ? Decimal5::null() : Decimal5{tick_};
+  }
+
+ private:
+  // The sort key, the best level has the lowest one on both sides
+  [[nodiscard]] int64_t key(Decimal5 price) const noexcept {
+    return bids_ ? -price.mantissa() : price.mantissa();
+  }
+
+  void apply(Decimal5 price, int64_t volume, int32_t orders);
+  // The slot of key in the window, dense_.size() outside or off the grid
+  [[nodiscard]] size_t index(int64_t key) const noexcept;
+  void learn_tick(int64_t key);
+  // Moves the window so that best_key lands in its first quarter
+  void recenter(int64_t best_key);
+  void next_best();
+
+  bool bids_;
+  std::vector<PriceLevel> dense_;
+  std::map<int64_t, PriceLevel> sparse_{};
+  int64_t anchor_{0};
+  bool anchored_{false};
+  int64_t tick_{0};
+  // key of dense_[0]
+  int64_t base_{0};
+  // first level of the window, dense_.size() when it is empty
+  size_t best_;
+  size_t levels_{0};
+};
+
+// Maintains the market-by-price book of each instrument (volume and order
+// count per price level) straight from the OrderUpdate and OrderExecution
+// messages, and reports the changes of the depth best levels of each side.
+// The orders are tracked by MDEntryID, so that a change, a deletion or a
+// fill moves the volume of the right level. A level worse than the depth
+// best ones leaves the reported depth untouched and costs no comparison.
+//
+// An aggressive order is reported as a transaction of many messages, the
+// last one flagged EndOfTransaction in MDFlags. With conflate, the changed
+// sides are only compared with the reported depth at the end of the
+// transaction: one update per changed level instead of one per message, and
+// none of the intermediate states (e.g. a crossed book) is ever reported.
+//
+// The book starts empty: the orders placed before the start of the stream
+// are unknown, their deletions and fills are counted and ignored.
+class MarketByPrice {
+ public:
+  using DepthHandler = std::function<void(const DepthUpdate &)>;
+
+  static constexpr size_t DEFAULT_WINDOW = 1024;
+
+  // Throws std::runtime_error on a depth of 0 or above 255
+  MarketByPrice(size_t depth, DepthHandler on_update,
+                size_t window = DEFAULT_WINDOW, bool conflate = false);
+
+  // time_ns stamps the reported updates
+  void on_order_update(simba::types::OrderUpdateView update, uint64_t time_ns);
+
+  void on_order_execution(simba::types::OrderExecutionView execution,
+                          uint64_t time_ns);
+
+  // Reports the changes of a transaction cut by the end of the stream
+  void flush();
+
+  // Appends the state of the books to state: the resting orders, the levels
+  // last reported and the pending sides, e.g. for a Checkpoint
+  void save(std::vector<std::byte> &state) const;
+
+  // Rebuilds the books from a state saved at the same depth, without
+  // reporting anything: the updates then go on as if never interrupted.
+  // Throws std::runtime_error when state is not such a state, or the book
+  // is not empty.
+  void restore(std::span<const std::byte> state);
+
+  // The best levels of a side, at most count
+  [[nodiscard]] std::vector<PriceLevel> levels(int32_t security_id,
+                                               MDEntryType side,
+                                               size_t count) const;
+
+  [[nodiscard]] size_t orders() const noexcept { return orders_.size(); }
+
+  [[nodiscard]] size_t instruments() const noexcept { return books_.size(); }
+
+  [[nodiscard]] size_t updates() const noexcept { return updates_; }
+
+  // Messages flagged EndOfTransaction
+  [[nodiscard]] size_t transactions() const noexcept { return transactions_; }
+
+  // Deletions and fills of orders never added
+  [[nodiscard]] size_t unknown_orders() const noexcept {
+    return unknown_orders_;
+  }
+
+ private:
+  struct Book {
+    Book(int32_t security_id, size_t depth, size_t window);
+
+    int32_t security_id;
+    PriceLadder bids;
+    PriceLadder offers;
+    // the levels last reported per side
+    std::vector<PriceLevel> reported_bids;
+    std::vector<PriceLevel> reported_offers;
+    // sides changed by the current transaction
+    bool pending_bids{false};
+    bool pending_offers{false};
+  };
+
+  struct Order {
+    Decimal5 price{};
+    int64_t volume{0};
+    uint32_t book{0};
+    MDEntryType side{MDEntryType::Bid};
+  };
+
+  void apply(simba::types::OrderUpdateView update, uint64_t time_ns);
+  void apply(simba::types::OrderExecutionView execution, uint64_t time_ns);
+  // Publishes the pending sides at the end of a transaction
+  void end_message(simba::types::MDFlagsSet flags, uint64_t time_ns);
+  uint32_t slot(int32_t security_id);
+  void insert(int64_t id, const Order &order, uint64_t time_ns);
+  void erase(std::unordered_map<int64_t, Order>::iterator order,
+             uint64_t time_ns);
+  // Reports the best levels of the side changed by an update at price, or
+  // marks the side pending until the end of the transaction
+  void report(Book &book, MDEntryType side, Decimal5 price, uint64_t time_ns);
+  // Reports the levels of the side that differ from the reported ones
+  void publish(Book &book, MDEntryType side, uint64_t time_ns);
+
+  size_t depth_;
+  DepthHandler on_update_;
+  size_t window_;
+  bool conflate_;
+
+  std::unordered_map<int32_t, uint32_t> slots_{};
+  std::vector<Book> books_{};
+  std::unordered_map<int64_t, Order> orders_{};
+  std::vector<PriceLevel> scratch_{};
+  // books with pending sides
+  std::vector<uint32_t> pending_{};
+  uint64_t time_ns_{0};
+
+  size_t updates_{0};
+  size_t transactions_{0};
+  size_t unknown_orders_{0};
+};
+
+}  // namespace task::market_data
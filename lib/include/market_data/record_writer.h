@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace task::market_data {
+
+// Appends fixed-size records to a binary file, as they are in memory (host
+// byte order). The records are batched in a buffer and written with one
+// fwrite per buffer, instead of a stream call per record: a day of updates
+// is written at the speed of the disk.
+template <typename Record>
+class RecordWriter {
+  static_assert(std::is_trivially_copyable_v<Record>);
+
+ public:
+  static constexpr size_t DEFAULT_BUFFER_RECORDS = 64 * 1024;
+
+  // With append, the records go after those already in the file (e.g. of a
+  // run resumed from a checkpoint) instead of replacing them. Throws
+  // std::runtime_error when the file cannot be created.
+  explicit RecordWriter(const std::string &path,
+                        size_t buffer_records = DEFAULT_BUFFER_RECORDS,
+                        bool append = false)
+      : file_(std::fopen(path.c_str(), append ? "ab" : "wb")),
+        capacity_(buffer_records == 0 ? 1 : buffer_records) {
+    if (file_ == nullptr) {
+      throw std::runtime_error("Cannot create " + path);
+    }
+    buffer_.reserve(capacity_);
+  }
+
+  RecordWriter(const RecordWriter &) = delete;
+  RecordWriter &operator=(const RecordWriter &) = delete;
+
+  ~RecordWriter() {
+    try {
+      flush();
+    } catch (const std::exception &) {
+      // nothing to report to from a destructor, flush() first to know
+    }
+    std::fclose(file_);
+  }
+
+  void write(const Record &record) {
+    if (buffer_.size() == capacity_) {
+      flush();
+    }
+    buffer_.push_back(record);
+    ++records_;
+  }
+
+  // Throws std::runtime_error when the records cannot be written
+  void flush() {
+    const size_t count = buffer_.size();
+    const size_t written =
+        std::fwrite(buffer_.data(), sizeof(Record), count, file_);
+    buffer_.clear();
+    if (written != count) {
+      throw std::runtime_error("Cannot write the records");
+    }
+    if (std::fflush(file_) != 0) {
+      throw std::runtime_error("Cannot write the records");
+    }
+  }
+
+  [[nodiscard]] size_t records() const noexcept { return records_; }
+
+ private:
+  std::FILE *file_;
+  size_t capacity_;
+  std::vector<Record> buffer_{};
+  size_t records_{0};
+};
+
+}  // namespace task::market_data
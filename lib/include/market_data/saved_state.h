@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+namespace task::market_data {
+
+// The save() and restore() of the consumers of the messages write their
+// state as a flat string of values in host byte order, e.g. for a
+// Checkpoint.
+
+template <typename T>
+void append_state(std::vector<std::byte> &state, T value) {
+  static_assert(std::is_trivially_copyable_v<T>);
+  const auto *bytes = reinterpret_cast<const std::byte *>(&value);
+  state.insert(state.end(), bytes, bytes + sizeof(value));
+}
+
+// Reads the next value of the state, throws std::runtime_error past its end
+template <typename T>
+T take_state(std::span<const std::byte> &state) {
+  static_assert(std::is_trivially_copyable_v<T>);
+  if (state.size() < sizeof(T)) {
+    throw std::runtime_error("Truncated state");
+  }
+  T value;
+  std::memcpy(&value, state.data(), sizeof(value));
+  state = state.subspan(sizeof(value));
+  return value;
+}
+
+}  // namespace task::market_data
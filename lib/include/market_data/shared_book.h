@@ -0,0 +1,177 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "market_data/market_by_price.h"
+#include "market_data/shared_memory.h"
+#include "simba_decoder/simba_types.h"
+
+namespace task::market_data {
+
+// The books of the instruments in a POSIX shared memory segment, for the
+// other processes of the host. The segment is a header followed by one
+// slot per instrument, each starting on its own cache line:
+//
+//   SharedBookHeader | slot 0 | slot 1 | ... | slot capacity - 1
+//   slot: SharedBookSlot | depth bid levels | depth offer levels
+//
+// The publisher is the only writer. Each slot is guarded by a seqlock: the
+// sequence is odd while the slot is written, and a reader retries when it
+// changed during its copy. Readers never write to the segment nor call the
+// kernel after opening it.
+
+inline constexpr uint64_t SHARED_BOOK_MAGIC = 0x314b4f4f424d4953;  // SIMBOOK1
+inline constexpr uint32_t SHARED_BOOK_LAYOUT = 1;
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free);
+static_assert(std::atomic<uint32_t>::is_always_lock_free);
+
+struct alignas(64) SharedBookHeader {
+  // SHARED_BOOK_MAGIC once the segment is initialised
+  std::atomic<uint64_t> magic{0};
+  uint32_t layout{SHARED_BOOK_LAYOUT};
+  uint32_t depth{0};
+  uint32_t capacity{0};
+  // bytes between two slots, a multiple of the cache line
+  uint32_t slot_size{0};
+  // slots in use, they are assigned in order
+  std::atomic<uint32_t> instruments{0};
+};
+
+struct SharedBookSlot {
+  // odd while the publisher writes the slot
+  std::atomic<uint64_t> sequence{0};
+  uint64_t time_ns{0};
+  int32_t security_id{0};
+  uint32_t reserved{0};
+};
+static_assert(sizeof(SharedBookSlot) % alignof(PriceLevel) == 0);
+
+// A consistent copy of a slot, the empty levels past the last one of a side
+struct SharedBookSnapshot {
+  int32_t security_id{0};
+  uint64_t time_ns{0};
+  // number of updates of the slot
+  uint64_t version{0};
+  std::vector<PriceLevel> bids{};
+  std::vector<PriceLevel> offers{};
+};
+
+// Maintains the market-by-price books of the order updates and publishes
+// the depth best levels of each instrument to the segment after every
+// message (every transaction with conflate). The segment outlives the
+// publisher, so that it can still be read after a replay; remove() deletes
+// it.
+class SharedBookPublisher {
+ public:
+  static constexpr size_t DEFAULT_CAPACITY = 4096;
+
+  // Creates or resets the segment /name. Throws std::runtime_error when it
+  // cannot be created, on a depth of 0 or above 255, or a zero capacity.
+  SharedBookPublisher(const std::string &name, size_t depth,
+                      size_t capacity = DEFAULT_CAPACITY,
+                      bool conflate = false);
+  SharedBookPublisher(const SharedBookPublisher &) = delete;
+  SharedBookPublisher &operator=(const SharedBookPublisher &) = delete;
+
+  void on_order_update(simba::types::OrderUpdateView update, uint64_t time_ns);
+
+  void on_order_execution(simba::types::OrderExecutionView execution,
+                          uint64_t time_ns);
+
+  // Publishes the changes of a transaction cut by the end of the stream
+  void flush();
+
+  // Unlinks the segment /name, false when it does not exist
+  static bool remove(const std::string &name);
+
+  [[nodiscard]] const MarketByPrice &book() const noexcept { return book_; }
+
+  // Slot writes
+  [[nodiscard]] size_t commits() const noexcept { return commits_; }
+
+  // Instruments past the capacity of the segment, not published
+  [[nodiscard]] size_t dropped_instruments() const noexcept {
+    return dropped_instruments_;
+  }
+
+ private:
+  static constexpr uint32_t NO_SLOT = UINT32_MAX;
+
+  // The levels of an instrument as last reported by the book, indexed by
+  // slot
+  struct Staged {
+    int32_t security_id{0};
+    uint64_t time_ns{0};
+    std::vector<PriceLevel> bids;
+    std::vector<PriceLevel> offers;
+    bool changed{false};
+  };
+
+  void on_depth(const DepthUpdate &update);
+  // Writes the changed instruments to their slots
+  void commit();
+  [[nodiscard]] SharedBookSlot *slot(size_t index) const noexcept;
+
+  MarketByPrice book_;
+  size_t depth_;
+  size_t capacity_;
+  size_t slot_size_;
+  SharedMemory segment_;
+  SharedBookHeader *header_;
+  // slot by instrument, NO_SLOT past the capacity
+  std::unordered_map<int32_t, uint32_t> slots_{};
+  std::vector<Staged> staged_{};
+  std::vector<uint32_t> changed_{};
+  size_t commits_{0};
+  size_t dropped_instruments_{0};
+};
+
+// Reads the books of a segment written by a SharedBookPublisher, possibly
+// from another process. A read copies one slot, without any system call or
+// write to the shared memory.
+class SharedBookReader {
+ public:
+  // Maps the segment /name read-only. Throws std::runtime_error when it
+  // does not exist or is not (yet) an initialised book segment.
+  explicit SharedBookReader(const std::string &name);
+
+  SharedBookReader(const SharedBookReader &) = delete;
+  SharedBookReader &operator=(const SharedBookReader &) = delete;
+
+  [[nodiscard]] size_t depth() const noexcept { return header_->depth; }
+
+  [[nodiscard]] size_t capacity() const noexcept { return header_->capacity; }
+
+  // Instruments published so far
+  [[nodiscard]] size_t instruments() const noexcept {
+    return header_->instruments.load(std::memory_order_acquire);
+  }
+
+  // The slot of an instrument, std::nullopt until it is published. The
+  // slots are scanned once, then cached.
+  [[nodiscard]] std::optional<size_t> find(int32_t security_id);
+
+  // Copies a consistent state of the slot into snapshot, reusing its
+  // vectors. False for a slot not in use, or when the publisher keeps
+  // rewriting it for too long (e.g. it died in the middle of a write).
+  bool read(size_t slot, SharedBookSnapshot &snapshot) const;
+
+ private:
+  static constexpr size_t MAX_RETRIES = 1 << 20;
+
+  [[nodiscard]] const SharedBookSlot *slot(size_t index) const noexcept;
+
+  SharedMemory segment_;
+  const SharedBookHeader *header_;
+  std::unordered_map<int32_t, size_t> slots_{};
+  size_t scanned_{0};
+};
+
+}  // namespace task::market_data
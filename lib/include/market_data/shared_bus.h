@@ -0,0 +1,144 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <type_traits>
+
+#include "market_data/shared_memory.h"
+#include "simba_decoder/simba_types.h"
+
+namespace task::market_data {
+
+// A broadcast ring of the decoded messages in a POSIX shared memory
+// segment: one writer, the decoder, and any number of readers in other
+// processes, each following the stream at its own cursor.
+//
+//   SharedBusHeader | slot 0 | slot 1 | ... | slot capacity - 1
+//
+// Event n goes to slot n % capacity, the writer never waits for the
+// readers. Each slot carries a state: 2n + 1 while event n is written,
+// 2n + 2 once it is. A reader expecting event n finds a lower state when it
+// is not written yet, and a higher one when the writer lapped it: the
+// overwritten events are skipped and counted as lost.
+
+inline constexpr uint64_t SHARED_BUS_MAGIC = 0x31535542424d4953;  // SIMBBUS1
+inline constexpr uint32_t SHARED_BUS_LAYOUT = 1;
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free);
+
+// A decoded message as published on the bus: the packed struct of the
+// message (as copied by to_message()) behind its template id
+struct BusEvent {
+  uint64_t capture_time_ns{0};
+  // TransactTime of the packet, 0 out of the incremental stream
+  uint64_t transact_time_ns{0};
+  uint16_t template_id{0};
+  // bytes of message in use
+  uint16_t length{0};
+  uint8_t reserved[4]{};
+  std::byte message[96]{};
+
+  // The message, std::nullopt for another template
+  template <typename Message>
+  [[nodiscard]] std::optional<Message> as() const noexcept {
+    static_assert(sizeof(Message) <= sizeof(message));
+    if (template_id != Message::TEMPLATE_ID) {
+      return std::nullopt;
+    }
+    Message copy;
+    std::memcpy(&copy, message, sizeof(Message));
+    return copy;
+  }
+};
+static_assert(sizeof(BusEvent) == 120);
+static_assert(std::is_trivially_copyable_v<BusEvent>);
+
+struct alignas(64) SharedBusHeader {
+  // SHARED_BUS_MAGIC once the segment is initialised
+  std::atomic<uint64_t> magic{0};
+  uint32_t layout{SHARED_BUS_LAYOUT};
+  // slots, a power of two
+  uint32_t capacity{0};
+  // events written so far
+  std::atomic<uint64_t> published{0};
+};
+
+struct alignas(64) SharedBusSlot {
+  std::atomic<uint64_t> state{0};
+  BusEvent event{};
+};
+static_assert(sizeof(SharedBusSlot) == 128);
+
+// Publishes the OrderUpdate and OrderExecution messages to the segment /name
+// (created or replaced, its previous readers keep their mapping).
+class SharedBusWriter {
+ public:
+  static constexpr size_t DEFAULT_CAPACITY = 64 * 1024;
+
+  // Throws std::runtime_error when the segment cannot be created, or when
+  // capacity is not a power of two
+  explicit SharedBusWriter(const std::string &name,
+                           size_t capacity = DEFAULT_CAPACITY);
+
+  SharedBusWriter(const SharedBusWriter &) = delete;
+  SharedBusWriter &operator=(const SharedBusWriter &) = delete;
+
+  void publish(simba::types::OrderUpdateView update, uint64_t capture_time_ns,
+               uint64_t transact_time_ns);
+
+  void publish(simba::types::OrderExecutionView execution,
+               uint64_t capture_time_ns, uint64_t transact_time_ns);
+
+  // Unlinks the segment /name, false when it does not exist
+  static bool remove(const std::string &name);
+
+  [[nodiscard]] uint64_t published() const noexcept { return next_; }
+
+ private:
+  template <typename Message>
+  void publish(const Message &message, uint64_t capture_time_ns,
+               uint64_t transact_time_ns);
+
+  SharedMemory segment_;
+  SharedBusHeader *header_;
+  SharedBusSlot *slots_;
+  uint64_t mask_;
+  uint64_t next_{0};
+};
+
+// Follows the events of a segment written by a SharedBusWriter, possibly
+// from another process, without system calls or writes to the segment.
+class SharedBusReader {
+ public:
+  // Maps the segment /name read-only and starts with the next event, or
+  // with replay at the oldest one still in the ring. Throws
+  // std::runtime_error when it is not an initialised bus segment.
+  explicit SharedBusReader(const std::string &name, bool replay = false);
+
+  // Copies the next event, returns its sequence number, std::nullopt once
+  // the reader caught up with the writer
+  std::optional<uint64_t> poll(BusEvent &event);
+
+  // Sequence number of the next event to read
+  [[nodiscard]] uint64_t cursor() const noexcept { return cursor_; }
+
+  // Events overwritten before they were read
+  [[nodiscard]] uint64_t lost() const noexcept { return lost_; }
+
+ private:
+  // Moves the cursor past the events overwritten by the slot state
+  void skip_overwritten(uint64_t state);
+
+  SharedMemory segment_;
+  const SharedBusHeader *header_;
+  const SharedBusSlot *slots_;
+  uint64_t capacity_;
+  uint64_t cursor_{0};
+  uint64_t lost_{0};
+};
+
+}  // namespace task::market_data
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <utility>
+
+namespace task::market_data {
+
+// A POSIX shared memory segment (/dev/shm/<name>) mapped in the process,
+// unmapped on destruction. The segment itself outlives the mapping.
+class SharedMemory {
+ public:
+  // Creates the segment /name of size zeroed bytes, mapped read-write. A
+  // previous segment of that name is unlinked first: its readers keep their
+  // mapping of it. Throws std::runtime_error when it cannot be created.
+  static SharedMemory create(const std::string &name, size_t size);
+
+  // Maps the existing segment /name read-only. Throws std::runtime_error
+  // when it does not exist.
+  static SharedMemory open(const std::string &name);
+
+  // Unlinks the segment /name, false when it does not exist
+  static bool remove(const std::string &name);
+
+  SharedMemory(SharedMemory &&other) noexcept;
+  SharedMemory &operator=(SharedMemory &&other) noexcept;
+  ~SharedMemory();
+
+  [[nodiscard]] std::byte *data() const noexcept { return data_; }
+
+  [[nodiscard]] size_t size() const noexcept { return size_; }
+
+  // "/name", for the error messages
+  [[nodiscard]] const std::string &path() const noexcept { return path_; }
+
+ private:
+  SharedMemory(std::string path, std::byte *data, size_t size) noexcept
+      : path_(std::move(path)), data_(data), size_(size) {}
+
+  std::string path_;
+  std::byte *data_{nullptr};
+  size_t size_{0};
+};
+
+}  // namespace task::market_data
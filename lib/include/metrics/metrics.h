@@ -0,0 +1,164 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "simba_decoder/simba_messages.h"
+
+namespace task::metrics {
+
+// Compile-time opt-out: configure with -DENABLE_METRICS=OFF and every call
+// below compiles to nothing on the hot path
+#ifdef TASK_ENABLE_METRICS
+inline constexpr bool ENABLED{true};
+#else
+inline constexpr bool ENABLED{false};
+#endif
+
+enum class Counter : uint8_t {
+  BytesRead = 0,
+  PacketsFramed,
+  NonUDPSkipped,
+  MalformedPackets,
+  UnknownTemplates,
+  SnapshotEntries,
+  ProducerStallNs,
+  ConsumerStallNs,
+  DatagramsReassembled,
+  FragmentsDropped,
+  TruncatedPackets,
+  ChecksumErrors,
+  UnsupportedSchemas,
+  ReadNs,
+  Count
+};
+
+inline constexpr std::array<std::string_view,
+                            static_cast<size_t>(Counter::Count)>
+    COUNTER_NAMES = {"bytes_read",        "packets_framed",
+                     "non_udp_skipped",   "malformed_packets",
+                     "unknown_templates", "snapshot_entries",
+                     "producer_stall_ns", "consumer_stall_ns",
+                     "datagrams_reassembled", "fragments_dropped",
+                     "truncated_packets", "checksum_errors",
+                     "unsupported_schemas", "read_ns"};
+
+enum class Gauge : uint8_t { QueueDepth = 0, Count };
+
+inline constexpr std::array<std::string_view, static_cast<size_t>(Gauge::Count)>
+    GAUGE_NAMES = {"queue_depth"};
+
+// The messages are counted by template of the schema, at the position of
+// the template in simba::types::TEMPLATE_IDS
+inline constexpr size_t TEMPLATE_COUNT = simba::types::TEMPLATE_IDS.size();
+
+// Counters written by a single thread. The block is cache-line aligned so
+// that threads never share a line; readers aggregate every block.
+struct alignas(64) ThreadCounters {
+  std::array<std::atomic<uint64_t>, static_cast<size_t>(Counter::Count)>
+      counters{};
+  std::array<std::atomic<uint64_t>, TEMPLATE_COUNT> messages{};
+
+  static void increment(std::atomic<uint64_t> &counter,
+                        uint64_t value) noexcept {
+    // single writer: a plain load/store pair, no locked instruction
+    counter.store(counter.load(std::memory_order_relaxed) + value,
+                  std::memory_order_relaxed);
+  }
+};
+
+// Registers the counters of the calling thread, they outlive the thread
+ThreadCounters *register_thread();
+
+inline ThreadCounters &local_counters() {
+  thread_local ThreadCounters *counters = register_thread();
+  return *counters;
+}
+
+struct alignas(64) PaddedGauge {
+  std::atomic<int64_t> value{0};
+};
+
+inline std::array<PaddedGauge, static_cast<size_t>(Gauge::Count)> gauges{};
+
+inline void add(Counter counter, uint64_t value = 1) noexcept {
+  if constexpr (ENABLED) {
+    ThreadCounters::increment(
+        local_counters().counters[static_cast<size_t>(counter)], value);
+  }
+}
+
+inline void add_message(uint16_t template_id) noexcept {
+  if constexpr (ENABLED) {
+    const size_t index = simba::types::template_index(template_id);
+    if (index < TEMPLATE_COUNT) {
+      ThreadCounters::increment(local_counters().messages[index], 1);
+    }
+  }
+}
+
+inline void set(Gauge gauge, int64_t value) noexcept {
+  if constexpr (ENABLED) {
+    gauges[static_cast<size_t>(gauge)].value.store(value,
+                                                   std::memory_order_relaxed);
+  }
+}
+
+// Adds the lifetime of the scope to a stall counter
+class ScopedTimer {
+ public:
+  explicit ScopedTimer(Counter counter) : counter_(counter) {
+    if constexpr (ENABLED) {
+      start_ = std::chrono::steady_clock::now();
+    }
+  }
+
+  ~ScopedTimer() {
+    if constexpr (ENABLED) {
+      add(counter_, std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::steady_clock::now() - start_)
+                        .count());
+    }
+  }
+
+  ScopedTimer(const ScopedTimer &) = delete;
+  ScopedTimer &operator=(const ScopedTimer &) = delete;
+
+ private:
+  Counter counter_;
+  std::chrono::steady_clock::time_point start_{};
+};
+
+struct Snapshot {
+  uint64_t timestamp_ns{0};
+  std::array<uint64_t, static_cast<size_t>(Counter::Count)> counters{};
+  // by template index, see TEMPLATE_COUNT
+  std::array<uint64_t, TEMPLATE_COUNT> messages{};
+  std::array<int64_t, static_cast<size_t>(Gauge::Count)> gauges{};
+
+  [[nodiscard]] uint64_t operator[](Counter counter) const noexcept {
+    return counters[static_cast<size_t>(counter)];
+  }
+
+  // 0 for the templates outside the schema
+  [[nodiscard]] uint64_t messages_of(uint16_t template_id) const noexcept {
+    const size_t index = simba::types::template_index(template_id);
+    return index < TEMPLATE_COUNT ? messages[index] : 0;
+  }
+
+  // One JSON object on a single line
+  [[nodiscard]] std::string to_json() const;
+
+  // Prometheus text exposition format
+  [[nodiscard]] std::string to_prometheus() const;
+};
+
+// Aggregates the counters of every thread
+Snapshot collect();
+
+}  // namespace task::metrics
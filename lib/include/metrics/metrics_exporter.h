@@ -0,0 +1,42 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+#include "metrics/metrics.h"
+
+namespace task::metrics {
+
+struct ExporterConfig {
+  // appends one JSON object per line at every interval
+  std::optional<std::filesystem::path> json_lines_path{};
+  // rewritten atomically, for the node_exporter textfile collector
+  std::optional<std::filesystem::path> prometheus_path{};
+  std::chrono::milliseconds interval{1000};
+};
+
+// Collects and exports the metrics from a background thread, a last export
+// is written when the exporter is destroyed
+class MetricsExporter {
+ public:
+  explicit MetricsExporter(ExporterConfig config);
+  ~MetricsExporter();
+
+  MetricsExporter(const MetricsExporter &) = delete;
+  MetricsExporter &operator=(const MetricsExporter &) = delete;
+
+  void export_now() const;
+
+ private:
+  ExporterConfig config_;
+  std::mutex mutex_;
+  std::condition_variable stop_condition_;
+  bool is_stopped_{false};
+  std::thread exporter_thread_{};
+};
+
+}  // namespace task::metrics
@@ -0,0 +1,167 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+#include "logging/logger.h"
+#include "metrics/metrics.h"
+#include "processors/flow_table.h"
+#include "processors/link_layer.h"
+#include "processors/packet_processor.h"
+#include "processors/packet_source.h"
+#include "processors/packet_validation.h"
+#include "processors/pcap_types.h"
+#include "simba_decoder/simba_decoder.h"
+
+namespace task::processors {
+
+// Decodes the frames of any PacketSource: link layer, IPv4 reassembly, UDP,
+// optional validation, feed routing and SIMBA decoding. Nothing runs in the
+// constructor: start(), then poll() from one thread until is_finished() (or
+// run() which loops), then stop().
+template <PacketSource Source>
+class CaptureProcessor {
+ public:
+  // Without feeds every UDP payload goes to one decoder. With feeds each one
+  // gets its own decoder, and datagrams to other destinations are skipped.
+  // The decoder of a feed with several destinations (A/B channels) keeps
+  // the first copy of each incremental packet. The source must outlive the
+  // processor.
+  CaptureProcessor(Source &source,
+                   const simba::decoder::MessageHandlers &handlers,
+                   const std::vector<FeedRoute> &feeds = {},
+                   transport_layer::ValidationConfig validation = {});
+
+  // The same, with a handler set per feed: feed_handlers[i] receives the
+  // messages of the i-th feed name of the routes (a single set without
+  // feeds). Throws std::runtime_error when their numbers differ.
+  CaptureProcessor(
+      Source &source,
+      const std::vector<simba::decoder::MessageHandlers> &feed_handlers,
+      const std::vector<FeedRoute> &feeds,
+      transport_layer::ValidationConfig validation = {});
+
+  // the packet processor points to the decoders
+  CaptureProcessor(const CaptureProcessor &) = delete;
+  CaptureProcessor &operator=(const CaptureProcessor &) = delete;
+
+  // Starts the source and picks the link-layer decoder of its link type,
+  // throws std::runtime_error when it is not supported
+  void start();
+
+  // Processes the next batch of the source if one is ready, returns its
+  // number of packets
+  size_t poll();
+
+  // Polls until the source is finished or request_stop() is called, waiting
+  // while nothing is ready. Returns the number of packets.
+  size_t run();
+
+  // run(), calling after_batch between the batches: a point where no
+  // message is being decoded, e.g. to save a Checkpoint
+  size_t run(const std::function<void()> &after_batch);
+
+  // Safe to call from another thread or from a signal handler
+  void request_stop() noexcept {
+    is_stop_requested_.store(true, std::memory_order_release);
+  }
+
+  // Stops the source, logs the totals, the feeds and the invalid packets
+  void stop();
+
+  [[nodiscard]] bool is_finished() const { return source_.is_finished(); }
+
+  [[nodiscard]] size_t packets_processed() const noexcept {
+    return packets_processed_;
+  }
+
+  // Bytes of the records processed, record headers included: how far the
+  // processor moved in a capture file
+  [[nodiscard]] uint64_t bytes_processed() const noexcept {
+    return bytes_processed_;
+  }
+
+  // Sequence number of the last incremental packet decoded, per feed (one
+  // without feeds)
+  [[nodiscard]] std::vector<uint32_t> sequence_numbers() const;
+
+  // Seeds the decoders with the sequence_numbers() of a previous run, e.g.
+  // from a Checkpoint. Throws std::runtime_error when they are not one per
+  // feed.
+  void restore_sequence_numbers(const std::vector<uint32_t> &sequence_numbers);
+
+  [[nodiscard]] const std::optional<FlowTable> &flow_table() const noexcept {
+    return flow_table_;
+  }
+
+  // Empty unless the validation is on
+  [[nodiscard]] const transport_layer::ValidationReport &
+  validation_report() const;
+
+  // Clocks of the datagram being decoded, read by the message handlers: the
+  // capture timestamp of the frame that carried it (the last fragment)...
+  [[nodiscard]] uint64_t capture_time_ns() const noexcept {
+    return record_ != nullptr ? pcap::types::to_nanoseconds(
+                                    *record_, pcap::types::MAGIC_NANOSECONDS)
+                              : 0;
+  }
+
+  // ...and the exchange transact_time of its SIMBA packet, 0 for snapshots
+  [[nodiscard]] uint64_t transact_time_ns() const noexcept {
+    const auto &header = decoder_->incremental_header();
+    return header ? header->transact_time : 0;
+  }
+
+ private:
+  // only parse_batch() is used, the datagrams are routed and decoded here
+  struct IgnoreDatagram {
+    void operator()(std::span<const std::byte>) const noexcept {}
+  };
+
+  template <transport_layer::LinkLayerDecoder LinkLayer>
+  using Processor = PacketProcessor<IgnoreDatagram, LinkLayer>;
+
+  // Feeds of the routes, the routes sharing a name are one feed (one
+  // without routes)
+  static size_t count_feeds(const std::vector<FeedRoute> &feeds);
+
+  // flow table routing, or straight to the single decoder
+  template <transport_layer::LinkLayerDecoder LinkLayer>
+  void process_packets(Processor<LinkLayer> &processor,
+                       const PacketBatch &batch);
+
+  Source &source_;
+  // one decoder per feed of the flow table, or a single one without it
+  std::vector<simba::decoder::SIMBADecoder> decoders_{};
+  std::optional<FlowTable> flow_table_{};
+  // the datagram being decoded and its decoder
+  const pcap::types::pcaprec_hdr_s *record_{nullptr};
+  const simba::decoder::SIMBADecoder *decoder_{nullptr};
+  transport_layer::ValidationConfig validation_{};
+  // chosen by start() from the link type of the source
+  std::variant<std::monostate, Processor<transport_layer::EthernetLink>,
+               Processor<transport_layer::LinuxSLLLink>,
+               Processor<transport_layer::LinuxSLL2Link>>
+      processor_{};
+
+  size_t batch_number_{1};
+  size_t packets_processed_{0};
+  uint64_t bytes_processed_{0};
+  bool is_stopped_{false};
+  std::atomic_bool is_stop_requested_{false};
+
+  static constexpr size_t CONSUMER_BUFFERING_TIME{500};
+  static constexpr std::string_view log_prefix_{"[CAPTURE_PROCESSOR]"};
+};
+
+}  // namespace task::processors
+
+#include "processors/capture_processor.hpp"
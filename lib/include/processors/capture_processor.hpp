@@ -0,0 +1,227 @@
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+
+#include "processors/capture_processor.h"
+
+namespace task::processors {
+
+template <PacketSource Source>
+CaptureProcessor<Source>::CaptureProcessor(
+    Source &source, const simba::decoder::MessageHandlers &handlers,
+    const std::vector<FeedRoute> &feeds,
+    transport_layer::ValidationConfig validation)
+    : CaptureProcessor(source,
+                       std::vector<simba::decoder::MessageHandlers>(
+                           count_feeds(feeds), handlers),
+                       feeds, validation) {}
+
+template <PacketSource Source>
+CaptureProcessor<Source>::CaptureProcessor(
+    Source &source,
+    const std::vector<simba::decoder::MessageHandlers> &feed_handlers,
+    const std::vector<FeedRoute> &feeds,
+    transport_layer::ValidationConfig validation)
+    : source_(source), validation_(validation) {
+  if (!feeds.empty()) {
+    flow_table_.emplace(feeds);
+  }
+  const size_t decoders = flow_table_ ? flow_table_->feeds() : 1;
+  if (feed_handlers.size() != decoders) {
+    throw std::runtime_error("One handler set per feed expected: " +
+                             std::to_string(decoders) + " feeds, " +
+                             std::to_string(feed_handlers.size()) +
+                             " handler sets");
+  }
+  for (size_t feed = 0; feed < decoders; ++feed) {
+    // A/B channels: the decoder arbitrates them
+    decoders_.emplace_back(feed_handlers[feed],
+                           flow_table_ && flow_table_->destinations(feed) > 1);
+  }
+  decoder_ = &decoders_.front();
+}
+
+template <PacketSource Source>
+void CaptureProcessor<Source>::start() {
+  const uint32_t link_type = source_.link_type();
+  // the link layer is resolved once for the whole source
+  const bool supported = transport_layer::visit_link_type(
+      link_type, [this]<typename LinkLayer>(LinkLayer) {
+        processor_.template emplace<Processor<LinkLayer>>(IgnoreDatagram{},
+                                                          validation_);
+      });
+  if (!supported) {
+    throw std::runtime_error("Unsupported link type " +
+                             std::to_string(link_type));
+  }
+  source_.start();
+}
+
+template <PacketSource Source>
+size_t CaptureProcessor<Source>::poll() {
+  if (std::holds_alternative<std::monostate>(processor_)) {
+    return 0;
+  }
+  const auto batch = source_.next_batch();
+  if (!batch) {
+    return 0;
+  }
+  logging::log(logging::Level::Debug,
+               "{} - Batch number ({}) - Number of read packets {}",
+               log_prefix_, batch_number_, batch->packets.size());
+
+  std::visit(
+      [this, &batch](auto &processor) {
+        if constexpr (!std::is_same_v<std::decay_t<decltype(processor)>,
+                                      std::monostate>) {
+          process_packets(processor, *batch);
+        }
+      },
+      processor_);
+  ++batch_number_;
+  packets_processed_ += batch->packets.size();
+  for (const auto &header : batch->headers) {
+    bytes_processed_ += sizeof(header) + header.captured_length;
+  }
+  return batch->packets.size();
+}
+
+template <PacketSource Source>
+size_t CaptureProcessor<Source>::run() {
+  return run({});
+}
+
+template <PacketSource Source>
+size_t CaptureProcessor<Source>::run(
+    const std::function<void()> &after_batch) {
+  const size_t first_packet = packets_processed_;
+  while (!is_stop_requested_.load(std::memory_order_acquire) &&
+         !source_.is_finished()) {
+    if (poll() > 0) {
+      if (after_batch) {
+        after_batch();
+      }
+    } else if (!source_.is_finished()) {
+      metrics::ScopedTimer stall_timer(metrics::Counter::ConsumerStallNs);
+      std::this_thread::sleep_for(
+          std::chrono::microseconds(CONSUMER_BUFFERING_TIME));
+    }
+  }
+  return packets_processed_ - first_packet;
+}
+
+template <PacketSource Source>
+void CaptureProcessor<Source>::stop() {
+  if (is_stopped_) {
+    return;
+  }
+  is_stopped_ = true;
+  source_.stop();
+
+  logging::log(logging::Level::Info, "{} - Finished to process the capture",
+               log_prefix_);
+  logging::log(logging::Level::Info,
+               "{} - Total number packets of packets processed: {}",
+               log_prefix_, packets_processed_);
+  if (flow_table_) {
+    for (size_t feed = 0; feed < flow_table_->feeds(); ++feed) {
+      const auto &stats = flow_table_->stats(feed);
+      logging::log(logging::Level::Info,
+                   "{} - Feed {}: {} datagrams, {} bytes, {} malformed, {} "
+                   "duplicates",
+                   log_prefix_, flow_table_->name(feed), stats.datagrams,
+                   stats.bytes, decoders_[feed].malformed_packets(),
+                   decoders_[feed].duplicate_packets());
+    }
+    logging::log(logging::Level::Info,
+                 "{} - Not routed: {} datagrams, {} bytes", log_prefix_,
+                 flow_table_->unrouted().datagrams,
+                 flow_table_->unrouted().bytes);
+  }
+
+  if (validation_.verify_checksums) {
+    const auto &report = validation_report();
+    logging::log(logging::Level::Info, "{} - Invalid packets: {}", log_prefix_,
+                 report.invalid_packets());
+    for (const auto &flow : report.flows()) {
+      logging::log(logging::Level::Warning, "{} - {}", log_prefix_,
+                   flow.to_string());
+    }
+  }
+}
+
+template <PacketSource Source>
+std::vector<uint32_t> CaptureProcessor<Source>::sequence_numbers() const {
+  std::vector<uint32_t> sequence_numbers;
+  for (const auto &decoder : decoders_) {
+    sequence_numbers.push_back(decoder.last_sequence_number());
+  }
+  return sequence_numbers;
+}
+
+template <PacketSource Source>
+void CaptureProcessor<Source>::restore_sequence_numbers(
+    const std::vector<uint32_t> &sequence_numbers) {
+  if (sequence_numbers.size() != decoders_.size()) {
+    throw std::runtime_error("One sequence number per feed expected: " +
+                             std::to_string(decoders_.size()) + " feeds, " +
+                             std::to_string(sequence_numbers.size()) +
+                             " sequence numbers");
+  }
+  for (size_t feed = 0; feed < decoders_.size(); ++feed) {
+    decoders_[feed].set_last_sequence_number(sequence_numbers[feed]);
+  }
+}
+
+template <PacketSource Source>
+const transport_layer::ValidationReport &
+CaptureProcessor<Source>::validation_report() const {
+  static const transport_layer::ValidationReport empty_report{};
+  return std::visit(
+      [](const auto &processor) -> const transport_layer::ValidationReport & {
+        if constexpr (std::is_same_v<std::decay_t<decltype(processor)>,
+                                     std::monostate>) {
+          return empty_report;
+        } else {
+          return processor.validation_report();
+        }
+      },
+      processor_);
+}
+
+template <PacketSource Source>
+size_t CaptureProcessor<Source>::count_feeds(
+    const std::vector<FeedRoute> &feeds) {
+  std::vector<std::string_view> names;
+  for (const auto &feed : feeds) {
+    if (std::find(names.begin(), names.end(), feed.name) == names.end()) {
+      names.push_back(feed.name);
+    }
+  }
+  return std::max<size_t>(names.size(), 1);
+}
+
+template <PacketSource Source>
+template <transport_layer::LinkLayerDecoder LinkLayer>
+void CaptureProcessor<Source>::process_packets(
+    Processor<LinkLayer> &processor, const PacketBatch &batch) {
+  // the sources hand out nanosecond record headers
+  for (const auto &datagram : processor.parse_batch(
+           batch.packets, batch.headers, pcap::types::MAGIC_NANOSECONDS)) {
+    size_t feed{0};
+    if (flow_table_) {
+      feed = flow_table_->route(datagram);
+      if (feed == FlowTable::NO_FEED) {
+        continue;
+      }
+    }
+    record_ = &batch.headers[datagram.packet_index];
+    decoder_ = &decoders_[feed];
+    decoders_[feed].decode_message(datagram.payload);
+  }
+  record_ = nullptr;
+}
+
+}  // namespace task::processors
@@ -0,0 +1,181 @@
+#pragma once
+
+#include <sys/types.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "processors/packet_source.h"
+#include "processors/pcap_buffer.h"
+#include "processors/pcap_file.h"
+#include "processors/pcap_merger.h"
+#include "processors/pcap_types.h"
+
+namespace task::processors {
+
+// A capture file read ahead by the producer thread of PCAPBuffer, in chunks
+// of 16MB. The records are read from offset, e.g. that of a Checkpoint.
+class FileSource {
+ public:
+  // Throws std::runtime_error when the file cannot be used, or offset is
+  // past its end
+  explicit FileSource(const std::filesystem::path &path,
+                      size_t offset = PCAPFile::HEADER_SIZE);
+  ~FileSource();
+
+  FileSource(const FileSource &) = delete;
+  FileSource &operator=(const FileSource &) = delete;
+
+  [[nodiscard]] uint32_t link_type() const noexcept {
+    return file_.header.network;
+  }
+  [[nodiscard]] size_t file_size() const noexcept { return file_.file_size; }
+
+  void start();
+  std::optional<PacketBatch> next_batch();
+  [[nodiscard]] bool is_finished() const noexcept { return is_finished_; }
+  void stop();
+
+  // batches of PCAPBuffer::BATCH_SIZE read ahead of the decoder: a decoder
+  // slower than the disk does not queue the whole capture in memory
+  static constexpr size_t READ_AHEAD_BATCHES = 8;
+
+ private:
+  PCAPFile file_;
+  std::unique_ptr<mt_buffer::PCAPBuffer> buffer_{};
+  std::optional<mt_buffer::BufferedPackets> batch_{};
+  bool is_started_{false};
+  bool is_finished_{false};
+};
+
+// Several capture files merged by timestamp (see PCAPMerger)
+class MergedSource {
+ public:
+  explicit MergedSource(const std::vector<std::filesystem::path> &files);
+
+  [[nodiscard]] uint32_t link_type() const noexcept { return link_type_; }
+  [[nodiscard]] size_t file_size() const noexcept {
+    return merger_.total_size();
+  }
+
+  // the files are opened as the merge reaches them
+  void start() {}
+  std::optional<PacketBatch> next_batch();
+  [[nodiscard]] bool is_finished() const noexcept { return is_finished_; }
+  void stop() { is_finished_ = true; }
+
+ private:
+  PCAPMerger merger_;
+  uint32_t link_type_{0};
+  bool is_finished_{false};
+};
+
+// A whole capture already in memory, e.g. built by a test. The buffer is
+// not copied and must outlive the source. The records are framed from
+// offset.
+class MemorySource {
+ public:
+  explicit MemorySource(std::span<const std::byte> capture,
+                        size_t offset = PCAPFile::HEADER_SIZE);
+
+  [[nodiscard]] uint32_t link_type() const noexcept { return header_.network; }
+
+  void start() {}
+  std::optional<PacketBatch> next_batch();
+  [[nodiscard]] bool is_finished() const noexcept { return is_finished_; }
+  void stop() { is_finished_ = true; }
+
+  static constexpr size_t BATCH_PACKETS = 1024;
+
+ private:
+  pcap::types::pcap_hdr_t header_{};
+  CaptureFramer framer_;
+  std::vector<transport_layer::PacketView> packets_{};
+  std::vector<pcap::types::pcaprec_hdr_s> headers_{};
+  bool is_finished_{false};
+};
+
+// A capture file mapped in memory: the frames are read straight from the
+// page cache, without a producer thread nor a copy
+class MappedFileSource {
+ public:
+  explicit MappedFileSource(const std::filesystem::path &path,
+                            size_t offset = PCAPFile::HEADER_SIZE);
+  ~MappedFileSource();
+
+  MappedFileSource(const MappedFileSource &) = delete;
+  MappedFileSource &operator=(const MappedFileSource &) = delete;
+
+  [[nodiscard]] uint32_t link_type() const noexcept {
+    return memory_->link_type();
+  }
+  [[nodiscard]] size_t file_size() const noexcept { return size_; }
+
+  void start() {}
+  std::optional<PacketBatch> next_batch() { return memory_->next_batch(); }
+  [[nodiscard]] bool is_finished() const noexcept {
+    return memory_->is_finished();
+  }
+  void stop() { memory_->stop(); }
+
+ private:
+  void *mapping_{nullptr};
+  size_t size_{0};
+  std::optional<MemorySource> memory_{};
+};
+
+// A compressed capture, decompressed by gzip, zstd, xz or lz4 (picked from
+// the extension) running as a child process: the decompression overlaps the
+// decoding. Chunks are read from the pipe into two alternating buffers, a
+// record cut at the end of a chunk is moved to the start of the next one.
+class CompressedFileSource {
+ public:
+  explicit CompressedFileSource(const std::filesystem::path &path);
+  ~CompressedFileSource();
+
+  CompressedFileSource(const CompressedFileSource &) = delete;
+  CompressedFileSource &operator=(const CompressedFileSource &) = delete;
+
+  // whether the extension names a supported compression
+  static bool is_compressed(const std::filesystem::path &path);
+
+  [[nodiscard]] uint32_t link_type() const noexcept { return header_.network; }
+
+  void start() {}
+  std::optional<PacketBatch> next_batch();
+  [[nodiscard]] bool is_finished() const noexcept { return is_finished_; }
+  void stop();
+
+  static constexpr size_t CHUNK_SIZE = 4 * 1024 * 1024;
+
+ private:
+  // Reads into the buffer until it is full, the pipe is empty or closed
+  size_t read_available(std::byte *data, size_t size);
+  bool read_exactly(std::byte *data, size_t size);
+  // Reaps the decompressor, returns its exit status
+  int wait_decompressor();
+
+  pid_t decompressor_{-1};
+  int pipe_{-1};
+  pcap::types::pcap_hdr_t header_{};
+  std::array<std::unique_ptr<std::byte[]>, 2> buffers_{};
+  size_t current_{0};
+  // bytes of the current buffer not framed yet
+  std::span<const std::byte> carry_{};
+  std::vector<transport_layer::PacketView> packets_{};
+  std::vector<pcap::types::pcaprec_hdr_s> headers_{};
+  bool end_of_stream_{false};
+  bool is_finished_{false};
+
+  static constexpr int POLL_TIMEOUT_MS = 100;
+  static constexpr std::string_view log_prefix_{"[COMPRESSED_SOURCE]"};
+};
+
+}  // namespace task::processors
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace task::processors {
+
+// Where a decoding run stands, saved periodically so that a run that died
+// can resume close to where it stopped instead of from the global header.
+// Written in host byte order:
+//
+//   magic | layout | feeds | file_offset | packets | capture_size
+//   | capture path size | capture path | sequence numbers
+//   | outputs | { path size | path | output size }...
+//   | states | { name size | name | state size | state }...
+struct Checkpoint {
+  // Canonical path and size of the capture it belongs to
+  std::string capture{};
+  uint64_t capture_size{0};
+  // Byte offset in the capture of the first record not processed yet
+  uint64_t file_offset{0};
+  // Records processed before it
+  uint64_t packets{0};
+  // Sequence number of the last packet decoded, per feed
+  std::vector<uint32_t> sequence_numbers{};
+  // Size of each output file by absolute path, flushed before the
+  // checkpoint: a resumed run cuts them back to it and appends
+  std::map<std::string, uint64_t> outputs{};
+  // State of each consumer of the messages (e.g. a book) by name, opaque
+  // here
+  std::map<std::string, std::vector<std::byte>> states{};
+
+  static constexpr uint64_t MAGIC = 0x31504b43424d4953;  // SIMBCKP1
+  static constexpr uint32_t LAYOUT = 2;
+
+  // Writes the checkpoint next to path then renames it over path: a run
+  // killed while saving leaves the previous checkpoint whole. Throws
+  // std::runtime_error when it cannot be written.
+  void save(const std::filesystem::path &path) const;
+
+  // std::nullopt when there is no file at path. Throws std::runtime_error
+  // when it is not a whole checkpoint.
+  static std::optional<Checkpoint> load(const std::filesystem::path &path);
+
+  friend bool operator==(const Checkpoint &, const Checkpoint &) = default;
+};
+
+}  // namespace task::processors
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace task::transport_layer {
+
+// RFC 1071 one's complement sum of the data read as big-endian 16-bit words
+// (an odd trailing byte is padded with zero), folded to 16 bits and not
+// complemented. initial is a folded sum to continue from, e.g. the UDP
+// pseudo header. A header holding its own correct checksum sums to 0xFFFF.
+//
+// Dispatches once to an AVX2 implementation when the CPU supports it.
+uint16_t ones_complement_sum(std::span<const std::byte> data,
+                             uint16_t initial = 0) noexcept;
+
+// Adds two folded sums
+constexpr uint16_t ones_complement_add(uint16_t lhs, uint16_t rhs) noexcept {
+  const uint32_t sum = uint32_t{lhs} + rhs;
+  return static_cast<uint16_t>((sum & 0xFFFF) + (sum >> 16));
+}
+
+namespace detail {
+uint16_t ones_complement_sum_scalar(std::span<const std::byte> data,
+                                    uint16_t initial) noexcept;
+
+// Only callable when avx2_supported()
+uint16_t ones_complement_sum_avx2(std::span<const std::byte> data,
+                                  uint16_t initial) noexcept;
+
+bool avx2_supported() noexcept;
+}  // namespace detail
+
+}  // namespace task::transport_layer
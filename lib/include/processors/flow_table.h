@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "processors/packet_types.h"
+#include "processors/udp_endpoint.h"
+
+namespace task::processors {
+
+// A named feed and the destinations (multicast group and port) carrying it.
+// A feed usually has several, e.g. its A and B channels.
+struct FeedRoute {
+  std::string name{};
+  std::vector<live::Endpoint> destinations{};
+
+  // Parses "name=address:port[,address:port...]", throws std::runtime_error
+  // on malformed routes
+  static FeedRoute parse(std::string_view route);
+};
+
+struct FeedStats {
+  size_t datagrams{0};
+  size_t bytes{0};
+};
+
+// Maps the destination of a datagram to the index of its feed. The table is
+// a sorted array of (address, port) keys, a handful of entries that fit a
+// cache line or two; the last hit is cached since datagrams of one flow come
+// in bursts.
+class FlowTable {
+ public:
+  // Throws std::runtime_error when a destination belongs to two feeds
+  explicit FlowTable(const std::vector<FeedRoute> &routes);
+
+  // Feed index of the flow, NO_FEED when it is not routed
+  [[nodiscard]] size_t find(const transport_layer::FlowKey &flow) noexcept;
+
+  // find(), also accounting the datagram to its feed
+  size_t route(const transport_layer::UDPDatagramView &datagram) noexcept;
+
+  [[nodiscard]] size_t feeds() const noexcept { return names_.size(); }
+
+  [[nodiscard]] const std::string &name(size_t feed) const {
+    return names_[feed];
+  }
+
+  // Distinct destinations of the feed, 2 for A/B channels
+  [[nodiscard]] size_t destinations(size_t feed) const {
+    return destinations_[feed];
+  }
+
+  [[nodiscard]] const FeedStats &stats(size_t feed) const {
+    return stats_[feed];
+  }
+
+  // Datagrams matching no feed
+  [[nodiscard]] const FeedStats &unrouted() const noexcept {
+    return unrouted_;
+  }
+
+  static constexpr size_t NO_FEED = std::numeric_limits<size_t>::max();
+
+ private:
+  static constexpr uint64_t to_key(uint32_t address, uint16_t port) noexcept {
+    return (uint64_t{address} << 16) | port;
+  }
+
+  std::vector<uint64_t> keys_{};
+  std::vector<size_t> key_feeds_{};
+  std::vector<std::string> names_{};
+  std::vector<size_t> destinations_{};
+  std::vector<FeedStats> stats_{};
+  FeedStats unrouted_{};
+
+  uint64_t last_key_{std::numeric_limits<uint64_t>::max()};
+  size_t last_feed_{NO_FEED};
+};
+
+}  // namespace task::processors
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "processors/packet_source.h"
+#include "processors/pcap_types.h"
+
+namespace task::processors {
+
+// A capture still being written, e.g. the rolling captures of an appliance:
+// the records are decoded as the file grows, until stop(). A record cut by
+// the end of the file waits for the rest of it. Once the writer starts the
+// next capture of the directory (the next name in order, see
+// list_captures), the current one is read to its end and the source rolls
+// over to the next one.
+//
+// The directory is watched with inotify, so a write wakes the source at
+// once. Without events (inotify unavailable, network file systems) the
+// source polls, backing off from 1 to 100ms while the files do not grow.
+class FollowSource {
+ public:
+  // Follows the capture at path, or the first capture of the directory at
+  // path. Throws std::runtime_error when it cannot be read or its global
+  // header is not written yet.
+  explicit FollowSource(const std::filesystem::path &path);
+  ~FollowSource();
+
+  FollowSource(const FollowSource &) = delete;
+  FollowSource &operator=(const FollowSource &) = delete;
+
+  [[nodiscard]] uint32_t link_type() const noexcept { return header_.network; }
+
+  void start() {}
+  // Throws std::runtime_error when the next capture has another link type
+  std::optional<PacketBatch> next_batch();
+  [[nodiscard]] bool is_finished() const noexcept {
+    return is_finished_.load(std::memory_order_acquire);
+  }
+  // Safe to call from another thread or from a signal handler
+  void stop() noexcept { is_finished_.store(true, std::memory_order_release); }
+
+  // The capture being followed
+  [[nodiscard]] const std::filesystem::path &path() const noexcept {
+    return path_;
+  }
+
+  // Captures opened so far
+  [[nodiscard]] size_t files() const noexcept { return files_; }
+
+  static constexpr size_t CHUNK_SIZE = 4 * 1024 * 1024;
+
+ private:
+  // Opens the capture at path, false while its global header is not whole
+  bool open(const std::filesystem::path &path);
+  // The first capture of the directory named after the current one
+  [[nodiscard]] std::optional<std::filesystem::path> next_capture() const;
+  // Moves to the next capture once the current one is read to its end
+  void roll_over();
+  // Waits for an event of the directory, at most the polling timeout
+  void wait();
+  size_t read_available(std::byte *data, size_t size);
+
+  std::filesystem::path path_;
+  int file_{-1};
+  int inotify_{-1};
+  pcap::types::pcap_hdr_t header_{};
+  std::array<std::unique_ptr<std::byte[]>, 2> buffers_{};
+  size_t current_{0};
+  // bytes of the current buffer not framed yet
+  std::span<const std::byte> carry_{};
+  std::vector<transport_layer::PacketView> packets_{};
+  std::vector<pcap::types::pcaprec_hdr_s> headers_{};
+  // the capture after the current one, once the writer created it
+  std::optional<std::filesystem::path> next_{};
+  // a capture may have been created since the last scan
+  bool directory_changed_{true};
+  int timeout_ms_{MIN_TIMEOUT_MS};
+  size_t files_{0};
+  std::atomic_bool is_finished_{false};
+
+  static constexpr int MIN_TIMEOUT_MS = 1;
+  static constexpr int MAX_TIMEOUT_MS = 100;
+  static constexpr std::string_view log_prefix_{"[FOLLOW_SOURCE]"};
+};
+
+}  // namespace task::processors
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <bitset>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace task::transport_layer {
+
+// Identifies the fragments of one IPv4 datagram (RFC 791)
+struct FragmentKey {
+  uint32_t source_address{0};
+  uint32_t destination_address{0};
+  uint16_t identification{0};
+  uint8_t protocol{0};
+
+  friend bool operator==(const FragmentKey &, const FragmentKey &) = default;
+};
+
+struct ReassemblerConfig {
+  // datagrams reassembled concurrently, the oldest is evicted when all are
+  // busy
+  size_t slots{32};
+  // incomplete datagrams older than this, in capture time, are dropped
+  std::chrono::nanoseconds timeout{std::chrono::seconds(1)};
+};
+
+// Reassembles fragmented IPv4 datagrams in a fixed table. A slot buffer is
+// allocated the first time the slot is used and reused afterwards, so a
+// steady flow of fragments does not touch the heap. A fragment that finds no
+// buffer (out of memory) is dropped.
+class IPv4Reassembler {
+ public:
+  explicit IPv4Reassembler(ReassemblerConfig config = {});
+
+  // Adds a fragment: its offset in bytes, the more fragments flag and the
+  // bytes following its IP header (bounded by the IP total length). Returns
+  // the whole IP payload once every fragment arrived; the bytes stay valid
+  // until release_completed(). now_ns is the capture time of the fragment,
+  // it may go backwards in merged captures.
+  std::optional<std::span<const std::byte>> add(
+      const FragmentKey &key, size_t offset, bool more_fragments,
+      std::span<const std::byte> fragment, uint64_t now_ns) noexcept;
+
+  // Recycles the slots of the datagrams returned by add()
+  void release_completed() noexcept;
+
+  [[nodiscard]] size_t datagrams_reassembled() const noexcept {
+    return datagrams_reassembled_;
+  }
+
+  // Fragments lost to timeouts, evictions, inconsistent offsets or a
+  // failed buffer allocation
+  [[nodiscard]] size_t fragments_dropped() const noexcept {
+    return fragments_dropped_;
+  }
+
+  // IPv4 total length limit minus the minimal header
+  static constexpr size_t MAX_PAYLOAD_SIZE = 65535 - 20;
+
+ private:
+  // fragment offsets count 8-byte blocks
+  static constexpr size_t BLOCK_SIZE = 8;
+  static constexpr size_t MAX_BLOCKS =
+      (MAX_PAYLOAD_SIZE + BLOCK_SIZE - 1) / BLOCK_SIZE;
+
+  struct Slot {
+    enum class State : uint8_t { Free, Assembling, Completed };
+
+    State state{State::Free};
+    FragmentKey key{};
+    uint64_t first_fragment_ns{0};
+    // known once the last fragment arrived
+    std::optional<size_t> payload_size{};
+    // end of the furthest fragment received
+    size_t received_end{0};
+    size_t received_blocks{0};
+    size_t fragments{0};
+    std::bitset<MAX_BLOCKS> blocks{};
+    std::unique_ptr<std::byte[]> buffer{};
+  };
+
+  // The slot assembling the key, or a new one: a free slot, an expired one
+  // or, when the table is full, the oldest datagram
+  Slot *acquire(const FragmentKey &key, uint64_t now_ns) noexcept;
+
+  // Frees the slot, counting its fragments as dropped
+  void drop(Slot &slot) noexcept;
+
+  // Frees the slot, keeping its buffer for the next datagram
+  static void reset(Slot &slot) noexcept;
+
+  std::vector<Slot> slots_;
+  uint64_t timeout_ns_{0};
+  // slots waiting for release_completed(), the common case skips the scan
+  size_t completed_{0};
+  size_t datagrams_reassembled_{0};
+  size_t fragments_dropped_{0};
+};
+
+}  // namespace task::transport_layer
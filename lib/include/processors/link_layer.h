@@ -0,0 +1,126 @@
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "processors/packet_types.h"
+
+namespace task::transport_layer {
+
+// Link types (pcap_hdr_t::network) of the supported captures
+enum class LinkType : uint32_t {
+  Ethernet = 1,
+  LinuxSLL = 113,   // tcpdump -i any, before libpcap 1.10
+  LinuxSLL2 = 276,  // tcpdump -i any
+};
+
+// Where the network layer of a frame starts
+struct NetworkLayer {
+  enum class Status : uint8_t { IPv4, Other, Truncated };
+
+  Status status{Status::Other};
+  size_t offset{0};
+};
+
+// A link-layer decoder is picked once per capture and inlined in the
+// PacketProcessor loop, so the per-packet path never branches on the type
+template <typename Decoder>
+concept LinkLayerDecoder = requires(PacketView frame) {
+  { Decoder::LINK_TYPE } -> std::convertible_to<LinkType>;
+  { Decoder::network_layer(frame) } noexcept -> std::same_as<NetworkLayer>;
+};
+
+namespace detail {
+inline constexpr uint16_t IPV4_ETHERTYPE = 0x0800;
+inline constexpr size_t ETHERTYPE_SIZE = 2;
+inline constexpr size_t VLAN_TAG_SIZE = 4;
+// 802.1ad QinQ stacks two tags, a few more are tolerated
+inline constexpr size_t MAX_VLAN_TAGS = 4;
+
+constexpr bool is_vlan_tag(uint16_t ethertype) noexcept {
+  // 802.1Q, 802.1ad and the pre-standard QinQ value
+  return ethertype == 0x8100 || ethertype == 0x88A8 || ethertype == 0x9100;
+}
+
+// Resolves the ethertype at type_offset, walking the VLAN tags that follow
+inline NetworkLayer resolve_ethertype(PacketView frame,
+                                      size_t type_offset) noexcept {
+  if (type_offset + ETHERTYPE_SIZE > frame.size()) {
+    return {NetworkLayer::Status::Truncated, 0};
+  }
+  uint16_t ethertype = read_big_endian_u16(frame.data() + type_offset);
+  // plain frames leave the loop at the first check
+  for (size_t tags = 0; is_vlan_tag(ethertype); ++tags) {
+    type_offset += VLAN_TAG_SIZE;
+    if (tags == MAX_VLAN_TAGS || type_offset + ETHERTYPE_SIZE > frame.size()) {
+      return {NetworkLayer::Status::Truncated, 0};
+    }
+    ethertype = read_big_endian_u16(frame.data() + type_offset);
+  }
+  return {ethertype == IPV4_ETHERTYPE ? NetworkLayer::Status::IPv4
+                                      : NetworkLayer::Status::Other,
+          type_offset + ETHERTYPE_SIZE};
+}
+}  // namespace detail
+
+// Ethernet II, with optional 802.1Q/802.1ad tags
+struct EthernetLink {
+  static constexpr LinkType LINK_TYPE = LinkType::Ethernet;
+  static constexpr size_t ETHERTYPE_OFFSET = 12;
+
+  static NetworkLayer network_layer(PacketView frame) noexcept {
+    return detail::resolve_ethertype(frame, ETHERTYPE_OFFSET);
+  }
+};
+
+// Linux cooked capture v1: 16-byte header, protocol in the last 2 bytes
+struct LinuxSLLLink {
+  static constexpr LinkType LINK_TYPE = LinkType::LinuxSLL;
+  static constexpr size_t PROTOCOL_OFFSET = 14;
+
+  static NetworkLayer network_layer(PacketView frame) noexcept {
+    return detail::resolve_ethertype(frame, PROTOCOL_OFFSET);
+  }
+};
+
+// Linux cooked capture v2: 20-byte header, protocol in the first 2 bytes
+struct LinuxSLL2Link {
+  static constexpr LinkType LINK_TYPE = LinkType::LinuxSLL2;
+  static constexpr size_t HEADER_SIZE = 20;
+
+  static NetworkLayer network_layer(PacketView frame) noexcept {
+    if (frame.size() < HEADER_SIZE) {
+      return {NetworkLayer::Status::Truncated, 0};
+    }
+    const uint16_t protocol = read_big_endian_u16(frame.data());
+    if (detail::is_vlan_tag(protocol)) {
+      // the tag follows the cooked header, as in an Ethernet frame
+      return detail::resolve_ethertype(frame, HEADER_SIZE + 2);
+    }
+    return {protocol == detail::IPV4_ETHERTYPE ? NetworkLayer::Status::IPv4
+                                               : NetworkLayer::Status::Other,
+            HEADER_SIZE};
+  }
+};
+
+// Calls visitor(Decoder{}) with the decoder of the link type, returns false
+// when the link type is not supported
+template <typename Visitor>
+bool visit_link_type(uint32_t network, Visitor &&visitor) {
+  switch (static_cast<LinkType>(network)) {
+    case LinkType::Ethernet:
+      visitor(EthernetLink{});
+      return true;
+    case LinkType::LinuxSLL:
+      visitor(LinuxSLLLink{});
+      return true;
+    case LinkType::LinuxSLL2:
+      visitor(LinuxSLL2Link{});
+      return true;
+  }
+  return false;
+}
+
+}  // namespace task::transport_layer
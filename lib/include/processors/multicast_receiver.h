@@ -0,0 +1,96 @@
+#pragma once
+
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+#include <atomic>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "metrics/metrics.h"
+#include "processors/udp_endpoint.h"
+
+namespace task::processors::live {
+
+struct ReceiverConfig {
+  // Groups sharing a port are joined on the same socket
+  std::vector<Endpoint> groups{};
+  std::string interface_address{"0.0.0.0"};
+  size_t batch_size{64};
+  size_t max_datagram_size{9000};
+  int busy_poll_usec{0};           // SO_BUSY_POLL, 0 disables busy polling
+  bool kernel_timestamps{false};   // SO_TIMESTAMPNS
+  int receive_buffer_size{0};      // SO_RCVBUF, 0 keeps the system default
+};
+
+struct Datagram {
+  std::span<const std::byte> payload{};
+  uint64_t timestamp_ns{0};  // kernel receive time, 0 when disabled
+};
+
+// Receives the UDP payloads of live multicast feeds. Every recvmmsg call
+// fills the next batch of a ring of preallocated buffers, so a payload stays
+// valid until the ring wraps around (RING_BATCHES - 1 further batches).
+class MulticastReceiver {
+ public:
+  explicit MulticastReceiver(ReceiverConfig config);
+  ~MulticastReceiver();
+
+  MulticastReceiver(const MulticastReceiver &) = delete;
+  MulticastReceiver &operator=(const MulticastReceiver &) = delete;
+
+  // Drains at most one batch per socket without blocking, returns the number
+  // of datagrams handed to the handler
+  template <std::invocable<const Datagram &> Handler>
+  size_t receive_batch(Handler &&handler);
+
+  // Receives until stop() is called, returns the number of datagrams
+  template <std::invocable<const Datagram &> Handler>
+  size_t run(Handler &&handler);
+
+  // Safe to call from another thread or from a signal handler
+  void stop() noexcept { is_running_.store(false, std::memory_order_release); }
+
+  [[nodiscard]] uint16_t local_port(size_t socket_index) const;
+
+  [[nodiscard]] size_t datagrams_truncated() const noexcept {
+    return datagrams_truncated_;
+  }
+
+ private:
+  void open_socket(uint16_t port, const std::vector<Endpoint> &groups);
+
+  // Blocks until a socket is readable or the poll timeout expires
+  void wait_readable() const;
+
+  // One recvmmsg call into the current ring batch, returns the datagrams read
+  size_t receive(int socket);
+
+  [[nodiscard]] uint64_t timestamp(const mmsghdr &message) const noexcept;
+
+  ReceiverConfig config_;
+  std::vector<int> sockets_{};
+
+  std::vector<std::byte> ring_{};
+  std::vector<std::byte> control_{};
+  std::vector<iovec> iovecs_{};
+  std::vector<mmsghdr> messages_{};
+  size_t ring_batch_{0};
+
+  size_t datagrams_truncated_{0};
+  std::atomic_bool is_running_{false};
+
+  static constexpr size_t RING_BATCHES = 4;
+  static constexpr size_t CONTROL_SIZE = 64;
+  static constexpr int POLL_TIMEOUT_MS = 100;
+  static constexpr std::string_view log_prefix_ = "[MULTICAST_RECEIVER]";
+};
+
+}  // namespace task::processors::live
+
+#include "processors/multicast_receiver.hpp"
@@ -0,0 +1,43 @@
+#include "processors/multicast_receiver.h"
+
+namespace task::processors::live {
+
+template <std::invocable<const Datagram &> Handler>
+size_t MulticastReceiver::receive_batch(Handler &&handler) {
+  size_t total_datagrams{0};
+  for (const int socket : sockets_) {
+    const size_t datagrams = receive(socket);
+    for (size_t index = 0; index < datagrams; ++index) {
+      const auto &message = messages_[index];
+      if (message.msg_hdr.msg_flags & MSG_TRUNC) {
+        ++datagrams_truncated_;
+        continue;
+      }
+      const auto *data =
+          static_cast<const std::byte *>(message.msg_hdr.msg_iov->iov_base);
+      metrics::add(metrics::Counter::BytesRead, message.msg_len);
+      handler(Datagram{{data, message.msg_len}, timestamp(message)});
+    }
+    metrics::add(metrics::Counter::PacketsFramed, datagrams);
+    total_datagrams += datagrams;
+  }
+  return total_datagrams;
+}
+
+template <std::invocable<const Datagram &> Handler>
+size_t MulticastReceiver::run(Handler &&handler) {
+  is_running_.store(true, std::memory_order_release);
+
+  size_t total_datagrams{0};
+  while (is_running_.load(std::memory_order_acquire)) {
+    const size_t datagrams = receive_batch(handler);
+    total_datagrams += datagrams;
+    // busy polling spins on the sockets, otherwise sleep in the kernel
+    if (datagrams == 0 && config_.busy_poll_usec == 0) {
+      wait_readable();
+    }
+  }
+  return total_datagrams;
+}
+
+}  // namespace task::processors::live
@@ -1,28 +1,136 @@
 #pragma once
 
+#include <concepts>
 #include <cstddef>
 #include <iostream>
 #include <span>
+#include <vector>
 
+#include "logging/logger.h"
+#include "processors/ip_reassembler.h"
+#include "metrics/metrics.h"
+#include "processors/checksum.h"
+#include "processors/link_layer.h"
 #include "processors/packet_types.h"
+#include "processors/packet_validation.h"
+#include "processors/pcap_types.h"
 #include "processors/utility.h"
 
 namespace task::processors {
 
-template <std::invocable<std::span<const std::byte>> UDPPacketHandler>
+using transport_layer::PacketView;
+
+// The link layer is a template parameter: it is chosen once per capture
+// (see transport_layer::visit_link_type) and the plain Ethernet path stays a
+// straight-line header read.
+template <std::invocable<std::span<const std::byte>> UDPPacketHandler,
+          transport_layer::LinkLayerDecoder LinkLayer =
+              transport_layer::EthernetLink>
 class PacketProcessor {
 
 public:
-  PacketProcessor(const UDPPacketHandler &on_upd_packet)
-      : udp_packet_handler_(on_upd_packet) {}
+  PacketProcessor(const UDPPacketHandler &on_upd_packet,
+                  transport_layer::ValidationConfig validation = {})
+      : udp_packet_handler_(on_upd_packet), validation_(validation) {}
+
+  // Hands the UDP payload of the packet to the handler. Truncated or
+  // malformed frames are counted and dropped without reading past the packet.
+  // capture_time_ns times out the incomplete fragmented datagrams.
+  void process_packet(std::span<const std::byte> packet,
+                      uint64_t capture_time_ns = 0);
+
+  // Parses the link/IPv4/UDP headers of the whole batch in one pass,
+  // prefetching the frames ahead, and returns the UDP payloads with their
+  // flow keys. The views point into the batch and are overwritten by the
+  // next call. The record headers, when given, clock the fragment timeout:
+  // without them the fragments only leave the table by eviction.
+  std::span<const transport_layer::UDPDatagramView>
+  parse_batch(std::span<const PacketView> packets,
+              std::span<const pcap::types::pcaprec_hdr_s> headers = {},
+              uint32_t magic_number = pcap::types::MAGIC_NANOSECONDS);
+
+  // parse_batch(), then hands every payload to the handler in order
+  void process_batch(std::span<const PacketView> packets,
+                     std::span<const pcap::types::pcaprec_hdr_s> headers = {},
+                     uint32_t magic_number = pcap::types::MAGIC_NANOSECONDS);
 
-  void process_packet(std::span<const std::byte> packet);
+  [[nodiscard]] size_t packets_malformed() const noexcept {
+    return packets_malformed_;
+  }
+
+  [[nodiscard]] const transport_layer::IPv4Reassembler &reassembler()
+      const noexcept {
+    return reassembler_;
+  }
+
+  // Empty unless ValidationConfig::verify_checksums is set
+  [[nodiscard]] const transport_layer::ValidationReport &validation_report()
+      const noexcept {
+    return report_;
+  }
 
 private:
+  // Fragment: held by the reassembler until the datagram is complete
+  // Invalid: rejected by the validation, already accounted in the report
+  enum class ParseResult { UDP, NonUDP, Malformed, Fragment, Invalid };
+
+  // The single bounds check of the L2-L4 stack: reads only the header bytes
+  // it needs, straight from the frame
+  ParseResult parse(PacketView packet, uint64_t capture_time_ns,
+                    transport_layer::UDPDatagramView &datagram) noexcept;
+
+  static ParseResult parse_udp(std::span<const std::byte> ip_payload,
+                               transport_layer::UDPDatagramView &datagram) noexcept;
+
+  // parse_udp(), then the UDP checksum when the validation is on
+  ParseResult parse_transport(std::span<const std::byte> ip_payload,
+                              transport_layer::UDPDatagramView &datagram) noexcept;
+
+  // Feeds a fragment to the reassembler, parses the datagram it completes
+  ParseResult reassemble(std::span<const std::byte> ip_packet,
+                         size_t ip_header_length, uint16_t fragment_field,
+                         uint64_t capture_time_ns,
+                         transport_layer::UDPDatagramView &datagram) noexcept;
+
+  static transport_layer::Verdict
+  verify_ip_header(std::span<const std::byte> ip_packet,
+                   size_t ip_header_length) noexcept;
+
+  // datagram.payload must have been parsed from ip_payload
+  static bool
+  udp_checksum_valid(std::span<const std::byte> ip_payload,
+                     const transport_layer::UDPDatagramView &datagram) noexcept;
+
+  // Records the verdict, returns whether the packet is dropped. udp_header
+  // is empty when the ports are unknown (later fragments).
+  bool reject(transport_layer::Verdict verdict,
+              std::span<const std::byte> udp_header,
+              transport_layer::UDPDatagramView &datagram);
+
+  void skip_non_udp(size_t count);
+
   UDPPacketHandler udp_packet_handler_;
   size_t packet_processed_{1};
-  static constexpr size_t ETH_PACKET_SIZE = 14;
+  size_t packets_malformed_{0};
+  std::vector<transport_layer::UDPDatagramView> datagrams_{};
+  transport_layer::IPv4Reassembler reassembler_{};
+  transport_layer::ValidationConfig validation_{};
+  transport_layer::ValidationReport report_{};
+
+  static constexpr size_t IP_IDENTIFICATION_OFFSET = 4;
+  static constexpr size_t IP_FRAGMENT_FIELD_OFFSET = 6;
+  static constexpr uint16_t MORE_FRAGMENTS_FLAG = 0x2000;
+  static constexpr uint16_t FRAGMENT_OFFSET_MASK = 0x1FFF;
+  static constexpr size_t IP_PROTOCOL_OFFSET = 9;
+  static constexpr size_t IP_SOURCE_OFFSET = 12;
+  static constexpr size_t IP_DESTINATION_OFFSET = 16;
   static constexpr size_t UDP_HEADER_SIZE = 8;
+  static constexpr size_t UDP_LENGTH_OFFSET = 4;
+  static constexpr size_t UDP_CHECKSUM_OFFSET = 6;
+  // a header holding its correct checksum sums to all ones
+  static constexpr uint16_t CHECKSUM_OK = 0xFFFF;
+  // frames are a few hundred bytes: a handful ahead covers the memory latency
+  static constexpr size_t PREFETCH_DISTANCE = 4;
 
   static constexpr std::byte UDP_PROTOCOL = std::byte{0x11};
   static constexpr bool ENABLE_DEBUGGING{false};
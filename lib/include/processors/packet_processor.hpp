@@ -2,45 +2,309 @@
 
 namespace task::processors {
 
-template <std::invocable<std::span<const std::byte>> UDPPacketHandler>
-void PacketProcessor<UDPPacketHandler>::process_packet(
-    std::span<const std::byte> packet) {
-  std::span<const std::byte> ethernet_frame{packet.data(), ETH_PACKET_SIZE};
-  transport_layer::EthernetPacket eth_packet(ethernet_frame);
-  size_t offset = ETH_PACKET_SIZE;
-
-  auto ip_span = packet.subspan(offset, 80);
-  transport_layer::IPPacket ip_packet(ip_span);
+template <std::invocable<std::span<const std::byte>> UDPPacketHandler,
+          transport_layer::LinkLayerDecoder LinkLayer>
+void PacketProcessor<UDPPacketHandler, LinkLayer>::process_packet(
+    std::span<const std::byte> packet, uint64_t capture_time_ns) {
+  reassembler_.release_completed();
+  transport_layer::UDPDatagramView datagram;
+  const auto result = parse(packet, capture_time_ns, datagram);
 
   if constexpr (ENABLE_DEBUGGING) {
-    if (packet_processed_ % 100000 == 0) {
+    if (packet_processed_ % 100000 == 0 && result == ParseResult::UDP) {
       std::cout << "@ packet_number " << std::dec << packet_processed_
                 << std::endl;
       utility::hex_dump(packet.data(), packet.size(), std::cout);
+      transport_layer::IPPacket ip_packet(
+          packet.subspan(LinkLayer::network_layer(packet).offset));
       std::cout << ip_packet.to_string() << std::endl;
+      std::cout << "[PACKET_PROCESSOR] - UDP PACKET SIZE: " << std::dec
+                << datagram.payload.size() + UDP_HEADER_SIZE << std::endl;
     }
   }
 
-  // UDP header start
-  offset += ip_packet.header_length();
+  switch (result) {
+    case ParseResult::Malformed:
+      ++packets_malformed_;
+      metrics::add(metrics::Counter::MalformedPackets);
+      return;
+    case ParseResult::NonUDP:
+      skip_non_udp(1);
+      return;
+    case ParseResult::Fragment:
+    case ParseResult::Invalid:
+      return;
+    case ParseResult::UDP:
+      break;
+  }
+  udp_packet_handler_(datagram.payload);
+  ++packet_processed_;
+}
+
+template <std::invocable<std::span<const std::byte>> UDPPacketHandler,
+          transport_layer::LinkLayerDecoder LinkLayer>
+std::span<const transport_layer::UDPDatagramView>
+PacketProcessor<UDPPacketHandler, LinkLayer>::parse_batch(
+    std::span<const PacketView> packets,
+    std::span<const pcap::types::pcaprec_hdr_s> headers,
+    uint32_t magic_number) {
+  // the datagrams reassembled by the previous batch are no longer referenced
+  reassembler_.release_completed();
+  datagrams_.resize(packets.size());
+
+  size_t parsed{0}, malformed{0}, non_udp{0};
+  for (size_t index = 0; index < packets.size(); ++index) {
+    if (index + PREFETCH_DISTANCE < packets.size()) {
+      // the headers span the first cache line of the frame
+      __builtin_prefetch(packets[index + PREFETCH_DISTANCE].data());
+    }
+    // the datagram slot is always written, the result selects whether it is
+    // kept: no branch on the outcome in the loop body
+    const uint64_t capture_time_ns =
+        headers.empty()
+            ? 0
+            : pcap::types::to_nanoseconds(headers[index], magic_number);
+    const auto result =
+        parse(packets[index], capture_time_ns, datagrams_[parsed]);
+    datagrams_[parsed].packet_index = static_cast<uint32_t>(index);
+    parsed += result == ParseResult::UDP;
+    malformed += result == ParseResult::Malformed;
+    non_udp += result == ParseResult::NonUDP;
+  }
+  datagrams_.resize(parsed);
 
-  // SKIP TCP packets because the tool does not support them
-  if (ip_packet.protocol != UDP_PROTOCOL) {
-    std::cout << "[PACKET_PROCESSOR] - skipping non-UDP packets since the tool "
-                 "does not support such packets"
-              << std::endl;
-    return;
+  packets_malformed_ += malformed;
+  metrics::add(metrics::Counter::MalformedPackets, malformed);
+  if (non_udp > 0) {
+    skip_non_udp(non_udp);
   }
+  return datagrams_;
+}
 
-  if constexpr (ENABLE_DEBUGGING) {
-    if (packet_processed_ % 100000 == 0) {
-      std::cout << "[PACKET_PROCESSOR] - UDP PACKET SIZE: " << std::dec
-                << packet.size() - offset << std::endl;
+template <std::invocable<std::span<const std::byte>> UDPPacketHandler,
+          transport_layer::LinkLayerDecoder LinkLayer>
+void PacketProcessor<UDPPacketHandler, LinkLayer>::process_batch(
+    std::span<const PacketView> packets,
+    std::span<const pcap::types::pcaprec_hdr_s> headers,
+    uint32_t magic_number) {
+  for (const auto &datagram : parse_batch(packets, headers, magic_number)) {
+    udp_packet_handler_(datagram.payload);
+  }
+  packet_processed_ += datagrams_.size();
+}
+
+template <std::invocable<std::span<const std::byte>> UDPPacketHandler,
+          transport_layer::LinkLayerDecoder LinkLayer>
+typename PacketProcessor<UDPPacketHandler, LinkLayer>::ParseResult
+PacketProcessor<UDPPacketHandler, LinkLayer>::parse(
+    PacketView packet, uint64_t capture_time_ns,
+    transport_layer::UDPDatagramView &datagram) noexcept {
+  using Status = transport_layer::NetworkLayer::Status;
+  const auto network_layer = LinkLayer::network_layer(packet);
+  if (network_layer.status == Status::Truncated) {
+    return ParseResult::Malformed;
+  }
+  // A frame must at least carry the link header and a minimal IP header
+  if (network_layer.offset + transport_layer::IPPacket::MIN_SIZE >
+      packet.size()) {
+    return ParseResult::Malformed;
+  }
+
+  // SKIP non IPv4 and TCP packets because the tool does not support them
+  const std::byte *frame = packet.data();
+  const std::byte *ip_header = frame + network_layer.offset;
+  const auto version = std::to_integer<uint8_t>(ip_header[0] >> 4);
+  if (network_layer.status != Status::IPv4 || version != 4 ||
+      ip_header[IP_PROTOCOL_OFFSET] != UDP_PROTOCOL) {
+    return ParseResult::NonUDP;
+  }
+
+  // UDP header start: the single length check for the whole L3/L4 stack
+  const size_t ip_header_length =
+      std::to_integer<size_t>(ip_header[0] & std::byte{0x0F}) * 4;
+  const size_t offset = network_layer.offset + ip_header_length;
+  if (ip_header_length < transport_layer::IPPacket::MIN_SIZE ||
+      offset > packet.size()) {
+    return ParseResult::Malformed;
+  }
+
+  datagram.flow.source_address =
+      transport_layer::read_big_endian_u32(ip_header + IP_SOURCE_OFFSET);
+  datagram.flow.destination_address =
+      transport_layer::read_big_endian_u32(ip_header + IP_DESTINATION_OFFSET);
+
+  const uint16_t fragment_field = transport_layer::read_big_endian_u16(
+      ip_header + IP_FRAGMENT_FIELD_OFFSET);
+  if (validation_.verify_checksums) [[unlikely]] {
+    // every fragment carries its own IP header
+    const auto verdict = verify_ip_header(packet.subspan(network_layer.offset),
+                                          ip_header_length);
+    const bool first_fragment = (fragment_field & FRAGMENT_OFFSET_MASK) == 0;
+    if (verdict != transport_layer::Verdict::Valid &&
+        reject(verdict,
+               first_fragment ? packet.subspan(offset)
+                              : std::span<const std::byte>{},
+               datagram)) {
+      return ParseResult::Invalid;
     }
   }
-  offset += UDP_HEADER_SIZE;
-  auto udp_span = packet.subspan(offset);
-  udp_packet_handler_(udp_span);
-  ++packet_processed_;
+
+  if ((fragment_field & (MORE_FRAGMENTS_FLAG | FRAGMENT_OFFSET_MASK)) != 0)
+      [[unlikely]] {
+    return reassemble(packet.subspan(network_layer.offset), ip_header_length,
+                      fragment_field, capture_time_ns, datagram);
+  }
+
+  // The UDP length bounds the payload: it excludes the Ethernet padding and
+  // detects captures truncated by the snap length
+  return parse_transport(packet.subspan(offset), datagram);
+}
+
+template <std::invocable<std::span<const std::byte>> UDPPacketHandler,
+          transport_layer::LinkLayerDecoder LinkLayer>
+typename PacketProcessor<UDPPacketHandler, LinkLayer>::ParseResult
+PacketProcessor<UDPPacketHandler, LinkLayer>::parse_transport(
+    std::span<const std::byte> ip_payload,
+    transport_layer::UDPDatagramView &datagram) noexcept {
+  const auto result = parse_udp(ip_payload, datagram);
+  if (validation_.verify_checksums && result == ParseResult::UDP &&
+      !udp_checksum_valid(ip_payload, datagram)) [[unlikely]] {
+    if (reject(transport_layer::Verdict::BadUDPChecksum, ip_payload,
+               datagram)) {
+      return ParseResult::Invalid;
+    }
+  }
+  return result;
+}
+
+template <std::invocable<std::span<const std::byte>> UDPPacketHandler,
+          transport_layer::LinkLayerDecoder LinkLayer>
+typename PacketProcessor<UDPPacketHandler, LinkLayer>::ParseResult
+PacketProcessor<UDPPacketHandler, LinkLayer>::parse_udp(
+    std::span<const std::byte> ip_payload,
+    transport_layer::UDPDatagramView &datagram) noexcept {
+  if (ip_payload.size() < UDP_HEADER_SIZE) {
+    return ParseResult::Malformed;
+  }
+  const std::byte *udp_header = ip_payload.data();
+  const size_t udp_length =
+      transport_layer::read_big_endian_u16(udp_header + UDP_LENGTH_OFFSET);
+  if (udp_length < UDP_HEADER_SIZE || udp_length > ip_payload.size()) {
+    return ParseResult::Malformed;
+  }
+
+  datagram.payload =
+      ip_payload.subspan(UDP_HEADER_SIZE, udp_length - UDP_HEADER_SIZE);
+  datagram.flow.source_port = transport_layer::read_big_endian_u16(udp_header);
+  datagram.flow.destination_port =
+      transport_layer::read_big_endian_u16(udp_header + 2);
+  return ParseResult::UDP;
+}
+
+template <std::invocable<std::span<const std::byte>> UDPPacketHandler,
+          transport_layer::LinkLayerDecoder LinkLayer>
+typename PacketProcessor<UDPPacketHandler, LinkLayer>::ParseResult
+PacketProcessor<UDPPacketHandler, LinkLayer>::reassemble(
+    std::span<const std::byte> ip_packet, size_t ip_header_length,
+    uint16_t fragment_field, uint64_t capture_time_ns,
+    transport_layer::UDPDatagramView &datagram) noexcept {
+  // the IP total length, not the frame, bounds a fragment: Ethernet padding
+  // would otherwise end up inside the datagram
+  const size_t total_length =
+      transport_layer::read_big_endian_u16(ip_packet.data() + 2);
+  if (total_length < ip_header_length || total_length > ip_packet.size()) {
+    return ParseResult::Malformed;
+  }
+
+  const transport_layer::FragmentKey key{
+      datagram.flow.source_address, datagram.flow.destination_address,
+      transport_layer::read_big_endian_u16(ip_packet.data() +
+                                           IP_IDENTIFICATION_OFFSET),
+      std::to_integer<uint8_t>(ip_packet[IP_PROTOCOL_OFFSET])};
+  const auto ip_payload = reassembler_.add(
+      key, static_cast<size_t>(fragment_field & FRAGMENT_OFFSET_MASK) * 8,
+      (fragment_field & MORE_FRAGMENTS_FLAG) != 0,
+      ip_packet.subspan(ip_header_length, total_length - ip_header_length),
+      capture_time_ns);
+  if (!ip_payload) {
+    return ParseResult::Fragment;
+  }
+  return parse_transport(*ip_payload, datagram);
+}
+
+template <std::invocable<std::span<const std::byte>> UDPPacketHandler,
+          transport_layer::LinkLayerDecoder LinkLayer>
+transport_layer::Verdict
+PacketProcessor<UDPPacketHandler, LinkLayer>::verify_ip_header(
+    std::span<const std::byte> ip_packet, size_t ip_header_length) noexcept {
+  // the capture holds less than the datagram: cut by the snap length
+  const size_t total_length =
+      transport_layer::read_big_endian_u16(ip_packet.data() + 2);
+  if (total_length > ip_packet.size()) {
+    return transport_layer::Verdict::Truncated;
+  }
+  if (transport_layer::ones_complement_sum(
+          ip_packet.first(ip_header_length)) != CHECKSUM_OK) {
+    return transport_layer::Verdict::BadIPChecksum;
+  }
+  return transport_layer::Verdict::Valid;
+}
+
+template <std::invocable<std::span<const std::byte>> UDPPacketHandler,
+          transport_layer::LinkLayerDecoder LinkLayer>
+bool PacketProcessor<UDPPacketHandler, LinkLayer>::udp_checksum_valid(
+    std::span<const std::byte> ip_payload,
+    const transport_layer::UDPDatagramView &datagram) noexcept {
+  // zero: the sender did not compute it
+  if (transport_layer::read_big_endian_u16(ip_payload.data() +
+                                           UDP_CHECKSUM_OFFSET) == 0) {
+    return true;
+  }
+  const auto udp_length =
+      static_cast<uint16_t>(datagram.payload.size() + UDP_HEADER_SIZE);
+  const auto &flow = datagram.flow;
+  // pseudo header: addresses, protocol and UDP length
+  uint16_t pseudo_header = 0;
+  for (const uint16_t word :
+       {static_cast<uint16_t>(flow.source_address >> 16),
+        static_cast<uint16_t>(flow.source_address),
+        static_cast<uint16_t>(flow.destination_address >> 16),
+        static_cast<uint16_t>(flow.destination_address),
+        std::to_integer<uint16_t>(UDP_PROTOCOL), udp_length}) {
+    pseudo_header = transport_layer::ones_complement_add(pseudo_header, word);
+  }
+  return transport_layer::ones_complement_sum(ip_payload.first(udp_length),
+                                              pseudo_header) == CHECKSUM_OK;
+}
+
+template <std::invocable<std::span<const std::byte>> UDPPacketHandler,
+          transport_layer::LinkLayerDecoder LinkLayer>
+bool PacketProcessor<UDPPacketHandler, LinkLayer>::reject(
+    transport_layer::Verdict verdict, std::span<const std::byte> udp_header,
+    transport_layer::UDPDatagramView &datagram) {
+  if (verdict != transport_layer::Verdict::BadUDPChecksum) {
+    // not parsed yet: the slot may still hold the previous datagram's ports
+    const bool ports_captured = udp_header.size() >= 4;
+    datagram.flow.source_port =
+        ports_captured ? transport_layer::read_big_endian_u16(udp_header.data())
+                       : 0;
+    datagram.flow.destination_port =
+        ports_captured
+            ? transport_layer::read_big_endian_u16(udp_header.data() + 2)
+            : 0;
+  }
+  report_.record(datagram.flow, verdict);
+  return verdict == transport_layer::Verdict::Truncated ||
+         validation_.drop_invalid;
+}
+
+template <std::invocable<std::span<const std::byte>> UDPPacketHandler,
+          transport_layer::LinkLayerDecoder LinkLayer>
+void PacketProcessor<UDPPacketHandler, LinkLayer>::skip_non_udp(size_t count) {
+  metrics::add(metrics::Counter::NonUDPSkipped, count);
+  static logging::RateLimiter non_udp_limiter{std::chrono::seconds(1)};
+  logging::log(non_udp_limiter, logging::Level::Warning,
+               "[PACKET_PROCESSOR] - skipping non-UDP packets since the tool "
+               "does not support such packets");
 }
-}  // namespace task::processors
\ No newline at end of file
+}  // namespace task::processors
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "processors/packet_types.h"
+#include "processors/pcap_types.h"
+
+namespace task::processors {
+
+// Frames handed out by a source, with their record headers (timestamps,
+// original lengths). The views stay valid until the next call to
+// next_batch() of the source.
+struct PacketBatch {
+  std::span<const transport_layer::PacketView> packets{};
+  std::span<const pcap::types::pcaprec_hdr_s> headers{};
+};
+
+// Where the captured frames come from: a file, several merged files, a
+// memory buffer, a decompressor, a socket. Every source feeds the same
+// downstream pipeline (see CaptureProcessor).
+template <typename Source>
+concept PacketSource = requires(Source &source, const Source &const_source) {
+  // `network` field of the PCAP header, known once constructed
+  { const_source.link_type() } -> std::convertible_to<uint32_t>;
+  // starts the read-ahead, if any
+  source.start();
+  // the next batch, std::nullopt when none is ready yet or the source is
+  // finished. Blocks at most for a short timeout.
+  { source.next_batch() } -> std::same_as<std::optional<PacketBatch>>;
+  // true once next_batch() will not return anything anymore
+  { const_source.is_finished() } -> std::convertible_to<bool>;
+  source.stop();
+};
+
+// Logs the global header of a capture. Throws std::runtime_error unless the
+// tool can read it: nanosecond magic number and a supported link type.
+void check_pcap_header(const pcap::types::pcap_hdr_t &header);
+
+// Frames the PCAP records of a memory buffer (without its global header)
+// into views over the buffer, without copying them
+class CaptureFramer {
+ public:
+  explicit CaptureFramer(std::span<const std::byte> records)
+      : records_(records) {}
+
+  // Appends up to max_packets whole records, returns how many. Stops at the
+  // first record running past the end of the buffer.
+  size_t frame(size_t max_packets,
+               std::vector<transport_layer::PacketView> &packets,
+               std::vector<pcap::types::pcaprec_hdr_s> &headers);
+
+  // the bytes after the last framed record
+  [[nodiscard]] std::span<const std::byte> remaining() const noexcept {
+    return records_.subspan(offset_);
+  }
+
+ private:
+  std::span<const std::byte> records_;
+  size_t offset_{0};
+};
+
+}  // namespace task::processors
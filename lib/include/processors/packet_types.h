@@ -31,11 +31,44 @@ struct IPPacket {
   uint8_t version{};
   uint8_t ihl{};  // internet header length
 
+  // The packet must hold at least MIN_SIZE bytes
   explicit IPPacket(std::span<const std::byte> packet);
 
   [[nodiscard]] std::string to_string() const noexcept;
 
-  size_t header_length() { return ihl * 4; }
+  size_t header_length() const noexcept { return ihl * 4; }
+
+  static constexpr size_t MIN_SIZE = 20;
+};
+
+inline uint16_t read_big_endian_u16(const std::byte *data) noexcept {
+  return static_cast<uint16_t>((std::to_integer<uint16_t>(data[0]) << 8) |
+                               std::to_integer<uint16_t>(data[1]));
+}
+
+inline uint32_t read_big_endian_u32(const std::byte *data) noexcept {
+  return (uint32_t{read_big_endian_u16(data)} << 16) |
+         read_big_endian_u16(data + 2);
+}
+
+// A captured link-layer frame, the bytes are owned by the batch holding it
+using PacketView = std::span<const std::byte>;
+
+// UDP flow of a datagram, addresses and ports in host byte order
+struct FlowKey {
+  uint32_t source_address{0};
+  uint32_t destination_address{0};
+  uint16_t source_port{0};
+  uint16_t destination_port{0};
+
+  friend bool operator==(const FlowKey &, const FlowKey &) = default;
+};
+
+struct UDPDatagramView {
+  std::span<const std::byte> payload{};
+  FlowKey flow{};
+  // frame of the batch that carried it, the last fragment when reassembled
+  uint32_t packet_index{0};
 };
 
 }  // namespace task::transport_layer
\ No newline at end of file
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "processors/packet_types.h"
+
+namespace task::transport_layer {
+
+// Optional pass of PacketProcessor, off by default
+struct ValidationConfig {
+  // IPv4 header and UDP checksums (a zero UDP checksum means not computed)
+  bool verify_checksums{false};
+  // drop datagrams with a bad checksum instead of only reporting them;
+  // truncated ones are always dropped
+  bool drop_invalid{false};
+};
+
+enum class Verdict : uint8_t {
+  Valid = 0,
+  Truncated,         // the capture holds less than the IP/UDP lengths
+  BadIPChecksum,
+  BadUDPChecksum,
+};
+
+struct FlowValidation {
+  FlowKey flow{};
+  size_t truncated{0};
+  size_t bad_ip_checksum{0};
+  size_t bad_udp_checksum{0};
+
+  // "10.0.0.1:16001 -> 239.195.1.1:20081 truncated 0, ..."
+  [[nodiscard]] std::string to_string() const;
+};
+
+// Invalid packets by flow. They are rare, so a flat vector searched
+// linearly is enough; flows past MAX_FLOWS are accounted to the last entry.
+class ValidationReport {
+ public:
+  void record(const FlowKey &flow, Verdict verdict);
+
+  [[nodiscard]] std::span<const FlowValidation> flows() const noexcept {
+    return flows_;
+  }
+
+  [[nodiscard]] size_t invalid_packets() const noexcept {
+    return invalid_packets_;
+  }
+
+  static constexpr size_t MAX_FLOWS = 1024;
+
+ private:
+  std::vector<FlowValidation> flows_{};
+  size_t invalid_packets_{0};
+};
+
+}  // namespace task::transport_layer
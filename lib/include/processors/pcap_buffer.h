@@ -1,35 +1,53 @@
+#pragma once
+
 #include <atomic>
+#include <chrono>
 #include <cstddef>
+#include <cstring>
 #include <deque>
 #include <fstream>
 #include <iostream>
-
+#include <memory>
 #include <mutex>
 #include <optional>
 #include <span>
 #include <thread>
 #include <vector>
 
+#include "logging/logger.h"
+#include "metrics/metrics.h"
+#include "processors/packet_types.h"
 #include "processors/pcap_types.h"
 #include "processors/utility.h"
 
 namespace task::processors::mt_buffer {
 
+// One chunk of the file and views over the frames it holds: the packets are
+// not copied, the views stay valid as long as the batch is alive (the batch
+// is move-only).
 struct BufferedPackets {
   size_t start_packet_number{0};
   size_t number_packets{0};
-  std::vector<std::vector<std::byte>> packets{};
+  std::unique_ptr<std::byte[]> data{};
+  std::vector<transport_layer::PacketView> packets{};
+  // record header of each packet, for timestamps and original lengths
+  std::vector<pcap::types::pcaprec_hdr_s> headers{};
 };
 
 class PCAPBuffer {
 public:
+  // max_queued_batches bounds the read-ahead (0: the whole file can be
+  // queued), the producer waits for the consumer beyond it
   explicit PCAPBuffer(std::ifstream &file_handle, size_t file_size,
-                      size_t offset)
+                      size_t offset, size_t max_queued_batches = 0)
       : file_handle_(file_handle), file_size_(file_size),
-        current_offset_(offset) {}
+        current_offset_(offset), max_queued_batches_(max_queued_batches) {}
 
+  // Spawns the producer thread. Corrupted or truncated records stop the
+  // buffering cleanly: the packets read so far stay available in next_batch().
   void start_buffering();
 
+  // Stops the producer after its current chunk, joins it, closes the file
   void stop();
 
   std::optional<BufferedPackets> next_batch();
@@ -40,23 +58,29 @@ public:
 
   void wait_started() { is_started_.wait(false); }
 
+  // True once the producer has pushed its last batch
+  bool is_finished() const noexcept {
+    return is_finished_.load(std::memory_order_acquire);
+  }
+
   std::thread &thread() { return producer_thread_; }
 
 private:
   size_t current_offset_{0};
   size_t file_size_{0};
+  size_t max_queued_batches_{0};
 
   std::ifstream &file_handle_;
 
-  std::vector<std::byte> local_buffer_{BATCH_SIZE, std::byte(0x00)};
-
   std::deque<BufferedPackets> pcap_data_chunks_;
   std::mutex chuncks_mutex;
 
   std::atomic_bool is_started_{false};
+  std::atomic_bool is_finished_{false};
   std::thread producer_thread_{};
 
   static constexpr size_t BATCH_SIZE = 16 * 1024 * 1024;
+  static constexpr size_t PRODUCER_BUFFERING_TIME{500};
   static constexpr bool ENABLE_DEBUGGING{false};
 
   static constexpr std::string_view log_prefix_ = "[PCAP_BUFFER]";
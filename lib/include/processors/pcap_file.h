@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <string_view>
+
+#include "processors/pcap_types.h"
+
+namespace task::processors {
+
+struct ErrorMessage {
+  static constexpr std::string_view ERROR_MSG_ZERO_SIZE =
+      "Cannot analyze a file of size zero";
+  static constexpr std::string_view ERROR_CANNOT_READ_PCAP_HEADER =
+      "Cannot read the PCAP file header, make sure it is a valid PCAP file.";
+};
+
+struct PCAPFile {
+  std::ifstream stream{};
+  size_t file_size{0};
+  pcap::types::pcap_hdr_t header{};
+
+  static constexpr size_t HEADER_SIZE = sizeof(pcap::types::pcap_hdr_t);
+};
+
+// Opens a capture and reads its global header, leaving the stream on the
+// first record. Throws std::runtime_error when the file cannot be used.
+PCAPFile open_pcap_file(const std::filesystem::path &path);
+
+}  // namespace task::processors
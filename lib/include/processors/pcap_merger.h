@@ -0,0 +1,103 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "processors/packet_types.h"
+#include "processors/pcap_buffer.h"
+#include "processors/pcap_file.h"
+#include "processors/pcap_types.h"
+
+namespace task::processors {
+
+// Expands the directories among the inputs to the regular files they hold,
+// sorted by name and skipping hidden ones. Throws std::runtime_error when
+// nothing is left.
+std::vector<std::filesystem::path>
+list_captures(const std::vector<std::string> &inputs);
+
+// Merged packets: the views point into batches owned by the merger and stay
+// valid until the next call to next_batch().
+struct MergedPackets {
+  std::vector<transport_layer::PacketView> packets{};
+  std::vector<pcap::types::pcaprec_hdr_s> headers{};
+};
+
+// K-way merge of several captures by capture timestamp, e.g. the rotated
+// files of a session recorded on several interfaces. A heap holds one cursor
+// per file. A file is opened, with its own bounded read-ahead, once the merge
+// reaches its first packet, and closed once drained: only the files
+// overlapping in time are open together.
+class PCAPMerger {
+ public:
+  // Reads the global header and first record of every file. Throws
+  // std::runtime_error when they do not share the same link type.
+  explicit PCAPMerger(const std::vector<std::filesystem::path> &files);
+
+  PCAPMerger(const PCAPMerger &) = delete;
+  PCAPMerger &operator=(const PCAPMerger &) = delete;
+
+  ~PCAPMerger();
+
+  // Up to MAX_BATCH_PACKETS packets in timestamp order (ties go to the file
+  // listed first), empty once every file is drained. Waits for the
+  // read-ahead of the files when needed.
+  const MergedPackets &next_batch();
+
+  // global header of each file, in the order given
+  [[nodiscard]] std::vector<pcap::types::pcap_hdr_t> headers() const;
+
+  [[nodiscard]] size_t total_size() const noexcept { return total_size_; }
+
+  static constexpr size_t MAX_BATCH_PACKETS = 4096;
+  // batches of PCAPBuffer::BATCH_SIZE queued per open file
+  static constexpr size_t READ_AHEAD_BATCHES = 2;
+
+ private:
+  struct Cursor {
+    std::filesystem::path path{};
+    pcap::types::pcap_hdr_t header{};
+    uint64_t first_timestamp{0};
+    // set while the file is open
+    std::optional<PCAPFile> file{};
+    std::unique_ptr<mt_buffer::PCAPBuffer> buffer{};
+    std::optional<mt_buffer::BufferedPackets> batch{};
+    size_t next{0};
+
+    [[nodiscard]] uint64_t timestamp() const noexcept {
+      return pcap::types::to_nanoseconds(batch->headers[next],
+                                         header.magic_number);
+    }
+  };
+
+  // (timestamp, cursor): the smallest on top
+  using HeapEntry = std::pair<uint64_t, size_t>;
+
+  void open(Cursor &cursor);
+  void close(Cursor &cursor);
+
+  // Moves to the next packet of the file, false once it is drained
+  bool advance(Cursor &cursor);
+
+  void push(HeapEntry entry);
+  HeapEntry pop();
+
+  std::vector<Cursor> cursors_{};
+  std::vector<HeapEntry> heap_{};
+  MergedPackets merged_{};
+  // batches some views of merged_ may still point into
+  std::vector<mt_buffer::BufferedPackets> retired_{};
+  size_t total_size_{0};
+
+  static constexpr size_t CONSUMER_BUFFERING_TIME{500};
+  static constexpr std::string_view log_prefix_{"[PCAP_MERGER]"};
+};
+
+}  // namespace task::processors
@@ -1,61 +1,34 @@
 #pragma once
 
-#include <atomic>
-#include <chrono>
-#include <cstdlib>
-#include <filesystem>
-#include <fstream>
-#include <iostream>
-#include <span>
-#include <string_view>
-#include <thread>
+#include <string>
 #include <vector>
 
-#include "processors/packet_processor.h"
-#include "processors/pcap_buffer.h"
-#include "processors/pcap_types.h"
-#include "processors/utility.h"
+#include "processors/flow_table.h"
+#include "processors/packet_validation.h"
 #include "simba_decoder/simba_decoder.h"
-#include "simba_decoder/simba_types.h"
 
 namespace task::processors {
 
-struct ErrorMessage {
-  static constexpr std::string_view ERROR_MSG_ZERO_SIZE =
-      "Cannot analyze a file of size zero";
-  static constexpr std::string_view ERROR_CANNOT_READ_PCAP_HEADER =
-      "Cannot read the PCAP file header, make sure it is a valid PCAP file.";
-};
-
+// Decodes capture files to the end in the constructor. One file is read
+// ahead by a producer thread (FileSource), or decompressed on the fly when
+// its extension names a compression (CompressedFileSource); several files
+// are merged by timestamp (MergedSource). To drive a source step by step,
+// use CaptureProcessor.
 class PCAPProcessor {
  public:
+  // Without feeds every UDP payload goes to one decoder. With feeds each one
+  // gets its own decoder, and datagrams to other destinations are skipped.
+  // With the validation on, the invalid packets are reported per flow.
   PCAPProcessor(std::string path,
-                const simba::decoder::MessageHandlers &handlers);
-
-  template <std::invocable<std::span<const std::byte>> Handler>
-  [[nodiscard]] size_t process_batch(PacketProcessor<Handler> &processor);
-
-  ~PCAPProcessor();
-
- private:
-  void process_header();
-  void print_end_of_file_info(size_t total_packets_number);
-
-  size_t batch_number_{1};
-  size_t file_size_{0};
-  std::ifstream pcap_file_;
-  std::unique_ptr<mt_buffer::PCAPBuffer> pcap_buffer_{};
-  std::thread consumer_thread_{};
-
-  simba::decoder::SIMBADecoder decoder;
-
-  static constexpr size_t CONSUMER_BUFFERING_TIME{500};
-  static constexpr size_t HEADER_SIZE = sizeof(pcap::types::pcap_hdr_t);
-  static constexpr bool ENABLE_DEBUGGING{false};
-
-  static constexpr std::string_view log_prefix_{"[PCAP_PROCESSOR]"};
-  static constexpr uint32_t PCAP_REFERENCE_MAGIC_NUMBER{0xa1b23c4d};
+                const simba::decoder::MessageHandlers &handlers,
+                const std::vector<FeedRoute> &feeds = {},
+                transport_layer::ValidationConfig validation = {});
+
+  // Several files, or directories of files (see list_captures), are decoded
+  // as one stream merged by capture timestamp.
+  PCAPProcessor(const std::vector<std::string> &inputs,
+                const simba::decoder::MessageHandlers &handlers,
+                const std::vector<FeedRoute> &feeds = {},
+                transport_layer::ValidationConfig validation = {});
 };
 }  // namespace task::processors
-
-#include "processors/pcap_processor.hpp"
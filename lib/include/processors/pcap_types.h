@@ -16,8 +16,21 @@ struct pcap_hdr_t {
 
 struct pcaprec_hdr_s {
   uint32_t ts_sec;          /* timestamp seconds */
-  uint32_t ts_usec;         /* timestamp microseconds */
+  uint32_t ts_usec;         /* timestamp microseconds (nanoseconds) */
   uint32_t captured_length; /* number of octets of packet saved in file */
   uint32_t orig_len;        /* actual length of packet */
 };
+
+static constexpr uint32_t MAGIC_MICROSECONDS = 0xa1b2c3d4;
+static constexpr uint32_t MAGIC_NANOSECONDS = 0xa1b23c4d;
+
+// Capture time in nanoseconds, ts_usec holds nanoseconds in the files
+// written with MAGIC_NANOSECONDS
+constexpr uint64_t to_nanoseconds(const pcaprec_hdr_s &record,
+                                  uint32_t magic_number) {
+  const uint64_t fraction = magic_number == MAGIC_NANOSECONDS
+                                ? record.ts_usec
+                                : uint64_t{record.ts_usec} * 1000;
+  return uint64_t{record.ts_sec} * 1'000'000'000 + fraction;
+}
 } // namespace task::pcap::types
\ No newline at end of file
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <linux/if_packet.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "processors/packet_source.h"
+#include "processors/pcap_types.h"
+
+namespace task::processors::live {
+
+// Captures the Ethernet frames of an interface on an AF_PACKET socket
+// (needs CAP_NET_RAW), so a live feed goes through the same link/IP/UDP
+// pipeline as a capture file: fragment reassembly, feeds, validation. The
+// interface receives all multicast traffic, joined or not. Each recvmmsg
+// call fills one batch; the frames stay valid until the next call.
+class RawSocketSource {
+ public:
+  explicit RawSocketSource(const std::string &interface_name,
+                           size_t batch_size = 64);
+  ~RawSocketSource();
+
+  RawSocketSource(const RawSocketSource &) = delete;
+  RawSocketSource &operator=(const RawSocketSource &) = delete;
+
+  // Ethernet and loopback interfaces: the frames keep their Ethernet header
+  [[nodiscard]] uint32_t link_type() const noexcept { return 1; }
+
+  void start() { is_running_.store(true, std::memory_order_release); }
+  std::optional<PacketBatch> next_batch();
+  [[nodiscard]] bool is_finished() const noexcept {
+    return !is_running_.load(std::memory_order_acquire);
+  }
+  // Safe to call from another thread or from a signal handler
+  void stop() noexcept { is_running_.store(false, std::memory_order_release); }
+
+  [[nodiscard]] size_t frames_truncated() const noexcept {
+    return frames_truncated_;
+  }
+
+  static constexpr size_t MAX_FRAME_SIZE = 9216;
+
+ private:
+  // One non-blocking recvmmsg call, returns the frames read
+  size_t receive();
+
+  int socket_{-1};
+  std::vector<std::byte> frames_{};
+  std::vector<iovec> iovecs_{};
+  std::vector<mmsghdr> messages_{};
+  std::vector<sockaddr_ll> addresses_{};
+  std::vector<transport_layer::PacketView> packets_{};
+  std::vector<pcap::types::pcaprec_hdr_s> headers_{};
+  size_t frames_truncated_{0};
+  std::atomic_bool is_running_{false};
+
+  static constexpr int POLL_TIMEOUT_MS = 100;
+  static constexpr std::string_view log_prefix_ = "[RAW_SOCKET]";
+};
+
+}  // namespace task::processors::live
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+
+namespace task::processors::live {
+
+// Maps capture timestamps onto CLOCK_MONOTONIC deadlines so that a replay
+// preserves the inter-packet gaps of the capture, divided by the speed.
+class ReplayPacer {
+ public:
+  // speed 1 replays at the original pace, 0 as fast as possible
+  explicit ReplayPacer(double speed) : speed_(speed) {}
+
+  // Monotonic deadline of the packet, the first packet anchors the schedule
+  [[nodiscard]] uint64_t deadline(uint64_t capture_ns);
+
+  // Waits for the deadline: sleeps through long gaps, then busy-waits the
+  // last SPIN_THRESHOLD_NS for precision. Returns the lateness in ns.
+  uint64_t wait_until(uint64_t deadline_ns) const;
+
+  [[nodiscard]] bool is_paced() const noexcept { return speed_ > 0; }
+
+  static uint64_t now() noexcept;
+
+ private:
+  double speed_{1.0};
+  std::optional<uint64_t> first_capture_ns_{};
+  uint64_t start_ns_{0};
+
+  static constexpr uint64_t SPIN_THRESHOLD_NS = 200'000;
+};
+
+}  // namespace task::processors::live
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <netinet/in.h>
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace task::processors::live {
+
+struct Endpoint {
+  std::string address{};
+  uint16_t port{0};
+
+  // Parses "address:port", throws std::runtime_error on malformed endpoints
+  static Endpoint parse(std::string_view endpoint);
+
+  [[nodiscard]] sockaddr_in to_sockaddr() const;
+
+  [[nodiscard]] bool is_multicast() const;
+
+  [[nodiscard]] std::string to_string() const {
+    return address + ":" + std::to_string(port);
+  }
+};
+
+// Converts a dotted IPv4 address, throws std::runtime_error when invalid
+in_addr to_in_addr(const std::string &address);
+
+}  // namespace task::processors::live
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+#include <cstddef>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "processors/udp_endpoint.h"
+
+namespace task::processors::live {
+
+struct SenderConfig {
+  // Every payload is sent to each destination
+  std::vector<Endpoint> destinations{};
+  std::string interface_address{};  // IP_MULTICAST_IF, empty for the default
+  int ttl{1};
+  bool multicast_loopback{true};
+  size_t batch_size{64};
+  size_t max_datagram_size{9000};
+};
+
+// Sends UDP payloads in batches with sendmmsg. Payloads are copied into a
+// preallocated batch so callers can reuse their buffers right away.
+class UDPSender {
+ public:
+  explicit UDPSender(SenderConfig config);
+  ~UDPSender();
+
+  UDPSender(const UDPSender &) = delete;
+  UDPSender &operator=(const UDPSender &) = delete;
+
+  // Queues the payload, flushing the batch when it is full
+  void send(std::span<const std::byte> payload);
+
+  // Sends every queued datagram
+  void flush();
+
+  [[nodiscard]] size_t datagrams_sent() const noexcept {
+    return datagrams_sent_;
+  }
+
+  [[nodiscard]] size_t bytes_sent() const noexcept { return bytes_sent_; }
+
+ private:
+  SenderConfig config_;
+  int socket_{-1};
+  std::vector<sockaddr_in> destinations_{};
+
+  std::vector<std::byte> batch_buffer_{};
+  std::vector<iovec> iovecs_{};
+  std::vector<mmsghdr> messages_{};
+  size_t queued_{0};
+
+  size_t datagrams_sent_{0};
+  size_t bytes_sent_{0};
+
+  static constexpr std::string_view log_prefix_ = "[UDP_SENDER]";
+};
+
+}  // namespace task::processors::live
@@ -0,0 +1,314 @@
+#pragma once
+
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace task::simba::types {
+
+// Intermediate of the price * quantity products, any int64 product fits
+__extension__ typedef __int128 int128_t;
+__extension__ typedef unsigned __int128 uint128_t;
+
+namespace detail {
+// Writes a fixed-point magnitude with 5 decimals, backward from the end of
+// the buffer. Without `fixed` the trailing zeros of the fraction, and the
+// point of integers, are trimmed. Returns the first written character.
+template <typename Unsigned>
+constexpr char *write_decimal5(char *end, Unsigned magnitude, bool negative,
+                               bool fixed) {
+  constexpr Unsigned SCALE = 100'000;
+  Unsigned fraction = magnitude % SCALE;
+  Unsigned integer = magnitude / SCALE;
+  int fraction_digits = 5;
+  if (!fixed) {
+    while (fraction_digits > 0 && fraction % 10 == 0) {
+      fraction /= 10;
+      --fraction_digits;
+    }
+  }
+  char *first = end;
+  for (int digit = 0; digit < fraction_digits; ++digit) {
+    *--first = static_cast<char>('0' + static_cast<int>(fraction % 10));
+    fraction /= 10;
+  }
+  if (fraction_digits > 0) {
+    *--first = '.';
+  }
+  do {
+    *--first = static_cast<char>('0' + static_cast<int>(integer % 10));
+    integer /= 10;
+  } while (integer != 0);
+  if (negative) {
+    *--first = '-';
+  }
+  return first;
+}
+
+// Copies [first, end) to the output, nullptr when it does not fit
+constexpr char *copy_chars(const char *first, const char *end, char *out,
+                           char *out_last) {
+  if (out_last - out < end - first) {
+    return nullptr;
+  }
+  while (first != end) {
+    *out++ = *first++;
+  }
+  return out;
+}
+}  // namespace detail
+
+// Decimal5 / Decimal5NULL of the SIMBA schema: an int64 mantissa with the
+// constant exponent -5, the exponent is not on the wire. Arithmetic,
+// comparisons and formatting stay on the integer, so prices are exact and
+// never go through a floating point division.
+#pragma pack(push, 1)
+class Decimal5 {
+ public:
+  static constexpr int8_t EXPONENT = -5;
+  static constexpr int64_t SCALE = 100'000;
+  static constexpr int64_t NULL_MANTISSA = std::numeric_limits<int64_t>::max();
+  // sign, 14 integer digits, point, 5 decimals
+  static constexpr size_t MAX_CHARS = 21;
+
+  constexpr Decimal5() noexcept = default;
+  constexpr explicit Decimal5(int64_t mantissa) noexcept
+      : mantissa_(mantissa) {}
+
+  static constexpr Decimal5 null() noexcept { return Decimal5{NULL_MANTISSA}; }
+
+  // a whole number of currency units, e.g. from_units(7) is 7.00000
+  static constexpr Decimal5 from_units(int64_t units) noexcept {
+    return Decimal5{units * SCALE};
+  }
+
+  // "-123.45", "7", ".5" or "NULL". std::nullopt when malformed, with more
+  // than 5 decimals or out of range.
+  static constexpr std::optional<Decimal5> parse(std::string_view text);
+
+  [[nodiscard]] constexpr int64_t mantissa() const noexcept {
+    return mantissa_;
+  }
+
+  [[nodiscard]] constexpr bool is_null() const noexcept {
+    return mantissa_ == NULL_MANTISSA;
+  }
+
+  // For display and statistics only, NaN when null
+  [[nodiscard]] constexpr double to_double() const noexcept {
+    return is_null() ? std::numeric_limits<double>::quiet_NaN()
+                     : static_cast<double>(mantissa_) / SCALE;
+  }
+
+  // Shortest exact text ("135.66", "98501"), "NULL" when null. Returns the
+  // end of the text, nullptr when the buffer is too small.
+  constexpr char *to_chars(char *first, char *last) const noexcept {
+    return format(first, last, false);
+  }
+
+  // Always 5 decimals ("135.66000")
+  constexpr char *to_chars_fixed(char *first, char *last) const noexcept {
+    return format(first, last, true);
+  }
+
+  [[nodiscard]] std::string to_string() const {
+    char text[MAX_CHARS];
+    return {text, to_chars(text, text + MAX_CHARS)};
+  }
+
+  // The operands of the arithmetic must not be null
+  constexpr Decimal5 &operator+=(Decimal5 other) noexcept {
+    mantissa_ += other.mantissa_;
+    return *this;
+  }
+
+  constexpr Decimal5 &operator-=(Decimal5 other) noexcept {
+    mantissa_ -= other.mantissa_;
+    return *this;
+  }
+
+  friend constexpr Decimal5 operator+(Decimal5 lhs, Decimal5 rhs) noexcept {
+    return lhs += rhs;
+  }
+
+  friend constexpr Decimal5 operator-(Decimal5 lhs, Decimal5 rhs) noexcept {
+    return lhs -= rhs;
+  }
+
+  friend constexpr Decimal5 operator-(Decimal5 value) noexcept {
+    return Decimal5{-value.mantissa_};
+  }
+
+  // e.g. a number of price steps
+  friend constexpr Decimal5 operator*(Decimal5 price, int64_t factor) noexcept {
+    return Decimal5{price.mantissa_ * factor};
+  }
+
+  friend constexpr Decimal5 operator*(int64_t factor, Decimal5 price) noexcept {
+    return price * factor;
+  }
+
+  // null compares greater than any price
+  friend constexpr std::strong_ordering operator<=>(Decimal5 lhs,
+                                                    Decimal5 rhs) noexcept {
+    return lhs.mantissa_ <=> rhs.mantissa_;
+  }
+
+  friend constexpr bool operator==(Decimal5 lhs, Decimal5 rhs) noexcept {
+    return lhs.mantissa_ == rhs.mantissa_;
+  }
+
+  // 5 decimals when the stream is std::fixed, the shortest text otherwise
+  friend std::ostream &operator<<(std::ostream &stream, Decimal5 value) {
+    char text[MAX_CHARS];
+    const bool fixed =
+        (stream.flags() & std::ios::floatfield) == std::ios::fixed;
+    const char *end = value.format(text, text + MAX_CHARS, fixed);
+    return stream << std::string_view(text, static_cast<size_t>(end - text));
+  }
+
+ private:
+  constexpr char *format(char *first, char *last, bool fixed) const noexcept {
+    constexpr std::string_view NULL_TEXT{"NULL"};
+    if (is_null()) {
+      return detail::copy_chars(NULL_TEXT.data(),
+                                NULL_TEXT.data() + NULL_TEXT.size(), first,
+                                last);
+    }
+    char text[MAX_CHARS];
+    // unsigned negation: INT64_MIN has no positive counterpart
+    const auto magnitude = static_cast<uint64_t>(mantissa_);
+    const uint64_t absolute = mantissa_ < 0 ? uint64_t{0} - magnitude
+                                            : magnitude;
+    const char *begin = detail::write_decimal5(text + MAX_CHARS, absolute,
+                                               mantissa_ < 0, fixed);
+    return detail::copy_chars(begin, text + MAX_CHARS, first, last);
+  }
+
+  int64_t mantissa_{0};
+};
+#pragma pack(pop)
+static_assert(sizeof(Decimal5) == 8);
+static_assert(std::is_trivially_copyable_v<Decimal5>);
+
+constexpr std::optional<Decimal5> Decimal5::parse(std::string_view text) {
+  if (text == "NULL") {
+    return null();
+  }
+  size_t position = 0;
+  const bool negative = !text.empty() && text.front() == '-';
+  if (!text.empty() && (text.front() == '-' || text.front() == '+')) {
+    ++position;
+  }
+  // the magnitude of INT64_MIN is one more than the largest mantissa
+  const uint64_t limit = static_cast<uint64_t>(NULL_MANTISSA) + negative;
+  uint64_t magnitude = 0;
+  size_t digits = 0, decimals = 0;
+  bool point = false;
+  for (; position < text.size(); ++position) {
+    const char character = text[position];
+    if (character == '.' && !point) {
+      point = true;
+      continue;
+    }
+    if (character < '0' || character > '9' || (point && decimals == 5)) {
+      return std::nullopt;
+    }
+    const auto digit = static_cast<uint64_t>(character - '0');
+    if (magnitude > (limit - digit) / 10) {
+      return std::nullopt;
+    }
+    magnitude = magnitude * 10 + digit;
+    ++digits;
+    decimals += point;
+  }
+  if (digits == 0) {
+    return std::nullopt;
+  }
+  for (; decimals < 5; ++decimals) {
+    if (magnitude > limit / 10) {
+      return std::nullopt;
+    }
+    magnitude *= 10;
+  }
+  const auto mantissa = negative ? static_cast<int64_t>(uint64_t{0} - magnitude)
+                                 : static_cast<int64_t>(magnitude);
+  // the largest mantissa is the NULL value, not a price
+  if (mantissa == NULL_MANTISSA) {
+    return std::nullopt;
+  }
+  return Decimal5{mantissa};
+}
+
+// price * quantity in units of 1e-5, exact
+constexpr int128_t notional(Decimal5 price, int64_t quantity) noexcept {
+  return int128_t{price.mantissa()} * quantity;
+}
+
+// Writes a notional like a price (see Decimal5::to_chars)
+constexpr char *notional_to_chars(char *first, char *last, int128_t value,
+                                  bool fixed = false) noexcept {
+  // 39 digits, sign and point
+  char text[48];
+  const uint128_t magnitude = value < 0 ? uint128_t{0} - uint128_t(value)
+                                        : uint128_t(value);
+  const char *begin =
+      detail::write_decimal5(text + sizeof(text), magnitude, value < 0, fixed);
+  return detail::copy_chars(begin, text + sizeof(text), first, last);
+}
+
+inline std::string notional_to_string(int128_t value) {
+  char text[48];
+  return {text, notional_to_chars(text, text + sizeof(text), value)};
+}
+
+// Volume-weighted average price of a sequence of trades. The notional is
+// summed exactly in 128 bits, only the final division rounds (to the
+// nearest 1e-5, halves away from zero).
+class VWAPAccumulator {
+ public:
+  // null prices and non-positive quantities carry no volume
+  constexpr void add(Decimal5 price, int64_t quantity) noexcept {
+    if (price.is_null() || quantity <= 0) {
+      return;
+    }
+    notional_ += types::notional(price, quantity);
+    volume_ += quantity;
+  }
+
+  // Decimal5::null() without volume
+  [[nodiscard]] constexpr Decimal5 vwap() const noexcept {
+    if (volume_ == 0) {
+      return Decimal5::null();
+    }
+    int128_t quotient = notional_ / volume_;
+    const int128_t remainder = notional_ % volume_;
+    if (2 * (remainder < 0 ? -remainder : remainder) >= volume_) {
+      quotient += notional_ < 0 ? -1 : 1;
+    }
+    return Decimal5{static_cast<int64_t>(quotient)};
+  }
+
+  [[nodiscard]] constexpr int128_t notional() const noexcept {
+    return notional_;
+  }
+
+  [[nodiscard]] constexpr int64_t volume() const noexcept { return volume_; }
+
+  constexpr void reset() noexcept {
+    notional_ = 0;
+    volume_ = 0;
+  }
+
+ private:
+  int128_t notional_{0};
+  int64_t volume_{0};
+};
+
+}  // namespace task::simba::types
@@ -0,0 +1,179 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <string_view>
+
+namespace task::simba::types {
+
+// Flyweight views of the SBE messages: two pointers over the bytes of the
+// packet, each accessor loads its own field at a constant offset. Handlers
+// get them by value and only pay for the fields they read; to_message()
+// copies the whole block into the packed struct when it must outlive the
+// packet. The views of each template are generated from the schema
+// (simba_messages.h), this is the part they share.
+namespace detail {
+// Unaligned load, a single mov on x86
+template <typename Field>
+[[nodiscard]] inline Field load(const std::byte *data) noexcept {
+  Field field;
+  std::memcpy(&field, data, sizeof(Field));
+  return field;
+}
+}  // namespace detail
+
+// A root block or a repeating group entry. Fields past a shorter block (an
+// older schema version) read as absent, the null value of optional fields,
+// the trailing bytes of a larger one (a newer version) are ignored.
+class BlockView {
+ public:
+  constexpr BlockView(const std::byte *block, size_t block_length) noexcept
+      : block_(block), end_(block + block_length) {}
+
+  [[nodiscard]] constexpr const std::byte *data() const noexcept {
+    return block_;
+  }
+
+  [[nodiscard]] constexpr size_t block_length() const noexcept {
+    return static_cast<size_t>(end_ - block_);
+  }
+
+ protected:
+  template <typename Field, size_t Offset>
+  [[nodiscard]] Field field(Field absent = Field{}) const noexcept {
+    if (block_length() < Offset + sizeof(Field)) [[unlikely]] {
+      return absent;
+    }
+    return detail::load<Field>(block_ + Offset);
+  }
+
+  // A fixed-length char array, up to its first NUL
+  template <size_t Offset, size_t Length>
+  [[nodiscard]] std::string_view chars() const noexcept {
+    if (block_length() < Offset + Length) [[unlikely]] {
+      return {};
+    }
+    const auto *first = reinterpret_cast<const char *>(block_ + Offset);
+    const void *nul = std::memchr(first, '\0', Length);
+    return {first, nul ? static_cast<const char *>(nul) - first : Length};
+  }
+
+  // The known fields of the block, the others value-initialized: null when
+  // optional
+  template <typename Message>
+  [[nodiscard]] Message copy() const noexcept {
+    Message message{};
+    std::memcpy(&message, block_, std::min(block_length(), sizeof(Message)));
+    return message;
+  }
+
+ private:
+  const std::byte *block_;
+  const std::byte *end_;
+};
+
+// A repeating group: its Dimension header (block_length, num_in_group) then
+// the entries, each block_length bytes, iterated in place
+template <typename Entry, typename Dimension>
+class GroupView {
+ public:
+  class iterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = Entry;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = Entry;
+
+    iterator() noexcept = default;
+    iterator(const std::byte *entry, size_t block_size) noexcept
+        : entry_(entry), block_size_(block_size) {}
+
+    Entry operator*() const noexcept { return Entry{entry_, block_size_}; }
+
+    iterator &operator++() noexcept {
+      entry_ += block_size_;
+      return *this;
+    }
+
+    iterator operator++(int) noexcept {
+      auto previous = *this;
+      ++*this;
+      return previous;
+    }
+
+    friend bool operator==(const iterator &lhs,
+                           const iterator &rhs) noexcept {
+      return lhs.entry_ == rhs.entry_;
+    }
+
+   private:
+    const std::byte *entry_{nullptr};
+    size_t block_size_{0};
+  };
+
+  explicit GroupView(const std::byte *group) noexcept
+      : first_(group + sizeof(Dimension)),
+        dimension_(detail::load<Dimension>(group)) {}
+
+  [[nodiscard]] size_t size() const noexcept {
+    return dimension_.num_in_group;
+  }
+
+  [[nodiscard]] bool empty() const noexcept { return size() == 0; }
+
+  [[nodiscard]] size_t block_size() const noexcept {
+    return dimension_.block_length;
+  }
+
+  // Bytes of the entries, without the dimension header
+  [[nodiscard]] size_t size_bytes() const noexcept {
+    return block_size() * size();
+  }
+
+  // First byte past the group, where the next one starts
+  [[nodiscard]] const std::byte *limit() const noexcept {
+    return first_ + size_bytes();
+  }
+
+  Entry operator[](size_t index) const noexcept {
+    return Entry{first_ + index * block_size(), block_size()};
+  }
+
+  [[nodiscard]] iterator begin() const noexcept {
+    return {first_, block_size()};
+  }
+
+  [[nodiscard]] iterator end() const noexcept {
+    return {limit(), block_size()};
+  }
+
+ private:
+  const std::byte *first_;
+  Dimension dimension_;
+};
+
+// Moves offset past the group of the message starting there, false if its
+// header or its entries overrun size, or if its entries are shorter than
+// min_block_length
+template <typename Dimension>
+[[nodiscard]] inline bool skip_group(const std::byte *message, size_t size,
+                                     size_t &offset,
+                                     size_t min_block_length = 0) noexcept {
+  if (offset + sizeof(Dimension) > size) {
+    return false;
+  }
+  const auto dimension = detail::load<Dimension>(message + offset);
+  if (dimension.num_in_group > 0 &&
+      dimension.block_length < min_block_length) {
+    return false;
+  }
+  offset += sizeof(Dimension) +
+            size_t{dimension.block_length} * dimension.num_in_group;
+  return offset <= size;
+}
+
+}  // namespace task::simba::types
@@ -2,30 +2,46 @@
 
 #include <cassert>
 #include <cstdio>
+#include <cstring>
+#include <functional>
 #include <iostream>
+#include <optional>
 #include <span>
 #include <type_traits>
-#include <unordered_map>
 
+#include "metrics/metrics.h"
 #include "simba_decoder/simba_types.h"
 
 namespace task::simba::decoder {
 
-struct MessageHandlers {
-  std::function<void(const types::OrderExecution &)> order_execution_handler;
-  std::function<void(const types::OrderUpdate &)> order_update_handler;
-  std::function<void(const types::OrderBookSnapshot &)>
-      order_book_snapshot_handler;
-};
+// Generated with the messages: one handler per template of the schema
+using MessageHandlers = types::MessageHandlers;
 
 class SIMBADecoder {
  public:
-  SIMBADecoder() = delete;
+  // Packets a channel of a feed may lag behind the other one
+  static constexpr uint32_t MAX_CHANNEL_LAG{10'000};
 
-  explicit SIMBADecoder(const MessageHandlers &message_handler)
-      : message_handlers_(message_handler) {}
+  SIMBADecoder() = delete;
 
-  void decode_message(std::span<const std::byte> udp_payload);
+  // With arbitrate, for a feed received on its A and B channels: an
+  // incremental packet whose sequence number is not above the last one is
+  // the copy of a packet already decoded from the other channel, and is
+  // skipped. The sequence restarts at the NewSeqNo of a SequenceReset, or
+  // at a packet more than MAX_CHANNEL_LAG behind the last one.
+  explicit SIMBADecoder(const MessageHandlers &message_handler,
+                        bool arbitrate = false)
+      : message_handlers_(message_handler), arbitrate_(arbitrate) {}
+
+  // Validates the packet once against the UDP payload length and the
+  // MarketDataPacketHeader::message_size, then decodes it without further
+  // bounds checks. Returns false (and decodes nothing) for malformed packets,
+  // for schemas other than the generated one and for the copies skipped by
+  // the arbitration. The first SBE header
+  // selects the decoder of its schema version, once per packet; decoding
+  // stops at the first template unknown to that version, or at a message of
+  // another schema version (counted as an unsupported packet).
+  bool decode_message(std::span<const std::byte> udp_payload);
 
   [[nodiscard]] const types::MarketDataPacketHeader &market_header()
       const noexcept {
@@ -36,32 +52,77 @@ class SIMBADecoder {
     return sbe_header_;
   }
 
+  // Header of the packet being decoded, std::nullopt for snapshot packets.
+  // Its transact_time is the exchange clock of the messages.
+  [[nodiscard]] const std::optional<types::IncrementalPacketHeader> &
+  incremental_header() const noexcept {
+    return incremental_header_;
+  }
+
+  [[nodiscard]] size_t malformed_packets() const noexcept {
+    return malformed_packets_;
+  }
+
+  // Sequence number of the last valid incremental packet, 0 before the first
+  // one
+  [[nodiscard]] uint32_t last_sequence_number() const noexcept {
+    return last_sequence_number_;
+  }
+
+  // Seeds the last sequence number, e.g. when resuming from a checkpoint:
+  // with arbitration the packets up to it are skipped
+  void set_last_sequence_number(uint32_t sequence_number) noexcept {
+    last_sequence_number_ = sequence_number;
+  }
+
+  // Incremental packets skipped by the arbitration
+  [[nodiscard]] size_t duplicate_packets() const noexcept {
+    return duplicate_packets_;
+  }
+
+  // Packets of another schema id, or cut short by a message of another
+  // schema id or version
+  [[nodiscard]] size_t unsupported_packets() const noexcept {
+    return unsupported_packets_;
+  }
+
  private:
-  [[nodiscard]] size_t handle_order_update(
-      const types::SBEHeader &sbe_header,
+  // Reads the MarketDataPacketHeader and returns the offset of the first SBE
+  // header, std::nullopt if the packet headers overrun the payload
+  [[nodiscard]] std::optional<size_t> packet_headers(
       std::span<const std::byte> udp_payload);
 
-  [[nodiscard]] size_t handle_order_execution(
-      const types::SBEHeader &sbe_header,
-      std::span<const std::byte> udp_payload);
+  // The decoder of the layout Version of the schema, from the first SBE
+  // header at offset
+  template <uint16_t Version>
+  bool decode_messages(std::span<const std::byte> udp_payload, size_t offset);
 
-  void handle_order_book_snapshot(std::span<const std::byte> udp_payload);
-  types::Messages from_id_to_type(uint16_t template_id) {
-    return mapping_[template_id];
-  }
+  // Walks the SBE headers from offset and checks that every message, and
+  // every repeating group, lies within message_size and holds the fields of
+  // Version. Returns the number of validated bytes, or std::nullopt if the
+  // packet is malformed.
+  template <uint16_t Version>
+  [[nodiscard]] std::optional<size_t> validate(
+      std::span<const std::byte> udp_payload, size_t offset) const;
+
+  // Whether the packet is an incremental packet already decoded
+  [[nodiscard]] bool is_duplicate(
+      std::span<const std::byte> udp_payload) const noexcept;
 
   size_t current_offset_{0};
+  size_t malformed_packets_{0};
+  size_t unsupported_packets_{0};
+  size_t duplicate_packets_{0};
+  uint32_t last_sequence_number_{0};
 
   simba::types::MarketDataPacketHeader market_update_header_{};
-  std::optional<simba::types::IncrementalPacketHeader> incremental_header{};
+  std::optional<simba::types::IncrementalPacketHeader> incremental_header_{};
   types::SBEHeader sbe_header_{};
 
-  std::unordered_map<uint64_t, types::Messages> mapping_ = {
-      {15, types::Messages::OrderUpdateType},
-      {16, types::Messages::OrderExecutionType},
-      {17, types::Messages::OrderBookSnapshotType}};
   MessageHandlers message_handlers_{};
+  bool arbitrate_{false};
 
+  static constexpr uint16_t INCREMENTAL_PACKET_FLAG{0x8};
   static constexpr bool ENABLE_DEBUGGING{false};
 };
-}  // namespace task::simba::decoder
\ No newline at end of file
+}  // namespace task::simba::decoder
@@ -0,0 +1,146 @@
+#include "processors/ip_reassembler.h"
+
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+#include "metrics/metrics.h"
+
+namespace task::transport_layer {
+
+IPv4Reassembler::IPv4Reassembler(ReassemblerConfig config)
+    : slots_(std::max<size_t>(config.slots, 1)),
+      timeout_ns_(static_cast<uint64_t>(config.timeout.count())) {}
+
+std::optional<std::span<const std::byte>> IPv4Reassembler::add(
+    const FragmentKey &key, size_t offset, bool more_fragments,
+    std::span<const std::byte> fragment, uint64_t now_ns) noexcept {
+  const size_t end = offset + fragment.size();
+  // every fragment but the last carries whole blocks
+  if (end > MAX_PAYLOAD_SIZE ||
+      (more_fragments && fragment.size() % BLOCK_SIZE != 0)) {
+    ++fragments_dropped_;
+    metrics::add(metrics::Counter::FragmentsDropped);
+    return std::nullopt;
+  }
+
+  Slot *slot = acquire(key, now_ns);
+  if (slot == nullptr) {
+    ++fragments_dropped_;
+    metrics::add(metrics::Counter::FragmentsDropped);
+    return std::nullopt;
+  }
+
+  // a second last fragment, or data past it (received before or after it),
+  // cannot be reassembled
+  if ((slot->payload_size &&
+       (end > *slot->payload_size ||
+        (!more_fragments && end != *slot->payload_size))) ||
+      (!more_fragments && slot->received_end > end)) {
+    drop(*slot);
+    ++fragments_dropped_;
+    metrics::add(metrics::Counter::FragmentsDropped);
+    return std::nullopt;
+  }
+  if (!more_fragments) {
+    slot->payload_size = end;
+  }
+
+  std::memcpy(slot->buffer.get() + offset, fragment.data(), fragment.size());
+  ++slot->fragments;
+  slot->received_end = std::max(slot->received_end, end);
+  // overlapping fragments only count their new blocks
+  const size_t last_block = (end + BLOCK_SIZE - 1) / BLOCK_SIZE;
+  for (size_t block = offset / BLOCK_SIZE; block < last_block; ++block) {
+    if (!slot->blocks.test(block)) {
+      slot->blocks.set(block);
+      ++slot->received_blocks;
+    }
+  }
+
+  // every block before the end of the last fragment, and none past it
+  if (!slot->payload_size ||
+      slot->received_blocks <
+          (*slot->payload_size + BLOCK_SIZE - 1) / BLOCK_SIZE) {
+    return std::nullopt;
+  }
+  slot->state = Slot::State::Completed;
+  ++completed_;
+  ++datagrams_reassembled_;
+  metrics::add(metrics::Counter::DatagramsReassembled);
+  return std::span<const std::byte>{slot->buffer.get(), *slot->payload_size};
+}
+
+void IPv4Reassembler::release_completed() noexcept {
+  if (completed_ == 0) {
+    return;
+  }
+  completed_ = 0;
+  for (auto &slot : slots_) {
+    if (slot.state == Slot::State::Completed) {
+      reset(slot);
+    }
+  }
+}
+
+IPv4Reassembler::Slot *IPv4Reassembler::acquire(const FragmentKey &key,
+                                                uint64_t now_ns) noexcept {
+  Slot *free_slot{nullptr};
+  Slot *oldest_slot{nullptr};
+  for (auto &slot : slots_) {
+    if (slot.state == Slot::State::Assembling) {
+      // time going backwards expires nothing
+      if (now_ns > slot.first_fragment_ns &&
+          now_ns - slot.first_fragment_ns > timeout_ns_) {
+        drop(slot);
+      } else if (slot.key == key) {
+        return &slot;
+      } else if (oldest_slot == nullptr ||
+                 slot.first_fragment_ns < oldest_slot->first_fragment_ns) {
+        oldest_slot = &slot;
+      }
+    }
+    if (slot.state == Slot::State::Free && free_slot == nullptr) {
+      free_slot = &slot;
+    }
+  }
+
+  Slot *slot = free_slot;
+  if (slot == nullptr) {
+    // completed datagrams are still referenced until release_completed()
+    if (oldest_slot == nullptr) {
+      return nullptr;
+    }
+    drop(*oldest_slot);
+    slot = oldest_slot;
+  }
+
+  if (!slot->buffer) {
+    // out of memory: the fragment is dropped, the slot stays free
+    slot->buffer.reset(new (std::nothrow) std::byte[MAX_PAYLOAD_SIZE]);
+    if (!slot->buffer) {
+      return nullptr;
+    }
+  }
+  slot->state = Slot::State::Assembling;
+  slot->key = key;
+  slot->first_fragment_ns = now_ns;
+  return slot;
+}
+
+void IPv4Reassembler::drop(Slot &slot) noexcept {
+  fragments_dropped_ += slot.fragments;
+  metrics::add(metrics::Counter::FragmentsDropped, slot.fragments);
+  reset(slot);
+}
+
+void IPv4Reassembler::reset(Slot &slot) noexcept {
+  slot.state = Slot::State::Free;
+  slot.payload_size.reset();
+  slot.received_end = 0;
+  slot.received_blocks = 0;
+  slot.fragments = 0;
+  slot.blocks.reset();
+}
+
+}  // namespace task::transport_layer
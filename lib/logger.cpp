@@ -0,0 +1,273 @@
+#include "logging/logger.h"
+
+#include <time.h>
+
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace task::logging {
+
+namespace {
+
+constexpr std::array<std::string_view, 4> LEVEL_NAMES = {"DEBUG", "INFO",
+                                                         "WARNING", "ERROR"};
+
+// Bounded multi-producer/single-consumer queue of records: every slot carries
+// a sequence number telling whether it is free or holds a published record
+class RecordQueue {
+ public:
+  bool push(const LogRecord &record) noexcept {
+    uint64_t position = tail_.load(std::memory_order_relaxed);
+    Slot *slot{nullptr};
+    while (true) {
+      slot = &slots_[position & MASK];
+      const uint64_t sequence = slot->sequence.load(std::memory_order_acquire);
+      const auto difference =
+          static_cast<int64_t>(sequence) - static_cast<int64_t>(position);
+      if (difference == 0) {
+        if (tail_.compare_exchange_weak(position, position + 1,
+                                        std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (difference < 0) {
+        return false;  // full
+      } else {
+        position = tail_.load(std::memory_order_relaxed);
+      }
+    }
+    slot->record = record;
+    slot->sequence.store(position + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool pop(LogRecord &record) noexcept {
+    Slot &slot = slots_[head_ & MASK];
+    if (slot.sequence.load(std::memory_order_acquire) != head_ + 1) {
+      return false;
+    }
+    record = slot.record;
+    slot.sequence.store(head_ + CAPACITY, std::memory_order_release);
+    ++head_;
+    written_.store(head_, std::memory_order_release);
+    return true;
+  }
+
+  uint64_t submitted() const noexcept {
+    return tail_.load(std::memory_order_acquire);
+  }
+
+  uint64_t written() const noexcept {
+    return written_.load(std::memory_order_acquire);
+  }
+
+ private:
+  static constexpr size_t CAPACITY = 16384;
+  static constexpr size_t MASK = CAPACITY - 1;
+
+  struct Slot {
+    std::atomic<uint64_t> sequence{0};
+    LogRecord record{};
+  };
+
+  std::unique_ptr<Slot[]> slots_ = [] {
+    auto slots = std::make_unique<Slot[]>(CAPACITY);
+    for (size_t index = 0; index < CAPACITY; ++index) {
+      slots[index].sequence.store(index, std::memory_order_relaxed);
+    }
+    return slots;
+  }();
+
+  alignas(64) std::atomic<uint64_t> tail_{0};
+  alignas(64) uint64_t head_{0};
+  std::atomic<uint64_t> written_{0};
+};
+
+// Owns the queue and the drain thread formatting and writing the records
+class Logger {
+ public:
+  Logger() {
+    drain_thread_ = std::thread([this]() {
+      while (is_running_.load(std::memory_order_acquire)) {
+        if (!drain()) {
+          std::this_thread::sleep_for(IDLE_SLEEP);
+        }
+      }
+      drain();
+    });
+  }
+
+  ~Logger() {
+    is_running_.store(false, std::memory_order_release);
+    drain_thread_.join();
+  }
+
+  void submit(const LogRecord &record) noexcept {
+    if (!queue_.push(record)) {
+      dropped_.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  void flush() {
+    const uint64_t submitted = queue_.submitted();
+    while (queue_.written() < submitted) {
+      std::this_thread::sleep_for(IDLE_SLEEP);
+    }
+  }
+
+  size_t dropped() const noexcept {
+    return dropped_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  // Returns false when there was nothing to write
+  bool drain() {
+    LogRecord record;
+    bool has_written{false};
+    while (queue_.pop(record)) {
+      std::string line = format_record(record);
+      line.push_back('\n');
+      std::FILE *stream = record.level >= Level::Warning ? stderr : stdout;
+      std::fwrite(line.data(), 1, line.size(), stream);
+      has_written = true;
+    }
+    if (has_written) {
+      std::fflush(stdout);
+      std::fflush(stderr);
+    }
+    return has_written;
+  }
+
+  RecordQueue queue_{};
+  std::atomic<size_t> dropped_{0};
+  std::atomic_bool is_running_{true};
+  std::thread drain_thread_{};
+
+  static constexpr auto IDLE_SLEEP = std::chrono::microseconds(500);
+};
+
+Logger &logger() {
+  static Logger instance;
+  return instance;
+}
+
+std::atomic<Level> minimum_level{Level::Info};
+
+void append_argument(std::string &line, const LogRecord &record,
+                     const Argument &argument, bool hexadecimal) {
+  char buffer[32];
+  int length{0};
+  switch (argument.type) {
+    case Argument::Type::Int:
+      length = std::snprintf(buffer, sizeof(buffer),
+                             hexadecimal ? "%" PRIx64 : "%" PRId64,
+                             argument.int_value);
+      break;
+    case Argument::Type::UInt:
+      length = std::snprintf(buffer, sizeof(buffer),
+                             hexadecimal ? "%" PRIx64 : "%" PRIu64,
+                             argument.uint_value);
+      break;
+    case Argument::Type::Double:
+      length = std::snprintf(buffer, sizeof(buffer), "%g",
+                             argument.double_value);
+      break;
+    case Argument::Type::String:
+      line.append(record.text.data() + argument.string.offset,
+                  argument.string.length);
+      return;
+  }
+  line.append(buffer, static_cast<size_t>(length));
+}
+
+}  // namespace
+
+void set_level(Level level) noexcept {
+  minimum_level.store(level, std::memory_order_relaxed);
+}
+
+Level level() noexcept { return minimum_level.load(std::memory_order_relaxed); }
+
+bool RateLimiter::allow(uint64_t now_ns, uint64_t &suppressed) noexcept {
+  uint64_t last_ns = last_ns_.load(std::memory_order_relaxed);
+  if ((last_ns == 0 || now_ns - last_ns >= interval_ns_) &&
+      last_ns_.compare_exchange_strong(last_ns, now_ns,
+                                       std::memory_order_relaxed)) {
+    suppressed = suppressed_.exchange(0, std::memory_order_relaxed);
+    return true;
+  }
+  suppressed_.fetch_add(1, std::memory_order_relaxed);
+  return false;
+}
+
+void LogRecord::add(std::string_view value) noexcept {
+  if (argument_count == MAX_ARGUMENTS) {
+    return;
+  }
+  const size_t length = std::min(value.size(), TEXT_SIZE - text_size);
+  std::memcpy(text.data() + text_size, value.data(), length);
+
+  auto &argument = arguments[argument_count++];
+  argument.type = Argument::Type::String;
+  argument.string = {text_size, static_cast<uint16_t>(length)};
+  text_size += static_cast<uint16_t>(length);
+}
+
+std::string format_record(const LogRecord &record) {
+  std::string line;
+  line.reserve(128);
+
+  const time_t seconds =
+      static_cast<time_t>(record.timestamp_ns / 1'000'000'000);
+  tm utc{};
+  ::gmtime_r(&seconds, &utc);
+  char time_buffer[48];
+  const size_t time_length = std::strftime(time_buffer, sizeof(time_buffer),
+                                           "%Y-%m-%d %H:%M:%S", &utc);
+  line.append(time_buffer, time_length);
+  const int micros_length =
+      std::snprintf(time_buffer, sizeof(time_buffer), ".%06" PRIu64 " ",
+                    (record.timestamp_ns % 1'000'000'000) / 1000);
+  line.append(time_buffer, static_cast<size_t>(micros_length));
+  line.append(LEVEL_NAMES[static_cast<size_t>(record.level)]);
+  line.push_back(' ');
+
+  size_t next_argument{0};
+  for (const char *cursor = record.format; *cursor != '\0'; ++cursor) {
+    const bool is_placeholder = std::strncmp(cursor, "{}", 2) == 0;
+    const bool is_hex_placeholder = std::strncmp(cursor, "{:x}", 4) == 0;
+    if ((is_placeholder || is_hex_placeholder) &&
+        next_argument < record.argument_count) {
+      append_argument(line, record, record.arguments[next_argument++],
+                      is_hex_placeholder);
+      cursor += is_placeholder ? 1 : 3;
+    } else {
+      line.push_back(*cursor);
+    }
+  }
+
+  if (record.suppressed > 0) {
+    line.append(" (" + std::to_string(record.suppressed) +
+                " similar messages suppressed)");
+  }
+  return line;
+}
+
+void submit(const LogRecord &record) noexcept { logger().submit(record); }
+
+uint64_t now_ns() noexcept {
+  timespec time{};
+  ::clock_gettime(CLOCK_REALTIME, &time);
+  return static_cast<uint64_t>(time.tv_sec) * 1'000'000'000 +
+         static_cast<uint64_t>(time.tv_nsec);
+}
+
+void flush() { logger().flush(); }
+
+size_t dropped_records() noexcept { return logger().dropped(); }
+
+}  // namespace task::logging
@@ -0,0 +1,518 @@
+#include "market_data/market_by_price.h"
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+#include "market_data/saved_state.h"
+
+namespace task::market_data {
+
+namespace {
+// a - b, false when it does not fit (the prices are too far apart to index)
+bool difference(int64_t a, int64_t b, int64_t &result) noexcept {
+  return !__builtin_sub_overflow(a, b, &result) &&
+         result != std::numeric_limits<int64_t>::min();
+}
+
+void append_level(std::vector<std::byte> &state, const PriceLevel &level) {
+  append_state(state, level.price.mantissa());
+  append_state(state, level.volume);
+  append_state(state, level.orders);
+}
+
+PriceLevel take_level(std::span<const std::byte> &state) {
+  PriceLevel level;
+  level.price = Decimal5{take_state<int64_t>(state)};
+  level.volume = take_state<int64_t>(state);
+  level.orders = take_state<uint32_t>(state);
+  return level;
+}
+
+bool tradable(MDEntryType side, Decimal5 price) noexcept {
+  // the negated bid prices must fit
+  return (side == MDEntryType::Bid || side == MDEntryType::Offer) &&
+         !price.is_null() &&
+         price.mantissa() != std::numeric_limits<int64_t>::min();
+}
+}  // namespace
+
+std::string DepthUpdate::to_csv_string() const {
+  std::stringstream sstream;
+  sstream << security_id;
+  sstream << ", " << time_ns;
+  sstream << ", " << simba::types::entry_side_to_string(side);
+  sstream << ", " << static_cast<int>(depth);
+
+  sstream << ", " << price;
+  sstream << ", " << volume;
+  sstream << ", " << orders;
+  return sstream.str();
+}
+
+PriceLadder::PriceLadder(bool bids, size_t window)
+    : bids_(bids), dense_(window), best_(window) {
+  if (window == 0) {
+    throw std::runtime_error("The price window must not be empty");
+  }
+}
+
+size_t PriceLadder::top(std::span<PriceLevel> levels) const {
+  // the window, then the levels out of it, merged by price
+  size_t count = 0;
+  size_t index = best_;
+  auto sparse = sparse_.begin();
+  while (count < levels.size()) {
+    while (index < dense_.size() && dense_[index].empty()) {
+      ++index;
+    }
+    const bool in_window = index < dense_.size();
+    if (!in_window && sparse == sparse_.end()) {
+      break;
+    }
+    if (in_window && (sparse == sparse_.end() ||
+                      key(dense_[index].price) < sparse->first)) {
+      levels[count++] = dense_[index++];
+    } else {
+      levels[count++] = (sparse++)->second;
+    }
+  }
+  std::fill(levels.begin() + count, levels.end(), PriceLevel{});
+  return count;
+}
+
+void PriceLadder::apply(Decimal5 price, int64_t volume, int32_t orders) {
+  const int64_t key = this->key(price);
+  if (orders > 0) {
+    learn_tick(key);
+  }
+  size_t slot = index(key);
+  if (slot == dense_.size() && orders > 0 && tick_ != 0) {
+    // a new best price out of the window
+    int64_t offset = 0;
+    const bool on_grid = difference(key, anchor_, offset) &&
+                         offset % tick_ == 0;
+    if (on_grid && (best_ == dense_.size() || key < base_)) {
+      recenter(key);
+      slot = index(key);
+    }
+  }
+
+  PriceLevel *level = nullptr;
+  if (slot < dense_.size()) {
+    level = &dense_[slot];
+  } else if (const auto found = sparse_.find(key); found != sparse_.end()) {
+    level = &found->second;
+  } else if (orders > 0) {
+    level = &sparse_[key];
+  } else {
+    // an unknown level, nothing to take away
+    return;
+  }
+
+  if (level->empty()) {
+    if (orders <= 0) {
+      return;
+    }
+    level->price = price;
+    ++levels_;
+  }
+  level->volume += volume;
+  const int64_t remaining = int64_t{level->orders} + orders;
+  if (remaining <= 0) {
+    --levels_;
+    if (slot < dense_.size()) {
+      *level = {};
+      if (slot == best_) {
+        next_best();
+      }
+    } else {
+      sparse_.erase(key);
+    }
+    return;
+  }
+  level->orders = static_cast<uint32_t>(remaining);
+  if (slot < dense_.size()) {
+    best_ = std::min(best_, slot);
+  }
+}
+
+size_t PriceLadder::index(int64_t key) const noexcept {
+  int64_t offset = 0;
+  if (tick_ == 0 || !difference(key, base_, offset) || offset < 0 ||
+      offset % tick_ != 0) {
+    return dense_.size();
+  }
+  return std::min(static_cast<size_t>(offset / tick_), dense_.size());
+}
+
+void PriceLadder::learn_tick(int64_t key) {
+  if (!anchored_) {
+    anchored_ = true;
+    anchor_ = key;
+    return;
+  }
+  int64_t offset = 0;
+  if (!difference(key, anchor_, offset) ||
+      (tick_ != 0 && offset % tick_ == 0)) {
+    return;
+  }
+  const int64_t tick = std::gcd(tick_, offset);
+  if (tick == tick_) {
+    return;
+  }
+  tick_ = tick;
+
+  // the grid changed: index the levels again around the best one
+  int64_t best_key = key;
+  if (best_ < dense_.size()) {
+    best_key = this->key(dense_[best_].price);
+  }
+  if (!sparse_.empty()) {
+    best_key = std::min(best_key, sparse_.begin()->first);
+  }
+  recenter(best_key);
+}
+
+void PriceLadder::recenter(int64_t best_key) {
+  for (size_t slot = best_; slot < dense_.size(); ++slot) {
+    if (!dense_[slot].empty()) {
+      sparse_.emplace(key(dense_[slot].price), dense_[slot]);
+      dense_[slot] = {};
+    }
+  }
+  best_ = dense_.size();
+  // room for a quarter of the window of better prices
+  const auto margin = static_cast<int64_t>(dense_.size() / 4);
+  if (__builtin_mul_overflow(margin, tick_, &base_) ||
+      !difference(best_key, base_, base_)) {
+    base_ = best_key;
+  }
+
+  auto level = sparse_.lower_bound(base_);
+  while (level != sparse_.end()) {
+    int64_t offset = 0;
+    if (!difference(level->first, base_, offset) ||
+        offset / tick_ >= static_cast<int64_t>(dense_.size())) {
+      break;
+    }
+    if (offset % tick_ != 0) {
+      ++level;
+      continue;
+    }
+    const auto slot = static_cast<size_t>(offset / tick_);
+    dense_[slot] = level->second;
+    best_ = std::min(best_, slot);
+    level = sparse_.erase(level);
+  }
+}
+
+void PriceLadder::next_best() {
+  while (best_ < dense_.size() && dense_[best_].empty()) {
+    ++best_;
+  }
+  if (best_ < dense_.size() || sparse_.empty()) {
+    return;
+  }
+  // the window emptied: move it to the best level left, on the grid
+  int64_t offset = 0;
+  const int64_t best_key = sparse_.begin()->first;
+  if (difference(best_key, anchor_, offset) && offset % tick_ == 0) {
+    recenter(best_key);
+  }
+}
+
+MarketByPrice::Book::Book(int32_t security_id, size_t depth, size_t window)
+    : security_id(security_id),
+      bids(true, window),
+      offers(false, window),
+      reported_bids(depth),
+      reported_offers(depth) {}
+
+MarketByPrice::MarketByPrice(size_t depth, DepthHandler on_update,
+                             size_t window, bool conflate)
+    : depth_(depth),
+      on_update_(std::move(on_update)),
+      window_(window),
+      conflate_(conflate),
+      scratch_(depth) {
+  if (depth_ == 0 || depth_ > std::numeric_limits<uint8_t>::max()) {
+    throw std::runtime_error("The book depth must be between 1 and 255");
+  }
+  if (window_ == 0) {
+    throw std::runtime_error("The price window must not be empty");
+  }
+}
+
+void MarketByPrice::on_order_update(simba::types::OrderUpdateView update,
+                                    uint64_t time_ns) {
+  apply(update, time_ns);
+  end_message(update.md_flags(), time_ns);
+}
+
+void MarketByPrice::on_order_execution(
+    simba::types::OrderExecutionView execution, uint64_t time_ns) {
+  apply(execution, time_ns);
+  end_message(execution.md_flags(), time_ns);
+}
+
+void MarketByPrice::flush() {
+  for (const auto index : pending_) {
+    auto &book = books_[index];
+    if (std::exchange(book.pending_bids, false)) {
+      publish(book, MDEntryType::Bid, time_ns_);
+    }
+    if (std::exchange(book.pending_offers, false)) {
+      publish(book, MDEntryType::Offer, time_ns_);
+    }
+  }
+  pending_.clear();
+}
+
+void MarketByPrice::save(std::vector<std::byte> &state) const {
+  append_state(state, static_cast<uint32_t>(depth_));
+  append_state(state, static_cast<uint32_t>(books_.size()));
+  append_state(state, static_cast<uint64_t>(orders_.size()));
+  append_state(state, static_cast<uint32_t>(pending_.size()));
+  append_state(state, time_ns_);
+  for (const auto &book : books_) {
+    append_state(state, book.security_id);
+    append_state(state, static_cast<uint8_t>(book.pending_bids));
+    append_state(state, static_cast<uint8_t>(book.pending_offers));
+    for (const auto &level : book.reported_bids) {
+      append_level(state, level);
+    }
+    for (const auto &level : book.reported_offers) {
+      append_level(state, level);
+    }
+  }
+  for (const auto index : pending_) {
+    append_state(state, index);
+  }
+  for (const auto &[id, order] : orders_) {
+    append_state(state, id);
+    append_state(state, order.price.mantissa());
+    append_state(state, order.volume);
+    append_state(state, order.book);
+    append_state(state, order.side);
+  }
+}
+
+void MarketByPrice::restore(std::span<const std::byte> state) {
+  if (!books_.empty() || !orders_.empty()) {
+    throw std::runtime_error("The book must be empty to be restored");
+  }
+  if (take_state<uint32_t>(state) != depth_) {
+    throw std::runtime_error("The book state was saved at another depth");
+  }
+  const auto books = take_state<uint32_t>(state);
+  const auto orders = take_state<uint64_t>(state);
+  const auto pending = take_state<uint32_t>(state);
+  time_ns_ = take_state<uint64_t>(state);
+  for (uint32_t index = 0; index < books; ++index) {
+    auto &book = books_[slot(take_state<int32_t>(state))];
+    book.pending_bids = take_state<uint8_t>(state) != 0;
+    book.pending_offers = take_state<uint8_t>(state) != 0;
+    for (auto &level : book.reported_bids) {
+      level = take_level(state);
+    }
+    for (auto &level : book.reported_offers) {
+      level = take_level(state);
+    }
+  }
+  for (uint32_t index = 0; index < pending; ++index) {
+    pending_.push_back(take_state<uint32_t>(state));
+    if (pending_.back() >= books_.size()) {
+      throw std::runtime_error("Corrupted book state");
+    }
+  }
+  orders_.reserve(orders);
+  for (uint64_t index = 0; index < orders; ++index) {
+    const auto id = take_state<int64_t>(state);
+    Order order;
+    order.price = Decimal5{take_state<int64_t>(state)};
+    order.volume = take_state<int64_t>(state);
+    order.book = take_state<uint32_t>(state);
+    order.side = take_state<MDEntryType>(state);
+    if (order.book >= books_.size() || !tradable(order.side, order.price)) {
+      throw std::runtime_error("Corrupted book state");
+    }
+    auto &book = books_[order.book];
+    auto &ladder = order.side == MDEntryType::Bid ? book.bids : book.offers;
+    ladder.insert(order.price, order.volume);
+    orders_.insert_or_assign(id, order);
+  }
+  if (!state.empty()) {
+    throw std::runtime_error("Corrupted book state");
+  }
+}
+
+void MarketByPrice::apply(simba::types::OrderUpdateView update,
+                          uint64_t time_ns) {
+  using simba::types::MDUpdateAction;
+
+  const int64_t id = update.md_entry_id();
+  switch (update.md_update_action()) {
+    case MDUpdateAction::New:
+    case MDUpdateAction::Change: {
+      if (!tradable(update.md_entry_type(), update.md_entry_px())) {
+        return;
+      }
+      const Order order{update.md_entry_px(), update.md_entry_size(),
+                        slot(update.security_id()), update.md_entry_type()};
+      const auto found = orders_.find(id);
+      if (found == orders_.end()) {
+        insert(id, order, time_ns);
+        return;
+      }
+      auto &current = found->second;
+      if (current.book != order.book || current.side != order.side ||
+          current.price != order.price) {
+        erase(found, time_ns);
+        insert(id, order, time_ns);
+        return;
+      }
+      // the same level, only its volume changes
+      auto &book = books_[order.book];
+      auto &ladder = order.side == MDEntryType::Bid ? book.bids : book.offers;
+      ladder.modify(order.price, order.volume - current.volume);
+      current.volume = order.volume;
+      report(book, order.side, order.price, time_ns);
+      return;
+    }
+    case MDUpdateAction::Delete: {
+      const auto found = orders_.find(id);
+      if (found == orders_.end()) {
+        ++unknown_orders_;
+        return;
+      }
+      erase(found, time_ns);
+      return;
+    }
+    default:
+      return;
+  }
+}
+
+void MarketByPrice::apply(simba::types::OrderExecutionView execution,
+                          uint64_t time_ns) {
+  const auto found = orders_.find(execution.md_entry_id());
+  if (found == orders_.end()) {
+    ++unknown_orders_;
+    return;
+  }
+  auto &order = found->second;
+  // the remaining volume, or the traded one when it is missing
+  int64_t remaining = execution.md_entry_size();
+  if (remaining == std::numeric_limits<int64_t>::max()) {
+    remaining = order.volume - execution.last_qty();
+  }
+  if (execution.md_update_action() == simba::types::MDUpdateAction::Delete ||
+      remaining <= 0) {
+    erase(found, time_ns);
+    return;
+  }
+  auto &book = books_[order.book];
+  auto &ladder = order.side == MDEntryType::Bid ? book.bids : book.offers;
+  ladder.modify(order.price, remaining - order.volume);
+  order.volume = remaining;
+  report(book, order.side, order.price, time_ns);
+}
+
+void MarketByPrice::end_message(simba::types::MDFlagsSet flags,
+                                uint64_t time_ns) {
+  time_ns_ = time_ns;
+  if (flags.end_of_transaction()) {
+    ++transactions_;
+    flush();
+  }
+}
+
+std::vector<PriceLevel> MarketByPrice::levels(int32_t security_id,
+                                              MDEntryType side,
+                                              size_t count) const {
+  const auto found = slots_.find(security_id);
+  if (found == slots_.end()) {
+    return {};
+  }
+  const auto &book = books_[found->second];
+  std::vector<PriceLevel> levels(count);
+  levels.resize(side == MDEntryType::Bid ? book.bids.top(levels)
+                                         : book.offers.top(levels));
+  return levels;
+}
+
+uint32_t MarketByPrice::slot(int32_t security_id) {
+  const auto [entry, inserted] = slots_.try_emplace(
+      security_id, static_cast<uint32_t>(books_.size()));
+  if (inserted) {
+    books_.emplace_back(security_id, depth_, window_);
+  }
+  return entry->second;
+}
+
+void MarketByPrice::insert(int64_t id, const Order &order, uint64_t time_ns) {
+  auto &book = books_[order.book];
+  auto &ladder = order.side == MDEntryType::Bid ? book.bids : book.offers;
+  ladder.insert(order.price, order.volume);
+  orders_.insert_or_assign(id, order);
+  report(book, order.side, order.price, time_ns);
+}
+
+void MarketByPrice::erase(std::unordered_map<int64_t, Order>::iterator order,
+                          uint64_t time_ns) {
+  const auto [price, volume, index, side] = order->second;
+  orders_.erase(order);
+  auto &book = books_[index];
+  auto &ladder = side == MDEntryType::Bid ? book.bids : book.offers;
+  ladder.erase(price, volume);
+  report(book, side, price, time_ns);
+}
+
+void MarketByPrice::report(Book &book, MDEntryType side, Decimal5 price,
+                           uint64_t time_ns) {
+  const bool bids = side == MDEntryType::Bid;
+  const auto &ladder = bids ? book.bids : book.offers;
+  auto &reported = bids ? book.reported_bids : book.reported_offers;
+  // below the reported depth: the best levels did not change
+  if (!reported.back().empty() && ladder.worse(price, reported.back().price)) {
+    return;
+  }
+  if (!conflate_) {
+    publish(book, side, time_ns);
+    return;
+  }
+  auto &pending = bids ? book.pending_bids : book.pending_offers;
+  if (!book.pending_bids && !book.pending_offers) {
+    pending_.push_back(static_cast<uint32_t>(&book - books_.data()));
+  }
+  pending = true;
+}
+
+void MarketByPrice::publish(Book &book, MDEntryType side, uint64_t time_ns) {
+  const bool bids = side == MDEntryType::Bid;
+  const auto &ladder = bids ? book.bids : book.offers;
+  auto &reported = bids ? book.reported_bids : book.reported_offers;
+  ladder.top(scratch_);
+  for (size_t depth = 0; depth < depth_; ++depth) {
+    if (scratch_[depth] == reported[depth]) {
+      continue;
+    }
+    reported[depth] = scratch_[depth];
+    DepthUpdate update;
+    update.time_ns = time_ns;
+    update.price = scratch_[depth].price;
+    update.volume = scratch_[depth].volume;
+    update.security_id = book.security_id;
+    update.orders = scratch_[depth].orders;
+    update.depth = static_cast<uint8_t>(depth);
+    update.side = side;
+    on_update_(update);
+    ++updates_;
+  }
+}
+
+}  // namespace task::market_data
@@ -0,0 +1,98 @@
+#include "metrics/metrics.h"
+
+#include <deque>
+#include <mutex>
+#include <sstream>
+
+namespace task::metrics {
+
+namespace {
+std::mutex registry_mutex;
+// deque: registered blocks never move
+std::deque<ThreadCounters> registry;
+
+constexpr std::string_view PROMETHEUS_PREFIX{"simba_"};
+}  // namespace
+
+ThreadCounters *register_thread() {
+  std::scoped_lock lock(registry_mutex);
+  return &registry.emplace_back();
+}
+
+Snapshot collect() {
+  Snapshot snapshot;
+  snapshot.timestamp_ns =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::system_clock::now().time_since_epoch())
+          .count();
+
+  {
+    std::scoped_lock lock(registry_mutex);
+    for (const auto &thread_counters : registry) {
+      for (size_t index = 0; index < snapshot.counters.size(); ++index) {
+        snapshot.counters[index] +=
+            thread_counters.counters[index].load(std::memory_order_relaxed);
+      }
+      for (size_t index = 0; index < snapshot.messages.size(); ++index) {
+        snapshot.messages[index] +=
+            thread_counters.messages[index].load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  for (size_t index = 0; index < snapshot.gauges.size(); ++index) {
+    snapshot.gauges[index] =
+        gauges[index].value.load(std::memory_order_relaxed);
+  }
+  return snapshot;
+}
+
+std::string Snapshot::to_json() const {
+  std::stringstream sstream;
+  sstream << "{\"timestamp_ns\":" << timestamp_ns;
+  for (size_t index = 0; index < counters.size(); ++index) {
+    sstream << ",\"" << COUNTER_NAMES[index] << "\":" << counters[index];
+  }
+  for (size_t index = 0; index < gauges.size(); ++index) {
+    sstream << ",\"" << GAUGE_NAMES[index] << "\":" << gauges[index];
+  }
+  sstream << ",\"messages\":{";
+  bool first{true};
+  for (size_t index = 0; index < messages.size(); ++index) {
+    if (messages[index] == 0) {
+      continue;
+    }
+    sstream << (first ? "" : ",") << '"' << simba::types::TEMPLATE_IDS[index]
+            << "\":" << messages[index];
+    first = false;
+  }
+  sstream << "}}";
+  return sstream.str();
+}
+
+std::string Snapshot::to_prometheus() const {
+  std::stringstream sstream;
+  for (size_t index = 0; index < counters.size(); ++index) {
+    sstream << "# TYPE " << PROMETHEUS_PREFIX << COUNTER_NAMES[index]
+            << "_total counter\n";
+    sstream << PROMETHEUS_PREFIX << COUNTER_NAMES[index] << "_total "
+            << counters[index] << '\n';
+  }
+  for (size_t index = 0; index < gauges.size(); ++index) {
+    sstream << "# TYPE " << PROMETHEUS_PREFIX << GAUGE_NAMES[index]
+            << " gauge\n";
+    sstream << PROMETHEUS_PREFIX << GAUGE_NAMES[index] << ' ' << gauges[index]
+            << '\n';
+  }
+  sstream << "# TYPE " << PROMETHEUS_PREFIX << "messages_total counter\n";
+  for (size_t index = 0; index < messages.size(); ++index) {
+    if (messages[index] != 0) {
+      sstream << PROMETHEUS_PREFIX << "messages_total{template_id=\""
+              << simba::types::TEMPLATE_IDS[index] << "\"} " << messages[index]
+              << '\n';
+    }
+  }
+  return sstream.str();
+}
+
+}  // namespace task::metrics
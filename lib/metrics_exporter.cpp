@@ -0,0 +1,47 @@
+#include "metrics/metrics_exporter.h"
+
+#include <fstream>
+
+namespace task::metrics {
+
+MetricsExporter::MetricsExporter(ExporterConfig config)
+    : config_(std::move(config)) {
+  exporter_thread_ = std::thread([this]() {
+    std::unique_lock lock(mutex_);
+    while (!stop_condition_.wait_for(lock, config_.interval,
+                                     [this] { return is_stopped_; })) {
+      export_now();
+    }
+  });
+}
+
+MetricsExporter::~MetricsExporter() {
+  {
+    std::scoped_lock lock(mutex_);
+    is_stopped_ = true;
+  }
+  stop_condition_.notify_one();
+  exporter_thread_.join();
+  export_now();
+}
+
+void MetricsExporter::export_now() const {
+  const auto snapshot = collect();
+
+  if (config_.json_lines_path) {
+    std::ofstream json_lines(*config_.json_lines_path, std::ios::app);
+    json_lines << snapshot.to_json() << '\n';
+  }
+
+  if (config_.prometheus_path) {
+    auto temporary_path = *config_.prometheus_path;
+    temporary_path += ".tmp";
+    {
+      std::ofstream prometheus(temporary_path, std::ios::trunc);
+      prometheus << snapshot.to_prometheus();
+    }
+    std::filesystem::rename(temporary_path, *config_.prometheus_path);
+  }
+}
+
+}  // namespace task::metrics
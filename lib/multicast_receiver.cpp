@@ -0,0 +1,184 @@
+#include "processors/multicast_receiver.h"
+
+#include "logging/logger.h"
+
+#include <netinet/in.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <map>
+#include <stdexcept>
+
+namespace task::processors::live {
+
+namespace {
+[[noreturn]] void throw_socket_error(const std::string &operation) {
+  throw std::runtime_error(operation + ": " + std::strerror(errno));
+}
+}  // namespace
+
+MulticastReceiver::MulticastReceiver(ReceiverConfig config)
+    : config_(std::move(config)) {
+  if (config_.groups.empty()) {
+    throw std::runtime_error("No multicast group to receive from");
+  }
+
+  std::map<uint16_t, std::vector<Endpoint>> groups_by_port;
+  for (const auto &group : config_.groups) {
+    groups_by_port[group.port].push_back(group);
+  }
+  for (const auto &[port, groups] : groups_by_port) {
+    open_socket(port, groups);
+  }
+
+  // Preallocate the ring and the recvmmsg descriptors once
+  const size_t ring_slots = RING_BATCHES * config_.batch_size;
+  ring_.resize(ring_slots * config_.max_datagram_size);
+  iovecs_.resize(ring_slots);
+  for (size_t slot = 0; slot < ring_slots; ++slot) {
+    iovecs_[slot].iov_base = ring_.data() + slot * config_.max_datagram_size;
+    iovecs_[slot].iov_len = config_.max_datagram_size;
+  }
+  control_.resize(config_.batch_size * CONTROL_SIZE);
+  messages_.resize(config_.batch_size);
+}
+
+MulticastReceiver::~MulticastReceiver() {
+  for (const int socket : sockets_) {
+    ::close(socket);
+  }
+}
+
+void MulticastReceiver::open_socket(uint16_t port,
+                                    const std::vector<Endpoint> &groups) {
+  const int socket = ::socket(AF_INET, SOCK_DGRAM, 0);
+  if (socket < 0) {
+    throw_socket_error("socket");
+  }
+  sockets_.push_back(socket);
+
+  const int enable{1};
+  if (::setsockopt(socket, SOL_SOCKET, SO_REUSEADDR, &enable,
+                   sizeof(enable)) < 0) {
+    throw_socket_error("SO_REUSEADDR");
+  }
+
+  if (config_.receive_buffer_size > 0 &&
+      ::setsockopt(socket, SOL_SOCKET, SO_RCVBUF, &config_.receive_buffer_size,
+                   sizeof(config_.receive_buffer_size)) < 0) {
+    throw_socket_error("SO_RCVBUF");
+  }
+
+  // Both options are best effort: busy polling may require CAP_NET_ADMIN
+  if (config_.busy_poll_usec > 0 &&
+      ::setsockopt(socket, SOL_SOCKET, SO_BUSY_POLL, &config_.busy_poll_usec,
+                   sizeof(config_.busy_poll_usec)) < 0) {
+    logging::log(logging::Level::Warning, "{} cannot enable SO_BUSY_POLL: {}",
+                 log_prefix_, std::strerror(errno));
+  }
+  if (config_.kernel_timestamps &&
+      ::setsockopt(socket, SOL_SOCKET, SO_TIMESTAMPNS, &enable,
+                   sizeof(enable)) < 0) {
+    logging::log(logging::Level::Warning,
+                 "{} cannot enable SO_TIMESTAMPNS: {}", log_prefix_,
+                 std::strerror(errno));
+  }
+
+  // A single group binds to its address so that the kernel filters out the
+  // other groups sharing the port
+  Endpoint bind_endpoint{"0.0.0.0", port};
+  if (groups.size() == 1) {
+    bind_endpoint.address = groups.front().address;
+  }
+  const auto bind_address = bind_endpoint.to_sockaddr();
+  if (::bind(socket, reinterpret_cast<const sockaddr *>(&bind_address),
+             sizeof(bind_address)) < 0) {
+    throw_socket_error("bind " + bind_endpoint.to_string());
+  }
+
+  for (const auto &group : groups) {
+    if (!group.is_multicast()) {
+      continue;
+    }
+    ip_mreq membership{};
+    membership.imr_multiaddr = to_in_addr(group.address);
+    membership.imr_interface = to_in_addr(config_.interface_address);
+    if (::setsockopt(socket, IPPROTO_IP, IP_ADD_MEMBERSHIP, &membership,
+                     sizeof(membership)) < 0) {
+      throw_socket_error("IP_ADD_MEMBERSHIP " + group.to_string());
+    }
+    logging::log(logging::Level::Info, "{} joined {}", log_prefix_,
+                 group.to_string());
+  }
+}
+
+void MulticastReceiver::wait_readable() const {
+  std::vector<pollfd> descriptors;
+  descriptors.reserve(sockets_.size());
+  for (const int socket : sockets_) {
+    descriptors.push_back(pollfd{socket, POLLIN, 0});
+  }
+  if (::poll(descriptors.data(), descriptors.size(), POLL_TIMEOUT_MS) < 0 &&
+      errno != EINTR) {
+    throw_socket_error("poll");
+  }
+}
+
+size_t MulticastReceiver::receive(int socket) {
+  const size_t first_slot = ring_batch_ * config_.batch_size;
+  for (size_t index = 0; index < config_.batch_size; ++index) {
+    auto &header = messages_[index].msg_hdr;
+    header = msghdr{};
+    header.msg_iov = &iovecs_[first_slot + index];
+    header.msg_iovlen = 1;
+    if (config_.kernel_timestamps) {
+      header.msg_control = control_.data() + index * CONTROL_SIZE;
+      header.msg_controllen = CONTROL_SIZE;
+    }
+  }
+
+  const int datagrams =
+      ::recvmmsg(socket, messages_.data(), config_.batch_size, MSG_DONTWAIT,
+                 nullptr);
+  if (datagrams < 0) {
+    if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+      return 0;
+    }
+    throw_socket_error("recvmmsg");
+  }
+
+  ring_batch_ = (ring_batch_ + 1) % RING_BATCHES;
+  return static_cast<size_t>(datagrams);
+}
+
+uint64_t MulticastReceiver::timestamp(const mmsghdr &message) const noexcept {
+  if (!config_.kernel_timestamps) {
+    return 0;
+  }
+  auto &header = const_cast<msghdr &>(message.msg_hdr);
+  for (auto *control = CMSG_FIRSTHDR(&header); control != nullptr;
+       control = CMSG_NXTHDR(&header, control)) {
+    if (control->cmsg_level == SOL_SOCKET &&
+        control->cmsg_type == SCM_TIMESTAMPNS) {
+      timespec time{};
+      std::memcpy(&time, CMSG_DATA(control), sizeof(time));
+      return static_cast<uint64_t>(time.tv_sec) * 1'000'000'000 +
+             static_cast<uint64_t>(time.tv_nsec);
+    }
+  }
+  return 0;
+}
+
+uint16_t MulticastReceiver::local_port(size_t socket_index) const {
+  sockaddr_in address{};
+  socklen_t length = sizeof(address);
+  if (::getsockname(sockets_.at(socket_index),
+                    reinterpret_cast<sockaddr *>(&address), &length) < 0) {
+    throw_socket_error("getsockname");
+  }
+  return ntohs(address.sin_port);
+}
+
+}  // namespace task::processors::live
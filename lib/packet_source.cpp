@@ -0,0 +1,53 @@
+#include "processors/packet_source.h"
+
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include "logging/logger.h"
+#include "processors/link_layer.h"
+
+namespace task::processors {
+
+void check_pcap_header(const pcap::types::pcap_hdr_t &header) {
+  logging::log(logging::Level::Info, "PCAP HEADER magic number: {:x}",
+               header.magic_number);
+  if (header.magic_number != pcap::types::MAGIC_NANOSECONDS) {
+    throw std::runtime_error(
+        "The tool has been tested with files produced with magic number: "
+        "0xA1B23C4D");
+  }
+  logging::log(logging::Level::Info,
+               "PCAP HEADER version: {}.{}, snaplen: {}, link type: {}",
+               header.version_major, header.version_minor, header.snaplen,
+               header.network);
+
+  if (!transport_layer::visit_link_type(header.network, [](auto) {})) {
+    throw std::runtime_error(
+        "Unsupported link type " + std::to_string(header.network) +
+        ": the tool reads Ethernet (1), Linux cooked SLL (113) and SLL2 (276) "
+        "captures");
+  }
+}
+
+size_t CaptureFramer::frame(size_t max_packets,
+                            std::vector<transport_layer::PacketView> &packets,
+                            std::vector<pcap::types::pcaprec_hdr_s> &headers) {
+  size_t framed{0};
+  while (framed < max_packets &&
+         offset_ + sizeof(pcap::types::pcaprec_hdr_s) <= records_.size()) {
+    pcap::types::pcaprec_hdr_s header;
+    std::memcpy(&header, records_.data() + offset_, sizeof(header));
+    const size_t packet_offset = offset_ + sizeof(header);
+    if (header.captured_length > records_.size() - packet_offset) {
+      break;
+    }
+    packets.push_back(records_.subspan(packet_offset, header.captured_length));
+    headers.push_back(header);
+    offset_ = packet_offset + header.captured_length;
+    ++framed;
+  }
+  return framed;
+}
+
+}  // namespace task::processors
@@ -5,12 +5,11 @@ namespace task::transport_layer {
 EthernetPacket::EthernetPacket(std::span<const std::byte> buffer) {
   std::memcpy(dest_address.data(), buffer.data(), 6);
   std::memcpy(source_address.data(), buffer.data() + 6, 6);
-  std::memcpy(packet_type.data(), packet_type.data() + 12, 2);
+  std::memcpy(packet_type.data(), buffer.data() + 12, 2);
 }
 
 IPPacket::IPPacket(std::span<const std::byte> packet) {
   size_t offset = 0;
-  uint32_t first_row{0};
   std::memcpy(&version_ihl, packet.data(), sizeof(version_ihl));
   offset += sizeof(version_ihl);
   offset += 1;
@@ -0,0 +1,62 @@
+#include "processors/packet_validation.h"
+
+#include <algorithm>
+#include <sstream>
+
+#include "metrics/metrics.h"
+
+namespace task::transport_layer {
+
+namespace {
+std::string to_endpoint(uint32_t address, uint16_t port) {
+  std::ostringstream endpoint;
+  endpoint << (address >> 24) << '.' << ((address >> 16) & 0xFF) << '.'
+           << ((address >> 8) & 0xFF) << '.' << (address & 0xFF) << ':'
+           << port;
+  return endpoint.str();
+}
+}  // namespace
+
+std::string FlowValidation::to_string() const {
+  return to_endpoint(flow.source_address, flow.source_port) + " -> " +
+         to_endpoint(flow.destination_address, flow.destination_port) +
+         " truncated " + std::to_string(truncated) + ", bad IP checksum " +
+         std::to_string(bad_ip_checksum) + ", bad UDP checksum " +
+         std::to_string(bad_udp_checksum);
+}
+
+void ValidationReport::record(const FlowKey &flow, Verdict verdict) {
+  if (verdict == Verdict::Valid) {
+    return;
+  }
+  ++invalid_packets_;
+
+  auto entry = std::find_if(
+      flows_.begin(), flows_.end(),
+      [&flow](const FlowValidation &entry) { return entry.flow == flow; });
+  if (entry == flows_.end()) {
+    if (flows_.size() < MAX_FLOWS) {
+      flows_.push_back({flow});
+    }
+    entry = flows_.end() - 1;
+  }
+
+  switch (verdict) {
+    case Verdict::Truncated:
+      ++entry->truncated;
+      metrics::add(metrics::Counter::TruncatedPackets);
+      break;
+    case Verdict::BadIPChecksum:
+      ++entry->bad_ip_checksum;
+      metrics::add(metrics::Counter::ChecksumErrors);
+      break;
+    case Verdict::BadUDPChecksum:
+      ++entry->bad_udp_checksum;
+      metrics::add(metrics::Counter::ChecksumErrors);
+      break;
+    case Verdict::Valid:
+      break;
+  }
+}
+
+}  // namespace task::transport_layer
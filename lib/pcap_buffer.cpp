@@ -3,10 +3,11 @@
 namespace task::processors::mt_buffer {
 
 void PCAPBuffer::start_buffering() {
+  // set before the thread runs, so that an early stop() is not overwritten
+  is_started_ = true;
+  is_started_.notify_one();
   producer_thread_ = std::thread([this]() {
-    std::cout << log_prefix_ << " Start buffering " << std::endl;
-    is_started_ = true;
-    is_started_.notify_one();
+    logging::log(logging::Level::Info, "{} Start buffering", log_prefix_);
 
     size_t packet_nr{1};
     while (current_offset_ < file_size_ &&
@@ -21,21 +22,28 @@ void PCAPBuffer::start_buffering() {
                   << bytes_to_read << std::endl;
       }
 
-      if (!file_handle_.read((char *)local_buffer_.data(), bytes_to_read)) {
-        throw std::runtime_error("Cannot read from the PCAP file.");
+      // the chunk is handed over to the consumer with the batch: left
+      // uninitialized since the read overwrites it
+      std::unique_ptr<std::byte[]> chunk(new std::byte[bytes_to_read]);
+      {
+        // the disk time, apart from the waits on the consumer
+        metrics::ScopedTimer read_timer(metrics::Counter::ReadNs);
+        if (!file_handle_.read((char *)chunk.get(), bytes_to_read)) {
+          logging::log(logging::Level::Error,
+                       "{} Cannot read from the PCAP file.", log_prefix_);
+          break;
+        }
       }
+      metrics::add(metrics::Counter::BytesRead, bytes_to_read);
 
       // buffer as many packets as possible that fit the BATCH SIZE
       BufferedPackets buffered_packets{};
       size_t offset{0};
       buffered_packets.start_packet_number = packet_nr;
-      while (current_offset_ < file_size_ && offset < BATCH_SIZE) {
+      while (offset + sizeof(pcap::types::pcaprec_hdr_s) <= bytes_to_read) {
         pcap::types::pcaprec_hdr_s packet_header;
-        std::span<std::byte> pcap_packet_header_span{
-            local_buffer_.data() + offset, sizeof(packet_header)};
-
-        std::memcpy(&packet_header, pcap_packet_header_span.data(),
-                    pcap_packet_header_span.size());
+        std::memcpy(&packet_header, chunk.get() + offset,
+                    sizeof(packet_header));
 
         if constexpr (ENABLE_DEBUGGING) {
           std::cout << "usec: " << std::hex << packet_header.ts_usec
@@ -46,42 +54,73 @@ void PCAPBuffer::start_buffering() {
                     << std::endl;
         }
 
-        offset += sizeof(packet_header);
-
-        if (offset + packet_header.captured_length >= BATCH_SIZE) {
+        // the record continues in the next chunk
+        const size_t record_end =
+            offset + sizeof(packet_header) + packet_header.captured_length;
+        if (record_end > bytes_to_read) {
           break;
         }
 
+        offset += sizeof(packet_header);
         if constexpr (ENABLE_DEBUGGING) {
-          utility::hex_dump(local_buffer_.data() + offset,
+          utility::hex_dump(chunk.get() + offset,
                             packet_header.captured_length, std::cout);
         }
-        buffered_packets.packets.emplace_back(
-            local_buffer_.begin() + offset,
-            local_buffer_.begin() + offset + packet_header.captured_length);
+        buffered_packets.packets.emplace_back(chunk.get() + offset,
+                                              packet_header.captured_length);
+        buffered_packets.headers.push_back(packet_header);
         buffered_packets.number_packets++;
 
         offset += packet_header.captured_length;
-        current_offset_ +=
-            sizeof(packet_header) + packet_header.captured_length;
         packet_nr++;
       }
+      current_offset_ += offset;
+
+      // Nothing fits in a whole chunk: either the record header is corrupted
+      // (captured_length larger than any chunk) or the file is truncated.
+      if (offset == 0) {
+        logging::log(logging::Level::Error,
+                     "{} Corrupted or truncated record at offset {}, stop "
+                     "buffering.",
+                     log_prefix_, current_offset_);
+        break;
+      }
+
+      metrics::add(metrics::Counter::PacketsFramed,
+                   buffered_packets.number_packets);
+      buffered_packets.data = std::move(chunk);
 
       // Critical section
+      size_t queued_batches{0};
       {
+        metrics::ScopedTimer lock_timer(metrics::Counter::ProducerStallNs);
+        std::scoped_lock file_lock(chuncks_mutex);
+        pcap_data_chunks_.push_back(std::move(buffered_packets));
+        queued_batches = pcap_data_chunks_.size();
+        metrics::set(metrics::Gauge::QueueDepth, queued_batches);
+      }
+
+      // bounded read-ahead: wait for the consumer to catch up
+      while (max_queued_batches_ > 0 && queued_batches >= max_queued_batches_ &&
+             is_started_.load(std::memory_order_acquire)) {
+        metrics::ScopedTimer stall_timer(metrics::Counter::ProducerStallNs);
+        std::this_thread::sleep_for(
+            std::chrono::microseconds(PRODUCER_BUFFERING_TIME));
         std::scoped_lock file_lock(chuncks_mutex);
-        pcap_data_chunks_.push_back(buffered_packets);
+        queued_batches = pcap_data_chunks_.size();
       }
 
       double processed_percentage =
           100 *
           static_cast<double>((double)current_offset_ / (double)file_size_);
-      std::cout << log_prefix_ << " Percentage of the whole file processed ("
-                << processed_percentage << "%)" << std::endl;
+      logging::log(logging::Level::Debug,
+                   "{} Percentage of the whole file processed ({}%)",
+                   log_prefix_, processed_percentage);
       file_handle_.seekg(current_offset_);
     }
 
     is_started_.store(false, std::memory_order_release);
+    is_finished_.store(true, std::memory_order_release);
   });
 
   return;
@@ -93,15 +132,21 @@ std::optional<BufferedPackets> PCAPBuffer::next_batch() {
     return std::nullopt;
   }
 
-  const auto next_chunk = pcap_data_chunks_.front();
+  auto next_chunk = std::move(pcap_data_chunks_.front());
   pcap_data_chunks_.pop_front();
+  metrics::set(metrics::Gauge::QueueDepth, pcap_data_chunks_.size());
   return next_chunk;
 }
 
 void PCAPBuffer::stop() {
-  std::cout << "[PCAP_BUFFER] stop buffering " << std::endl;
+  logging::log(logging::Level::Info, "{} stop buffering", log_prefix_);
   is_started_.store(false, std::memory_order_release);
-  std::cout << "[PCAP_BUFFER] closing pcap file " << std::endl;
+  // the producer may still be reading the file
+  if (producer_thread_.joinable() &&
+      producer_thread_.get_id() != std::this_thread::get_id()) {
+    producer_thread_.join();
+  }
+  logging::log(logging::Level::Info, "{} closing pcap file", log_prefix_);
   file_handle_.close();
 }
-} // namespace task::processors::mt_buffer
\ No newline at end of file
+} // namespace task::processors::mt_buffer
@@ -0,0 +1,33 @@
+#include "processors/pcap_file.h"
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace task::processors {
+
+PCAPFile open_pcap_file(const std::filesystem::path &path) {
+  PCAPFile pcap_file;
+  pcap_file.stream =
+      std::ifstream(path.string(), std::ios::binary | std::ios::ate);
+
+  if (!pcap_file.stream)
+    throw std::runtime_error(path.string() + ": " + std::strerror(errno));
+
+  const auto end = pcap_file.stream.tellg();
+  pcap_file.stream.seekg(0, std::ios::beg);
+
+  pcap_file.file_size = std::size_t(end - pcap_file.stream.tellg());
+  if (pcap_file.file_size == 0)
+    throw std::runtime_error(ErrorMessage::ERROR_MSG_ZERO_SIZE.data());
+
+  if (!pcap_file.stream.read(reinterpret_cast<char *>(&pcap_file.header),
+                             PCAPFile::HEADER_SIZE))
+    throw std::runtime_error(
+        ErrorMessage::ERROR_CANNOT_READ_PCAP_HEADER.data());
+
+  return pcap_file;
+}
+
+}  // namespace task::processors
@@ -0,0 +1,179 @@
+#include "processors/pcap_merger.h"
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <stdexcept>
+#include <thread>
+
+#include "logging/logger.h"
+#include "metrics/metrics.h"
+
+namespace task::processors {
+
+std::vector<std::filesystem::path>
+list_captures(const std::vector<std::string> &inputs) {
+  std::vector<std::filesystem::path> captures;
+  for (const auto &input : inputs) {
+    const std::filesystem::path path{input};
+    if (!std::filesystem::is_directory(path)) {
+      captures.push_back(path);
+      continue;
+    }
+    std::vector<std::filesystem::path> files;
+    for (const auto &entry : std::filesystem::directory_iterator(path)) {
+      if (entry.is_regular_file() &&
+          !entry.path().filename().string().starts_with('.')) {
+        files.push_back(entry.path());
+      }
+    }
+    std::sort(files.begin(), files.end());
+    captures.insert(captures.end(), files.begin(), files.end());
+  }
+  if (captures.empty()) {
+    throw std::runtime_error("No capture to process");
+  }
+  return captures;
+}
+
+PCAPMerger::PCAPMerger(const std::vector<std::filesystem::path> &files) {
+  cursors_.reserve(files.size());
+  for (const auto &path : files) {
+    // closed again at the end of the iteration, and reopened when the merge
+    // reaches it: a day of rotated files would exhaust the descriptors
+    auto file = open_pcap_file(path);
+    total_size_ += file.file_size;
+    if (!cursors_.empty() &&
+        file.header.network != cursors_.front().header.network) {
+      throw std::runtime_error(
+          "Captures with different link types: " +
+          cursors_.front().path.string() + " (" +
+          std::to_string(cursors_.front().header.network) + ") and " +
+          path.string() + " (" + std::to_string(file.header.network) + ")");
+    }
+
+    Cursor cursor{path, file.header};
+    pcap::types::pcaprec_hdr_s first_record{};
+    if (file.file_size < PCAPFile::HEADER_SIZE + sizeof(first_record) ||
+        !file.stream.read(reinterpret_cast<char *>(&first_record),
+                          sizeof(first_record))) {
+      logging::log(logging::Level::Warning, "{} - {} holds no packet",
+                   log_prefix_, path.string());
+      cursors_.push_back(std::move(cursor));
+      continue;
+    }
+    cursor.first_timestamp =
+        pcap::types::to_nanoseconds(first_record, file.header.magic_number);
+    cursors_.push_back(std::move(cursor));
+    push({cursors_.back().first_timestamp, cursors_.size() - 1});
+  }
+}
+
+PCAPMerger::~PCAPMerger() {
+  for (auto &cursor : cursors_) {
+    if (cursor.buffer) {
+      close(cursor);
+    }
+  }
+}
+
+const MergedPackets &PCAPMerger::next_batch() {
+  retired_.clear();
+  merged_.packets.clear();
+  merged_.headers.clear();
+
+  while (merged_.packets.size() < MAX_BATCH_PACKETS && !heap_.empty()) {
+    const size_t index = pop().second;
+    auto &cursor = cursors_[index];
+    if (!cursor.buffer) {
+      open(cursor);
+      if (advance(cursor)) {
+        push({cursor.timestamp(), index});
+      }
+      continue;
+    }
+
+    // the packets preceding the next file go without heap operations
+    bool more{false};
+    do {
+      merged_.packets.push_back(cursor.batch->packets[cursor.next]);
+      merged_.headers.push_back(cursor.batch->headers[cursor.next]);
+      more = advance(cursor);
+    } while (more && merged_.packets.size() < MAX_BATCH_PACKETS &&
+             (heap_.empty() ||
+              HeapEntry{cursor.timestamp(), index} < heap_.front()));
+    if (more) {
+      push({cursor.timestamp(), index});
+    }
+  }
+  return merged_;
+}
+
+std::vector<pcap::types::pcap_hdr_t> PCAPMerger::headers() const {
+  std::vector<pcap::types::pcap_hdr_t> headers;
+  for (const auto &cursor : cursors_) {
+    headers.push_back(cursor.header);
+  }
+  return headers;
+}
+
+void PCAPMerger::open(Cursor &cursor) {
+  logging::log(logging::Level::Debug, "{} - opening {}", log_prefix_,
+               cursor.path.string());
+  cursor.file.emplace(open_pcap_file(cursor.path));
+  cursor.buffer = std::make_unique<mt_buffer::PCAPBuffer>(
+      cursor.file->stream, cursor.file->file_size, PCAPFile::HEADER_SIZE,
+      READ_AHEAD_BATCHES);
+  cursor.buffer->start_buffering();
+}
+
+void PCAPMerger::close(Cursor &cursor) {
+  cursor.buffer->stop();
+  cursor.buffer.reset();
+  cursor.file.reset();
+}
+
+bool PCAPMerger::advance(Cursor &cursor) {
+  if (cursor.batch && ++cursor.next < cursor.batch->packets.size()) {
+    return true;
+  }
+  if (cursor.batch) {
+    // merged_ may still point into it
+    retired_.push_back(std::move(*cursor.batch));
+    cursor.batch.reset();
+  }
+
+  while (true) {
+    // read the flag first: once finished, the last batches are still queued
+    const bool is_finished = cursor.buffer->is_finished();
+    if (auto batch = cursor.buffer->next_batch()) {
+      if (!batch->packets.empty()) {
+        cursor.batch = std::move(batch);
+        cursor.next = 0;
+        return true;
+      }
+      continue;
+    }
+    if (is_finished) {
+      close(cursor);
+      return false;
+    }
+    metrics::ScopedTimer stall_timer(metrics::Counter::ConsumerStallNs);
+    std::this_thread::sleep_for(
+        std::chrono::microseconds(CONSUMER_BUFFERING_TIME));
+  }
+}
+
+void PCAPMerger::push(HeapEntry entry) {
+  heap_.push_back(entry);
+  std::push_heap(heap_.begin(), heap_.end(), std::greater<>{});
+}
+
+PCAPMerger::HeapEntry PCAPMerger::pop() {
+  std::pop_heap(heap_.begin(), heap_.end(), std::greater<>{});
+  const auto entry = heap_.back();
+  heap_.pop_back();
+  return entry;
+}
+
+}  // namespace task::processors
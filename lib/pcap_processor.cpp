@@ -1,94 +1,46 @@
 #include "processors/pcap_processor.h"
 
-namespace task::processors {
-
-PCAPProcessor::PCAPProcessor(std::string path,
-                             const simba::decoder::MessageHandlers &handlers)
-    : decoder(handlers) {
-  std::filesystem::path reference{std::move(path)};
-
-  pcap_file_ =
-      std::ifstream(reference.string(), std::ios::binary | std::ios::ate);
-
-  if (!pcap_file_)
-    throw std::runtime_error(reference.string() + ": " + std::strerror(errno));
-
-  auto end = pcap_file_.tellg();
-  std::cout << "FILE NAME > " << reference.string() << std::endl;
-  std::cout << "FILE SIZE > " << end << " bytes " << std::endl;
-
-  pcap_file_.seekg(0, std::ios::beg);
-
-  file_size_ = std::size_t(end - pcap_file_.tellg());
-  if (file_size_ == 0)
-    throw std::runtime_error(ErrorMessage::ERROR_MSG_ZERO_SIZE.data());
-
-  process_header();
-  pcap_file_.seekg(HEADER_SIZE);
-
-  // start to produce data
-  pcap_buffer_ = std::make_unique<mt_buffer::PCAPBuffer>(pcap_file_, file_size_,
-                                                         HEADER_SIZE);
-
-  consumer_thread_ = std::thread([this]() {
-    std::cout << "Starting consumer thread: " << std::this_thread::get_id()
-              << std::endl;
-
-    pcap_buffer_->wait_started();
-    size_t total_number_packets = 0;
+#include "processors/capture_processor.h"
+#include "processors/capture_sources.h"
+#include "processors/pcap_merger.h"
 
-    // decoder handler, calls the decode message when seeing an UDP packet
-    std::invocable<std::span<const std::byte>> auto handler =
-        [this](std::span<const std::byte> udp_payload) {
-          decoder.decode_message(udp_payload);
-        };
-
-    PacketProcessor processor(handler);
-    while (pcap_buffer_->is_started()) {
-      total_number_packets += process_batch(processor);
-      std::this_thread::sleep_for(
-          std::chrono::microseconds(CONSUMER_BUFFERING_TIME));
-    }
-    print_end_of_file_info(total_number_packets);
-  });
-
-  pcap_buffer_->start_buffering();
+namespace task::processors {
 
-  pcap_buffer_->thread().join();
-  consumer_thread_.join();
+namespace {
+template <PacketSource Source>
+void decode_capture(Source &source,
+                    const simba::decoder::MessageHandlers &handlers,
+                    const std::vector<FeedRoute> &feeds,
+                    transport_layer::ValidationConfig validation) {
+  CaptureProcessor processor(source, handlers, feeds, validation);
+  processor.start();
+  processor.run();
+  processor.stop();
 }
+}  // namespace
 
-void PCAPProcessor::process_header() {
-  std::vector<std::byte> global_header(HEADER_SIZE);
-
-  if (!pcap_file_.read((char *)global_header.data(), HEADER_SIZE))
-    throw std::runtime_error(
-        ErrorMessage::ERROR_CANNOT_READ_PCAP_HEADER.data());
-
-  pcap::types::pcap_hdr_t header;
-  std::memcpy(&header, global_header.data(), global_header.size());
-
-  std::cout << "########## PCAP HEADER #############" << std::endl;
-  std::cout << "magic number: " << std::hex << header.magic_number << std::endl;
-
-  if (header.magic_number != PCAP_REFERENCE_MAGIC_NUMBER) {
-    std::cout << "WARNING: the tool has been tested with files produced with "
-                 "magic number: 0xA1B23C4D";
-    exit(1);
+PCAPProcessor::PCAPProcessor(std::string path,
+                             const simba::decoder::MessageHandlers &handlers,
+                             const std::vector<FeedRoute> &feeds,
+                             transport_layer::ValidationConfig validation)
+    : PCAPProcessor(std::vector<std::string>{std::move(path)}, handlers,
+                    feeds, validation) {}
+
+PCAPProcessor::PCAPProcessor(const std::vector<std::string> &inputs,
+                             const simba::decoder::MessageHandlers &handlers,
+                             const std::vector<FeedRoute> &feeds,
+                             transport_layer::ValidationConfig validation) {
+  const auto files = list_captures(inputs);
+  if (files.size() > 1) {
+    MergedSource source(files);
+    decode_capture(source, handlers, feeds, validation);
+  } else if (CompressedFileSource::is_compressed(files.front())) {
+    CompressedFileSource source(files.front());
+    decode_capture(source, handlers, feeds, validation);
+  } else {
+    FileSource source(files.front());
+    decode_capture(source, handlers, feeds, validation);
   }
-  std::cout << "version major: " << std::hex << header.version_major
-            << std::endl;
-  std::cout << "version minor: " << std::hex << header.version_minor
-            << std::endl;
-  std::cout << "####################################" << std::endl;
 }
 
-void PCAPProcessor::print_end_of_file_info(size_t total_packets_number) {
-  std::cout << log_prefix_ << "- Finished to process file " << std::endl;
-  std::cout << log_prefix_ << "- Total number packets of packets processed: "
-            << total_packets_number << std::endl;
-}
-
-PCAPProcessor::~PCAPProcessor() { pcap_buffer_->stop(); }
-
-}  // namespace task::processors
\ No newline at end of file
+}  // namespace task::processors
@@ -0,0 +1,136 @@
+#include "processors/raw_socket_source.h"
+
+#include <arpa/inet.h>
+#include <linux/if_packet.h>
+#include <net/ethernet.h>
+#include <net/if.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+
+#include "logging/logger.h"
+#include "metrics/metrics.h"
+
+namespace task::processors::live {
+
+namespace {
+[[noreturn]] void throw_socket_error(const std::string &operation) {
+  throw std::runtime_error(operation + ": " + std::strerror(errno));
+}
+}  // namespace
+
+RawSocketSource::RawSocketSource(const std::string &interface_name,
+                                 size_t batch_size) {
+  const unsigned interface_index = ::if_nametoindex(interface_name.c_str());
+  if (interface_index == 0) {
+    throw_socket_error("interface " + interface_name);
+  }
+  socket_ = ::socket(AF_PACKET, SOCK_RAW | SOCK_CLOEXEC, htons(ETH_P_ALL));
+  if (socket_ < 0) {
+    throw_socket_error("AF_PACKET socket");
+  }
+
+  sockaddr_ll address{};
+  address.sll_family = AF_PACKET;
+  address.sll_protocol = htons(ETH_P_ALL);
+  address.sll_ifindex = static_cast<int>(interface_index);
+  if (::bind(socket_, reinterpret_cast<const sockaddr *>(&address),
+             sizeof(address)) < 0) {
+    ::close(socket_);
+    throw_socket_error("bind " + interface_name);
+  }
+  // the multicast groups nobody joined on this host are filtered by the NIC
+  packet_mreq membership{};
+  membership.mr_ifindex = static_cast<int>(interface_index);
+  membership.mr_type = PACKET_MR_ALLMULTI;
+  if (::setsockopt(socket_, SOL_PACKET, PACKET_ADD_MEMBERSHIP, &membership,
+                   sizeof(membership)) < 0) {
+    logging::log(logging::Level::Warning, "{} cannot enable ALLMULTI: {}",
+                 log_prefix_, std::strerror(errno));
+  }
+
+  // Preallocate the frames and the recvmmsg descriptors once
+  frames_.resize(batch_size * MAX_FRAME_SIZE);
+  iovecs_.resize(batch_size);
+  messages_.resize(batch_size);
+  addresses_.resize(batch_size);
+  for (size_t slot = 0; slot < batch_size; ++slot) {
+    iovecs_[slot].iov_base = frames_.data() + slot * MAX_FRAME_SIZE;
+    iovecs_[slot].iov_len = MAX_FRAME_SIZE;
+  }
+  packets_.reserve(batch_size);
+  headers_.reserve(batch_size);
+  logging::log(logging::Level::Info, "{} capturing on {}", log_prefix_,
+               interface_name);
+}
+
+RawSocketSource::~RawSocketSource() { ::close(socket_); }
+
+std::optional<PacketBatch> RawSocketSource::next_batch() {
+  if (is_finished()) {
+    return std::nullopt;
+  }
+  size_t frames = receive();
+  if (frames == 0) {
+    pollfd readable{socket_, POLLIN, 0};
+    if (::poll(&readable, 1, POLL_TIMEOUT_MS) <= 0) {
+      return std::nullopt;
+    }
+    frames = receive();
+  }
+
+  const auto now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                       std::chrono::system_clock::now().time_since_epoch())
+                       .count();
+  packets_.clear();
+  headers_.clear();
+  for (size_t index = 0; index < frames; ++index) {
+    // our own transmissions show up too
+    if (addresses_[index].sll_pkttype == PACKET_OUTGOING) {
+      continue;
+    }
+    const uint32_t length = messages_[index].msg_len;
+    const uint32_t captured = std::min<uint32_t>(length, MAX_FRAME_SIZE);
+    frames_truncated_ += captured < length;
+    packets_.emplace_back(frames_.data() + index * MAX_FRAME_SIZE, captured);
+    headers_.push_back({static_cast<uint32_t>(now / 1'000'000'000),
+                        static_cast<uint32_t>(now % 1'000'000'000), captured,
+                        length});
+  }
+  if (packets_.empty()) {
+    return std::nullopt;
+  }
+  metrics::add(metrics::Counter::PacketsFramed, packets_.size());
+  return PacketBatch{packets_, headers_};
+}
+
+size_t RawSocketSource::receive() {
+  for (size_t slot = 0; slot < messages_.size(); ++slot) {
+    auto &header = messages_[slot].msg_hdr;
+    header = {};
+    header.msg_name = &addresses_[slot];
+    header.msg_namelen = sizeof(sockaddr_ll);
+    header.msg_iov = &iovecs_[slot];
+    header.msg_iovlen = 1;
+  }
+  // MSG_TRUNC: msg_len is the length on the wire, even when cut
+  const int received =
+      ::recvmmsg(socket_, messages_.data(),
+                 static_cast<unsigned>(messages_.size()),
+                 MSG_DONTWAIT | MSG_TRUNC, nullptr);
+  if (received < 0) {
+    if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+      logging::log(logging::Level::Error, "{} recvmmsg failed: {}",
+                   log_prefix_, std::strerror(errno));
+    }
+    return 0;
+  }
+  return static_cast<size_t>(received);
+}
+
+}  // namespace task::processors::live
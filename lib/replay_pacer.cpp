@@ -0,0 +1,42 @@
+#include "processors/replay_pacer.h"
+
+#include <time.h>
+
+namespace task::processors::live {
+
+uint64_t ReplayPacer::deadline(uint64_t capture_ns) {
+  if (!first_capture_ns_) {
+    first_capture_ns_ = capture_ns;
+    start_ns_ = now();
+  }
+  if (!is_paced() || capture_ns <= *first_capture_ns_) {
+    return start_ns_;
+  }
+  const double offset_ns =
+      static_cast<double>(capture_ns - *first_capture_ns_) / speed_;
+  return start_ns_ + static_cast<uint64_t>(offset_ns);
+}
+
+uint64_t ReplayPacer::wait_until(uint64_t deadline_ns) const {
+  uint64_t current_ns = now();
+  if (current_ns + SPIN_THRESHOLD_NS < deadline_ns) {
+    const uint64_t wake_up_ns = deadline_ns - SPIN_THRESHOLD_NS;
+    const timespec wake_up{static_cast<time_t>(wake_up_ns / 1'000'000'000),
+                           static_cast<long>(wake_up_ns % 1'000'000'000)};
+    ::clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &wake_up, nullptr);
+    current_ns = now();
+  }
+  while (current_ns < deadline_ns) {
+    current_ns = now();
+  }
+  return current_ns - deadline_ns;
+}
+
+uint64_t ReplayPacer::now() noexcept {
+  timespec time{};
+  ::clock_gettime(CLOCK_MONOTONIC, &time);
+  return static_cast<uint64_t>(time.tv_sec) * 1'000'000'000 +
+         static_cast<uint64_t>(time.tv_nsec);
+}
+
+}  // namespace task::processors::live
@@ -0,0 +1,202 @@
+#include "market_data/shared_book.h"
+
+#include <cstring>
+#include <new>
+#include <stdexcept>
+
+namespace task::market_data {
+
+namespace {
+constexpr size_t CACHE_LINE = 64;
+
+size_t checked_capacity(size_t capacity) {
+  if (capacity == 0 || capacity >= UINT32_MAX) {
+    throw std::runtime_error("Invalid capacity of the shared book");
+  }
+  return capacity;
+}
+
+// the levels of both sides, rounded up to the cache line
+size_t slot_size(size_t depth) {
+  const size_t bytes = sizeof(SharedBookSlot) + 2 * depth * sizeof(PriceLevel);
+  return (bytes + CACHE_LINE - 1) / CACHE_LINE * CACHE_LINE;
+}
+
+const PriceLevel *levels_of(const SharedBookSlot *slot) noexcept {
+  return reinterpret_cast<const PriceLevel *>(slot + 1);
+}
+}  // namespace
+
+SharedBookPublisher::SharedBookPublisher(const std::string &name,
+                                         size_t depth, size_t capacity,
+                                         bool conflate)
+    : book_(
+          depth, [this](const DepthUpdate &update) { on_depth(update); },
+          MarketByPrice::DEFAULT_WINDOW, conflate),
+      depth_(depth),
+      capacity_(checked_capacity(capacity)),
+      slot_size_(slot_size(depth)),
+      segment_(SharedMemory::create(
+          name, sizeof(SharedBookHeader) + capacity_ * slot_size_)),
+      header_(new (segment_.data()) SharedBookHeader{}) {
+  header_->depth = static_cast<uint32_t>(depth_);
+  header_->capacity = static_cast<uint32_t>(capacity_);
+  header_->slot_size = static_cast<uint32_t>(slot_size_);
+  for (size_t index = 0; index < capacity_; ++index) {
+    new (slot(index)) SharedBookSlot{};
+  }
+  // the readers check the magic last
+  header_->magic.store(SHARED_BOOK_MAGIC, std::memory_order_release);
+}
+
+void SharedBookPublisher::on_order_update(
+    simba::types::OrderUpdateView update, uint64_t time_ns) {
+  book_.on_order_update(update, time_ns);
+  commit();
+}
+
+void SharedBookPublisher::on_order_execution(
+    simba::types::OrderExecutionView execution, uint64_t time_ns) {
+  book_.on_order_execution(execution, time_ns);
+  commit();
+}
+
+void SharedBookPublisher::flush() {
+  book_.flush();
+  commit();
+}
+
+bool SharedBookPublisher::remove(const std::string &name) {
+  return SharedMemory::remove(name);
+}
+
+void SharedBookPublisher::on_depth(const DepthUpdate &update) {
+  const auto [entry, inserted] = slots_.try_emplace(update.security_id,
+                                                    NO_SLOT);
+  if (inserted) {
+    if (staged_.size() == capacity_) {
+      ++dropped_instruments_;
+    } else {
+      entry->second = static_cast<uint32_t>(staged_.size());
+      auto &staged = staged_.emplace_back();
+      staged.security_id = update.security_id;
+      staged.bids.resize(depth_);
+      staged.offers.resize(depth_);
+    }
+  }
+  if (entry->second == NO_SLOT) {
+    return;
+  }
+
+  auto &staged = staged_[entry->second];
+  auto &levels = update.side == MDEntryType::Bid ? staged.bids : staged.offers;
+  levels[update.depth] = {update.price, update.volume, update.orders};
+  staged.time_ns = update.time_ns;
+  if (!staged.changed) {
+    staged.changed = true;
+    changed_.push_back(entry->second);
+  }
+}
+
+void SharedBookPublisher::commit() {
+  for (const auto index : changed_) {
+    auto &staged = staged_[index];
+    staged.changed = false;
+
+    // the seqlock: odd while written, the readers of a changed sequence
+    // retry, so the plain stores below are never seen half done
+    auto *shared = slot(index);
+    const uint64_t sequence = shared->sequence.load(std::memory_order_relaxed);
+    shared->sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    shared->time_ns = staged.time_ns;
+    shared->security_id = staged.security_id;
+    auto *levels = reinterpret_cast<PriceLevel *>(shared + 1);
+    std::memcpy(levels, staged.bids.data(), depth_ * sizeof(PriceLevel));
+    std::memcpy(levels + depth_, staged.offers.data(),
+                depth_ * sizeof(PriceLevel));
+    shared->sequence.store(sequence + 2, std::memory_order_release);
+    ++commits_;
+
+    // a new instrument is visible once its slot is written
+    if (index >= header_->instruments.load(std::memory_order_relaxed)) {
+      header_->instruments.store(index + 1, std::memory_order_release);
+    }
+  }
+  changed_.clear();
+}
+
+SharedBookSlot *SharedBookPublisher::slot(size_t index) const noexcept {
+  return reinterpret_cast<SharedBookSlot *>(
+      segment_.data() + sizeof(SharedBookHeader) + index * slot_size_);
+}
+
+SharedBookReader::SharedBookReader(const std::string &name)
+    : segment_(SharedMemory::open(name)),
+      header_(reinterpret_cast<const SharedBookHeader *>(segment_.data())) {
+  const size_t size = segment_.size();
+  const size_t slot_size =
+      size < sizeof(SharedBookHeader) ? 0 : header_->slot_size;
+  const bool valid =
+      slot_size != 0 &&
+      header_->magic.load(std::memory_order_acquire) == SHARED_BOOK_MAGIC &&
+      header_->layout == SHARED_BOOK_LAYOUT && slot_size % CACHE_LINE == 0 &&
+      slot_size >= sizeof(SharedBookSlot) +
+                       2 * size_t{header_->depth} * sizeof(PriceLevel) &&
+      size >= sizeof(SharedBookHeader) + header_->capacity * slot_size;
+  if (!valid) {
+    throw std::runtime_error(segment_.path() + ": not a shared book");
+  }
+}
+
+std::optional<size_t> SharedBookReader::find(int32_t security_id) {
+  auto found = slots_.find(security_id);
+  if (found == slots_.end()) {
+    // the slots published since the last scan
+    const size_t published = instruments();
+    for (; scanned_ < published; ++scanned_) {
+      slots_.emplace(slot(scanned_)->security_id, scanned_);
+    }
+    found = slots_.find(security_id);
+    if (found == slots_.end()) {
+      return std::nullopt;
+    }
+  }
+  return found->second;
+}
+
+bool SharedBookReader::read(size_t index,
+                            SharedBookSnapshot &snapshot) const {
+  if (index >= instruments()) {
+    return false;
+  }
+  const size_t depth = header_->depth;
+  snapshot.bids.resize(depth);
+  snapshot.offers.resize(depth);
+  const auto *shared = slot(index);
+  for (size_t retry = 0; retry < MAX_RETRIES; ++retry) {
+    const uint64_t before = shared->sequence.load(std::memory_order_acquire);
+    if (before % 2 != 0) {
+      continue;
+    }
+    snapshot.security_id = shared->security_id;
+    snapshot.time_ns = shared->time_ns;
+    std::memcpy(snapshot.bids.data(), levels_of(shared),
+                depth * sizeof(PriceLevel));
+    std::memcpy(snapshot.offers.data(), levels_of(shared) + depth,
+                depth * sizeof(PriceLevel));
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (shared->sequence.load(std::memory_order_relaxed) == before) {
+      snapshot.version = before / 2;
+      return true;
+    }
+  }
+  return false;
+}
+
+const SharedBookSlot *SharedBookReader::slot(size_t index) const noexcept {
+  return reinterpret_cast<const SharedBookSlot *>(
+      segment_.data() + sizeof(SharedBookHeader) + index * header_->slot_size);
+}
+
+}  // namespace task::market_data
@@ -0,0 +1,125 @@
+#include "market_data/shared_bus.h"
+
+#include <bit>
+#include <new>
+#include <stdexcept>
+
+namespace task::market_data {
+
+namespace {
+static_assert(sizeof(simba::types::OrderUpdate) <= sizeof(BusEvent::message));
+static_assert(sizeof(simba::types::OrderExecution) <=
+              sizeof(BusEvent::message));
+
+size_t checked_capacity(size_t capacity) {
+  if (capacity > UINT32_MAX || !std::has_single_bit(capacity)) {
+    throw std::runtime_error("Invalid capacity of the shared bus");
+  }
+  return capacity;
+}
+}  // namespace
+
+SharedBusWriter::SharedBusWriter(const std::string &name, size_t capacity)
+    : segment_(SharedMemory::create(
+          name, sizeof(SharedBusHeader) +
+                    checked_capacity(capacity) * sizeof(SharedBusSlot))),
+      header_(new (segment_.data()) SharedBusHeader{}),
+      slots_(reinterpret_cast<SharedBusSlot *>(header_ + 1)),
+      mask_(capacity - 1) {
+  header_->capacity = static_cast<uint32_t>(capacity);
+  for (size_t index = 0; index < capacity; ++index) {
+    new (slots_ + index) SharedBusSlot{};
+  }
+  // the readers check the magic last
+  header_->magic.store(SHARED_BUS_MAGIC, std::memory_order_release);
+}
+
+void SharedBusWriter::publish(simba::types::OrderUpdateView update,
+                              uint64_t capture_time_ns,
+                              uint64_t transact_time_ns) {
+  publish(update.to_message(), capture_time_ns, transact_time_ns);
+}
+
+void SharedBusWriter::publish(simba::types::OrderExecutionView execution,
+                              uint64_t capture_time_ns,
+                              uint64_t transact_time_ns) {
+  publish(execution.to_message(), capture_time_ns, transact_time_ns);
+}
+
+bool SharedBusWriter::remove(const std::string &name) {
+  return SharedMemory::remove(name);
+}
+
+template <typename Message>
+void SharedBusWriter::publish(const Message &message,
+                              uint64_t capture_time_ns,
+                              uint64_t transact_time_ns) {
+  auto &slot = slots_[next_ & mask_];
+  // odd while written: a reader of the previous lap sees the slot taken
+  slot.state.store(2 * next_ + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  slot.event.capture_time_ns = capture_time_ns;
+  slot.event.transact_time_ns = transact_time_ns;
+  slot.event.template_id = Message::TEMPLATE_ID;
+  slot.event.length = sizeof(Message);
+  std::memcpy(slot.event.message, &message, sizeof(Message));
+  slot.state.store(2 * next_ + 2, std::memory_order_release);
+  ++next_;
+  header_->published.store(next_, std::memory_order_release);
+}
+
+SharedBusReader::SharedBusReader(const std::string &name, bool replay)
+    : segment_(SharedMemory::open(name)),
+      header_(reinterpret_cast<const SharedBusHeader *>(segment_.data())),
+      slots_(reinterpret_cast<const SharedBusSlot *>(header_ + 1)),
+      capacity_(segment_.size() < sizeof(SharedBusHeader)
+                    ? 0
+                    : header_->capacity) {
+  const bool valid =
+      capacity_ != 0 && std::has_single_bit(capacity_) &&
+      header_->magic.load(std::memory_order_acquire) == SHARED_BUS_MAGIC &&
+      header_->layout == SHARED_BUS_LAYOUT &&
+      segment_.size() >=
+          sizeof(SharedBusHeader) + capacity_ * sizeof(SharedBusSlot);
+  if (!valid) {
+    throw std::runtime_error(segment_.path() + ": not a shared bus");
+  }
+  cursor_ = header_->published.load(std::memory_order_acquire);
+  if (replay) {
+    cursor_ = cursor_ > capacity_ ? cursor_ - capacity_ : 0;
+  }
+}
+
+std::optional<uint64_t> SharedBusReader::poll(BusEvent &event) {
+  for (;;) {
+    const auto &slot = slots_[cursor_ & (capacity_ - 1)];
+    const uint64_t written = 2 * cursor_ + 2;
+    const uint64_t state = slot.state.load(std::memory_order_acquire);
+    if (state < written) {
+      return std::nullopt;
+    }
+    if (state == written) {
+      event = slot.event;
+      std::atomic_thread_fence(std::memory_order_acquire);
+      const uint64_t after = slot.state.load(std::memory_order_relaxed);
+      if (after == written) {
+        return cursor_++;
+      }
+      skip_overwritten(after);
+    } else {
+      skip_overwritten(state);
+    }
+  }
+}
+
+void SharedBusReader::skip_overwritten(uint64_t state) {
+  // the slot holds, or is taking, the event (state - 1) / 2: the events of a
+  // lap before are gone
+  const uint64_t oldest = (state - 1) / 2 - capacity_ + 1;
+  if (oldest > cursor_) {
+    lost_ += oldest - cursor_;
+    cursor_ = oldest;
+  }
+}
+
+}  // namespace task::market_data
@@ -0,0 +1,95 @@
+#include "market_data/shared_memory.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+namespace task::market_data {
+
+namespace {
+// shm_open wants a single leading slash
+std::string segment_path(const std::string &name) {
+  return name.starts_with('/') ? name : '/' + name;
+}
+}  // namespace
+
+SharedMemory SharedMemory::create(const std::string &name, size_t size) {
+  // a new segment: the readers of a previous one keep their mapping
+  auto path = segment_path(name);
+  ::shm_unlink(path.c_str());
+  const int descriptor =
+      ::shm_open(path.c_str(), O_CREAT | O_EXCL | O_RDWR | O_CLOEXEC, 0644);
+  if (descriptor < 0) {
+    throw std::runtime_error(path + ": " + std::strerror(errno));
+  }
+  if (::ftruncate(descriptor, static_cast<off_t>(size)) < 0) {
+    const std::string error = std::strerror(errno);
+    ::close(descriptor);
+    ::shm_unlink(path.c_str());
+    throw std::runtime_error(path + ": " + error);
+  }
+  void *mapping = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED,
+                         descriptor, 0);
+  ::close(descriptor);
+  if (mapping == MAP_FAILED) {
+    const std::string error = std::strerror(errno);
+    ::shm_unlink(path.c_str());
+    throw std::runtime_error(path + ": " + error);
+  }
+  return {std::move(path), static_cast<std::byte *>(mapping), size};
+}
+
+SharedMemory SharedMemory::open(const std::string &name) {
+  auto path = segment_path(name);
+  const int descriptor = ::shm_open(path.c_str(), O_RDONLY | O_CLOEXEC, 0);
+  if (descriptor < 0) {
+    throw std::runtime_error(path + ": " + std::strerror(errno));
+  }
+  struct stat status {};
+  if (::fstat(descriptor, &status) < 0 || status.st_size == 0) {
+    ::close(descriptor);
+    throw std::runtime_error(path + ": empty segment");
+  }
+  const auto size = static_cast<size_t>(status.st_size);
+  void *mapping = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, descriptor, 0);
+  ::close(descriptor);
+  if (mapping == MAP_FAILED) {
+    throw std::runtime_error(path + ": " + std::strerror(errno));
+  }
+  return {std::move(path), static_cast<std::byte *>(mapping), size};
+}
+
+bool SharedMemory::remove(const std::string &name) {
+  return ::shm_unlink(segment_path(name).c_str()) == 0;
+}
+
+SharedMemory::SharedMemory(SharedMemory &&other) noexcept
+    : path_(std::move(other.path_)),
+      data_(std::exchange(other.data_, nullptr)),
+      size_(std::exchange(other.size_, 0)) {}
+
+SharedMemory &SharedMemory::operator=(SharedMemory &&other) noexcept {
+  if (this != &other) {
+    if (data_ != nullptr) {
+      ::munmap(data_, size_);
+    }
+    path_ = std::move(other.path_);
+    data_ = std::exchange(other.data_, nullptr);
+    size_ = std::exchange(other.size_, 0);
+  }
+  return *this;
+}
+
+SharedMemory::~SharedMemory() {
+  if (data_ != nullptr) {
+    ::munmap(data_, size_);
+  }
+}
+
+}  // namespace task::market_data
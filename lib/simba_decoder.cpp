@@ -2,129 +2,205 @@
 
 namespace task::simba::decoder {
 
-void SIMBADecoder::decode_message(std::span<const std::byte> udp_payload) {
+bool SIMBADecoder::decode_message(std::span<const std::byte> udp_payload) {
+  if (arbitrate_ && is_duplicate(udp_payload)) {
+    ++duplicate_packets_;
+    return false;
+  }
+  const auto first_message = packet_headers(udp_payload);
+  const size_t message_size = market_update_header_.message_size;
+  if (!first_message ||
+      (*first_message < message_size &&
+       *first_message + sizeof(sbe_header_) > message_size)) {
+    ++malformed_packets_;
+    metrics::add(metrics::Counter::MalformedPackets);
+    return false;
+  }
+
+  if (*first_message < message_size) {
+    std::memcpy(&sbe_header_, udp_payload.data() + *first_message,
+                sizeof(sbe_header_));
+  } else {
+    // a packet without messages, any version decodes its headers
+    sbe_header_ = types::SBEHeader{.schema_id = types::SCHEMA_ID,
+                                   .version = types::SCHEMA_VERSION};
+  }
+
+  // the layout of the schema version is selected once per packet, the
+  // messages are then decoded by the instance of that layout
+  bool decoded = false;
+  const bool supported = types::visit_version(
+      sbe_header_.schema_id, sbe_header_.version, [&](auto layout) {
+        decoded = decode_messages<decltype(layout)::value>(udp_payload,
+                                                           *first_message);
+      });
+  if (!supported) {
+    ++unsupported_packets_;
+    metrics::add(metrics::Counter::UnsupportedSchemas);
+    return false;
+  }
+  return decoded;
+}
+
+std::optional<size_t> SIMBADecoder::packet_headers(
+    std::span<const std::byte> udp_payload) {
+  const size_t payload_size = udp_payload.size();
+  if (payload_size < sizeof(market_update_header_)) {
+    return std::nullopt;
+  }
+
+  std::memcpy(&market_update_header_, udp_payload.data(),
+              sizeof(market_update_header_));
+  const size_t message_size = market_update_header_.message_size;
+  if (message_size > payload_size) {
+    return std::nullopt;
+  }
+
+  size_t offset = sizeof(market_update_header_);
+  if (market_update_header_.message_flags & INCREMENTAL_PACKET_FLAG) {
+    offset += sizeof(types::IncrementalPacketHeader);
+  }
+  if (offset > message_size) {
+    return std::nullopt;
+  }
+  return offset;
+}
+
+bool SIMBADecoder::is_duplicate(
+    std::span<const std::byte> udp_payload) const noexcept {
+  types::MarketDataPacketHeader header;
+  if (last_sequence_number_ == 0 || udp_payload.size() < sizeof(header)) {
+    return false;
+  }
+  std::memcpy(&header, udp_payload.data(), sizeof(header));
+  // snapshot packets are not arbitrated: they repeat in cycles, and a copy
+  // only restates the book. A sequence far behind the last one restarted
+  // (e.g. a new session) rather than lagging on the other channel.
+  return (header.message_flags & INCREMENTAL_PACKET_FLAG) != 0 &&
+         header.sequence_number <= last_sequence_number_ &&
+         last_sequence_number_ - header.sequence_number <= MAX_CHANNEL_LAG;
+}
+
+template <uint16_t Version>
+bool SIMBADecoder::decode_messages(std::span<const std::byte> udp_payload,
+                                   size_t offset) {
   constexpr auto INCREMENTAL_HEADER_SIZE{
       sizeof(types::IncrementalPacketHeader)};
 
-  // Reset decoder offset
-  current_offset_ = 0;
+  // the SBE header of the first message, the one of the layout
+  const types::SBEHeader packet_sbe_header = sbe_header_;
+  const auto validated_size = validate<Version>(udp_payload, offset);
+  if (!validated_size) {
+    ++malformed_packets_;
+    metrics::add(metrics::Counter::MalformedPackets);
+    return false;
+  }
 
-  // Read the MarketPacketHeader
-  auto span_market_header =
-      udp_payload.subspan(0, sizeof(market_update_header_));
-  std::memcpy(&market_update_header_, span_market_header.data(),
-              span_market_header.size());
-  current_offset_ += span_market_header.size();
+  // From here on every read lies within the validated bytes
+  const std::byte *payload = udp_payload.data();
+  const size_t end = *validated_size;
+  current_offset_ = sizeof(market_update_header_);
 
   if constexpr (ENABLE_DEBUGGING) {
     std::cout << market_update_header_.to_string() << std::endl;
   }
 
   // Read the IncrementalPacketHeader if available
-  if (market_update_header_.message_flags & 0x8) {
+  incremental_header_.reset();
+  if (market_update_header_.message_flags & INCREMENTAL_PACKET_FLAG) {
     types::IncrementalPacketHeader inc_header;
-    auto span_incremental_header =
-        udp_payload.subspan(current_offset_, INCREMENTAL_HEADER_SIZE);
+    std::memcpy(&inc_header, payload + current_offset_,
+                INCREMENTAL_HEADER_SIZE);
     current_offset_ += INCREMENTAL_HEADER_SIZE;
-    std::memcpy(&inc_header, span_incremental_header.data(),
-                span_incremental_header.size());
-    incremental_header = inc_header;
+    incremental_header_ = inc_header;
+    // only a valid packet is the one of its sequence number: a corrupt copy
+    // leaves the intact one of the other channel to the arbitration
+    last_sequence_number_ = market_update_header_.sequence_number;
 
     if constexpr (ENABLE_DEBUGGING) {
-      std::cout << incremental_header->to_string() << std::endl;
+      std::cout << incremental_header_->to_string() << std::endl;
     }
   }
 
   // Reading the SBE Header
-  bool to_be_skipped{
-      false};  // We skip the messages that are not of our interest
-  while (current_offset_ < market_update_header_.message_size &&
-         !to_be_skipped) {
-    auto sbe_header_span =
-        udp_payload.subspan(current_offset_, sizeof(sbe_header_));
-    std::memcpy(&sbe_header_, sbe_header_span.data(), sbe_header_span.size());
+  while (current_offset_ < end) {
+    std::memcpy(&sbe_header_, payload + current_offset_, sizeof(sbe_header_));
     if constexpr (ENABLE_DEBUGGING) {
       std::cout << sbe_header_.to_string() << std::endl;
     }
     current_offset_ += sizeof(sbe_header_);
 
-    auto template_type = from_id_to_type(sbe_header_.template_id);
-
-    switch (template_type) {
-      case types::Messages::OrderUpdateType: {
-        current_offset_ += handle_order_update(sbe_header_, udp_payload);
-        break;
-      }
-      case types::Messages::OrderExecutionType: {
-        current_offset_ += handle_order_execution(sbe_header_, udp_payload);
-        break;
-      }
-      case types::Messages::OrderBookSnapshotType: {
-        handle_order_book_snapshot(udp_payload);
-        break;
-      }
-      default:
-        to_be_skipped = true;
-        break;
-    }
+    metrics::add_message(sbe_header_.template_id);
+    types::visit_message<Version>(
+        sbe_header_.template_id, payload + current_offset_,
+        sbe_header_.block_length, [this](auto message) {
+          if constexpr (std::is_same_v<decltype(message),
+                                       types::OrderBookSnapshotView>) {
+            metrics::add(metrics::Counter::SnapshotEntries,
+                         message.no_md_entries().size());
+          } else if constexpr (std::is_same_v<decltype(message),
+                                              types::SequenceResetView>) {
+            // the next packet carries NewSeqNo
+            last_sequence_number_ =
+                message.new_seq_no() > 0 ? message.new_seq_no() - 1 : 0;
+          }
+          // the groups are read in place by the handler, if any
+          message_handlers_(message);
+          current_offset_ += message.size_bytes();
+        });
   }
-}
-
-[[nodiscard]] size_t SIMBADecoder::handle_order_update(
-    const types::SBEHeader &sbe_header,
-    std::span<const std::byte> udp_payload) {
-  auto message_span =
-      udp_payload.subspan(current_offset_, sbe_header.block_length);
-  types::OrderUpdate order_update;
-  std::memcpy(&order_update, message_span.data(), message_span.size());
-  if (message_handlers_.order_update_handler) {
-    message_handlers_.order_update_handler(order_update);
-  }
-
-  return sizeof(types::OrderUpdate);
-}
 
-[[nodiscard]] size_t SIMBADecoder::handle_order_execution(
-    const types::SBEHeader &sbe_header,
-    std::span<const std::byte> udp_payload) {
-  auto message_span =
-      udp_payload.subspan(current_offset_, sbe_header.block_length);
-  types::OrderExecution order_execution;
-  std::memcpy(&order_execution, message_span.data(), message_span.size());
-  if (message_handlers_.order_execution_handler) {
-    message_handlers_.order_execution_handler(order_execution);
+  // validate() stops right before the first message it cannot size: the
+  // rest of the packet is lost, counted by its cause
+  if (end < market_update_header_.message_size) {
+    types::SBEHeader next_header;
+    std::memcpy(&next_header, payload + end, sizeof(next_header));
+    if (next_header.schema_id != packet_sbe_header.schema_id ||
+        next_header.version != packet_sbe_header.version) {
+      ++unsupported_packets_;
+      metrics::add(metrics::Counter::UnsupportedSchemas);
+    } else {
+      metrics::add(metrics::Counter::UnknownTemplates);
+    }
   }
-  return sizeof(types::OrderExecution);
+  return true;
 }
 
-void SIMBADecoder::handle_order_book_snapshot(
-    std::span<const std::byte> udp_payload) {
-  auto message_span =
-      udp_payload.subspan(current_offset_, sbe_header_.block_length);
-  types::OrderBookSnapshotHeader order_book_snapshot_header;
-  std::memcpy(&order_book_snapshot_header, message_span.data(),
-              message_span.size() + sizeof(types::GroupSize));
-  current_offset_ += message_span.size() + sizeof(types::GroupSize);
-  const auto num_in_group = order_book_snapshot_header.group_size.num_in_group;
-  std::vector<types::OrderBookEntry> book_entries(num_in_group);
-  size_t entry_nr = 0;
-
-  types::OrderBookSnapshot snapshot(order_book_snapshot_header);
-
-  // Decode each book entry
-  while (entry_nr < num_in_group) {
-    types::OrderBookEntry entry;
-    auto span_entry = udp_payload.subspan(
-        current_offset_, order_book_snapshot_header.group_size.block_size);
-    std::memcpy(&entry, span_entry.data(), span_entry.size());
-    current_offset_ += span_entry.size();
-    snapshot.insert(std::move(entry));
-    ++entry_nr;
-  }
-
-  if (message_handlers_.order_book_snapshot_handler) {
-    message_handlers_.order_book_snapshot_handler(snapshot);
+template <uint16_t Version>
+std::optional<size_t> SIMBADecoder::validate(
+    std::span<const std::byte> udp_payload, size_t offset) const {
+  const size_t message_size = market_update_header_.message_size;
+  types::SBEHeader sbe_header;
+  while (offset < message_size) {
+    if (offset + sizeof(sbe_header) > message_size) {
+      return std::nullopt;
+    }
+    std::memcpy(&sbe_header, udp_payload.data() + offset, sizeof(sbe_header));
+    if (sbe_header.schema_id != sbe_header_.schema_id ||
+        sbe_header.version != sbe_header_.version) {
+      // the layout of this instance is that of the first message only
+      return offset;
+    }
+    const size_t message_offset = offset + sizeof(sbe_header);
+
+    std::optional<size_t> message_bytes;
+    const bool known = types::visit_template<Version>(
+        sbe_header.template_id, [&]<typename View>(std::type_identity<View>) {
+          message_bytes = View::template wire_size<Version>(
+              udp_payload.data() + message_offset, sbe_header.block_length,
+              message_size - message_offset);
+        });
+    if (!known) {
+      // Unknown templates may carry repeating groups, so the rest of the
+      // packet cannot be sized: stop right before this message.
+      return offset;
+    }
+    if (!message_bytes) {
+      return std::nullopt;
+    }
+    offset = message_offset + *message_bytes;
   }
+  return offset;
 }
 
-}  // namespace task::simba::decoder
\ No newline at end of file
+}  // namespace task::simba::decoder
@@ -0,0 +1,51 @@
+#include "processors/udp_endpoint.h"
+
+#include <arpa/inet.h>
+
+#include <charconv>
+#include <stdexcept>
+
+namespace task::processors::live {
+
+Endpoint Endpoint::parse(std::string_view endpoint) {
+  const auto separator = endpoint.rfind(':');
+  if (separator == std::string_view::npos) {
+    throw std::runtime_error("Invalid endpoint, expected address:port - " +
+                             std::string(endpoint));
+  }
+
+  Endpoint parsed{std::string(endpoint.substr(0, separator))};
+  const auto port = endpoint.substr(separator + 1);
+  const auto [end, error] =
+      std::from_chars(port.data(), port.data() + port.size(), parsed.port);
+  if (error != std::errc{} || end != port.data() + port.size()) {
+    throw std::runtime_error("Invalid port in endpoint - " +
+                             std::string(endpoint));
+  }
+
+  // validate the address eagerly
+  (void)to_in_addr(parsed.address);
+  return parsed;
+}
+
+sockaddr_in Endpoint::to_sockaddr() const {
+  sockaddr_in socket_address{};
+  socket_address.sin_family = AF_INET;
+  socket_address.sin_port = htons(port);
+  socket_address.sin_addr = to_in_addr(address);
+  return socket_address;
+}
+
+bool Endpoint::is_multicast() const {
+  return IN_MULTICAST(ntohl(to_in_addr(address).s_addr));
+}
+
+in_addr to_in_addr(const std::string &address) {
+  in_addr converted{};
+  if (inet_pton(AF_INET, address.c_str(), &converted) != 1) {
+    throw std::runtime_error("Invalid IPv4 address - " + address);
+  }
+  return converted;
+}
+
+}  // namespace task::processors::live
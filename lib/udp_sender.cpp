@@ -0,0 +1,117 @@
+#include "processors/udp_sender.h"
+
+#include "logging/logger.h"
+
+#include <netinet/in.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+namespace task::processors::live {
+
+namespace {
+[[noreturn]] void throw_socket_error(const std::string &operation) {
+  throw std::runtime_error(operation + ": " + std::strerror(errno));
+}
+}  // namespace
+
+UDPSender::UDPSender(SenderConfig config) : config_(std::move(config)) {
+  if (config_.destinations.empty()) {
+    throw std::runtime_error("No destination to send to");
+  }
+
+  socket_ = ::socket(AF_INET, SOCK_DGRAM, 0);
+  if (socket_ < 0) {
+    throw_socket_error("socket");
+  }
+
+  const unsigned char ttl = static_cast<unsigned char>(config_.ttl);
+  const unsigned char loopback = config_.multicast_loopback ? 1 : 0;
+  if (::setsockopt(socket_, IPPROTO_IP, IP_MULTICAST_TTL, &ttl,
+                   sizeof(ttl)) < 0 ||
+      ::setsockopt(socket_, IPPROTO_IP, IP_MULTICAST_LOOP, &loopback,
+                   sizeof(loopback)) < 0) {
+    ::close(socket_);
+    throw_socket_error("multicast socket options");
+  }
+  if (!config_.interface_address.empty()) {
+    const in_addr interface = to_in_addr(config_.interface_address);
+    if (::setsockopt(socket_, IPPROTO_IP, IP_MULTICAST_IF, &interface,
+                     sizeof(interface)) < 0) {
+      ::close(socket_);
+      throw_socket_error("IP_MULTICAST_IF");
+    }
+  }
+
+  for (const auto &destination : config_.destinations) {
+    destinations_.push_back(destination.to_sockaddr());
+  }
+
+  // One slot per (payload, destination) pair, the payload is copied once
+  // and its iovec shared by every destination
+  const size_t slots = config_.batch_size * destinations_.size();
+  batch_buffer_.resize(config_.batch_size * config_.max_datagram_size);
+  iovecs_.resize(config_.batch_size);
+  messages_.resize(slots);
+}
+
+UDPSender::~UDPSender() {
+  if (socket_ >= 0) {
+    try {
+      flush();
+    } catch (const std::runtime_error &error) {
+      logging::log(logging::Level::Error, "{} {}", log_prefix_, error.what());
+    }
+    ::close(socket_);
+  }
+}
+
+void UDPSender::send(std::span<const std::byte> payload) {
+  if (payload.size() > config_.max_datagram_size) {
+    throw std::runtime_error("Datagram larger than the sender slots");
+  }
+
+  std::byte *slot = batch_buffer_.data() + queued_ * config_.max_datagram_size;
+  std::memcpy(slot, payload.data(), payload.size());
+  iovecs_[queued_] = iovec{slot, payload.size()};
+
+  for (size_t destination = 0; destination < destinations_.size();
+       ++destination) {
+    auto &header =
+        messages_[queued_ * destinations_.size() + destination].msg_hdr;
+    header = msghdr{};
+    header.msg_name = &destinations_[destination];
+    header.msg_namelen = sizeof(sockaddr_in);
+    header.msg_iov = &iovecs_[queued_];
+    header.msg_iovlen = 1;
+  }
+
+  if (++queued_ == config_.batch_size) {
+    flush();
+  }
+}
+
+void UDPSender::flush() {
+  const size_t total = queued_ * destinations_.size();
+  size_t sent = 0;
+  while (sent < total) {
+    const int result =
+        ::sendmmsg(socket_, messages_.data() + sent, total - sent, 0);
+    if (result < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      throw_socket_error("sendmmsg");
+    }
+    for (size_t index = sent; index < sent + result; ++index) {
+      bytes_sent_ += messages_[index].msg_len;
+    }
+    sent += static_cast<size_t>(result);
+  }
+  datagrams_sent_ += total;
+  queued_ = 0;
+}
+
+}  // namespace task::processors::live
@@ -0,0 +1,254 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+#include "market_data/bar_aggregator.h"
+#include "processors/capture_processor.h"
+#include "processors/capture_sources.h"
+#include "test_vectors.h"
+
+namespace task::tests {
+
+using market_data::Bar;
+using market_data::BarAggregator;
+using market_data::BarConfig;
+using market_data::BarKind;
+using simba::types::Decimal5;
+
+namespace {
+constexpr uint64_t SECOND_NS = 1'000'000'000;
+
+simba::types::OrderExecution make_trade(int32_t security_id, int64_t trade_id,
+                                        int64_t price, int64_t volume) {
+  simba::types::OrderExecution execution;
+  execution.security_id = security_id;
+  execution.trade_id = trade_id;
+  execution.last_px = Decimal5::from_units(price);
+  execution.last_qty = volume;
+  return execution;
+}
+
+void trade(BarAggregator &aggregator,
+           const simba::types::OrderExecution &execution, uint64_t time_ns) {
+  aggregator.on_trade(simba::types::OrderExecutionView{execution}, time_ns);
+}
+}  // namespace
+
+TEST(BarAggregatorTest, GIVEN_captured_executions_WHEN_tick_bars_THEN_ohlcv) {
+  std::vector<Bar> bars;
+  BarAggregator aggregator(BarConfig::parse("tick:3"),
+                           [&bars](const Bar &bar) { bars.push_back(bar); });
+
+  const auto capture = make_pcap_file(
+      {make_udp_frame(TEST_ORDER_UPDATE_DATA),
+       make_udp_frame(TEST_ORDER_EXECUTION_DATA)});
+  processors::MemorySource source(capture);
+  simba::decoder::MessageHandlers handlers;
+  const processors::CaptureProcessor<processors::MemorySource> *clock{nullptr};
+  uint64_t transact_time_ns{0};
+  handlers.order_execution_handler =
+      [&](simba::types::OrderExecutionView execution) {
+        aggregator.on_trade(execution, clock->capture_time_ns());
+        transact_time_ns = clock->transact_time_ns();
+      };
+  processors::CaptureProcessor processor(source, handlers);
+  clock = &processor;
+  processor.start();
+  processor.run();
+  processor.stop();
+  aggregator.flush();
+
+  // 16 executions, the two legs of 8 trades
+  EXPECT_EQ(aggregator.trades(), 8);
+  EXPECT_EQ(aggregator.instruments(), 1);
+  EXPECT_EQ(transact_time_ns, 1696917600000041405);
+  ASSERT_EQ(bars.size(), 3);
+
+  // the frame of the executions is the second of the capture
+  const uint64_t capture_time_ns = 1696923540 * SECOND_NS + 1'000'000;
+  EXPECT_EQ(bars[0].security_id, 2448082);
+  EXPECT_EQ(bars[0].open_time_ns, capture_time_ns);
+  EXPECT_EQ(bars[0].close_time_ns, capture_time_ns);
+  EXPECT_EQ(bars[0].open, Decimal5::from_units(98'828));
+  EXPECT_EQ(bars[0].high, Decimal5::from_units(98'837));
+  EXPECT_EQ(bars[0].low, Decimal5::from_units(98'828));
+  EXPECT_EQ(bars[0].close, Decimal5::from_units(98'837));
+  EXPECT_EQ(bars[0].vwap, *Decimal5::parse("98832.11111"));
+  EXPECT_EQ(bars[0].volume, 9);
+  EXPECT_EQ(bars[0].trades, 3);
+
+  EXPECT_EQ(bars[1].vwap, *Decimal5::parse("98838.42857"));
+  EXPECT_EQ(bars[1].volume, 7);
+  // the last bar is closed by the flush
+  EXPECT_EQ(bars[2].trades, 2);
+  EXPECT_EQ(bars[2].volume, 3);
+  EXPECT_EQ(bars[2].to_csv_string(),
+            "2448082, 1696923540001000000, 1696923540001000000, 98840, "
+            "98840, 98840, 98840, 98840, 3, 2");
+}
+
+TEST(BarAggregatorTest,
+     GIVEN_two_instruments_WHEN_time_bars_THEN_close_at_interval_end) {
+  std::vector<Bar> bars;
+  BarAggregator aggregator(BarConfig::parse("time:1s"),
+                           [&bars](const Bar &bar) { bars.push_back(bar); });
+
+  trade(aggregator, make_trade(1, 10, 100, 2), SECOND_NS / 5);
+  trade(aggregator, make_trade(1, 11, 101, 1), SECOND_NS * 7 / 10);
+  trade(aggregator, make_trade(1, 11, 101, 1), SECOND_NS * 7 / 10);
+  auto no_price = make_trade(1, 12, 0, 1);
+  no_price.last_px = Decimal5::null();
+  trade(aggregator, no_price, SECOND_NS * 8 / 10);
+  EXPECT_TRUE(bars.empty());
+
+  // a trade of another instrument in the next second closes the first bar
+  trade(aggregator, make_trade(2, 20, 50, 4), SECOND_NS * 11 / 10);
+  ASSERT_EQ(bars.size(), 1);
+  EXPECT_EQ(bars[0].security_id, 1);
+  EXPECT_EQ(bars[0].open_time_ns, 0);
+  EXPECT_EQ(bars[0].close_time_ns, SECOND_NS * 7 / 10);
+  EXPECT_EQ(bars[0].open, Decimal5::from_units(100));
+  EXPECT_EQ(bars[0].close, Decimal5::from_units(101));
+  EXPECT_EQ(bars[0].volume, 3);
+  EXPECT_EQ(bars[0].trades, 2);
+  EXPECT_EQ(bars[0].vwap, *Decimal5::parse("100.33333"));
+
+  trade(aggregator, make_trade(2, 21, 49, 1), SECOND_NS * 15 / 10);
+  trade(aggregator, make_trade(1, 13, 102, 1), SECOND_NS * 23 / 10);
+  ASSERT_EQ(bars.size(), 2);
+  EXPECT_EQ(bars[1].security_id, 2);
+  EXPECT_EQ(bars[1].open_time_ns, SECOND_NS);
+  EXPECT_EQ(bars[1].low, Decimal5::from_units(49));
+  EXPECT_EQ(bars[1].volume, 5);
+
+  aggregator.flush();
+  ASSERT_EQ(bars.size(), 3);
+  EXPECT_EQ(bars[2].security_id, 1);
+  EXPECT_EQ(bars[2].open_time_ns, 2 * SECOND_NS);
+  EXPECT_EQ(aggregator.bars(), 3);
+  EXPECT_EQ(aggregator.trades(), 5);
+}
+
+TEST(BarAggregatorTest,
+     GIVEN_volume_bars_WHEN_size_reached_THEN_close_and_profile_volume) {
+  std::vector<Bar> bars;
+  BarAggregator aggregator(
+      BarConfig::parse("volume:10"),
+      [&bars](const Bar &bar) { bars.push_back(bar); }, true);
+
+  trade(aggregator, make_trade(7, 1, 100, 4), 1);
+  trade(aggregator, make_trade(7, 2, 101, 4), 2);
+  // the trade is not split, the bar overshoots its size
+  trade(aggregator, make_trade(7, 3, 100, 5), 3);
+  ASSERT_EQ(bars.size(), 1);
+  EXPECT_EQ(bars[0].volume, 13);
+  EXPECT_EQ(bars[0].open_time_ns, 1);
+  EXPECT_EQ(bars[0].close_time_ns, 3);
+  trade(aggregator, make_trade(3, 1, 20, 1), 4);
+  aggregator.flush();
+  ASSERT_EQ(bars.size(), 2);
+  EXPECT_EQ(bars[1].security_id, 3);
+
+  std::ostringstream profile;
+  aggregator.write_volume_profile(profile);
+  EXPECT_EQ(profile.str(), "3, 20, 1\n7, 100, 9\n7, 101, 4\n");
+
+  const auto time = BarConfig::parse("time:500ms");
+  EXPECT_EQ(time.kind, BarKind::Time);
+  EXPECT_EQ(time.size, SECOND_NS / 2);
+  EXPECT_EQ(BarConfig::parse("time:5m").size, 300 * SECOND_NS);
+  EXPECT_EQ(BarConfig::parse("tick:100").kind, BarKind::Tick);
+  for (const auto malformed : {"", "time", "time:60", "time:0s", "time:1d",
+                               "volume:-1", "volume:10s", "tick:", "bars:1"}) {
+    EXPECT_THROW(BarConfig::parse(malformed), std::runtime_error) << malformed;
+  }
+}
+
+TEST(BarAggregatorTest,
+     GIVEN_sweep_legs_not_back_to_back_WHEN_tick_bars_THEN_count_once) {
+  std::vector<Bar> bars;
+  BarAggregator aggregator(BarConfig::parse("tick:100"),
+                           [&bars](const Bar &bar) { bars.push_back(bar); });
+  const simba::types::MDFlagsSet end_of_transaction{
+      simba::types::MDFlagsSet::EndOfTransaction};
+
+  // an aggressive order sweeps three levels: the passive legs, then the
+  // aggressive ones
+  for (const int64_t trade_id : {1, 2, 3, 1, 2, 3}) {
+    trade(aggregator, make_trade(5, trade_id, 100 + trade_id, 2), 1);
+  }
+  // the transaction ends on the update of the rest of the order
+  simba::types::OrderUpdate rest;
+  rest.md_flags = end_of_transaction;
+  aggregator.on_order_update(simba::types::OrderUpdateView{rest});
+
+  // the next transaction ends on its last leg
+  trade(aggregator, make_trade(5, 4, 103, 1), 2);
+  auto last_leg = make_trade(5, 4, 103, 1);
+  last_leg.md_flags = end_of_transaction;
+  trade(aggregator, last_leg, 2);
+  aggregator.flush();
+
+  ASSERT_EQ(bars.size(), 1);
+  EXPECT_EQ(bars[0].trades, 4);
+  EXPECT_EQ(bars[0].volume, 7);
+  EXPECT_EQ(bars[0].vwap, *Decimal5::parse("102.14286"));
+  EXPECT_EQ(aggregator.trades(), 4);
+}
+
+TEST(BarAggregatorTest, GIVEN_saved_bars_WHEN_restored_THEN_same_bars) {
+  std::vector<Bar> bars, resumed;
+  const auto make_aggregator = [](std::vector<Bar> &closed) {
+    return BarAggregator(
+        BarConfig::parse("tick:3"),
+        [&closed](const Bar &bar) { closed.push_back(bar); }, true);
+  };
+  auto aggregator = make_aggregator(bars);
+  trade(aggregator, make_trade(5, 1, 100, 2), 1);
+  trade(aggregator, make_trade(6, 2, 50, 1), 2);
+  // saved between the two legs of a trade
+  trade(aggregator, make_trade(5, 3, 101, 4), 3);
+  std::vector<std::byte> state;
+  aggregator.save(state);
+
+  auto restored = make_aggregator(resumed);
+  EXPECT_THROW(restored.restore(std::span(state).first(state.size() - 1)),
+               std::runtime_error);
+  restored = make_aggregator(resumed);
+  restored.restore(state);
+  EXPECT_EQ(restored.instruments(), 2);
+  EXPECT_THROW(restored.restore(state), std::runtime_error);
+  EXPECT_THROW(BarAggregator(BarConfig::parse("tick:4"), nullptr, true)
+                   .restore(state),
+               std::runtime_error);
+  EXPECT_THROW(BarAggregator(BarConfig::parse("tick:3"), nullptr)
+                   .restore(state),
+               std::runtime_error);
+
+  // the rest of the stream closes the same bars
+  for (auto *target : {&aggregator, &restored}) {
+    trade(*target, make_trade(5, 3, 101, 4), 3);
+    trade(*target, make_trade(5, 4, 99, 1), 4);
+    trade(*target, make_trade(6, 5, 51, 1), 5);
+    target->flush();
+  }
+  ASSERT_EQ(bars.size(), 2);
+  ASSERT_EQ(resumed.size(), bars.size());
+  for (size_t index = 0; index < bars.size(); ++index) {
+    EXPECT_EQ(std::memcmp(&resumed[index], &bars[index], sizeof(Bar)), 0);
+  }
+  EXPECT_EQ(resumed[0].trades, 3);
+  EXPECT_EQ(resumed[0].volume, 7);
+  std::ostringstream profile, resumed_profile;
+  aggregator.write_volume_profile(profile);
+  restored.write_volume_profile(resumed_profile);
+  EXPECT_EQ(resumed_profile.str(), profile.str());
+}
+
+}  // namespace task::tests
@@ -0,0 +1,164 @@
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "market_data/bbo_tracker.h"
+#include "market_data/record_writer.h"
+#include "test_vectors.h"
+
+namespace task::tests {
+
+using market_data::BboTracker;
+using market_data::BboUpdate;
+using market_data::RecordWriter;
+using simba::types::Decimal5;
+using simba::types::MDEntryType;
+using simba::types::MDUpdateAction;
+
+TEST(BboTrackerTest, GIVEN_order_updates_WHEN_top_changes_THEN_report_bbo) {
+  std::vector<BboUpdate> updates;
+  BboTracker tracker(
+      [&updates](const BboUpdate &update) { updates.push_back(update); });
+  const auto apply = [&tracker](const simba::types::OrderUpdate &update,
+                                uint64_t time_ns) {
+    tracker.on_order_update(simba::types::OrderUpdateView{update}, time_ns,
+                            time_ns + 1);
+  };
+
+  apply(make_order(7, 1, MDUpdateAction::New, MDEntryType::Bid, 99, 5), 10);
+  apply(make_order(7, 2, MDUpdateAction::New, MDEntryType::Offer, 101, 2), 20);
+  ASSERT_EQ(updates.size(), 2);
+  EXPECT_EQ(updates[1].security_id, 7);
+  EXPECT_EQ(updates[1].capture_time_ns, 20);
+  EXPECT_EQ(updates[1].transact_time_ns, 21);
+  EXPECT_EQ(updates[1].bid_price, Decimal5::from_units(99));
+  EXPECT_EQ(updates[1].bid_volume, 5);
+  EXPECT_EQ(updates[1].offer_price, Decimal5::from_units(101));
+  EXPECT_EQ(updates[1].offer_volume, 2);
+  EXPECT_EQ(updates[1].to_csv_string(), "7, 20, 21, 99, 5, 101, 2");
+
+  // deeper in the book, or another order of the same volume at the top
+  apply(make_order(7, 3, MDUpdateAction::New, MDEntryType::Bid, 98, 1), 30);
+  apply(make_order(7, 4, MDUpdateAction::New, MDEntryType::Offer, 101, 0), 40);
+  EXPECT_EQ(updates.size(), 2);
+
+  // the other instruments have their own top
+  apply(make_order(8, 5, MDUpdateAction::New, MDEntryType::Offer, 50, 1), 50);
+  ASSERT_EQ(updates.size(), 3);
+  EXPECT_EQ(updates[2].security_id, 8);
+  EXPECT_TRUE(updates[2].bid_price.is_null());
+
+  // the best bid leaves: the next level is the top
+  apply(make_order(7, 1, MDUpdateAction::Delete, MDEntryType::Bid, 99, 5), 60);
+  ASSERT_EQ(updates.size(), 4);
+  EXPECT_EQ(updates[3].bid_price, Decimal5::from_units(98));
+  EXPECT_EQ(updates[3].bid_volume, 1);
+  EXPECT_EQ(updates[3].offer_price, Decimal5::from_units(101));
+  EXPECT_EQ(tracker.updates(), 4);
+  EXPECT_EQ(tracker.book().instruments(), 2);
+}
+
+TEST(BboTrackerTest, GIVEN_saved_tracker_WHEN_restored_THEN_same_updates) {
+  std::vector<BboUpdate> reported, resumed;
+  const auto make_tracker = [](std::vector<BboUpdate> &updates) {
+    return std::make_unique<BboTracker>(
+        [&updates](const BboUpdate &update) { updates.push_back(update); });
+  };
+  const auto apply = [](BboTracker &tracker,
+                        const simba::types::OrderUpdate &update,
+                        uint64_t time_ns) {
+    tracker.on_order_update(simba::types::OrderUpdateView{update}, time_ns,
+                            time_ns + 1);
+  };
+  auto tracker = make_tracker(reported);
+  apply(*tracker, make_order(7, 1, MDUpdateAction::New, MDEntryType::Bid, 99,
+                             5),
+        10);
+  apply(*tracker, make_order(7, 2, MDUpdateAction::New, MDEntryType::Bid, 98,
+                             1),
+        20);
+  std::vector<std::byte> state;
+  tracker->save(state);
+
+  auto restored = make_tracker(resumed);
+  EXPECT_THROW(restored->restore(std::span(state).first(state.size() - 1)),
+               std::runtime_error);
+  restored = make_tracker(resumed);
+  restored->restore(state);
+  EXPECT_TRUE(resumed.empty());
+  EXPECT_EQ(restored->book().instruments(), 1);
+  EXPECT_THROW(restored->restore(state), std::runtime_error);
+
+  // the rest of the stream reports the same changes of the top
+  reported.clear();
+  for (auto *target : {tracker.get(), restored.get()}) {
+    // deeper in the book: nothing to report
+    apply(*target, make_order(7, 3, MDUpdateAction::New, MDEntryType::Bid, 97,
+                              1),
+          30);
+    apply(*target, make_order(7, 1, MDUpdateAction::Delete, MDEntryType::Bid,
+                              99, 5),
+          40);
+    target->flush();
+  }
+  ASSERT_EQ(reported.size(), 1);
+  ASSERT_EQ(resumed.size(), reported.size());
+  for (size_t index = 0; index < reported.size(); ++index) {
+    EXPECT_EQ(std::memcmp(&resumed[index], &reported[index],
+                          sizeof(BboUpdate)),
+              0);
+  }
+  EXPECT_EQ(resumed[0].bid_price, Decimal5::from_units(98));
+}
+
+TEST(BboTrackerTest, GIVEN_records_WHEN_writing_THEN_read_back_in_order) {
+  const auto path = std::filesystem::temp_directory_path() /
+                    ("test_bbo_tracker_" + std::to_string(::getpid()));
+  {
+    // a buffer smaller than the records: written in several batches
+    RecordWriter<BboUpdate> writer(path.string(), 4);
+    for (int32_t security_id = 0; security_id < 10; ++security_id) {
+      BboUpdate update;
+      update.security_id = security_id;
+      update.bid_price = Decimal5::from_units(security_id);
+      writer.write(update);
+    }
+    EXPECT_EQ(writer.records(), 10);
+  }
+  {
+    // the records of a resumed run go after the others
+    RecordWriter<BboUpdate> writer(path.string(), 4, true);
+    BboUpdate update;
+    update.security_id = 10;
+    writer.write(update);
+  }
+
+  ASSERT_EQ(std::filesystem::file_size(path), 11 * sizeof(BboUpdate));
+  std::ifstream file(path, std::ios::binary);
+  std::vector<BboUpdate> records(11);
+  file.read(reinterpret_cast<char *>(records.data()),
+            static_cast<std::streamsize>(records.size() * sizeof(BboUpdate)));
+  for (int32_t security_id = 0; security_id < 10; ++security_id) {
+    EXPECT_EQ(records[security_id].security_id, security_id);
+    EXPECT_EQ(records[security_id].bid_price,
+              Decimal5::from_units(security_id));
+    EXPECT_TRUE(records[security_id].offer_price.is_null());
+  }
+  EXPECT_EQ(records[10].security_id, 10);
+  std::filesystem::remove(path);
+
+  EXPECT_THROW(RecordWriter<BboUpdate>("/nonexistent/bbo.bin"),
+               std::runtime_error);
+}
+
+}  // namespace task::tests
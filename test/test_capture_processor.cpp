@@ -0,0 +1,215 @@
+#include <gtest/gtest.h>
+
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "processors/capture_processor.h"
+#include "processors/capture_sources.h"
+#include "processors/raw_socket_source.h"
+#include "processors/udp_sender.h"
+#include "test_vectors.h"
+
+namespace task::tests {
+
+namespace {
+// destination port and timestamp of every frame, in source order
+template <processors::PacketSource Source>
+std::vector<std::pair<uint16_t, uint32_t>> drain(Source &source) {
+  constexpr size_t DESTINATION_PORT_OFFSET = 14 + 20 + 2;
+  std::vector<std::pair<uint16_t, uint32_t>> frames;
+  source.start();
+  while (!source.is_finished()) {
+    if (const auto batch = source.next_batch()) {
+      for (size_t index = 0; index < batch->packets.size(); ++index) {
+        frames.emplace_back(
+            transport_layer::read_big_endian_u16(batch->packets[index].data() +
+                                                 DESTINATION_PORT_OFFSET),
+            batch->headers[index].ts_usec);
+      }
+    }
+  }
+  source.stop();
+  return frames;
+}
+}  // namespace
+
+class CaptureProcessorTestFixture : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    handlers_.order_update_handler =
+        [this](simba::types::OrderUpdateView) { ++updates_; };
+    simba::decoder::SIMBADecoder reference(handlers_);
+    reference.decode_message(TEST_ORDER_UPDATE_DATA);
+    updates_per_packet_ = updates_;
+    updates_ = 0;
+  }
+
+  // one order update per frame, to consecutive ports
+  static std::vector<std::byte> make_capture(size_t frames) {
+    std::vector<std::vector<std::byte>> packets;
+    for (size_t index = 0; index < frames; ++index) {
+      packets.push_back(make_udp_frame(TEST_ORDER_UPDATE_DATA,
+                                       static_cast<uint16_t>(index)));
+    }
+    return make_pcap_file(packets);
+  }
+
+  simba::decoder::MessageHandlers handlers_{};
+  size_t updates_{0};
+  size_t updates_per_packet_{0};
+};
+
+TEST_F(CaptureProcessorTestFixture,
+       GIVEN_memory_capture_WHEN_polling_THEN_decode_every_batch) {
+  constexpr size_t BATCH_PACKETS = processors::MemorySource::BATCH_PACKETS;
+  const auto capture = make_capture(2 * BATCH_PACKETS + 1);
+  processors::MemorySource source(capture);
+  processors::CaptureProcessor processor(source, handlers_);
+
+  // nothing is read before start
+  EXPECT_EQ(processor.poll(), 0);
+  processor.start();
+  EXPECT_EQ(processor.poll(), BATCH_PACKETS);
+  EXPECT_EQ(updates_, BATCH_PACKETS * updates_per_packet_);
+
+  EXPECT_EQ(processor.run(), BATCH_PACKETS + 1);
+  EXPECT_TRUE(processor.is_finished());
+  EXPECT_EQ(processor.poll(), 0);
+  processor.stop();
+  EXPECT_EQ(processor.packets_processed(), 2 * BATCH_PACKETS + 1);
+  EXPECT_EQ(updates_, processor.packets_processed() * updates_per_packet_);
+
+  // a truncated global header, an unknown link type
+  EXPECT_THROW(processors::MemorySource(std::span(capture).first(10)),
+               std::runtime_error);
+  auto cooked = make_pcap_file({}, 105);
+  EXPECT_THROW(processors::MemorySource{cooked}, std::runtime_error);
+}
+
+TEST_F(CaptureProcessorTestFixture,
+       GIVEN_processed_bytes_WHEN_resuming_at_offset_THEN_decode_the_rest) {
+  constexpr size_t BATCH_PACKETS = processors::MemorySource::BATCH_PACKETS;
+  const auto capture = make_capture(2 * BATCH_PACKETS + 1);
+  processors::MemorySource source(capture);
+  processors::CaptureProcessor processor(source, handlers_);
+  processor.start();
+  std::vector<uint64_t> offsets;
+  processor.run([&] {
+    offsets.push_back(processors::PCAPFile::HEADER_SIZE +
+                      processor.bytes_processed());
+  });
+  ASSERT_EQ(offsets.size(), 3);
+  EXPECT_EQ(offsets.back(), capture.size());
+  const auto sequence_numbers = processor.sequence_numbers();
+  ASSERT_EQ(sequence_numbers.size(), 1);
+  EXPECT_NE(sequence_numbers.front(), 0);
+
+  // from the offset after the first batch, the other two
+  updates_ = 0;
+  processors::MemorySource resumed(capture, offsets.front());
+  processors::CaptureProcessor resumed_processor(resumed, handlers_);
+  EXPECT_THROW(resumed_processor.restore_sequence_numbers({1, 2}),
+               std::runtime_error);
+  resumed_processor.restore_sequence_numbers({sequence_numbers.front() - 1});
+  EXPECT_EQ(resumed_processor.sequence_numbers().front(),
+            sequence_numbers.front() - 1);
+  resumed_processor.start();
+  EXPECT_EQ(resumed_processor.run(), BATCH_PACKETS + 1);
+  EXPECT_EQ(updates_, (BATCH_PACKETS + 1) * updates_per_packet_);
+  EXPECT_THROW(processors::MemorySource(capture, capture.size() + 1),
+               std::runtime_error);
+}
+
+TEST_F(CaptureProcessorTestFixture,
+       GIVEN_capture_file_WHEN_reading_from_any_source_THEN_same_frames) {
+  const auto directory = std::filesystem::temp_directory_path() /
+                         ("test_capture_processor_" +
+                          std::to_string(::getpid()));
+  std::filesystem::create_directories(directory);
+  const auto path = directory / "capture.pcap";
+  // larger than a decompressed chunk: records are cut between chunks
+  const auto capture = make_capture(60'000);
+  ASSERT_GT(capture.size(), processors::CompressedFileSource::CHUNK_SIZE);
+  {
+    std::ofstream file(path, std::ios::binary);
+    file.write(reinterpret_cast<const char *>(capture.data()),
+               static_cast<std::streamsize>(capture.size()));
+  }
+
+  processors::MemorySource memory(capture);
+  const auto expected = drain(memory);
+  ASSERT_EQ(expected.size(), 60'000);
+
+  processors::FileSource file(path);
+  EXPECT_EQ(drain(file), expected);
+  processors::MappedFileSource mapped(path);
+  EXPECT_EQ(drain(mapped), expected);
+
+  // from the record after the first one
+  const size_t second = processors::PCAPFile::HEADER_SIZE +
+                        sizeof(pcap::types::pcaprec_hdr_s) +
+                        make_udp_frame(TEST_ORDER_UPDATE_DATA, 0).size();
+  const std::vector rest(expected.begin() + 1, expected.end());
+  processors::FileSource file_rest(path, second);
+  EXPECT_EQ(drain(file_rest), rest);
+  processors::MappedFileSource mapped_rest(path, second);
+  EXPECT_EQ(drain(mapped_rest), rest);
+  EXPECT_THROW(processors::FileSource(path, capture.size() + 1),
+               std::runtime_error);
+
+  const auto compressed = directory / "capture.pcap.gz";
+  const std::string command =
+      "gzip -c " + path.string() + " > " + compressed.string() + " 2>/dev/null";
+  if (std::system(command.c_str()) == 0) {
+    ASSERT_TRUE(processors::CompressedFileSource::is_compressed(compressed));
+    processors::CompressedFileSource decompressed(compressed);
+    EXPECT_EQ(drain(decompressed), expected);
+  }
+  std::filesystem::remove_all(directory);
+}
+
+TEST_F(CaptureProcessorTestFixture,
+       GIVEN_loopback_interface_WHEN_capturing_THEN_decode_the_datagrams) {
+  std::unique_ptr<processors::live::RawSocketSource> source;
+  try {
+    source = std::make_unique<processors::live::RawSocketSource>("lo");
+  } catch (const std::runtime_error &error) {
+    GTEST_SKIP() << "raw sockets unavailable: " << error.what();
+  }
+  // the other traffic of the host on lo is not routed
+  const std::vector<processors::FeedRoute> feeds{
+      processors::FeedRoute::parse("test=127.0.0.1:16789")};
+  processors::CaptureProcessor processor(*source, handlers_, feeds);
+  processor.start();
+
+  processors::live::SenderConfig sender_config;
+  sender_config.destinations.push_back(
+      processors::live::Endpoint::parse("127.0.0.1:16789"));
+  processors::live::UDPSender sender(sender_config);
+  constexpr size_t DATAGRAMS = 5;
+  for (size_t index = 0; index < DATAGRAMS; ++index) {
+    sender.send(TEST_ORDER_UPDATE_DATA);
+  }
+  sender.flush();
+
+  const auto deadline =
+      std::chrono::steady_clock::now() + std::chrono::seconds(2);
+  while (processor.flow_table()->stats(0).datagrams < DATAGRAMS &&
+         std::chrono::steady_clock::now() < deadline) {
+    processor.poll();
+  }
+  processor.stop();
+  EXPECT_TRUE(processor.is_finished());
+  // each datagram is seen once: the outgoing copy is skipped
+  EXPECT_EQ(processor.flow_table()->stats(0).datagrams, DATAGRAMS);
+  EXPECT_EQ(updates_, DATAGRAMS * updates_per_packet_);
+}
+
+}  // namespace task::tests
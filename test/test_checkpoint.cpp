@@ -0,0 +1,46 @@
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <cstddef>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+
+#include "processors/checkpoint.h"
+
+namespace task::tests {
+
+using processors::Checkpoint;
+
+TEST(CheckpointTest, GIVEN_checkpoint_WHEN_saved_THEN_loaded_whole) {
+  const auto path = std::filesystem::temp_directory_path() /
+                    ("test_checkpoint_" + std::to_string(::getpid()));
+  EXPECT_FALSE(Checkpoint::load(path));
+
+  Checkpoint checkpoint;
+  checkpoint.file_offset = 1'024;
+  checkpoint.packets = 42;
+  checkpoint.capture = "/captures/simba.pcap";
+  checkpoint.capture_size = 1 << 20;
+  checkpoint.sequence_numbers = {7, 9};
+  checkpoint.outputs["/data/depth.csv"] = 4'096;
+  checkpoint.states["book"] = {std::byte{1}, std::byte{2}, std::byte{3}};
+  checkpoint.states["bars"] = {};
+  checkpoint.save(path);
+  EXPECT_EQ(Checkpoint::load(path), checkpoint);
+
+  // a newer checkpoint replaces it
+  checkpoint.packets = 43;
+  checkpoint.states.erase("book");
+  checkpoint.save(path);
+  EXPECT_EQ(Checkpoint::load(path), checkpoint);
+
+  // cut short, or not a checkpoint at all
+  std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1);
+  EXPECT_THROW(Checkpoint::load(path), std::runtime_error);
+  std::filesystem::resize_file(path, 4);
+  EXPECT_THROW(Checkpoint::load(path), std::runtime_error);
+  std::filesystem::remove(path);
+}
+
+}  // namespace task::tests
@@ -0,0 +1,107 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <limits>
+#include <sstream>
+#include <string>
+
+#include "simba_decoder/decimal.h"
+#include "simba_decoder/simba_types.h"
+
+namespace task::tests {
+
+using simba::types::Decimal5;
+
+// the arithmetic is usable in constant expressions
+static_assert(Decimal5::parse("135.66")->mantissa() == 13'566'000);
+static_assert(Decimal5::from_units(2) - Decimal5{50'000} == Decimal5{150'000});
+static_assert(Decimal5{1} < Decimal5::null());
+
+TEST(Decimal5Test, GIVEN_prices_WHEN_formatting_and_parsing_THEN_exact) {
+  EXPECT_EQ(Decimal5{13'566'000}.to_string(), "135.66");
+  EXPECT_EQ(Decimal5{9'850'100'000}.to_string(), "98501");
+  EXPECT_EQ(Decimal5{-1}.to_string(), "-0.00001");
+  EXPECT_EQ(Decimal5{0}.to_string(), "0");
+  EXPECT_EQ(Decimal5::null().to_string(), "NULL");
+  // the double formatting would round it to 6 significant digits
+  EXPECT_EQ(Decimal5{12'345'678'901}.to_string(), "123456.78901");
+  const Decimal5 lowest{std::numeric_limits<int64_t>::min()};
+  EXPECT_EQ(lowest.to_string(), "-92233720368547.75808");
+
+  char text[Decimal5::MAX_CHARS];
+  char *end = Decimal5{187'020'000}.to_chars_fixed(text, text + sizeof(text));
+  EXPECT_EQ(std::string(text, end), "1870.20000");
+  EXPECT_EQ(Decimal5{187'020'000}.to_chars(text, text + 3), nullptr);
+
+  std::ostringstream stream;
+  stream << Decimal5{187'020'000} << ' ' << std::fixed << Decimal5{187'020'000};
+  EXPECT_EQ(stream.str(), "1870.2 1870.20000");
+
+  for (const auto price : {Decimal5{13'566'000}, Decimal5{-1}, lowest,
+                           Decimal5{Decimal5::NULL_MANTISSA - 1},
+                           Decimal5::null()}) {
+    EXPECT_EQ(Decimal5::parse(price.to_string()), price);
+  }
+  EXPECT_EQ(Decimal5::parse("+.5"), Decimal5{50'000});
+  EXPECT_EQ(Decimal5::parse("7."), Decimal5::from_units(7));
+  for (const auto malformed : {"", "-", ".", "1.000001", "1.2.3", "12a",
+                               "92233720368547.75808", "92233720368547.75807"}) {
+    EXPECT_FALSE(Decimal5::parse(malformed)) << malformed;
+  }
+}
+
+TEST(Decimal5Test, GIVEN_trades_WHEN_accumulating_THEN_vwap_is_exact) {
+  simba::types::VWAPAccumulator accumulator;
+  EXPECT_TRUE(accumulator.vwap().is_null());
+
+  // (98828.00000 * 1 + 98830.00000 * 5 + 98837.00000 * 3) / 9 = 98832.1111..
+  accumulator.add(Decimal5::from_units(98'828), 1);
+  accumulator.add(Decimal5::from_units(98'830), 5);
+  accumulator.add(Decimal5::from_units(98'837), 3);
+  accumulator.add(Decimal5::null(), 10);
+  accumulator.add(Decimal5::from_units(1), 0);
+  EXPECT_EQ(accumulator.volume(), 9);
+  EXPECT_EQ(accumulator.vwap(), *Decimal5::parse("98832.11111"));
+  EXPECT_EQ(simba::types::notional_to_string(accumulator.notional()),
+            "889489");
+
+  // the notional of these two trades overflows 64 bits
+  accumulator.reset();
+  const Decimal5 high = *Decimal5::parse("90000000.00001");
+  accumulator.add(high, 1'000'000);
+  accumulator.add(high + Decimal5{2}, 1'000'000);
+  EXPECT_EQ(accumulator.vwap(), high + Decimal5{1});
+  EXPECT_EQ(simba::types::notional_to_string(accumulator.notional()),
+            "180000000000040");
+
+  // to the nearest, halves away from zero
+  accumulator.reset();
+  accumulator.add(Decimal5{1}, 1);
+  accumulator.add(Decimal5{2}, 2);
+  EXPECT_EQ(accumulator.vwap(), Decimal5{2});
+  accumulator.add(Decimal5{-8}, 1);
+  EXPECT_EQ(accumulator.vwap(), Decimal5{-1});
+  accumulator.reset();
+  accumulator.add(Decimal5{-1}, 1);
+  accumulator.add(Decimal5{-2}, 1);
+  EXPECT_EQ(accumulator.vwap(), Decimal5{-2});
+}
+
+TEST(Decimal5Test, GIVEN_order_execution_WHEN_printing_THEN_prices_are_exact) {
+  simba::types::OrderExecution execution;
+  execution.md_entry_id = 1;
+  execution.md_entry_px = Decimal5{9'915'000'000};
+  execution.last_px = Decimal5{9'882'850'000};
+  execution.last_qty = 1;
+
+  // the trade price used to be multiplied by the exponent
+  const auto text = execution.to_string();
+  EXPECT_NE(text.find("md_entry_px: 99150"), std::string::npos) << text;
+  EXPECT_NE(text.find("last_px: 98828.5"), std::string::npos) << text;
+
+  execution.md_entry_px = Decimal5::null();
+  EXPECT_EQ(simba::types::to_csv_string(execution).substr(0, 9),
+            "1, NULL, ");
+}
+
+}  // namespace task::tests
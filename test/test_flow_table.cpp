@@ -0,0 +1,164 @@
+#include <gtest/gtest.h>
+
+#include <unistd.h>
+
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+#include "processors/capture_processor.h"
+#include "processors/capture_sources.h"
+#include "processors/flow_table.h"
+#include "processors/pcap_processor.h"
+#include "test_vectors.h"
+
+namespace task::tests {
+
+namespace {
+transport_layer::FlowKey flow(uint32_t address, uint16_t port) {
+  return {0x0A000001, address, 16001, port};
+}
+
+// Rewrites the destination address of a frame built by make_udp_frame
+std::vector<std::byte> to_destination(std::vector<std::byte> frame,
+                                      uint32_t address) {
+  constexpr size_t DESTINATION_OFFSET = 14 + 16;
+  for (size_t index = 0; index < 4; ++index) {
+    frame[DESTINATION_OFFSET + index] = std::byte(address >> (24 - 8 * index));
+  }
+  return frame;
+}
+}  // namespace
+
+TEST(FlowTableTest, GIVEN_feed_routes_WHEN_looking_up_THEN_match_destinations) {
+  processors::FlowTable table(
+      {processors::FeedRoute::parse("orders=239.195.1.1:20081,"
+                                    "239.195.129.1:20081"),
+       processors::FeedRoute::parse("trades=239.195.1.2:20082"),
+       processors::FeedRoute::parse("orders=239.195.1.3:20083")});
+
+  ASSERT_EQ(table.feeds(), 2);
+  EXPECT_EQ(table.name(0), "orders");
+  EXPECT_EQ(table.name(1), "trades");
+  EXPECT_EQ(table.find(flow(0xEFC30101, 20081)), 0);
+  EXPECT_EQ(table.find(flow(0xEFC30101, 20081)), 0);  // cached
+  EXPECT_EQ(table.find(flow(0xEFC38101, 20081)), 0);
+  EXPECT_EQ(table.find(flow(0xEFC30103, 20083)), 0);
+  EXPECT_EQ(table.find(flow(0xEFC30102, 20082)), 1);
+  EXPECT_EQ(table.find(flow(0xEFC30102, 20081)),
+            processors::FlowTable::NO_FEED);
+  EXPECT_EQ(table.find(flow(0xEFC30104, 20081)),
+            processors::FlowTable::NO_FEED);
+
+  EXPECT_THROW(processors::FeedRoute::parse("239.195.1.1:20081"),
+               std::runtime_error);
+  EXPECT_THROW(processors::FeedRoute::parse("orders="), std::runtime_error);
+  EXPECT_THROW(processors::FlowTable(
+                   {processors::FeedRoute::parse("a=239.195.1.1:20081"),
+                    processors::FeedRoute::parse("b=239.195.1.1:20081")}),
+               std::runtime_error);
+}
+
+TEST(FlowTableTest, GIVEN_a_capture_with_feeds_WHEN_processing_THEN_route_them) {
+  // orders on one group, executions on another, noise on a third
+  const auto orders = to_destination(
+      make_udp_frame(TEST_ORDER_UPDATE_DATA, 20081), 0xEFC30101);
+  const auto trades = to_destination(
+      make_udp_frame(TEST_ORDER_EXECUTION_DATA, 20082), 0xEFC30102);
+  const auto other = to_destination(
+      make_udp_frame(TEST_ORDER_EXECUTION_DATA, 20083), 0xEFC30103);
+  const auto capture =
+      make_pcap_file({orders, trades, other, orders, trades, other});
+
+  const auto capture_path =
+      std::filesystem::temp_directory_path() /
+      ("test_flow_table_" + std::to_string(::getpid()) + ".pcap");
+  {
+    std::ofstream file(capture_path, std::ios::binary);
+    file.write(reinterpret_cast<const char *>(capture.data()),
+               static_cast<std::streamsize>(capture.size()));
+  }
+
+  size_t updates{0}, executions{0};
+  simba::decoder::MessageHandlers handlers;
+  handlers.order_update_handler = [&updates](simba::types::OrderUpdateView) {
+    ++updates;
+  };
+  handlers.order_execution_handler =
+      [&executions](simba::types::OrderExecutionView) { ++executions; };
+  // what one orders and one trades datagram decode to
+  simba::decoder::SIMBADecoder reference(handlers);
+  reference.decode_message(TEST_ORDER_UPDATE_DATA);
+  reference.decode_message(TEST_ORDER_EXECUTION_DATA);
+  const size_t expected_updates = updates, expected_executions = executions;
+  updates = executions = 0;
+
+  {
+    processors::PCAPProcessor processor(
+        capture_path.string(), handlers,
+        {processors::FeedRoute::parse("orders=239.195.1.1:20081"),
+         processors::FeedRoute::parse("trades=239.195.1.2:20082")});
+  }
+  std::filesystem::remove(capture_path);
+
+  // the third destination is skipped
+  EXPECT_EQ(updates, 2 * expected_updates);
+  EXPECT_EQ(executions, 2 * expected_executions);
+}
+
+TEST(FlowTableTest, GIVEN_a_and_b_channels_WHEN_processing_THEN_decode_once) {
+  // two orders packets, each on both channels of the feed, B first then A
+  auto next_update = TEST_ORDER_UPDATE_DATA;
+  next_update[0] = std::byte(std::to_integer<uint8_t>(next_update[0]) + 1);
+  const auto a_first = to_destination(
+      make_udp_frame(TEST_ORDER_UPDATE_DATA, 20081), 0xEFC30101);
+  const auto b_first = to_destination(
+      make_udp_frame(TEST_ORDER_UPDATE_DATA, 20081), 0xEFC38101);
+  const auto a_next =
+      to_destination(make_udp_frame(next_update, 20081), 0xEFC30101);
+  const auto b_next =
+      to_destination(make_udp_frame(next_update, 20081), 0xEFC38101);
+  // a feed on a single channel is not arbitrated
+  const auto trades = to_destination(
+      make_udp_frame(TEST_ORDER_EXECUTION_DATA, 20082), 0xEFC30102);
+  const auto capture =
+      make_pcap_file({a_first, b_first, b_next, a_next, trades, trades});
+
+  // one handler set per feed
+  size_t orders{0}, executions{0};
+  simba::decoder::MessageHandlers orders_handlers;
+  orders_handlers.order_update_handler =
+      [&orders](simba::types::OrderUpdateView) { ++orders; };
+  simba::decoder::MessageHandlers trades_handlers;
+  trades_handlers.order_execution_handler =
+      [&executions](simba::types::OrderExecutionView) { ++executions; };
+  simba::decoder::SIMBADecoder reference(orders_handlers);
+  reference.decode_message(TEST_ORDER_UPDATE_DATA);
+  const size_t updates_per_packet = orders;
+  orders = 0;
+
+  const std::vector routes{
+      processors::FeedRoute::parse("orders=239.195.1.1:20081,"
+                                   "239.195.129.1:20081"),
+      processors::FeedRoute::parse("trades=239.195.1.2:20082")};
+  processors::MemorySource source(capture);
+  processors::CaptureProcessor processor(
+      source, std::vector{orders_handlers, trades_handlers}, routes);
+  processor.start();
+  processor.run();
+  processor.stop();
+
+  EXPECT_EQ(orders, 2 * updates_per_packet);
+  EXPECT_GT(executions, 0);
+  ASSERT_TRUE(processor.flow_table());
+  EXPECT_EQ(processor.flow_table()->destinations(0), 2);
+  EXPECT_EQ(processor.flow_table()->stats(0).datagrams, 4);
+
+  processors::MemorySource other_source(capture);
+  EXPECT_THROW(processors::CaptureProcessor(
+                   other_source, std::vector{orders_handlers}, routes),
+               std::runtime_error);
+}
+
+}  // namespace task::tests
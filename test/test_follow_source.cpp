@@ -0,0 +1,88 @@
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "processors/follow_source.h"
+#include "test_vectors.h"
+
+namespace task::tests {
+
+namespace {
+void append(const std::filesystem::path &path,
+            std::span<const std::byte> bytes) {
+  std::ofstream file(path, std::ios::binary | std::ios::app);
+  file.write(reinterpret_cast<const char *>(bytes.data()),
+             static_cast<std::streamsize>(bytes.size()));
+}
+
+// timestamps of the frames framed until there are count of them, at most
+// max_polls polls of up to 100ms each
+std::vector<uint32_t> follow(processors::FollowSource &source, size_t count,
+                             std::vector<uint32_t> timestamps = {},
+                             size_t max_polls = 200) {
+  for (size_t polls = 0; timestamps.size() < count && polls < max_polls;
+       ++polls) {
+    if (const auto batch = source.next_batch()) {
+      for (const auto &header : batch->headers) {
+        timestamps.push_back(header.ts_usec);
+      }
+    }
+  }
+  return timestamps;
+}
+}  // namespace
+
+TEST(FollowSourceTest,
+     GIVEN_capture_being_written_WHEN_following_THEN_frame_as_it_grows) {
+  const auto directory =
+      std::filesystem::temp_directory_path() /
+      ("test_follow_source_" + std::to_string(::getpid()));
+  std::filesystem::create_directories(directory);
+  const std::vector frames(4, make_udp_frame(TEST_ORDER_UPDATE_DATA, 20081));
+  const auto first = make_pcap_file({frames.begin(), frames.begin() + 3});
+  const auto second = make_pcap_file({frames.begin() + 3, frames.end()}, 1,
+                                     3'000'000);
+
+  // not even a whole global header yet
+  append(directory / "a.pcap", std::span(first).first(10));
+  EXPECT_THROW(processors::FollowSource{directory}, std::runtime_error);
+
+  // the second record cut in its middle
+  const size_t cut = first.size() - frames[0].size() / 2 -
+                     sizeof(pcap::types::pcaprec_hdr_s) - frames[0].size();
+  append(directory / "a.pcap", std::span(first).subspan(10, cut - 10));
+  processors::FollowSource source(directory);
+  EXPECT_EQ(source.path(), directory / "a.pcap");
+  auto timestamps = follow(source, 2, {}, 10);
+  EXPECT_EQ(timestamps, (std::vector<uint32_t>{0}));
+
+  append(directory / "a.pcap", std::span(first).subspan(cut));
+  timestamps = follow(source, 3, timestamps);
+  EXPECT_EQ(timestamps, (std::vector<uint32_t>{0, 1'000'000, 2'000'000}));
+
+  // the writer moved on to the next capture
+  append(directory / "b.pcap", second);
+  timestamps = follow(source, 4, timestamps);
+  EXPECT_EQ(timestamps.size(), 4);
+  EXPECT_EQ(timestamps.back(), 3'000'000);
+  EXPECT_EQ(source.files(), 2);
+  EXPECT_EQ(source.path(), directory / "b.pcap");
+
+  // captures of another link type are not mixed
+  append(directory / "c.pcap", make_pcap_file({}, 113));
+  EXPECT_THROW(follow(source, 5), std::runtime_error);
+
+  source.stop();
+  EXPECT_TRUE(source.is_finished());
+  EXPECT_FALSE(source.next_batch());
+  std::filesystem::remove_all(directory);
+}
+
+}  // namespace task::tests
@@ -0,0 +1,127 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <vector>
+
+#include "processors/ip_reassembler.h"
+
+namespace task::tests {
+
+class IPv4ReassemblerTestFixture : public ::testing::Test {
+ protected:
+  IPv4ReassemblerTestFixture() {
+    datagram_.resize(3000);
+    for (size_t index = 0; index < datagram_.size(); ++index) {
+      datagram_[index] = std::byte(index * 7);
+    }
+  }
+
+  std::optional<std::span<const std::byte>> add(
+      size_t offset, size_t size, uint64_t now_ns = 0,
+      transport_layer::FragmentKey key = KEY) {
+    const bool more_fragments = offset + size < datagram_.size();
+    return reassembler_.add(key, offset, more_fragments,
+                            std::span(datagram_).subspan(offset, size), now_ns);
+  }
+
+  static constexpr transport_layer::FragmentKey KEY{0x0A000001, 0xEFC30101,
+                                                    0x1234, 0x11};
+  std::vector<std::byte> datagram_;
+  transport_layer::IPv4Reassembler reassembler_{
+      {.slots = 2, .timeout = std::chrono::milliseconds(10)}};
+};
+
+TEST_F(IPv4ReassemblerTestFixture,
+       GIVEN_fragments_out_of_order_WHEN_adding_THEN_return_the_datagram) {
+  EXPECT_FALSE(add(2960, 40));
+  EXPECT_FALSE(add(1480, 1480));
+  EXPECT_FALSE(add(1480, 1480));  // duplicates are harmless
+  const auto datagram = add(0, 1480);
+
+  ASSERT_TRUE(datagram);
+  ASSERT_EQ(datagram->size(), datagram_.size());
+  EXPECT_TRUE(std::equal(datagram->begin(), datagram->end(), datagram_.begin()));
+  EXPECT_EQ(reassembler_.datagrams_reassembled(), 1);
+  EXPECT_EQ(reassembler_.fragments_dropped(), 0);
+}
+
+TEST_F(IPv4ReassemblerTestFixture,
+       GIVEN_incomplete_datagrams_WHEN_expired_or_evicted_THEN_drop_them) {
+  constexpr uint64_t MS = 1'000'000;
+  auto other = KEY;
+  other.identification = 0x1235;
+  auto third = KEY;
+  third.identification = 0x1236;
+
+  EXPECT_FALSE(add(0, 1480, 0));
+  // the first datagram times out: its fragment is dropped
+  EXPECT_FALSE(add(1480, 1480, 20 * MS));
+  EXPECT_EQ(reassembler_.fragments_dropped(), 1);
+
+  // the table holds two datagrams, a third evicts the oldest
+  EXPECT_FALSE(add(0, 1480, 21 * MS, other));
+  EXPECT_FALSE(add(0, 1480, 22 * MS, third));
+  EXPECT_EQ(reassembler_.fragments_dropped(), 2);
+  EXPECT_FALSE(add(1480, 1480, 23 * MS, other));
+  EXPECT_TRUE(add(2960, 40, 24 * MS, other));
+  EXPECT_EQ(reassembler_.fragments_dropped(), 2);
+}
+
+TEST_F(IPv4ReassemblerTestFixture,
+       GIVEN_time_going_backwards_WHEN_adding_THEN_keep_the_datagram) {
+  constexpr uint64_t MS = 1'000'000;
+  // merged captures are not monotonic: an earlier fragment is not a
+  // timeout
+  EXPECT_FALSE(add(0, 1480, 20 * MS));
+  EXPECT_FALSE(add(1480, 1480, 5 * MS));
+  EXPECT_TRUE(add(2960, 40, 25 * MS));
+  EXPECT_EQ(reassembler_.fragments_dropped(), 0);
+}
+
+TEST_F(IPv4ReassemblerTestFixture,
+       GIVEN_inconsistent_fragments_WHEN_adding_THEN_drop_the_datagram) {
+  EXPECT_FALSE(add(2960, 40));
+  // data past the last fragment
+  EXPECT_FALSE(reassembler_.add(KEY, 2960, true,
+                                std::span(datagram_).subspan(0, 80), 0));
+  EXPECT_EQ(reassembler_.fragments_dropped(), 2);
+
+  // not a whole number of blocks before the last fragment
+  EXPECT_FALSE(reassembler_.add(KEY, 0, true,
+                                std::span(datagram_).subspan(0, 1479), 0));
+  // beyond the largest IPv4 datagram
+  EXPECT_FALSE(reassembler_.add(
+      KEY, transport_layer::IPv4Reassembler::MAX_PAYLOAD_SIZE - 8, false,
+      std::span(datagram_).subspan(0, 16), 0));
+  EXPECT_EQ(reassembler_.fragments_dropped(), 4);
+
+  // data past a last fragment that arrives after it: the first blocks of
+  // the shorter datagram were never received
+  EXPECT_FALSE(reassembler_.add(KEY, 24, true,
+                                std::span(datagram_).subspan(24, 24), 0));
+  EXPECT_FALSE(reassembler_.add(KEY, 16, false,
+                                std::span(datagram_).subspan(16, 8), 0));
+  EXPECT_EQ(reassembler_.fragments_dropped(), 6);
+  EXPECT_EQ(reassembler_.datagrams_reassembled(), 0);
+}
+
+TEST_F(IPv4ReassemblerTestFixture,
+       GIVEN_completed_datagrams_WHEN_not_released_THEN_keep_their_bytes) {
+  auto other = KEY;
+  other.identification = 0x1235;
+  auto third = KEY;
+  third.identification = 0x1236;
+
+  const auto first = reassembler_.add(KEY, 0, false, datagram_, 0);
+  const auto second = reassembler_.add(other, 0, false, datagram_, 0);
+  ASSERT_TRUE(first && second);
+  // both slots are still referenced: a new datagram cannot take them
+  EXPECT_FALSE(add(0, 1480, 0, third));
+  EXPECT_EQ(reassembler_.fragments_dropped(), 1);
+
+  reassembler_.release_completed();
+  EXPECT_FALSE(add(0, 1480, 0, third));
+  EXPECT_EQ(reassembler_.fragments_dropped(), 1);
+}
+
+}  // namespace task::tests
@@ -0,0 +1,73 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <string>
+
+#include "logging/logger.h"
+
+namespace task::tests {
+
+namespace {
+logging::LogRecord make_record(const char *format) {
+  logging::LogRecord record;
+  record.timestamp_ns = 1'700'000'000'123'456'789;
+  record.format = format;
+  record.level = logging::Level::Warning;
+  return record;
+}
+}  // namespace
+
+TEST(LoggerTest,
+     GIVEN_a_binary_record_WHEN_formatting_THEN_replace_the_placeholders) {
+  auto record = make_record("{} joined {} port {} ({:x}) {}");
+  record.add(std::string_view{"[RECEIVER]"});
+  record.add(std::string_view{"239.195.1.1"});
+  record.add(uint16_t{20081});
+  record.add(uint32_t{0xa1b23c4d});
+  record.add(-1.5);
+
+  EXPECT_EQ(logging::format_record(record),
+            "2023-11-14 22:13:20.123456 WARNING [RECEIVER] joined 239.195.1.1 "
+            "port 20081 (a1b23c4d) -1.5");
+}
+
+TEST(LoggerTest,
+     GIVEN_missing_or_oversized_arguments_WHEN_formatting_THEN_stay_bounded) {
+  auto record = make_record("{} and {}");
+  record.add(std::string(2 * logging::LogRecord::TEXT_SIZE, 'a'));
+  record.suppressed = 7;
+
+  const auto line = logging::format_record(record);
+  EXPECT_NE(line.find(std::string(logging::LogRecord::TEXT_SIZE, 'a') +
+                      " and {}"),
+            std::string::npos);
+  EXPECT_TRUE(line.ends_with(" (7 similar messages suppressed)"));
+}
+
+TEST(LoggerTest,
+     GIVEN_a_rate_limiter_WHEN_logging_in_a_burst_THEN_count_suppressed) {
+  logging::RateLimiter limiter{std::chrono::seconds(1)};
+  uint64_t suppressed{0};
+  const uint64_t start_ns = 5'000'000'000;
+
+  EXPECT_TRUE(limiter.allow(start_ns, suppressed));
+  EXPECT_EQ(suppressed, 0);
+  for (uint64_t message = 1; message <= 10; ++message) {
+    EXPECT_FALSE(limiter.allow(start_ns + message * 1000, suppressed));
+  }
+  EXPECT_TRUE(limiter.allow(start_ns + 1'000'000'000, suppressed));
+  EXPECT_EQ(suppressed, 10);
+}
+
+TEST(LoggerTest, GIVEN_many_records_WHEN_flushing_THEN_nothing_is_lost) {
+  const size_t dropped_before = logging::dropped_records();
+  for (int message = 0; message < 1000; ++message) {
+    logging::log(logging::Level::Debug, "discarded below the level {}",
+                 message);
+  }
+  logging::log(logging::Level::Info, "[LOGGER_TEST] {} records", 1000);
+  logging::flush();
+  EXPECT_EQ(logging::dropped_records(), dropped_before);
+}
+
+}  // namespace task::tests
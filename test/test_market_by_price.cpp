@@ -0,0 +1,292 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <map>
+#include <random>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "market_data/market_by_price.h"
+#include "test_vectors.h"
+
+namespace task::tests {
+
+using market_data::DepthUpdate;
+using market_data::MarketByPrice;
+using market_data::PriceLadder;
+using market_data::PriceLevel;
+using simba::types::Decimal5;
+using simba::types::MDEntryType;
+using simba::types::MDFlagsSet;
+using simba::types::MDUpdateAction;
+
+namespace {
+PriceLevel level(int64_t price, int64_t volume, uint32_t orders) {
+  return {Decimal5::from_units(price), volume, orders};
+}
+}  // namespace
+
+TEST(PriceLadderTest, GIVEN_prices_on_a_grid_WHEN_adding_THEN_best_first) {
+  PriceLadder offers(false, 16);
+  offers.insert(Decimal5::from_units(100), 5);
+  EXPECT_TRUE(offers.tick().is_null());
+  offers.insert(Decimal5::from_units(110), 1);
+  offers.insert(Decimal5::from_units(105), 2);
+  offers.insert(Decimal5::from_units(105), 3);
+  // the differences are multiples of 5 units
+  EXPECT_EQ(offers.tick(), Decimal5::from_units(5));
+  EXPECT_EQ(offers.size(), 3);
+  EXPECT_EQ(offers.sparse_levels(), 0);
+
+  std::vector<PriceLevel> top(4);
+  EXPECT_EQ(offers.top(top), 3);
+  EXPECT_EQ(top[0], level(100, 5, 1));
+  EXPECT_EQ(top[1], level(105, 5, 2));
+  EXPECT_EQ(top[2], level(110, 1, 1));
+  EXPECT_TRUE(top[3].empty());
+
+  // far from the window: kept aside, still in price order
+  offers.insert(Decimal5::from_units(1000), 1);
+  EXPECT_EQ(offers.sparse_levels(), 1);
+  offers.erase(Decimal5::from_units(100), 5);
+  offers.modify(Decimal5::from_units(105), -4);
+  EXPECT_EQ(offers.top(top), 3);
+  EXPECT_EQ(top[0], level(105, 1, 2));
+  EXPECT_EQ(top[2], level(1000, 1, 1));
+
+  // the bids are sorted the other way, an off-grid price refines the tick
+  PriceLadder bids(true, 16);
+  bids.insert(Decimal5::from_units(100), 1);
+  bids.insert(Decimal5::from_units(110), 1);
+  bids.insert(Decimal5::from_units(104), 1);
+  EXPECT_EQ(bids.tick(), Decimal5::from_units(2));
+  EXPECT_EQ(bids.top(top), 3);
+  EXPECT_EQ(top[0].price, Decimal5::from_units(110));
+  EXPECT_EQ(top[1].price, Decimal5::from_units(104));
+  EXPECT_EQ(top[2].price, Decimal5::from_units(100));
+  EXPECT_TRUE(bids.worse(Decimal5::from_units(99), Decimal5::from_units(100)));
+  EXPECT_THROW(PriceLadder(true, 0), std::runtime_error);
+}
+
+TEST(PriceLadderTest, GIVEN_random_orders_WHEN_moving_THEN_match_sorted_map) {
+  std::mt19937 generator{7};
+  for (const bool bids : {true, false}) {
+    // a small window, so that the best price keeps leaving it
+    PriceLadder ladder(bids, 8);
+    std::map<int64_t, PriceLevel> expected;
+    std::vector<std::pair<int64_t, int64_t>> orders;
+    std::uniform_int_distribution<int64_t> price(0, 60);
+    std::uniform_int_distribution<int64_t> volume(1, 10);
+    for (size_t step = 0; step < 20000; ++step) {
+      if (orders.empty() || generator() % 3 != 0) {
+        // on a grid of 25 units, then sometimes off it
+        const bool off_grid = step > 10000 && step % 97 == 0;
+        const int64_t mantissa = off_grid ? price(generator) * 7 + 3
+                                          : price(generator) * 25;
+        const int64_t size = volume(generator);
+        ladder.insert(Decimal5{mantissa}, size);
+        orders.emplace_back(mantissa, size);
+        auto &level = expected[mantissa];
+        level.price = Decimal5{mantissa};
+        level.volume += size;
+        ++level.orders;
+      } else {
+        const size_t index = generator() % orders.size();
+        const auto [mantissa, size] = orders[index];
+        orders[index] = orders.back();
+        orders.pop_back();
+        ladder.erase(Decimal5{mantissa}, size);
+        auto &level = expected[mantissa];
+        level.volume -= size;
+        if (--level.orders == 0) {
+          expected.erase(mantissa);
+        }
+      }
+
+      std::vector<PriceLevel> top(5);
+      const size_t count = ladder.top(top);
+      ASSERT_EQ(ladder.size(), expected.size());
+      ASSERT_EQ(count, std::min<size_t>(5, expected.size()));
+      if (step == 10000) {
+        EXPECT_EQ(ladder.tick(), Decimal5{25});
+      }
+      auto best = expected.begin();
+      auto best_bid = expected.rbegin();
+      for (size_t index = 0; index < count; ++index) {
+        ASSERT_EQ(top[index], bids ? (best_bid++)->second : (best++)->second)
+            << "step " << step << ", depth " << index;
+      }
+    }
+  }
+}
+
+TEST(MarketByPriceTest, GIVEN_order_updates_WHEN_aggregating_THEN_depth) {
+  std::vector<DepthUpdate> updates;
+  MarketByPrice book(2, [&updates](const DepthUpdate &update) {
+    updates.push_back(update);
+  });
+  const auto apply = [&book](const simba::types::OrderUpdate &update) {
+    book.on_order_update(simba::types::OrderUpdateView{update}, 1);
+  };
+
+  apply(make_order(7, 1, MDUpdateAction::New, MDEntryType::Bid, 100, 5));
+  apply(make_order(7, 2, MDUpdateAction::New, MDEntryType::Bid, 100, 3));
+  apply(make_order(7, 3, MDUpdateAction::New, MDEntryType::Bid, 99, 1));
+  apply(make_order(7, 4, MDUpdateAction::New, MDEntryType::Offer, 101, 2));
+  // below the reported depth: nothing to report
+  updates.clear();
+  apply(make_order(7, 5, MDUpdateAction::New, MDEntryType::Bid, 98, 4));
+  EXPECT_TRUE(updates.empty());
+  EXPECT_EQ(book.orders(), 5);
+  EXPECT_EQ(book.levels(7, MDEntryType::Bid, 5),
+            (std::vector<PriceLevel>{level(100, 8, 2), level(99, 1, 1),
+                                     level(98, 4, 1)}));
+
+  // the deletion of the last order of the best level shifts the depth
+  apply(make_order(7, 1, MDUpdateAction::Delete, MDEntryType::Bid, 100, 5));
+  apply(make_order(7, 2, MDUpdateAction::Delete, MDEntryType::Bid, 100, 3));
+  ASSERT_EQ(updates.size(), 3);
+  EXPECT_EQ(updates[0].volume, 3);
+  EXPECT_EQ(updates[0].orders, 1);
+  EXPECT_EQ(updates[1].depth, 0);
+  EXPECT_EQ(updates[1].price, Decimal5::from_units(99));
+  EXPECT_EQ(updates[2].depth, 1);
+  EXPECT_EQ(updates[2].price, Decimal5::from_units(98));
+  EXPECT_EQ(updates[2].to_csv_string(), "7, 1, BUY, 1, 98, 4, 1");
+
+  // a change of volume stays on its level, a change of price moves it
+  updates.clear();
+  apply(make_order(7, 4, MDUpdateAction::Change, MDEntryType::Offer, 101, 6));
+  apply(make_order(7, 3, MDUpdateAction::Change, MDEntryType::Bid, 97, 1));
+  ASSERT_EQ(updates.size(), 4);
+  EXPECT_EQ(updates[0].side, MDEntryType::Offer);
+  EXPECT_EQ(updates[0].volume, 6);
+  EXPECT_EQ(book.levels(7, MDEntryType::Bid, 5),
+            (std::vector<PriceLevel>{level(98, 4, 1), level(97, 1, 1)}));
+
+  // a partial fill, then the fill of the rest
+  simba::types::OrderExecution execution;
+  execution.md_entry_id = 4;
+  execution.md_entry_size = 2;
+  execution.last_qty = 4;
+  execution.md_update_action = MDUpdateAction::Change;
+  book.on_order_execution(simba::types::OrderExecutionView{execution}, 2);
+  EXPECT_EQ(book.levels(7, MDEntryType::Offer, 1)[0], level(101, 2, 1));
+  execution.md_entry_size = 0;
+  execution.last_qty = 2;
+  execution.md_update_action = MDUpdateAction::Delete;
+  book.on_order_execution(simba::types::OrderExecutionView{execution}, 3);
+  EXPECT_TRUE(book.levels(7, MDEntryType::Offer, 1).empty());
+  EXPECT_TRUE(updates.back().price.is_null());
+  EXPECT_EQ(updates.back().time_ns, 3);
+
+  // the orders of before the stream are unknown
+  book.on_order_execution(simba::types::OrderExecutionView{execution}, 4);
+  apply(make_order(7, 42, MDUpdateAction::Delete, MDEntryType::Bid, 98, 1));
+  EXPECT_EQ(book.unknown_orders(), 2);
+  EXPECT_EQ(book.instruments(), 1);
+  EXPECT_EQ(book.orders(), 2);
+  EXPECT_THROW(MarketByPrice(0, nullptr), std::runtime_error);
+}
+
+TEST(MarketByPriceTest, GIVEN_transactions_WHEN_conflating_THEN_report_at_end) {
+  std::vector<DepthUpdate> updates;
+  MarketByPrice book(
+      1, [&updates](const DepthUpdate &update) { updates.push_back(update); },
+      MarketByPrice::DEFAULT_WINDOW, true);
+  const MDFlagsSet end_of_transaction{MDFlagsSet::EndOfTransaction};
+  EXPECT_TRUE(end_of_transaction.end_of_transaction());
+  EXPECT_FALSE(end_of_transaction.ioc());
+  EXPECT_TRUE(MDFlagsSet{}.has(0));
+
+  auto update =
+      make_order(7, 1, MDUpdateAction::New, MDEntryType::Offer, 101, 2);
+  book.on_order_update(simba::types::OrderUpdateView{update}, 1);
+  update = make_order(7, 2, MDUpdateAction::New, MDEntryType::Bid, 99, 1);
+  update.md_flags = end_of_transaction;
+  book.on_order_update(simba::types::OrderUpdateView{update}, 2);
+  ASSERT_EQ(updates.size(), 2);
+  EXPECT_EQ(updates[0].time_ns, 2);
+  updates.clear();
+
+  // a bid crossing the offer, then the fills of both orders
+  update = make_order(7, 3, MDUpdateAction::New, MDEntryType::Bid, 101, 2);
+  book.on_order_update(simba::types::OrderUpdateView{update}, 3);
+  simba::types::OrderExecution execution;
+  execution.md_entry_id = 1;
+  execution.md_entry_size = 0;
+  execution.last_qty = 2;
+  execution.md_update_action = MDUpdateAction::Delete;
+  book.on_order_execution(simba::types::OrderExecutionView{execution}, 4);
+  EXPECT_TRUE(updates.empty());
+  execution.md_entry_id = 3;
+  execution.md_flags = end_of_transaction;
+  book.on_order_execution(simba::types::OrderExecutionView{execution}, 5);
+  // the crossed bid was never reported, only the offer left
+  ASSERT_EQ(updates.size(), 1);
+  EXPECT_EQ(updates[0].side, MDEntryType::Offer);
+  EXPECT_TRUE(updates[0].price.is_null());
+  EXPECT_EQ(updates[0].time_ns, 5);
+  EXPECT_EQ(book.transactions(), 2);
+
+  // a transaction cut by the end of the stream
+  updates.clear();
+  update = make_order(7, 4, MDUpdateAction::New, MDEntryType::Bid, 100, 1);
+  book.on_order_update(simba::types::OrderUpdateView{update}, 6);
+  EXPECT_TRUE(updates.empty());
+  book.flush();
+  ASSERT_EQ(updates.size(), 1);
+  EXPECT_EQ(updates[0].price, Decimal5::from_units(100));
+  EXPECT_EQ(updates[0].time_ns, 6);
+}
+
+TEST(MarketByPriceTest, GIVEN_saved_book_WHEN_restored_THEN_same_updates) {
+  std::vector<std::string> reported, resumed;
+  const auto make_book = [](std::vector<std::string> &updates) {
+    return MarketByPrice(
+        2,
+        [&updates](const DepthUpdate &update) {
+          updates.push_back(update.to_csv_string());
+        },
+        MarketByPrice::DEFAULT_WINDOW, true);
+  };
+  auto book = make_book(reported);
+  auto update = make_order(7, 1, MDUpdateAction::New, MDEntryType::Bid, 99, 5);
+  update.md_flags = MDFlagsSet{MDFlagsSet::EndOfTransaction};
+  book.on_order_update(simba::types::OrderUpdateView{update}, 1);
+  // saved in the middle of a transaction
+  update = make_order(7, 2, MDUpdateAction::New, MDEntryType::Offer, 101, 3);
+  book.on_order_update(simba::types::OrderUpdateView{update}, 2);
+  std::vector<std::byte> state;
+  book.save(state);
+
+  auto restored = make_book(resumed);
+  EXPECT_THROW(restored.restore(std::span(state).first(state.size() - 1)),
+               std::runtime_error);
+  restored = make_book(resumed);
+  restored.restore(state);
+  EXPECT_TRUE(resumed.empty());
+  EXPECT_EQ(restored.orders(), 2);
+  EXPECT_EQ(restored.levels(7, MDEntryType::Bid, 2),
+            book.levels(7, MDEntryType::Bid, 2));
+  EXPECT_THROW(restored.restore(state), std::runtime_error);
+  EXPECT_THROW(MarketByPrice(3, nullptr).restore(state), std::runtime_error);
+
+  // the rest of the stream reports the same updates
+  reported.clear();
+  for (auto *target : {&book, &restored}) {
+    update = make_order(7, 1, MDUpdateAction::Change, MDEntryType::Bid, 99, 4);
+    update.md_flags = MDFlagsSet{MDFlagsSet::EndOfTransaction};
+    target->on_order_update(simba::types::OrderUpdateView{update}, 3);
+    update =
+        make_order(7, 2, MDUpdateAction::Delete, MDEntryType::Offer, 101, 3);
+    target->on_order_update(simba::types::OrderUpdateView{update}, 4);
+    target->flush();
+  }
+  EXPECT_EQ(reported.size(), 3);
+  EXPECT_EQ(resumed, reported);
+}
+
+}  // namespace task::tests
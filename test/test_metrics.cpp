@@ -0,0 +1,52 @@
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+#include "metrics/metrics.h"
+
+namespace task::tests {
+
+TEST(MetricsTest,
+     GIVEN_counters_from_several_threads_WHEN_collecting_THEN_aggregate_them) {
+  if constexpr (!metrics::ENABLED) {
+    GTEST_SKIP() << "metrics compiled out";
+  }
+
+  const auto before = metrics::collect();
+
+  constexpr size_t THREADS = 4, INCREMENTS = 10000;
+  std::vector<std::thread> threads;
+  for (size_t thread = 0; thread < THREADS; ++thread) {
+    threads.emplace_back([] {
+      for (size_t increment = 0; increment < INCREMENTS; ++increment) {
+        metrics::add(metrics::Counter::PacketsFramed);
+        metrics::add_message(16);
+      }
+      metrics::add_message(1000);  // Logon, past the message ids
+      // ids outside the schema are ignored
+      metrics::add_message(999);
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  metrics::set(metrics::Gauge::QueueDepth, 3);
+
+  const auto after = metrics::collect();
+  EXPECT_EQ(after[metrics::Counter::PacketsFramed] -
+                before[metrics::Counter::PacketsFramed],
+            THREADS * INCREMENTS);
+  EXPECT_EQ(after.messages_of(16) - before.messages_of(16),
+            THREADS * INCREMENTS);
+  EXPECT_EQ(after.messages_of(1000) - before.messages_of(1000), THREADS);
+  EXPECT_EQ(after.messages_of(999), 0);
+  EXPECT_EQ(after.gauges[0], 3);
+
+  EXPECT_NE(after.to_json().find("\"queue_depth\":3"), std::string::npos);
+  EXPECT_NE(after.to_prometheus().find("simba_messages_total{template_id=\"16\"}"),
+            std::string::npos);
+  EXPECT_NE(after.to_json().find("\"1000\":"), std::string::npos);
+}
+
+}  // namespace task::tests
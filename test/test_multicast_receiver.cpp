@@ -0,0 +1,133 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <stdexcept>
+
+#include "processors/multicast_receiver.h"
+#include "processors/packet_processor.h"
+#include "processors/replay_pacer.h"
+#include "processors/udp_sender.h"
+#include "simba_decoder/simba_decoder.h"
+#include "test_vectors.h"
+
+namespace task::tests {
+
+class MulticastReceiverTestFixture : public ::testing::Test {
+  void SetUp() override {
+    message_handlers.order_update_handler =
+        [this](simba::types::OrderUpdateView) { ++decoded_updates; };
+    message_handlers.order_execution_handler =
+        [this](simba::types::OrderExecutionView) { ++decoded_executions; };
+  }
+
+ protected:
+  // Replays the UDP payloads of a capture like pcap_replay does: frames go
+  // through the PacketProcessor and their payloads to the sender
+  void replay(processors::live::UDPSender &sender, size_t repetitions) {
+    auto handler = [&sender](std::span<const std::byte> udp_payload) {
+      sender.send(udp_payload);
+    };
+    processors::PacketProcessor processor(handler);
+    const auto order_update = make_udp_frame(TEST_ORDER_UPDATE_DATA);
+    const auto order_execution = make_udp_frame(TEST_ORDER_EXECUTION_DATA);
+    for (size_t repetition = 0; repetition < repetitions; ++repetition) {
+      processor.process_packet(order_update);
+      processor.process_packet(order_execution);
+    }
+    sender.flush();
+  }
+
+  size_t receive(processors::live::MulticastReceiver &receiver,
+                 size_t expected_datagrams) {
+    simba::decoder::SIMBADecoder decoder{message_handlers};
+    size_t datagrams{0};
+    const auto deadline =
+        std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (datagrams < expected_datagrams &&
+           std::chrono::steady_clock::now() < deadline) {
+      datagrams += receiver.receive_batch(
+          [&decoder](const processors::live::Datagram &datagram) {
+            EXPECT_TRUE(decoder.decode_message(datagram.payload));
+            EXPECT_NE(datagram.timestamp_ns, 0);
+          });
+    }
+    return datagrams;
+  }
+
+  simba::decoder::MessageHandlers message_handlers;
+  size_t decoded_updates{0};
+  size_t decoded_executions{0};
+
+  static constexpr size_t REPETITIONS = 100;
+  static constexpr size_t ROUND_SIZE = 10;
+};
+
+TEST_F(MulticastReceiverTestFixture,
+       GIVEN_loopback_sender_WHEN_receiving_in_batches_THEN_decode_every_datagram) {
+  processors::live::ReceiverConfig receiver_config;
+  receiver_config.groups.push_back({"127.0.0.1", 0});
+  receiver_config.kernel_timestamps = true;
+  processors::live::MulticastReceiver receiver(receiver_config);
+
+  processors::live::SenderConfig sender_config;
+  sender_config.destinations.push_back({"127.0.0.1", receiver.local_port(0)});
+  processors::live::UDPSender sender(sender_config);
+
+  // Rounds small enough for the default socket buffer on loopback
+  size_t datagrams{0};
+  for (size_t round = 0; round < REPETITIONS / ROUND_SIZE; ++round) {
+    replay(sender, ROUND_SIZE);
+    datagrams += receive(receiver, 2 * ROUND_SIZE);
+  }
+  EXPECT_EQ(sender.datagrams_sent(), 2 * REPETITIONS);
+  EXPECT_EQ(datagrams, 2 * REPETITIONS);
+  EXPECT_EQ(decoded_updates, 2 * REPETITIONS);
+  EXPECT_EQ(decoded_executions, 16 * REPETITIONS);
+}
+
+TEST_F(MulticastReceiverTestFixture,
+       GIVEN_multicast_group_on_loopback_WHEN_joining_THEN_receive_the_feed) {
+  processors::live::ReceiverConfig receiver_config;
+  receiver_config.groups.push_back({"239.255.0.1", 0});
+  receiver_config.interface_address = "127.0.0.1";
+  receiver_config.kernel_timestamps = true;
+
+  std::unique_ptr<processors::live::MulticastReceiver> receiver;
+  std::unique_ptr<processors::live::UDPSender> sender;
+  try {
+    receiver =
+        std::make_unique<processors::live::MulticastReceiver>(receiver_config);
+    processors::live::SenderConfig sender_config;
+    sender_config.destinations.push_back(
+        {"239.255.0.1", receiver->local_port(0)});
+    sender_config.interface_address = "127.0.0.1";
+    sender = std::make_unique<processors::live::UDPSender>(sender_config);
+  } catch (const std::runtime_error &error) {
+    GTEST_SKIP() << "multicast unavailable on loopback: " << error.what();
+  }
+
+  size_t datagrams{0};
+  for (size_t round = 0; round < REPETITIONS / ROUND_SIZE; ++round) {
+    replay(*sender, ROUND_SIZE);
+    datagrams += receive(*receiver, 2 * ROUND_SIZE);
+  }
+  EXPECT_EQ(datagrams, 2 * REPETITIONS);
+  EXPECT_EQ(decoded_executions, 16 * REPETITIONS);
+}
+
+TEST(ReplayPacerTest,
+     GIVEN_capture_timestamps_WHEN_replaying_faster_THEN_scale_the_gaps) {
+  processors::live::ReplayPacer pacer(4.0);
+  const uint64_t start = pacer.deadline(1'000'000'000);
+  EXPECT_EQ(pacer.deadline(1'004'000'000) - start, 1'000'000);
+  EXPECT_EQ(pacer.deadline(999'000'000), start);
+
+  pacer.wait_until(pacer.deadline(1'004'000'000));
+  EXPECT_GE(processors::live::ReplayPacer::now(), start + 1'000'000);
+
+  processors::live::ReplayPacer as_fast_as_possible(0.0);
+  const uint64_t first = as_fast_as_possible.deadline(0);
+  EXPECT_EQ(as_fast_as_possible.deadline(60'000'000'000), first);
+}
+
+}  // namespace task::tests
@@ -0,0 +1,206 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+#include "processors/packet_processor.h"
+#include "test_vectors.h"
+
+namespace task::tests {
+
+class PacketProcessorTestFixture : public ::testing::Test {
+ protected:
+  static std::vector<std::byte> make_frame(uint16_t destination_port) {
+    auto frame = make_udp_frame(TEST_ORDER_UPDATE_DATA, destination_port);
+    // source 10.0.0.1:16001, destination 239.195.1.1
+    constexpr size_t IP_OFFSET = 14, UDP_OFFSET = 34;
+    const std::byte addresses[] = {std::byte{10},  std::byte{0},
+                                   std::byte{0},   std::byte{1},
+                                   std::byte{239}, std::byte{195},
+                                   std::byte{1},   std::byte{1}};
+    std::copy(std::begin(addresses), std::end(addresses),
+              frame.begin() + IP_OFFSET + 12);
+    frame[UDP_OFFSET] = std::byte{16001 >> 8};
+    frame[UDP_OFFSET + 1] = std::byte{16001 & 0xFF};
+    return frame;
+  }
+
+  std::vector<std::span<const std::byte>> payloads_;
+  std::function<void(std::span<const std::byte>)> handler_{
+      [this](std::span<const std::byte> payload) {
+        payloads_.push_back(payload);
+      }};
+  processors::PacketProcessor<decltype(handler_)> processor_{handler_};
+};
+
+TEST_F(PacketProcessorTestFixture,
+       GIVEN_a_mixed_batch_WHEN_parsing_THEN_emit_udp_payloads_and_flows) {
+  const auto first = make_frame(20081);
+  const auto second = make_frame(20082);
+  auto tcp = make_frame(20081);
+  tcp[14 + 9] = std::byte{0x06};
+  auto vlan = make_frame(20081);
+  vlan[12] = std::byte{0x81};
+  const auto truncated =
+      std::vector<std::byte>(first.begin(), first.end() - 10);
+
+  const std::vector<processors::PacketView> batch{
+      first, tcp, truncated, second, vlan, first, first, second};
+  const auto datagrams = processor_.parse_batch(batch);
+
+  ASSERT_EQ(datagrams.size(), 5);
+  EXPECT_EQ(processor_.packets_malformed(), 1);
+  const std::vector<uint16_t> expected_ports{20081, 20082, 20081, 20081,
+                                             20082};
+  for (size_t index = 0; index < datagrams.size(); ++index) {
+    const auto &datagram = datagrams[index];
+    EXPECT_EQ(datagram.flow.source_address, 0x0A000001);
+    EXPECT_EQ(datagram.flow.destination_address, 0xEFC30101);
+    EXPECT_EQ(datagram.flow.source_port, 16001);
+    EXPECT_EQ(datagram.flow.destination_port, expected_ports[index]);
+    ASSERT_EQ(datagram.payload.size(), TEST_ORDER_UPDATE_DATA.size());
+    EXPECT_TRUE(std::equal(datagram.payload.begin(), datagram.payload.end(),
+                           TEST_ORDER_UPDATE_DATA.begin()));
+  }
+}
+
+TEST_F(PacketProcessorTestFixture,
+       GIVEN_a_batch_WHEN_processing_THEN_match_the_per_packet_path) {
+  const auto frame = make_frame(20081);
+  auto padded = frame;
+  padded.resize(padded.size() + 6);  // Ethernet padding is not payload
+  auto bad_ihl = frame;
+  bad_ihl[14] = std::byte{0x44};
+
+  const std::vector<processors::PacketView> batch{frame, padded, bad_ihl,
+                                                  frame};
+  for (const auto &packet : batch) {
+    processor_.process_packet(packet);
+  }
+  const auto per_packet = payloads_;
+  payloads_.clear();
+  processor_.process_batch(batch);
+
+  ASSERT_EQ(payloads_.size(), 3);
+  ASSERT_EQ(per_packet.size(), 3);
+  for (size_t index = 0; index < payloads_.size(); ++index) {
+    EXPECT_EQ(payloads_[index].data(), per_packet[index].data());
+    EXPECT_EQ(payloads_[index].size(), per_packet[index].size());
+  }
+  EXPECT_EQ(processor_.packets_malformed(), 2);
+}
+
+TEST_F(PacketProcessorTestFixture,
+       GIVEN_vlan_tagged_frames_WHEN_parsing_THEN_walk_the_tags) {
+  const auto frame = make_frame(20081);
+  const auto dot1q = add_vlan_tags(frame, {0x8100});
+  const auto qinq = add_vlan_tags(frame, {0x88A8, 0x8100});
+  auto tagged_arp = dot1q;
+  tagged_arp[16] = std::byte{0x08};
+  tagged_arp[17] = std::byte{0x06};
+  const auto too_many_tags =
+      add_vlan_tags(frame, {0x8100, 0x8100, 0x8100, 0x8100, 0x8100});
+  const auto truncated_tag = std::vector<std::byte>(qinq.begin(),
+                                                    qinq.begin() + 17);
+
+  const std::vector<processors::PacketView> batch{
+      dot1q, qinq, tagged_arp, too_many_tags, truncated_tag};
+  const auto datagrams = processor_.parse_batch(batch);
+
+  ASSERT_EQ(datagrams.size(), 2);
+  EXPECT_EQ(processor_.packets_malformed(), 2);
+  for (const auto &datagram : datagrams) {
+    EXPECT_EQ(datagram.flow.destination_address, 0xEFC30101);
+    EXPECT_EQ(datagram.flow.destination_port, 20081);
+    EXPECT_EQ(datagram.payload.size(), TEST_ORDER_UPDATE_DATA.size());
+  }
+}
+
+TEST_F(PacketProcessorTestFixture,
+       GIVEN_linux_cooked_captures_WHEN_parsing_THEN_use_the_link_type) {
+  const auto frame = make_frame(20081);
+  const auto sll = to_linux_cooked_frame(frame, 1);
+  const auto sll2 = to_linux_cooked_frame(frame, 2);
+  const auto tagged_sll2 =
+      to_linux_cooked_frame(add_vlan_tags(frame, {0x8100}), 2);
+
+  const auto parse = [](auto link, processors::PacketView packet) {
+    std::vector<processors::PacketView> batch{packet};
+    auto handler = [](std::span<const std::byte>) {};
+    processors::PacketProcessor<decltype(handler), decltype(link)> processor(
+        handler);
+    const auto datagrams = processor.parse_batch(batch);
+    return datagrams.empty() ? transport_layer::UDPDatagramView{}
+                             : datagrams.front();
+  };
+  for (const auto &datagram :
+       {parse(transport_layer::LinuxSLLLink{}, sll),
+        parse(transport_layer::LinuxSLL2Link{}, sll2),
+        parse(transport_layer::LinuxSLL2Link{}, tagged_sll2)}) {
+    EXPECT_EQ(datagram.flow.source_address, 0x0A000001);
+    EXPECT_EQ(datagram.flow.destination_port, 20081);
+    EXPECT_EQ(datagram.payload.size(), TEST_ORDER_UPDATE_DATA.size());
+  }
+
+  size_t visited{0};
+  EXPECT_TRUE(transport_layer::visit_link_type(
+      276, [&visited]<typename LinkLayer>(LinkLayer) {
+        visited = static_cast<size_t>(LinkLayer::LINK_TYPE);
+      }));
+  EXPECT_EQ(visited, 276);
+  EXPECT_FALSE(transport_layer::visit_link_type(101, [](auto) {}));
+}
+
+TEST_F(PacketProcessorTestFixture,
+       GIVEN_a_fragmented_datagram_WHEN_processing_THEN_decode_it_whole) {
+  std::vector<std::byte> snapshot_payload(4000);
+  for (size_t index = 0; index < snapshot_payload.size(); ++index) {
+    snapshot_payload[index] = std::byte(index * 7);
+  }
+  auto fragments =
+      fragment_frame(make_udp_frame(snapshot_payload, 20082), 1480);
+  ASSERT_EQ(fragments.size(), 3);
+  fragments.back().resize(fragments.back().size() + 20);  // padding
+  const auto frame = make_frame(20081);
+
+  // fragments interleaved with whole datagrams, the last one first
+  const std::vector<processors::PacketView> batch{
+      fragments[2], frame, fragments[0], fragments[1], frame};
+  processor_.process_batch(batch);
+
+  ASSERT_EQ(payloads_.size(), 3);
+  EXPECT_EQ(payloads_[0].size(), TEST_ORDER_UPDATE_DATA.size());
+  ASSERT_EQ(payloads_[1].size(), snapshot_payload.size());
+  EXPECT_TRUE(std::equal(payloads_[1].begin(), payloads_[1].end(),
+                         snapshot_payload.begin()));
+  EXPECT_EQ(payloads_[2].size(), TEST_ORDER_UPDATE_DATA.size());
+  EXPECT_EQ(processor_.reassembler().datagrams_reassembled(), 1);
+  EXPECT_EQ(processor_.packets_malformed(), 0);
+}
+
+TEST_F(PacketProcessorTestFixture,
+       GIVEN_a_capture_gap_WHEN_reassembling_THEN_expire_the_fragments) {
+  std::vector<std::byte> snapshot_payload(4000);
+  const auto fragments =
+      fragment_frame(make_udp_frame(snapshot_payload, 20082), 1480);
+  ASSERT_EQ(fragments.size(), 3);
+  const std::vector<processors::PacketView> batch{fragments[0], fragments[1],
+                                                  fragments[2]};
+
+  // the record timestamps clock the timeout (1s), whatever the decoding
+  // speed: 2s between the first fragments expires the datagram
+  const std::vector<pcap::types::pcaprec_hdr_s> late{
+      {.ts_sec = 10}, {.ts_sec = 12}, {.ts_sec = 12}};
+  processor_.process_batch(batch, late);
+  EXPECT_TRUE(payloads_.empty());
+  EXPECT_EQ(processor_.reassembler().fragments_dropped(), 1);
+
+  const std::vector<pcap::types::pcaprec_hdr_s> close{
+      {.ts_sec = 20}, {.ts_sec = 20, .ts_usec = 500'000'000}, {.ts_sec = 20}};
+  processor_.process_batch(batch, close);
+  ASSERT_EQ(payloads_.size(), 1);
+  EXPECT_EQ(payloads_[0].size(), snapshot_payload.size());
+}
+
+}  // namespace task::tests
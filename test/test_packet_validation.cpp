@@ -0,0 +1,130 @@
+#include <gtest/gtest.h>
+
+#include <functional>
+#include <random>
+#include <vector>
+
+#include "processors/checksum.h"
+#include "processors/packet_processor.h"
+#include "test_vectors.h"
+
+namespace task::tests {
+
+namespace {
+// source 10.0.0.1:16001, destination 239.195.1.1:20081, checksums filled
+std::vector<std::byte> make_frame() {
+  auto frame = make_udp_frame(TEST_ORDER_UPDATE_DATA, 20081);
+  constexpr size_t IP_OFFSET = 14, UDP_OFFSET = 34;
+  const std::byte addresses[] = {std::byte{10},  std::byte{0},
+                                 std::byte{0},   std::byte{1},
+                                 std::byte{239}, std::byte{195},
+                                 std::byte{1},   std::byte{1}};
+  std::copy(std::begin(addresses), std::end(addresses),
+            frame.begin() + IP_OFFSET + 12);
+  frame[UDP_OFFSET] = std::byte{16001 >> 8};
+  frame[UDP_OFFSET + 1] = std::byte{16001 & 0xFF};
+  return add_checksums(std::move(frame));
+}
+}  // namespace
+
+TEST(ChecksumTest, GIVEN_an_ip_header_WHEN_summing_THEN_match_rfc_1071) {
+  // 192.168.0.1 -> 192.168.0.199, checksum 0xB861
+  const std::vector<std::byte> header = {
+      std::byte{0x45}, std::byte{0x00}, std::byte{0x00}, std::byte{0x73},
+      std::byte{0x00}, std::byte{0x00}, std::byte{0x40}, std::byte{0x00},
+      std::byte{0x40}, std::byte{0x11}, std::byte{0xB8}, std::byte{0x61},
+      std::byte{0xC0}, std::byte{0xA8}, std::byte{0x00}, std::byte{0x01},
+      std::byte{0xC0}, std::byte{0xA8}, std::byte{0x00}, std::byte{0xC7}};
+  EXPECT_EQ(transport_layer::ones_complement_sum(header), 0xFFFF);
+
+  auto without_checksum = header;
+  without_checksum[10] = without_checksum[11] = std::byte{0};
+  EXPECT_EQ(transport_layer::ones_complement_sum(without_checksum),
+            static_cast<uint16_t>(~0xB861));
+  // an odd trailing byte is the high byte of a zero padded word
+  EXPECT_EQ(transport_layer::ones_complement_sum(
+                std::span<const std::byte>(header).first(1)),
+            0x4500);
+  EXPECT_EQ(transport_layer::ones_complement_sum({}, 0x1234), 0x1234);
+}
+
+TEST(ChecksumTest, GIVEN_random_buffers_WHEN_summing_THEN_avx2_matches_scalar) {
+  if (!transport_layer::detail::avx2_supported()) {
+    GTEST_SKIP() << "AVX2 not supported";
+  }
+  std::mt19937 generator(42);
+  std::vector<std::byte> buffer(1 << 20);
+  for (auto &byte : buffer) {
+    byte = std::byte(generator());
+  }
+
+  const std::span<const std::byte> data(buffer);
+  for (size_t size = 0; size < 300; ++size) {
+    const auto initial = static_cast<uint16_t>(generator());
+    const auto chunk = data.subspan(size % 7, size);
+    EXPECT_EQ(transport_layer::detail::ones_complement_sum_avx2(chunk, initial),
+              transport_layer::detail::ones_complement_sum_scalar(chunk, initial))
+        << "size " << size;
+  }
+  // long enough to flush the 32-bit lanes
+  EXPECT_EQ(transport_layer::detail::ones_complement_sum_avx2(data, 0),
+            transport_layer::detail::ones_complement_sum_scalar(data, 0));
+
+  const std::vector<std::byte> ones(1 << 20, std::byte{0xFF});
+  EXPECT_EQ(transport_layer::detail::ones_complement_sum_avx2(ones, 0), 0xFFFF);
+}
+
+TEST(PacketValidationTest,
+     GIVEN_corrupt_packets_WHEN_verifying_THEN_report_them_per_flow) {
+  std::vector<std::span<const std::byte>> payloads;
+  std::function<void(std::span<const std::byte>)> handler =
+      [&payloads](std::span<const std::byte> payload) {
+        payloads.push_back(payload);
+      };
+
+  const auto valid = make_frame();
+  auto bad_udp = valid;
+  bad_udp.back() ^= std::byte{0x01};
+  auto bad_ip = valid;
+  bad_ip[14 + 8] = std::byte{1};  // TTL
+  const std::vector<std::byte> truncated(valid.begin(), valid.end() - 4);
+  auto no_udp_checksum = bad_udp;
+  no_udp_checksum[34 + 6] = no_udp_checksum[34 + 7] = std::byte{0};
+
+  const std::vector<transport_layer::PacketView> batch = {
+      valid, bad_udp, bad_ip, truncated, no_udp_checksum};
+
+  // off by default: only the truncated capture is rejected, as malformed
+  processors::PacketProcessor<decltype(handler)> unchecked(handler);
+  EXPECT_EQ(unchecked.parse_batch(batch).size(), 4);
+  EXPECT_EQ(unchecked.packets_malformed(), 1);
+  EXPECT_EQ(unchecked.validation_report().invalid_packets(), 0);
+
+  processors::PacketProcessor<decltype(handler)> reporting(
+      handler, {.verify_checksums = true, .drop_invalid = false});
+  EXPECT_EQ(reporting.parse_batch(batch).size(), 4);
+  EXPECT_EQ(reporting.packets_malformed(), 0);
+
+  const auto &report = reporting.validation_report();
+  EXPECT_EQ(report.invalid_packets(), 3);
+  ASSERT_EQ(report.flows().size(), 1);
+  const auto &flow = report.flows().front();
+  EXPECT_EQ(flow.flow, (transport_layer::FlowKey{0x0A000001, 0xEFC30101, 16001,
+                                                 20081}));
+  EXPECT_EQ(flow.truncated, 1);
+  EXPECT_EQ(flow.bad_ip_checksum, 1);
+  EXPECT_EQ(flow.bad_udp_checksum, 1);
+  EXPECT_EQ(flow.to_string(),
+            "10.0.0.1:16001 -> 239.195.1.1:20081 truncated 1, bad IP checksum "
+            "1, bad UDP checksum 1");
+
+  processors::PacketProcessor<decltype(handler)> dropping(
+      handler, {.verify_checksums = true, .drop_invalid = true});
+  dropping.process_batch(batch);
+  ASSERT_EQ(payloads.size(), 2);
+  EXPECT_EQ(payloads[0].data(), valid.data() + 42);
+  EXPECT_EQ(payloads[1].data(), no_udp_checksum.data() + 42);
+  EXPECT_EQ(dropping.validation_report().invalid_packets(), 3);
+}
+
+}  // namespace task::tests
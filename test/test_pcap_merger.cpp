@@ -0,0 +1,102 @@
+#include <gtest/gtest.h>
+
+#include <unistd.h>
+
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+#include "processors/pcap_merger.h"
+#include "processors/pcap_processor.h"
+#include "test_vectors.h"
+
+namespace task::tests {
+
+class PCAPMergerTestFixture : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    directory_ = std::filesystem::temp_directory_path() /
+                 ("test_pcap_merger_" + std::to_string(::getpid()));
+    std::filesystem::create_directories(directory_);
+  }
+
+  void TearDown() override { std::filesystem::remove_all(directory_); }
+
+  // one order update per destination port
+  void write_capture(const std::string &name,
+                     const std::vector<uint16_t> &ports,
+                     uint32_t first_timestamp_ns, uint32_t link_type = 1) {
+    std::vector<std::vector<std::byte>> frames;
+    for (const auto port : ports) {
+      frames.push_back(make_udp_frame(TEST_ORDER_UPDATE_DATA, port));
+    }
+    const auto capture = make_pcap_file(frames, link_type, first_timestamp_ns);
+    std::ofstream file(directory_ / name, std::ios::binary);
+    file.write(reinterpret_cast<const char *>(capture.data()),
+               static_cast<std::streamsize>(capture.size()));
+  }
+
+  static uint16_t destination_port(transport_layer::PacketView frame) {
+    constexpr size_t DESTINATION_PORT_OFFSET = 14 + 20 + 2;
+    return transport_layer::read_big_endian_u16(frame.data() +
+                                                DESTINATION_PORT_OFFSET);
+  }
+
+  std::filesystem::path directory_{};
+};
+
+TEST_F(PCAPMergerTestFixture,
+       GIVEN_interleaved_captures_WHEN_merging_THEN_emit_them_in_time_order) {
+  // two interfaces recorded together, then a rotated file of the first one
+  write_capture("eth0_0.pcap", {1, 3, 5}, 0);
+  write_capture("eth1_0.pcap", {2, 4, 6}, 500'000);
+  write_capture("eth0_1.pcap", {7}, 10'000'000);
+  write_capture("empty.pcap", {}, 0);
+  write_capture(".partial.pcap", {8}, 0);
+
+  const auto files = processors::list_captures({directory_.string()});
+  ASSERT_EQ(files.size(), 4);
+  EXPECT_EQ(files.front().filename(), "empty.pcap");
+  EXPECT_EQ(files.back().filename(), "eth1_0.pcap");
+
+  {
+    processors::PCAPMerger merger(files);
+    const auto &merged = merger.next_batch();
+    ASSERT_EQ(merged.packets.size(), 7);
+    for (size_t index = 0; index < merged.packets.size(); ++index) {
+      EXPECT_EQ(destination_port(merged.packets[index]), index + 1);
+      if (index > 0) {
+        EXPECT_LT(merged.headers[index - 1].ts_usec,
+                  merged.headers[index].ts_usec);
+      }
+    }
+    EXPECT_TRUE(merger.next_batch().packets.empty());
+  }
+
+  size_t updates{0};
+  simba::decoder::MessageHandlers handlers;
+  handlers.order_update_handler = [&updates](simba::types::OrderUpdateView) {
+    ++updates;
+  };
+  simba::decoder::SIMBADecoder reference(handlers);
+  reference.decode_message(TEST_ORDER_UPDATE_DATA);
+  const size_t expected_updates = updates;
+  updates = 0;
+
+  { processors::PCAPProcessor processor({directory_.string()}, handlers); }
+  EXPECT_EQ(updates, 7 * expected_updates);
+}
+
+TEST_F(PCAPMergerTestFixture,
+       GIVEN_captures_with_different_link_types_WHEN_merging_THEN_throw) {
+  write_capture("ethernet.pcap", {1}, 0);
+  write_capture("cooked.pcap", {2}, 0, 113);
+
+  EXPECT_THROW(
+      processors::PCAPMerger(processors::list_captures({directory_.string()})),
+      std::runtime_error);
+  EXPECT_THROW(processors::list_captures({}), std::runtime_error);
+}
+
+}  // namespace task::tests
@@ -0,0 +1,120 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+#include "versioned_messages.h"
+
+namespace task::tests {
+
+namespace versioned {
+// the layout of each version is a prefix of the next one
+static_assert(Quote::min_block_length(0) == 12);
+static_assert(Quote::min_block_length(1) == 12);
+static_assert(Quote::min_block_length(2) == Quote::BLOCK_LENGTH);
+static_assert(Quote::Levels::min_block_length(2) == 8);
+static_assert(Quote::Levels::min_block_length(3) == 12);
+static_assert(Status::SINCE_VERSION == 3);
+}  // namespace versioned
+
+namespace {
+// A Quote as encoded by the given version of the schema: the root block
+// and the levels end with the last field of that version
+std::vector<std::byte> encode_quote(uint16_t version,
+                                    const versioned::Quote &quote,
+                                    const versioned::Quote::Levels &level) {
+  const size_t block_length = versioned::Quote::min_block_length(version);
+  const auto level_length = static_cast<uint16_t>(
+      versioned::Quote::Levels::min_block_length(version));
+  const versioned::GroupSize group_size{level_length, 1};
+
+  std::vector<std::byte> bytes(block_length + sizeof(group_size) +
+                               level_length);
+  std::memcpy(bytes.data(), &quote, block_length);
+  std::memcpy(bytes.data() + block_length, &group_size, sizeof(group_size));
+  std::memcpy(bytes.data() + block_length + sizeof(group_size), &level,
+              level_length);
+  return bytes;
+}
+
+uint16_t layout(uint16_t schema_id, uint16_t version) {
+  uint16_t selected = UINT16_MAX;
+  versioned::visit_version(schema_id, version,
+                           [&selected](auto layout_version) {
+                             selected = decltype(layout_version)::value;
+                           });
+  return selected;
+}
+}  // namespace
+
+TEST(SBECodegenTest, GIVEN_schema_versions_WHEN_dispatching_THEN_layout) {
+  // the versions without new fields decode with the previous layout
+  EXPECT_EQ(layout(versioned::SCHEMA_ID, 0), 0);
+  EXPECT_EQ(layout(versioned::SCHEMA_ID, 1), 0);
+  EXPECT_EQ(layout(versioned::SCHEMA_ID, 2), 2);
+  EXPECT_EQ(layout(versioned::SCHEMA_ID, 3), 3);
+  EXPECT_EQ(layout(versioned::SCHEMA_ID, 9), 3);
+  EXPECT_FALSE(versioned::visit_version(versioned::SCHEMA_ID + 1, 3,
+                                        [](auto) { FAIL(); }));
+
+  // the templates of a newer version are unknown to the older ones
+  const auto ignore = []<typename View>(std::type_identity<View>) {};
+  EXPECT_FALSE(
+      versioned::visit_template<2>(versioned::Status::TEMPLATE_ID, ignore));
+  EXPECT_TRUE(
+      versioned::visit_template<3>(versioned::Status::TEMPLATE_ID, ignore));
+}
+
+TEST(SBECodegenTest, GIVEN_older_version_WHEN_viewing_THEN_new_fields_null) {
+  versioned::Quote quote;
+  quote.security_id = 42;
+  quote.bid_px = versioned::Decimal5::from_units(10);
+  quote.offer_px = versioned::Decimal5::from_units(11);
+  versioned::Quote::Levels level;
+  level.px = versioned::Decimal5::from_units(9);
+  level.qty = 5;
+
+  // version 1: no offer_px in the block, no qty in the levels
+  const auto v1 = encode_quote(1, quote, level);
+  const auto size = versioned::QuoteView::wire_size<0>(
+      v1.data(), versioned::Quote::min_block_length(1), v1.size());
+  ASSERT_TRUE(size);
+  EXPECT_EQ(*size, v1.size());
+  // the decoder of version 2 expects offer_px: the block is malformed
+  EXPECT_FALSE(versioned::QuoteView::wire_size<2>(
+      v1.data(), versioned::Quote::min_block_length(1), v1.size()));
+
+  const bool known = versioned::visit_message<0>(
+      versioned::Quote::TEMPLATE_ID, v1.data(),
+      versioned::Quote::min_block_length(1), [&](auto view) {
+        if constexpr (std::is_same_v<decltype(view), versioned::QuoteView>) {
+          EXPECT_EQ(view.security_id(), 42);
+          EXPECT_EQ(view.bid_px(), versioned::Decimal5::from_units(10));
+          EXPECT_TRUE(view.offer_px().is_null());
+          ASSERT_EQ(view.levels().size(), 1);
+          EXPECT_EQ(view.levels()[0].px(), versioned::Decimal5::from_units(9));
+          EXPECT_EQ(view.levels()[0].qty(), INT32_MIN);
+          EXPECT_EQ(view.size_bytes(), v1.size());
+          // the copies are normalised the same way
+          EXPECT_EQ(view.to_string(),
+                    "Quote(security_id: 42, bid_px: 10, offer_px: NULL)");
+          EXPECT_EQ(view.levels()[0].to_message().qty, INT32_MIN);
+        } else {
+          FAIL();
+        }
+      });
+  EXPECT_TRUE(known);
+
+  // version 3 carries every field
+  const auto v3 = encode_quote(3, quote, level);
+  const versioned::QuoteView view{v3.data(), versioned::Quote::BLOCK_LENGTH};
+  EXPECT_EQ(view.offer_px(), versioned::Decimal5::from_units(11));
+  EXPECT_EQ(view.levels()[0].qty(), 5);
+  EXPECT_EQ(versioned::QuoteView::wire_size<3>(
+                v3.data(), versioned::Quote::BLOCK_LENGTH, v3.size()),
+            v3.size());
+}
+
+}  // namespace task::tests
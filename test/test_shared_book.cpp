@@ -0,0 +1,123 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include "market_data/shared_book.h"
+#include "test_vectors.h"
+
+namespace task::tests {
+
+using market_data::PriceLevel;
+using market_data::SharedBookPublisher;
+using market_data::SharedBookReader;
+using market_data::SharedBookSnapshot;
+using simba::types::Decimal5;
+using simba::types::MDEntryType;
+using simba::types::MDFlagsSet;
+using simba::types::MDUpdateAction;
+
+TEST(SharedBookTest, GIVEN_order_updates_WHEN_published_THEN_read_levels) {
+  const auto name = segment_name("levels");
+  EXPECT_THROW(SharedBookReader{name}, std::runtime_error);
+  {
+    SharedBookPublisher publisher(name, 2, 1);
+    const auto apply = [&publisher](const simba::types::OrderUpdate &update,
+                                    uint64_t time_ns) {
+      publisher.on_order_update(simba::types::OrderUpdateView{update},
+                                time_ns);
+    };
+
+    SharedBookReader reader(name);
+    EXPECT_EQ(reader.depth(), 2);
+    EXPECT_EQ(reader.capacity(), 1);
+    EXPECT_EQ(reader.instruments(), 0);
+    EXPECT_FALSE(reader.find(7));
+
+    apply(make_order(7, 1, MDUpdateAction::New, MDEntryType::Bid, 99, 5), 1);
+    apply(make_order(7, 2, MDUpdateAction::New, MDEntryType::Bid, 98, 1), 2);
+    apply(make_order(7, 3, MDUpdateAction::New, MDEntryType::Offer, 101, 2),
+          3);
+    // past the capacity of the segment
+    apply(make_order(8, 4, MDUpdateAction::New, MDEntryType::Bid, 10, 1), 4);
+    EXPECT_EQ(publisher.dropped_instruments(), 1);
+    EXPECT_EQ(publisher.commits(), 3);
+
+    const auto slot = reader.find(7);
+    ASSERT_TRUE(slot);
+    EXPECT_FALSE(reader.find(8));
+    SharedBookSnapshot snapshot;
+    ASSERT_TRUE(reader.read(*slot, snapshot));
+    EXPECT_EQ(snapshot.security_id, 7);
+    EXPECT_EQ(snapshot.time_ns, 3);
+    EXPECT_EQ(snapshot.version, 3);
+    EXPECT_EQ(snapshot.bids[0],
+              (PriceLevel{Decimal5::from_units(99), 5, 1}));
+    EXPECT_EQ(snapshot.bids[1],
+              (PriceLevel{Decimal5::from_units(98), 1, 1}));
+    EXPECT_EQ(snapshot.offers[0],
+              (PriceLevel{Decimal5::from_units(101), 2, 1}));
+    EXPECT_TRUE(snapshot.offers[1].empty());
+    EXPECT_FALSE(reader.read(1, snapshot));
+
+    // a newer publisher gets its own segment, the reader keeps the old one
+    SharedBookPublisher next(name, 2, 1);
+    apply(make_order(7, 1, MDUpdateAction::Delete, MDEntryType::Bid, 99, 5),
+          5);
+    ASSERT_TRUE(reader.read(*slot, snapshot));
+    EXPECT_EQ(snapshot.bids[0].price, Decimal5::from_units(98));
+    EXPECT_EQ(SharedBookReader(name).instruments(), 0);
+  }
+  EXPECT_TRUE(SharedBookPublisher::remove(name));
+  EXPECT_FALSE(SharedBookPublisher::remove(name));
+}
+
+TEST(SharedBookTest, GIVEN_concurrent_writes_WHEN_reading_THEN_consistent) {
+  const auto name = segment_name("seqlock");
+  SharedBookPublisher publisher(name, 2, 1, true);
+  SharedBookReader reader(name);
+  constexpr int64_t UPDATES = 20'000;
+
+  // two bid levels changed together by every transaction
+  auto first = make_order(7, 1, MDUpdateAction::New, MDEntryType::Bid, 99, 1);
+  auto second = make_order(7, 2, MDUpdateAction::New, MDEntryType::Bid, 98, 1);
+  second.md_flags = MDFlagsSet{MDFlagsSet::EndOfTransaction};
+  publisher.on_order_update(simba::types::OrderUpdateView{first}, 0);
+  publisher.on_order_update(simba::types::OrderUpdateView{second}, 0);
+  ASSERT_TRUE(reader.find(7));
+
+  std::atomic<bool> done{false};
+  std::thread writer([&] {
+    first.md_update_action = MDUpdateAction::Change;
+    second.md_update_action = MDUpdateAction::Change;
+    for (int64_t volume = 2; volume <= UPDATES; ++volume) {
+      first.md_entry_size = volume;
+      second.md_entry_size = volume;
+      publisher.on_order_update(simba::types::OrderUpdateView{first}, volume);
+      publisher.on_order_update(simba::types::OrderUpdateView{second},
+                                volume);
+    }
+    done = true;
+  });
+
+  SharedBookSnapshot snapshot;
+  size_t reads = 0;
+  int64_t last = 0;
+  while (!done || last != UPDATES) {
+    ASSERT_TRUE(reader.read(0, snapshot));
+    // never the first level of a transaction with the second of another
+    ASSERT_EQ(snapshot.bids[0].volume, snapshot.bids[1].volume);
+    ASSERT_GE(snapshot.bids[0].volume, last);
+    last = snapshot.bids[0].volume;
+    ++reads;
+  }
+  writer.join();
+  EXPECT_GT(reads, 0);
+  EXPECT_EQ(snapshot.time_ns, UPDATES);
+  SharedBookPublisher::remove(name);
+}
+
+}  // namespace task::tests
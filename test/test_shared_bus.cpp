@@ -0,0 +1,101 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+#include "market_data/shared_bus.h"
+#include "test_vectors.h"
+
+namespace task::tests {
+
+using market_data::BusEvent;
+using market_data::SharedBusReader;
+using market_data::SharedBusWriter;
+using simba::types::Decimal5;
+using simba::types::OrderExecution;
+using simba::types::OrderUpdate;
+
+namespace {
+void publish_update(SharedBusWriter &writer, int64_t id) {
+  OrderUpdate update;
+  update.md_entry_id = id;
+  update.md_entry_px = Decimal5::from_units(100 + id);
+  update.md_entry_size = id;
+  update.security_id = 7;
+  writer.publish(simba::types::OrderUpdateView{update}, id, 0);
+}
+}  // namespace
+
+TEST(SharedBusTest, GIVEN_messages_WHEN_published_THEN_readers_follow) {
+  const auto name = segment_name("bus_follow");
+  EXPECT_THROW(SharedBusReader{name}, std::runtime_error);
+  EXPECT_THROW(SharedBusWriter(name, 3), std::runtime_error);
+  {
+    SharedBusWriter writer(name, 4);
+    SharedBusReader reader(name);
+    BusEvent event;
+    EXPECT_FALSE(reader.poll(event));
+
+    publish_update(writer, 1);
+    OrderExecution execution;
+    execution.md_entry_id = 1;
+    execution.last_px = Decimal5::from_units(101);
+    execution.last_qty = 1;
+    execution.trade_id = 42;
+    execution.security_id = 7;
+    writer.publish(simba::types::OrderExecutionView{execution}, 2, 3);
+    EXPECT_EQ(writer.published(), 2);
+
+    ASSERT_EQ(reader.poll(event), 0);
+    EXPECT_EQ(event.capture_time_ns, 1);
+    EXPECT_FALSE(event.as<OrderExecution>());
+    const auto update = event.as<OrderUpdate>();
+    ASSERT_TRUE(update);
+    EXPECT_EQ(update->md_entry_px, Decimal5::from_units(101));
+
+    ASSERT_EQ(reader.poll(event), 1);
+    EXPECT_EQ(event.transact_time_ns, 3);
+    EXPECT_EQ(event.length, sizeof(OrderExecution));
+    const auto executed = event.as<OrderExecution>();
+    ASSERT_TRUE(executed);
+    EXPECT_EQ(executed->trade_id, 42);
+    EXPECT_EQ(executed->last_qty, 1);
+    EXPECT_FALSE(reader.poll(event));
+    EXPECT_EQ(reader.lost(), 0);
+
+    // a late reader starts at the next event, or replays the ring
+    EXPECT_EQ(SharedBusReader(name).cursor(), 2);
+    SharedBusReader replay(name, true);
+    EXPECT_EQ(replay.poll(event), 0);
+  }
+  EXPECT_TRUE(SharedBusWriter::remove(name));
+  EXPECT_FALSE(SharedBusWriter::remove(name));
+}
+
+TEST(SharedBusTest, GIVEN_slow_reader_WHEN_lapped_THEN_count_lost_events) {
+  const auto name = segment_name("bus_lapped");
+  SharedBusWriter writer(name, 4);
+  SharedBusReader reader(name);
+  for (int64_t id = 0; id < 10; ++id) {
+    publish_update(writer, id);
+  }
+
+  // events 0 to 5 overwritten
+  BusEvent event;
+  ASSERT_EQ(reader.poll(event), 6);
+  EXPECT_EQ(event.as<OrderUpdate>()->md_entry_id, 6);
+  EXPECT_EQ(reader.lost(), 6);
+  EXPECT_EQ(reader.poll(event), 7);
+  EXPECT_EQ(reader.poll(event), 8);
+  EXPECT_EQ(reader.poll(event), 9);
+  EXPECT_FALSE(reader.poll(event));
+
+  SharedBusReader replay(name, true);
+  EXPECT_EQ(replay.cursor(), 6);
+  EXPECT_EQ(replay.poll(event), 6);
+  EXPECT_EQ(replay.lost(), 0);
+  SharedBusWriter::remove(name);
+}
+
+}  // namespace task::tests
@@ -1,387 +1,15 @@
 #include <gtest/gtest.h>
 
+#include <cstring>
+#include <random>
+#include <vector>
+
 #include "simba_decoder/simba_decoder.h"
 #include "simba_decoder/simba_types.h"
+#include "test_vectors.h"
 
 namespace task::tests {
 
-static std::vector<std::byte> TEST_ORDER_UPDATE_DATA = {
-    std::byte{0xfb}, std::byte{0xf},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x56}, std::byte{0x0},  std::byte{0x9},  std::byte{0x0},
-    std::byte{0xff}, std::byte{0x10}, std::byte{0x8d}, std::byte{0xf5},
-    std::byte{0xbf}, std::byte{0xa8}, std::byte{0x8c}, std::byte{0x17},
-    std::byte{0x21}, std::byte{0xee}, std::byte{0x8d}, std::byte{0xf5},
-    std::byte{0xbf}, std::byte{0xa8}, std::byte{0x8c}, std::byte{0x17},
-    std::byte{0xf6}, std::byte{0x1a}, std::byte{0x0},  std::byte{0x0},
-    std::byte{0x32}, std::byte{0x0},  std::byte{0xf},  std::byte{0x0},
-    std::byte{0x44}, std::byte{0x4d}, std::byte{0x4},  std::byte{0x0},
-    std::byte{0x66}, std::byte{0x4c}, std::byte{0x0},  std::byte{0x0},
-    std::byte{0xf6}, std::byte{0x1a}, std::byte{0x17}, std::byte{0x1c},
-    std::byte{0x38}, std::byte{0xb3}, std::byte{0x14}, std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x1},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x1},  std::byte{0x10}, std::byte{0x20}, std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0xcd}, std::byte{0x31}, std::byte{0x28}, std::byte{0x0},
-    std::byte{0x13}, std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x2},  std::byte{0x31}};
-
-static std::vector<std::byte> TEST_ORDER_EXECUTION_DATA = {
-    std::byte{0xfe}, std::byte{0x14}, std::byte{0x0},  std::byte{0x0},
-    std::byte{0x76}, std::byte{0x5},  std::byte{0x8},  std::byte{0x0},
-    std::byte{0xa0}, std::byte{0x9a}, std::byte{0x22}, std::byte{0x9},
-    std::byte{0x91}, std::byte{0xa9}, std::byte{0x8c}, std::byte{0x17},
-    std::byte{0xbd}, std::byte{0x61}, std::byte{0x1c}, std::byte{0x9},
-    std::byte{0x91}, std::byte{0xa9}, std::byte{0x8c}, std::byte{0x17},
-    std::byte{0xf6}, std::byte{0x1a}, std::byte{0x0},  std::byte{0x0},
-    std::byte{0x32}, std::byte{0x0},  std::byte{0xf},  std::byte{0x0},
-    std::byte{0x44}, std::byte{0x4d}, std::byte{0x4},  std::byte{0x0},
-    std::byte{0xa7}, std::byte{0xcd}, std::byte{0xf},  std::byte{0x0},
-    std::byte{0xf6}, std::byte{0x1a}, std::byte{0x45}, std::byte{0x1a},
-    std::byte{0xc0}, std::byte{0xe4}, std::byte{0xfa}, std::byte{0x4e},
-    std::byte{0x2},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x90}, std::byte{0x1},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x2},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0xd2}, std::byte{0x5a}, std::byte{0x25}, std::byte{0x0},
-    std::byte{0x2e}, std::byte{0x2},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x30}, std::byte{0x4a}, std::byte{0x0},
-    std::byte{0x10}, std::byte{0x0},  std::byte{0x44}, std::byte{0x4d},
-    std::byte{0x4},  std::byte{0x0},  std::byte{0xa7}, std::byte{0xcd},
-    std::byte{0xf},  std::byte{0x0},  std::byte{0xf6}, std::byte{0x1a},
-    std::byte{0x45}, std::byte{0x1a}, std::byte{0xc0}, std::byte{0xe4},
-    std::byte{0xfa}, std::byte{0x4e}, std::byte{0x2},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x8f}, std::byte{0x1},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x80}, std::byte{0x8f},
-    std::byte{0xf},  std::byte{0x4d}, std::byte{0x2},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x1},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0xf4}, std::byte{0xf1},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0xf6}, std::byte{0x1a},
-    std::byte{0x45}, std::byte{0x1a}, std::byte{0x2},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x2},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0xd2}, std::byte{0x5a},
-    std::byte{0x25}, std::byte{0x0},  std::byte{0x2f}, std::byte{0x2},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x1},  std::byte{0x30},
-    std::byte{0x4a}, std::byte{0x0},  std::byte{0x10}, std::byte{0x0},
-    std::byte{0x44}, std::byte{0x4d}, std::byte{0x4},  std::byte{0x0},
-    std::byte{0x89}, std::byte{0xcd}, std::byte{0xf},  std::byte{0x0},
-    std::byte{0xf6}, std::byte{0x1a}, std::byte{0x45}, std::byte{0x1a},
-    std::byte{0x80}, std::byte{0x8f}, std::byte{0xf},  std::byte{0x4d},
-    std::byte{0x2},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x80}, std::byte{0x8f}, std::byte{0xf},  std::byte{0x4d},
-    std::byte{0x2},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x1},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0xf4}, std::byte{0xf1}, std::byte{0x0},  std::byte{0x0},
-    std::byte{0xf6}, std::byte{0x1a}, std::byte{0x45}, std::byte{0x1a},
-    std::byte{0x1},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x4},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0xd2}, std::byte{0x5a}, std::byte{0x25}, std::byte{0x0},
-    std::byte{0x30}, std::byte{0x2},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x2},  std::byte{0x31}, std::byte{0x4a}, std::byte{0x0},
-    std::byte{0x10}, std::byte{0x0},  std::byte{0x44}, std::byte{0x4d},
-    std::byte{0x4},  std::byte{0x0},  std::byte{0xa7}, std::byte{0xcd},
-    std::byte{0xf},  std::byte{0x0},  std::byte{0xf6}, std::byte{0x1a},
-    std::byte{0x45}, std::byte{0x1a}, std::byte{0xc0}, std::byte{0xe4},
-    std::byte{0xfa}, std::byte{0x4e}, std::byte{0x2},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x8a}, std::byte{0x1},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0xc0}, std::byte{0x9c},
-    std::byte{0x12}, std::byte{0x4d}, std::byte{0x2},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x5},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0xf5}, std::byte{0xf1},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0xf6}, std::byte{0x1a},
-    std::byte{0x45}, std::byte{0x1a}, std::byte{0x2},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x2},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0xd2}, std::byte{0x5a},
-    std::byte{0x25}, std::byte{0x0},  std::byte{0x31}, std::byte{0x2},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x1},  std::byte{0x30},
-    std::byte{0x4a}, std::byte{0x0},  std::byte{0x10}, std::byte{0x0},
-    std::byte{0x44}, std::byte{0x4d}, std::byte{0x4},  std::byte{0x0},
-    std::byte{0x5e}, std::byte{0xca}, std::byte{0xf},  std::byte{0x0},
-    std::byte{0xf6}, std::byte{0x1a}, std::byte{0x45}, std::byte{0x1a},
-    std::byte{0xc0}, std::byte{0x9c}, std::byte{0x12}, std::byte{0x4d},
-    std::byte{0x2},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0xc0}, std::byte{0x9c}, std::byte{0x12}, std::byte{0x4d},
-    std::byte{0x2},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x5},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0xf5}, std::byte{0xf1}, std::byte{0x0},  std::byte{0x0},
-    std::byte{0xf6}, std::byte{0x1a}, std::byte{0x45}, std::byte{0x1a},
-    std::byte{0x1},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x4},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0xd2}, std::byte{0x5a}, std::byte{0x25}, std::byte{0x0},
-    std::byte{0x32}, std::byte{0x2},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x2},  std::byte{0x31}, std::byte{0x4a}, std::byte{0x0},
-    std::byte{0x10}, std::byte{0x0},  std::byte{0x44}, std::byte{0x4d},
-    std::byte{0x4},  std::byte{0x0},  std::byte{0xa7}, std::byte{0xcd},
-    std::byte{0xf},  std::byte{0x0},  std::byte{0xf6}, std::byte{0x1a},
-    std::byte{0x45}, std::byte{0x1a}, std::byte{0xc0}, std::byte{0xe4},
-    std::byte{0xfa}, std::byte{0x4e}, std::byte{0x2},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x87}, std::byte{0x1},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x20}, std::byte{0x4b},
-    std::byte{0x1d}, std::byte{0x4d}, std::byte{0x2},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x3},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0xf6}, std::byte{0xf1},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0xf6}, std::byte{0x1a},
-    std::byte{0x45}, std::byte{0x1a}, std::byte{0x2},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x2},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0xd2}, std::byte{0x5a},
-    std::byte{0x25}, std::byte{0x0},  std::byte{0x33}, std::byte{0x2},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x1},  std::byte{0x30},
-    std::byte{0x4a}, std::byte{0x0},  std::byte{0x10}, std::byte{0x0},
-    std::byte{0x44}, std::byte{0x4d}, std::byte{0x4},  std::byte{0x0},
-    std::byte{0xe8}, std::byte{0xc2}, std::byte{0xf},  std::byte{0x0},
-    std::byte{0xf6}, std::byte{0x1a}, std::byte{0x45}, std::byte{0x1a},
-    std::byte{0x20}, std::byte{0x4b}, std::byte{0x1d}, std::byte{0x4d},
-    std::byte{0x2},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x20}, std::byte{0x4b}, std::byte{0x1d}, std::byte{0x4d},
-    std::byte{0x2},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x3},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0xf6}, std::byte{0xf1}, std::byte{0x0},  std::byte{0x0},
-    std::byte{0xf6}, std::byte{0x1a}, std::byte{0x45}, std::byte{0x1a},
-    std::byte{0x1},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x4},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0xd2}, std::byte{0x5a}, std::byte{0x25}, std::byte{0x0},
-    std::byte{0x34}, std::byte{0x2},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x2},  std::byte{0x31}, std::byte{0x4a}, std::byte{0x0},
-    std::byte{0x10}, std::byte{0x0},  std::byte{0x44}, std::byte{0x4d},
-    std::byte{0x4},  std::byte{0x0},  std::byte{0xa7}, std::byte{0xcd},
-    std::byte{0xf},  std::byte{0x0},  std::byte{0xf6}, std::byte{0x1a},
-    std::byte{0x45}, std::byte{0x1a}, std::byte{0xc0}, std::byte{0xe4},
-    std::byte{0xfa}, std::byte{0x4e}, std::byte{0x2},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x82}, std::byte{0x1},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0xc0}, std::byte{0xd1},
-    std::byte{0x1e}, std::byte{0x4d}, std::byte{0x2},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x5},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0xf7}, std::byte{0xf1},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0xf6}, std::byte{0x1a},
-    std::byte{0x45}, std::byte{0x1a}, std::byte{0x2},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x2},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0xd2}, std::byte{0x5a},
-    std::byte{0x25}, std::byte{0x0},  std::byte{0x35}, std::byte{0x2},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x1},  std::byte{0x30},
-    std::byte{0x4a}, std::byte{0x0},  std::byte{0x10}, std::byte{0x0},
-    std::byte{0x44}, std::byte{0x4d}, std::byte{0x4},  std::byte{0x0},
-    std::byte{0x6c}, std::byte{0xc2}, std::byte{0xf},  std::byte{0x0},
-    std::byte{0xf6}, std::byte{0x1a}, std::byte{0x45}, std::byte{0x1a},
-    std::byte{0xc0}, std::byte{0xd1}, std::byte{0x1e}, std::byte{0x4d},
-    std::byte{0x2},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0xc0}, std::byte{0xd1}, std::byte{0x1e}, std::byte{0x4d},
-    std::byte{0x2},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x5},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0xf7}, std::byte{0xf1}, std::byte{0x0},  std::byte{0x0},
-    std::byte{0xf6}, std::byte{0x1a}, std::byte{0x45}, std::byte{0x1a},
-    std::byte{0x1},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x4},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0xd2}, std::byte{0x5a}, std::byte{0x25}, std::byte{0x0},
-    std::byte{0x36}, std::byte{0x2},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x2},  std::byte{0x31}, std::byte{0x4a}, std::byte{0x0},
-    std::byte{0x10}, std::byte{0x0},  std::byte{0x44}, std::byte{0x4d},
-    std::byte{0x4},  std::byte{0x0},  std::byte{0xa7}, std::byte{0xcd},
-    std::byte{0xf},  std::byte{0x0},  std::byte{0xf6}, std::byte{0x1a},
-    std::byte{0x45}, std::byte{0x1a}, std::byte{0xc0}, std::byte{0xe4},
-    std::byte{0xfa}, std::byte{0x4e}, std::byte{0x2},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x81}, std::byte{0x1},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x60}, std::byte{0x58},
-    std::byte{0x20}, std::byte{0x4d}, std::byte{0x2},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x1},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0xf8}, std::byte{0xf1},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0xf6}, std::byte{0x1a},
-    std::byte{0x45}, std::byte{0x1a}, std::byte{0x2},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x2},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0xd2}, std::byte{0x5a},
-    std::byte{0x25}, std::byte{0x0},  std::byte{0x37}, std::byte{0x2},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x1},  std::byte{0x30},
-    std::byte{0x4a}, std::byte{0x0},  std::byte{0x10}, std::byte{0x0},
-    std::byte{0x44}, std::byte{0x4d}, std::byte{0x4},  std::byte{0x0},
-    std::byte{0xdf}, std::byte{0xbd}, std::byte{0xf},  std::byte{0x0},
-    std::byte{0xf6}, std::byte{0x1a}, std::byte{0x45}, std::byte{0x1a},
-    std::byte{0x60}, std::byte{0x58}, std::byte{0x20}, std::byte{0x4d},
-    std::byte{0x2},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x60}, std::byte{0x58}, std::byte{0x20}, std::byte{0x4d},
-    std::byte{0x2},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x1},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0xf8}, std::byte{0xf1}, std::byte{0x0},  std::byte{0x0},
-    std::byte{0xf6}, std::byte{0x1a}, std::byte{0x45}, std::byte{0x1a},
-    std::byte{0x1},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x4},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0xd2}, std::byte{0x5a}, std::byte{0x25}, std::byte{0x0},
-    std::byte{0x38}, std::byte{0x2},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x2},  std::byte{0x31}, std::byte{0x4a}, std::byte{0x0},
-    std::byte{0x10}, std::byte{0x0},  std::byte{0x44}, std::byte{0x4d},
-    std::byte{0x4},  std::byte{0x0},  std::byte{0xa7}, std::byte{0xcd},
-    std::byte{0xf},  std::byte{0x0},  std::byte{0xf6}, std::byte{0x1a},
-    std::byte{0x45}, std::byte{0x1a}, std::byte{0xc0}, std::byte{0xe4},
-    std::byte{0xfa}, std::byte{0x4e}, std::byte{0x2},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x80}, std::byte{0x1},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0xdf},
-    std::byte{0x21}, std::byte{0x4d}, std::byte{0x2},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x1},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0xf9}, std::byte{0xf1},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0xf6}, std::byte{0x1a},
-    std::byte{0x45}, std::byte{0x1a}, std::byte{0x2},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x2},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0xd2}, std::byte{0x5a},
-    std::byte{0x25}, std::byte{0x0},  std::byte{0x39}, std::byte{0x2},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x1},  std::byte{0x30},
-    std::byte{0x4a}, std::byte{0x0},  std::byte{0x10}, std::byte{0x0},
-    std::byte{0x44}, std::byte{0x4d}, std::byte{0x4},  std::byte{0x0},
-    std::byte{0x6},  std::byte{0x9a}, std::byte{0xf},  std::byte{0x0},
-    std::byte{0xf6}, std::byte{0x1a}, std::byte{0x45}, std::byte{0x1a},
-    std::byte{0x0},  std::byte{0xdf}, std::byte{0x21}, std::byte{0x4d},
-    std::byte{0x2},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0xdf}, std::byte{0x21}, std::byte{0x4d},
-    std::byte{0x2},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x1},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0xf9}, std::byte{0xf1}, std::byte{0x0},  std::byte{0x0},
-    std::byte{0xf6}, std::byte{0x1a}, std::byte{0x45}, std::byte{0x1a},
-    std::byte{0x1},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x4},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0xd2}, std::byte{0x5a}, std::byte{0x25}, std::byte{0x0},
-    std::byte{0x3a}, std::byte{0x2},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x2},  std::byte{0x31}, std::byte{0x4a}, std::byte{0x0},
-    std::byte{0x10}, std::byte{0x0},  std::byte{0x44}, std::byte{0x4d},
-    std::byte{0x4},  std::byte{0x0},  std::byte{0xa7}, std::byte{0xcd},
-    std::byte{0xf},  std::byte{0x0},  std::byte{0xf6}, std::byte{0x1a},
-    std::byte{0x45}, std::byte{0x1a}, std::byte{0xc0}, std::byte{0xe4},
-    std::byte{0xfa}, std::byte{0x4e}, std::byte{0x2},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x7f}, std::byte{0x1},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0xdf},
-    std::byte{0x21}, std::byte{0x4d}, std::byte{0x2},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x1},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0xfa}, std::byte{0xf1},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0xf6}, std::byte{0x1a},
-    std::byte{0x45}, std::byte{0x1a}, std::byte{0x2},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x2},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0xd2}, std::byte{0x5a},
-    std::byte{0x25}, std::byte{0x0},  std::byte{0x3b}, std::byte{0x2},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x1},  std::byte{0x30},
-    std::byte{0x4a}, std::byte{0x0},  std::byte{0x10}, std::byte{0x0},
-    std::byte{0x44}, std::byte{0x4d}, std::byte{0x4},  std::byte{0x0},
-    std::byte{0x58}, std::byte{0xac}, std::byte{0xf},  std::byte{0x0},
-    std::byte{0xf6}, std::byte{0x1a}, std::byte{0x45}, std::byte{0x1a},
-    std::byte{0x0},  std::byte{0xdf}, std::byte{0x21}, std::byte{0x4d},
-    std::byte{0x2},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0xdf}, std::byte{0x21}, std::byte{0x4d},
-    std::byte{0x2},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x1},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0xfa}, std::byte{0xf1}, std::byte{0x0},  std::byte{0x0},
-    std::byte{0xf6}, std::byte{0x1a}, std::byte{0x45}, std::byte{0x1a},
-    std::byte{0x1},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x4},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0xd2}, std::byte{0x5a}, std::byte{0x25}, std::byte{0x0},
-    std::byte{0x3c}, std::byte{0x2},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x2},  std::byte{0x31}, std::byte{0x4a}, std::byte{0x0},
-    std::byte{0x10}, std::byte{0x0},  std::byte{0x44}, std::byte{0x4d},
-    std::byte{0x4},  std::byte{0x0},  std::byte{0xa7}, std::byte{0xcd},
-    std::byte{0xf},  std::byte{0x0},  std::byte{0xf6}, std::byte{0x1a},
-    std::byte{0x45}, std::byte{0x1a}, std::byte{0xc0}, std::byte{0xe4},
-    std::byte{0xfa}, std::byte{0x4e}, std::byte{0x2},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x7d}, std::byte{0x1},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0xdf},
-    std::byte{0x21}, std::byte{0x4d}, std::byte{0x2},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x2},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0xfb}, std::byte{0xf1},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0xf6}, std::byte{0x1a},
-    std::byte{0x45}, std::byte{0x1a}, std::byte{0x2},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x2},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0xd2}, std::byte{0x5a},
-    std::byte{0x25}, std::byte{0x0},  std::byte{0x3d}, std::byte{0x2},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x1},  std::byte{0x30},
-    std::byte{0x4a}, std::byte{0x0},  std::byte{0x10}, std::byte{0x0},
-    std::byte{0x44}, std::byte{0x4d}, std::byte{0x4},  std::byte{0x0},
-    std::byte{0x18}, std::byte{0xad}, std::byte{0xf},  std::byte{0x0},
-    std::byte{0xf6}, std::byte{0x1a}, std::byte{0x45}, std::byte{0x1a},
-    std::byte{0x0},  std::byte{0xdf}, std::byte{0x21}, std::byte{0x4d},
-    std::byte{0x2},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0xdf}, std::byte{0x21}, std::byte{0x4d},
-    std::byte{0x2},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x2},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0xfb}, std::byte{0xf1}, std::byte{0x0},  std::byte{0x0},
-    std::byte{0xf6}, std::byte{0x1a}, std::byte{0x45}, std::byte{0x1a},
-    std::byte{0x1},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x4},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0xd2}, std::byte{0x5a}, std::byte{0x25}, std::byte{0x0},
-    std::byte{0x3e}, std::byte{0x2},  std::byte{0x0},  std::byte{0x0},
-    std::byte{0x2},  std::byte{0x31},
-};
-
 class SIMBADecoderTestFixture : public ::testing::Test {
   void SetUp() override {}
 
@@ -395,8 +23,8 @@ TEST_F(
   simba::decoder::MessageHandlers message_handlers;
   std::vector<simba::types::OrderUpdate> decoded_orders;
   message_handlers.order_update_handler =
-      [&decoded_orders](const simba::types::OrderUpdate &order_update) {
-        decoded_orders.push_back(order_update);
+      [&decoded_orders](simba::types::OrderUpdateView order_update) {
+        decoded_orders.push_back(order_update.to_message());
       };
   task::simba::decoder::SIMBADecoder simba_decoder_{message_handlers};
 
@@ -407,13 +35,13 @@ TEST_F(
   EXPECT_EQ(simba_decoder_.sbe_header().block_length, 50);
 
   auto order = decoded_orders.back();
-  EXPECT_EQ(order.order_id, 2024116201390623846);
-  EXPECT_EQ(order.order_price, 1356600);
-  EXPECT_EQ(order.order_volume, 1);
+  EXPECT_EQ(order.md_entry_id, 2024116201390623846);
+  EXPECT_EQ(order.md_entry_px.mantissa(), 1356600);
+  EXPECT_EQ(order.md_entry_size, 1);
   EXPECT_EQ(order.rpt_seq, 19);
   EXPECT_EQ(order.security_id, 2634189);
-  EXPECT_EQ(order.action, simba::types::MDUpdateAction::Delete);
-  EXPECT_EQ(order.side, simba::types::MDEntryType::Offer);
+  EXPECT_EQ(order.md_update_action, simba::types::MDUpdateAction::Delete);
+  EXPECT_EQ(order.md_entry_type, simba::types::MDEntryType::Offer);
 }
 
 TEST_F(SIMBADecoderTestFixture,
@@ -422,12 +50,12 @@ TEST_F(SIMBADecoderTestFixture,
   std::vector<simba::types::OrderExecution> decoded_orders;
   std::vector<simba::types::OrderUpdate> decoded_order_update;
   message_handlers.order_update_handler =
-      [&decoded_order_update](const simba::types::OrderUpdate &order_update) {
-        decoded_order_update.push_back(order_update);
+      [&decoded_order_update](simba::types::OrderUpdateView order_update) {
+        decoded_order_update.push_back(order_update.to_message());
       };
   message_handlers.order_execution_handler =
-      [&decoded_orders](const simba::types::OrderExecution &order_update) {
-        decoded_orders.push_back(order_update);
+      [&decoded_orders](simba::types::OrderExecutionView order_update) {
+        decoded_orders.push_back(order_update.to_message());
       };
   task::simba::decoder::SIMBADecoder simba_decoder_{message_handlers};
 
@@ -436,39 +64,452 @@ TEST_F(SIMBADecoderTestFixture,
   EXPECT_EQ(decoded_order_update.size(), 1);
 
   const auto order = decoded_order_update.back();
-  EXPECT_EQ(order.order_id, 1892948862244474279);
-  EXPECT_EQ(order.order_price,
+  EXPECT_EQ(order.md_entry_id, 1892948862244474279);
+  EXPECT_EQ(order.md_entry_px.mantissa(),
             9915000000);  // for the multiplier we need to divide 1e5
-  EXPECT_EQ(order.order_volume, 400);
-  EXPECT_EQ(order.action, simba::types::MDUpdateAction::New);
-  EXPECT_EQ(order.side, simba::types::MDEntryType::Bid);
+  EXPECT_EQ(order.md_entry_size, 400);
+  EXPECT_EQ(order.md_update_action, simba::types::MDUpdateAction::New);
+  EXPECT_EQ(order.md_entry_type, simba::types::MDEntryType::Bid);
 
   EXPECT_EQ(simba_decoder_.market_header().sequence_number, 5374);
   EXPECT_EQ(simba_decoder_.market_header().message_size, 1398);
 
   EXPECT_EQ(simba_decoder_.sbe_header().template_id, 16);
   EXPECT_EQ(simba_decoder_.sbe_header().block_length, 74);
-  EXPECT_EQ(order.side, simba::types::MDEntryType::Bid);
+  EXPECT_EQ(order.md_entry_type, simba::types::MDEntryType::Bid);
 
   const auto execution = decoded_orders[0];
-  EXPECT_EQ(execution.order_id, 1892948862244474279);
-  EXPECT_EQ(execution.order_price,
+  EXPECT_EQ(execution.md_entry_id, 1892948862244474279);
+  EXPECT_EQ(execution.md_entry_px.mantissa(),
             9915000000);  // for the multiplier we need to divide 1e5
-  EXPECT_EQ(execution.remaining_quantity, 399);
-  EXPECT_EQ(execution.trade_price, 9882800000);
-  EXPECT_EQ(execution.trade_volume, 1);
+  EXPECT_EQ(execution.md_entry_size, 399);
+  EXPECT_EQ(execution.last_px.mantissa(), 9882800000);
+  EXPECT_EQ(execution.last_qty, 1);
   EXPECT_EQ(execution.security_id, 2448082);
-  EXPECT_EQ(execution.side, simba::types::MDEntryType::Bid);
+  EXPECT_EQ(execution.md_entry_type, simba::types::MDEntryType::Bid);
 
   const auto execution2 = decoded_orders[1];
-  EXPECT_EQ(execution2.order_id, 1892948862244474249);
-  EXPECT_EQ(execution2.order_price,
+  EXPECT_EQ(execution2.md_entry_id, 1892948862244474249);
+  EXPECT_EQ(execution2.md_entry_px.mantissa(),
             9882800000);  // for the multiplier we need to divide 1e5
-  EXPECT_EQ(execution2.remaining_quantity, 0);
-  EXPECT_EQ(execution2.trade_price, 9882800000);
-  EXPECT_EQ(execution2.trade_volume, 1);
+  EXPECT_EQ(execution2.md_entry_size, 0);
+  EXPECT_EQ(execution2.last_px.mantissa(), 9882800000);
+  EXPECT_EQ(execution2.last_qty, 1);
   EXPECT_EQ(execution2.security_id, 2448082);
-  EXPECT_EQ(execution2.side, simba::types::MDEntryType::Offer);
+  EXPECT_EQ(execution2.md_entry_type, simba::types::MDEntryType::Offer);
+}
+
+TEST_F(
+    SIMBADecoderTestFixture,
+    GIVEN_larger_block_length_WHEN_decoding_order_update_THEN_skip_unknown_fields) {
+  // Simulate a newer schema version appending 10 bytes to the OrderUpdate
+  // root block: block_length and message_size grow accordingly
+  constexpr size_t EXTRA_FIELDS_SIZE = 10;
+  auto extended = TEST_ORDER_UPDATE_DATA;
+  extended.insert(extended.end(), EXTRA_FIELDS_SIZE, std::byte{0xAB});
+  uint16_t message_size = 86 + EXTRA_FIELDS_SIZE;
+  uint16_t block_length = 50 + EXTRA_FIELDS_SIZE;
+  std::memcpy(extended.data() + 4, &message_size, sizeof(message_size));
+  std::memcpy(extended.data() + 28, &block_length, sizeof(block_length));
+
+  // Append a second copy of the message to check the decoder stays in sync
+  extended.insert(extended.end(), extended.begin() + 28, extended.end());
+  message_size += sizeof(simba::types::SBEHeader) + block_length;
+  std::memcpy(extended.data() + 4, &message_size, sizeof(message_size));
+
+  std::vector<simba::types::OrderUpdate> decoded_orders;
+  message_handlers.order_update_handler =
+      [&decoded_orders](simba::types::OrderUpdateView order_update) {
+        decoded_orders.push_back(order_update.to_message());
+      };
+  task::simba::decoder::SIMBADecoder simba_decoder_{message_handlers};
+
+  EXPECT_TRUE(simba_decoder_.decode_message(extended));
+  ASSERT_EQ(decoded_orders.size(), 2);
+  for (const auto &order : decoded_orders) {
+    EXPECT_EQ(order.md_entry_id, 2024116201390623846);
+    EXPECT_EQ(order.security_id, 2634189);
+    EXPECT_EQ(order.md_entry_type, simba::types::MDEntryType::Offer);
+  }
+}
+
+TEST_F(SIMBADecoderTestFixture,
+       GIVEN_message_views_WHEN_reading_fields_THEN_match_the_copied_message) {
+  std::vector<simba::types::OrderExecution> copies;
+  std::vector<simba::types::OrderExecution> fields;
+  message_handlers.order_execution_handler =
+      [&](simba::types::OrderExecutionView view) {
+        copies.push_back(view.to_message());
+        simba::types::OrderExecution execution;
+        execution.md_entry_id = view.md_entry_id();
+        execution.last_px = view.last_px();
+        execution.last_qty = view.last_qty();
+        execution.trade_id = view.trade_id();
+        execution.security_id = view.security_id();
+        execution.md_entry_type = view.md_entry_type();
+        fields.push_back(execution);
+      };
+  task::simba::decoder::SIMBADecoder simba_decoder_{message_handlers};
+  simba_decoder_.decode_message(TEST_ORDER_EXECUTION_DATA);
+  ASSERT_EQ(fields.size(), 16);
+  for (size_t index = 0; index < fields.size(); ++index) {
+    EXPECT_EQ(fields[index].md_entry_id, copies[index].md_entry_id);
+    EXPECT_EQ(fields[index].last_px, copies[index].last_px);
+    EXPECT_EQ(fields[index].last_qty, copies[index].last_qty);
+    EXPECT_EQ(fields[index].trade_id, copies[index].trade_id);
+    EXPECT_EQ(fields[index].security_id, copies[index].security_id);
+    EXPECT_EQ(fields[index].md_entry_type, copies[index].md_entry_type);
+  }
+
+  // an older schema version: the fields past the block read as default
+  simba::types::OrderUpdate update;
+  update.md_entry_id = 7;
+  update.security_id = 42;
+  const simba::types::OrderUpdateView full{update};
+  const simba::types::OrderUpdateView short_block{full.data(), 24};
+  EXPECT_EQ(full.security_id(), 42);
+  EXPECT_EQ(short_block.md_entry_id(), 7);
+  EXPECT_EQ(short_block.security_id(), 0);
+  EXPECT_EQ(short_block.to_message().security_id, 0);
+
+  // a snapshot root block, its group size and two entries read in place
+  simba::types::OrderBookSnapshot root;
+  root.security_id = 3036264;
+  root.rpt_seq = 24;
+  const simba::types::GroupSize group_size{
+      simba::types::OrderBookSnapshot::NoMDEntries::BLOCK_LENGTH, 2};
+  simba::types::OrderBookSnapshot::NoMDEntries bid;
+  bid.md_entry_px = simba::types::Decimal5::from_units(1868);
+  bid.md_entry_size = 5;
+  bid.md_entry_type = simba::types::MDEntryType::Bid;
+  auto offer = bid;
+  offer.md_entry_px = simba::types::Decimal5::from_units(1869);
+  offer.md_entry_type = simba::types::MDEntryType::Offer;
+  std::vector<std::byte> message(sizeof(root) + sizeof(group_size) +
+                                 2 * sizeof(bid));
+  std::byte *write = message.data();
+  for (const auto &[part, size] :
+       {std::pair<const void *, size_t>{&root, sizeof(root)},
+        {&group_size, sizeof(group_size)},
+        {&bid, sizeof(bid)},
+        {&offer, sizeof(offer)}}) {
+    std::memcpy(write, part, size);
+    write += size;
+  }
+
+  const simba::types::OrderBookSnapshotView snapshot{message.data(),
+                                                     sizeof(root)};
+  EXPECT_EQ(snapshot.security_id(), 3036264);
+  EXPECT_EQ(snapshot.rpt_seq(), 24);
+  EXPECT_EQ(snapshot.size_bytes(), message.size());
+  EXPECT_EQ(simba::types::OrderBookSnapshotView::wire_size(
+                message.data(), sizeof(root), message.size()),
+            message.size());
+  EXPECT_EQ(simba::types::OrderBookSnapshotView::wire_size(
+                message.data(), sizeof(root), message.size() - 1),
+            std::nullopt);
+  ASSERT_EQ(snapshot.no_md_entries().size(), 2);
+  std::vector<simba::types::Decimal5> prices;
+  for (const auto entry : snapshot.no_md_entries()) {
+    prices.push_back(entry.md_entry_px());
+  }
+  EXPECT_EQ(prices, (std::vector{bid.md_entry_px, offer.md_entry_px}));
+  EXPECT_EQ(snapshot.no_md_entries()[1].md_entry_type(),
+            simba::types::MDEntryType::Offer);
+  EXPECT_NE(simba::types::SnapshotBook(snapshot).to_string().find(
+                "1869.00000"),
+            std::string::npos);
+}
+
+TEST_F(SIMBADecoderTestFixture,
+       GIVEN_truncated_packet_WHEN_decoding_THEN_reject_without_decoding) {
+  size_t decoded_messages{0};
+  message_handlers.order_update_handler =
+      [&decoded_messages](simba::types::OrderUpdateView) {
+        ++decoded_messages;
+      };
+  message_handlers.order_execution_handler =
+      [&decoded_messages](simba::types::OrderExecutionView) {
+        ++decoded_messages;
+      };
+  task::simba::decoder::SIMBADecoder simba_decoder_{message_handlers};
+
+  // Every strict prefix is shorter than message_size and must be rejected
+  for (const auto &data : {TEST_ORDER_UPDATE_DATA, TEST_ORDER_EXECUTION_DATA}) {
+    for (size_t length = 0; length < data.size(); ++length) {
+      std::vector<std::byte> truncated(data.begin(), data.begin() + length);
+      EXPECT_FALSE(simba_decoder_.decode_message(truncated));
+    }
+  }
+  EXPECT_EQ(decoded_messages, 0);
+  EXPECT_EQ(simba_decoder_.malformed_packets(),
+            TEST_ORDER_UPDATE_DATA.size() + TEST_ORDER_EXECUTION_DATA.size());
+}
+
+TEST_F(SIMBADecoderTestFixture,
+       GIVEN_random_mutations_WHEN_decoding_THEN_never_read_out_of_bounds) {
+  message_handlers.order_update_handler =
+      [](simba::types::OrderUpdateView) {};
+  message_handlers.order_execution_handler =
+      [](simba::types::OrderExecutionView) {};
+  message_handlers.order_book_snapshot_handler =
+      [](simba::types::OrderBookSnapshotView snapshot) {
+        EXPECT_FALSE(simba::types::SnapshotBook(snapshot).to_string().empty());
+      };
+  task::simba::decoder::SIMBADecoder simba_decoder_{message_handlers};
+
+  // Mutations target the header bytes; packets are copied into exactly sized
+  // buffers so that sanitizers flag any read past the end
+  std::mt19937 generator{42};
+  for (const auto &data : {TEST_ORDER_UPDATE_DATA, TEST_ORDER_EXECUTION_DATA}) {
+    std::uniform_int_distribution<size_t> position(0, 48);
+    std::uniform_int_distribution<int> value(0, 255);
+    for (size_t iteration = 0; iteration < 20000; ++iteration) {
+      auto mutated = data;
+      for (size_t flip = 0; flip < 3; ++flip) {
+        mutated[position(generator)] = std::byte(value(generator));
+      }
+      // Occasionally turn the first message into a snapshot
+      if (iteration % 4 == 0) {
+        mutated[30] = std::byte{17};
+      }
+      mutated.resize(std::min(mutated.size(), position(generator) * 32));
+      mutated.shrink_to_fit();
+      simba_decoder_.decode_message(mutated);
+    }
+  }
+}
+
+TEST_F(SIMBADecoderTestFixture,
+       GIVEN_schema_templates_WHEN_decoding_THEN_dispatch_up_to_unknown_one) {
+  // SequenceReset, BestPrices with one entry, then the OrderUpdate
+  const auto message_header = [](uint16_t block_length, uint16_t template_id) {
+    const simba::types::MessageHeader header{
+        block_length, template_id, simba::types::SCHEMA_ID,
+        simba::types::SCHEMA_VERSION};
+    std::vector<std::byte> bytes(sizeof(header));
+    std::memcpy(bytes.data(), &header, sizeof(header));
+    return bytes;
+  };
+  auto sequence_reset =
+      message_header(simba::types::SequenceReset::BLOCK_LENGTH,
+                     simba::types::SequenceReset::TEMPLATE_ID);
+  const uint32_t new_seq_no = 1000;
+  sequence_reset.resize(sequence_reset.size() + sizeof(new_seq_no));
+  std::memcpy(sequence_reset.data() + 8, &new_seq_no, sizeof(new_seq_no));
+
+  auto best_prices = message_header(simba::types::BestPrices::BLOCK_LENGTH,
+                                    simba::types::BestPrices::TEMPLATE_ID);
+  const simba::types::GroupSize group_size{
+      simba::types::BestPrices::NoMDEntries::BLOCK_LENGTH, 1};
+  simba::types::BestPrices::NoMDEntries entry;
+  entry.mkt_bid_px = simba::types::Decimal5::from_units(99);
+  entry.mkt_offer_px = simba::types::Decimal5::null();
+  entry.security_id = 2634189;
+  best_prices.resize(best_prices.size() + sizeof(group_size) + sizeof(entry));
+  std::memcpy(best_prices.data() + 8, &group_size, sizeof(group_size));
+  std::memcpy(best_prices.data() + 8 + sizeof(group_size), &entry,
+              sizeof(entry));
+
+  const auto packet = [&](std::vector<std::vector<std::byte>> messages) {
+    // the market data and incremental headers of the test vector
+    std::vector<std::byte> bytes(TEST_ORDER_UPDATE_DATA.begin(),
+                                 TEST_ORDER_UPDATE_DATA.begin() + 28);
+    for (const auto &message : messages) {
+      bytes.insert(bytes.end(), message.begin(), message.end());
+    }
+    bytes.insert(bytes.end(), TEST_ORDER_UPDATE_DATA.begin() + 28,
+                 TEST_ORDER_UPDATE_DATA.end());
+    const auto message_size = static_cast<uint16_t>(bytes.size());
+    std::memcpy(bytes.data() + 4, &message_size, sizeof(message_size));
+    return bytes;
+  };
+
+  std::vector<std::string> decoded;
+  message_handlers.sequence_reset_handler =
+      [&decoded](simba::types::SequenceResetView reset) {
+        EXPECT_EQ(reset.new_seq_no(), 1000);
+        decoded.push_back(reset.to_string());
+      };
+  message_handlers.best_prices_handler =
+      [&decoded](simba::types::BestPricesView prices) {
+        ASSERT_EQ(prices.no_md_entries().size(), 1);
+        EXPECT_TRUE(prices.no_md_entries()[0].mkt_offer_px().is_null());
+        decoded.push_back(prices.no_md_entries()[0].to_string());
+      };
+  message_handlers.order_update_handler =
+      [&decoded](simba::types::OrderUpdateView update) {
+        decoded.push_back(update.to_string());
+      };
+  task::simba::decoder::SIMBADecoder simba_decoder_{message_handlers};
+
+  EXPECT_TRUE(
+      simba_decoder_.decode_message(packet({sequence_reset, best_prices})));
+  ASSERT_EQ(decoded.size(), 3);
+  EXPECT_EQ(decoded[0], "SequenceReset(new_seq_no: 1000)");
+  EXPECT_EQ(decoded[1],
+            "NoMDEntries(mkt_bid_px: 99, mkt_offer_px: NULL, "
+            "security_id: 2634189)");
+  EXPECT_NE(decoded[2].find("md_update_action: Delete, md_entry_type: Offer"),
+            std::string::npos)
+      << decoded[2];
+
+  // an unknown template cannot be sized, the messages after it are skipped
+  decoded.clear();
+  EXPECT_TRUE(simba_decoder_.decode_message(
+      packet({sequence_reset, message_header(4, 999)})));
+  EXPECT_EQ(decoded.size(), 1);
+  EXPECT_EQ(simba::types::to_string(simba::types::MDEntryType{'X'}),
+            "UNKNOWN");
+}
+
+TEST_F(SIMBADecoderTestFixture,
+       GIVEN_schema_versions_WHEN_decoding_THEN_select_decoder_per_packet) {
+  size_t decoded_messages{0};
+  message_handlers.order_update_handler =
+      [&decoded_messages](simba::types::OrderUpdateView) {
+        ++decoded_messages;
+      };
+  task::simba::decoder::SIMBADecoder simba_decoder_{message_handlers};
+
+  // the SBE header of the order update follows the packet headers
+  constexpr size_t SBE_HEADER = 28;
+  const auto with_header = [](uint16_t block_length, uint16_t schema_id,
+                              uint16_t version) {
+    auto packet = TEST_ORDER_UPDATE_DATA;
+    std::memcpy(packet.data() + SBE_HEADER, &block_length,
+                sizeof(block_length));
+    std::memcpy(packet.data() + SBE_HEADER + 4, &schema_id, sizeof(schema_id));
+    std::memcpy(packet.data() + SBE_HEADER + 6, &version, sizeof(version));
+    return packet;
+  };
+  constexpr uint16_t BLOCK_LENGTH = simba::types::OrderUpdate::BLOCK_LENGTH;
+
+  // a newer version only appends fields, decoded with the latest layout
+  EXPECT_TRUE(simba_decoder_.decode_message(with_header(
+      BLOCK_LENGTH, simba::types::SCHEMA_ID,
+      simba::types::SCHEMA_VERSION + 1)));
+  EXPECT_EQ(decoded_messages, 1);
+
+  // another schema is not decoded at all
+  EXPECT_FALSE(simba_decoder_.decode_message(
+      with_header(BLOCK_LENGTH, 1, simba::types::SCHEMA_VERSION)));
+  EXPECT_EQ(simba_decoder_.unsupported_packets(), 1);
+  EXPECT_EQ(decoded_messages, 1);
+
+  // a block missing fields of its version is malformed
+  auto shorter = with_header(BLOCK_LENGTH - 1, simba::types::SCHEMA_ID,
+                             simba::types::SCHEMA_VERSION);
+  EXPECT_FALSE(simba_decoder_.decode_message(shorter));
+  EXPECT_EQ(simba_decoder_.malformed_packets(), 1);
+
+  // a message of another version ends the packet, as an unknown template
+  auto mixed = with_header(BLOCK_LENGTH, simba::types::SCHEMA_ID,
+                           simba::types::SCHEMA_VERSION);
+  const std::vector<std::byte> message(mixed.begin() + SBE_HEADER,
+                                       mixed.end());
+  mixed.insert(mixed.end(), message.begin(), message.end());
+  const uint16_t next_version = simba::types::SCHEMA_VERSION + 1;
+  std::memcpy(mixed.data() + mixed.size() - message.size() + 6,
+              &next_version, sizeof(next_version));
+  const auto message_size = static_cast<uint16_t>(mixed.size());
+  std::memcpy(mixed.data() + 4, &message_size, sizeof(message_size));
+  EXPECT_TRUE(simba_decoder_.decode_message(mixed));
+  EXPECT_EQ(decoded_messages, 2);
+  EXPECT_EQ(simba_decoder_.malformed_packets(), 1);
+  // the message left out is accounted
+  EXPECT_EQ(simba_decoder_.unsupported_packets(), 2);
+}
+
+TEST_F(SIMBADecoderTestFixture,
+       GIVEN_corrupt_a_copy_WHEN_arbitrating_THEN_decode_the_b_copy) {
+  size_t decoded_messages{0};
+  message_handlers.order_update_handler =
+      [&decoded_messages](simba::types::OrderUpdateView) {
+        ++decoded_messages;
+      };
+  task::simba::decoder::SIMBADecoder simba_decoder_{message_handlers, true};
+
+  constexpr size_t SBE_HEADER = 28;
+  const auto with_sequence = [](uint32_t sequence_number) {
+    auto packet = TEST_ORDER_UPDATE_DATA;
+    std::memcpy(packet.data(), &sequence_number, sizeof(sequence_number));
+    return packet;
+  };
+  EXPECT_TRUE(simba_decoder_.decode_message(with_sequence(100)));
+  const size_t updates_per_packet = decoded_messages;
+
+  // the A copies of 101: a block missing fields, another schema
+  auto malformed = with_sequence(101);
+  const uint16_t short_block = simba::types::OrderUpdate::BLOCK_LENGTH - 1;
+  std::memcpy(malformed.data() + SBE_HEADER, &short_block,
+              sizeof(short_block));
+  EXPECT_FALSE(simba_decoder_.decode_message(malformed));
+  auto unsupported = with_sequence(101);
+  const uint16_t other_schema = 1;
+  std::memcpy(unsupported.data() + SBE_HEADER + 4, &other_schema,
+              sizeof(other_schema));
+  EXPECT_FALSE(simba_decoder_.decode_message(unsupported));
+  EXPECT_EQ(simba_decoder_.last_sequence_number(), 100);
+
+  // the intact B copy is decoded, a later copy is not
+  EXPECT_TRUE(simba_decoder_.decode_message(with_sequence(101)));
+  EXPECT_FALSE(simba_decoder_.decode_message(with_sequence(101)));
+  EXPECT_EQ(decoded_messages, 2 * updates_per_packet);
+  EXPECT_EQ(simba_decoder_.duplicate_packets(), 1);
+  EXPECT_EQ(simba_decoder_.malformed_packets(), 1);
+  EXPECT_EQ(simba_decoder_.unsupported_packets(), 1);
+}
+
+TEST_F(SIMBADecoderTestFixture,
+       GIVEN_sequence_restart_WHEN_arbitrating_THEN_decode_the_new_sequence) {
+  size_t decoded_messages{0};
+  message_handlers.order_update_handler =
+      [&decoded_messages](simba::types::OrderUpdateView) {
+        ++decoded_messages;
+      };
+  task::simba::decoder::SIMBADecoder simba_decoder_{message_handlers, true};
+
+  constexpr size_t SBE_HEADER = 28;
+  const auto with_sequence = [](uint32_t sequence_number) {
+    auto packet = TEST_ORDER_UPDATE_DATA;
+    std::memcpy(packet.data(), &sequence_number, sizeof(sequence_number));
+    return packet;
+  };
+  // the packet headers of the test vector, then a SequenceReset to 7
+  auto sequence_reset = with_sequence(501);
+  sequence_reset.resize(SBE_HEADER);
+  const simba::types::MessageHeader reset_header{
+      simba::types::SequenceReset::BLOCK_LENGTH,
+      simba::types::SequenceReset::TEMPLATE_ID, simba::types::SCHEMA_ID,
+      simba::types::SCHEMA_VERSION};
+  const uint32_t new_seq_no = 7;
+  sequence_reset.resize(SBE_HEADER + sizeof(reset_header) +
+                        sizeof(new_seq_no));
+  std::memcpy(sequence_reset.data() + SBE_HEADER, &reset_header,
+              sizeof(reset_header));
+  std::memcpy(sequence_reset.data() + SBE_HEADER + sizeof(reset_header),
+              &new_seq_no, sizeof(new_seq_no));
+  const auto message_size = static_cast<uint16_t>(sequence_reset.size());
+  std::memcpy(sequence_reset.data() + 4, &message_size, sizeof(message_size));
+
+  EXPECT_TRUE(simba_decoder_.decode_message(with_sequence(500)));
+  const size_t updates_per_packet = decoded_messages;
+  EXPECT_TRUE(simba_decoder_.decode_message(sequence_reset));
+  EXPECT_EQ(simba_decoder_.last_sequence_number(), 6);
+  EXPECT_TRUE(simba_decoder_.decode_message(with_sequence(7)));
+  EXPECT_FALSE(simba_decoder_.decode_message(with_sequence(7)));
+  EXPECT_EQ(decoded_messages, 2 * updates_per_packet);
+
+  // a session restarted without a SequenceReset: far behind, not a copy
+  constexpr uint32_t LAG =
+      task::simba::decoder::SIMBADecoder::MAX_CHANNEL_LAG;
+  EXPECT_TRUE(simba_decoder_.decode_message(with_sequence(LAG + 100)));
+  EXPECT_FALSE(simba_decoder_.decode_message(with_sequence(100)));
+  EXPECT_TRUE(simba_decoder_.decode_message(with_sequence(1)));
+  EXPECT_FALSE(simba_decoder_.decode_message(with_sequence(1)));
+  EXPECT_EQ(decoded_messages, 4 * updates_per_packet);
+  EXPECT_EQ(simba_decoder_.duplicate_packets(), 3);
 }
 
 }  // namespace task::tests
@@ -0,0 +1,567 @@
+#pragma once
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "processors/pcap_types.h"
+#include "simba_decoder/simba_messages.h"
+
+// Packets captured from the MOEX SIMBA SPECTRA feed, shared by the unit
+// tests, the fuzzing seed corpus and the benchmarks.
+namespace task::tests {
+
+inline const std::vector<std::byte> TEST_ORDER_UPDATE_DATA = {
+    std::byte{0xfb}, std::byte{0xf},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x56}, std::byte{0x0},  std::byte{0x9},  std::byte{0x0},
+    std::byte{0xff}, std::byte{0x10}, std::byte{0x8d}, std::byte{0xf5},
+    std::byte{0xbf}, std::byte{0xa8}, std::byte{0x8c}, std::byte{0x17},
+    std::byte{0x21}, std::byte{0xee}, std::byte{0x8d}, std::byte{0xf5},
+    std::byte{0xbf}, std::byte{0xa8}, std::byte{0x8c}, std::byte{0x17},
+    std::byte{0xf6}, std::byte{0x1a}, std::byte{0x0},  std::byte{0x0},
+    std::byte{0x32}, std::byte{0x0},  std::byte{0xf},  std::byte{0x0},
+    std::byte{0x44}, std::byte{0x4d}, std::byte{0x4},  std::byte{0x0},
+    std::byte{0x66}, std::byte{0x4c}, std::byte{0x0},  std::byte{0x0},
+    std::byte{0xf6}, std::byte{0x1a}, std::byte{0x17}, std::byte{0x1c},
+    std::byte{0x38}, std::byte{0xb3}, std::byte{0x14}, std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x1},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x1},  std::byte{0x10}, std::byte{0x20}, std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0xcd}, std::byte{0x31}, std::byte{0x28}, std::byte{0x0},
+    std::byte{0x13}, std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x2},  std::byte{0x31}};
+
+inline const std::vector<std::byte> TEST_ORDER_EXECUTION_DATA = {
+    std::byte{0xfe}, std::byte{0x14}, std::byte{0x0},  std::byte{0x0},
+    std::byte{0x76}, std::byte{0x5},  std::byte{0x8},  std::byte{0x0},
+    std::byte{0xa0}, std::byte{0x9a}, std::byte{0x22}, std::byte{0x9},
+    std::byte{0x91}, std::byte{0xa9}, std::byte{0x8c}, std::byte{0x17},
+    std::byte{0xbd}, std::byte{0x61}, std::byte{0x1c}, std::byte{0x9},
+    std::byte{0x91}, std::byte{0xa9}, std::byte{0x8c}, std::byte{0x17},
+    std::byte{0xf6}, std::byte{0x1a}, std::byte{0x0},  std::byte{0x0},
+    std::byte{0x32}, std::byte{0x0},  std::byte{0xf},  std::byte{0x0},
+    std::byte{0x44}, std::byte{0x4d}, std::byte{0x4},  std::byte{0x0},
+    std::byte{0xa7}, std::byte{0xcd}, std::byte{0xf},  std::byte{0x0},
+    std::byte{0xf6}, std::byte{0x1a}, std::byte{0x45}, std::byte{0x1a},
+    std::byte{0xc0}, std::byte{0xe4}, std::byte{0xfa}, std::byte{0x4e},
+    std::byte{0x2},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x90}, std::byte{0x1},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x2},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0xd2}, std::byte{0x5a}, std::byte{0x25}, std::byte{0x0},
+    std::byte{0x2e}, std::byte{0x2},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x30}, std::byte{0x4a}, std::byte{0x0},
+    std::byte{0x10}, std::byte{0x0},  std::byte{0x44}, std::byte{0x4d},
+    std::byte{0x4},  std::byte{0x0},  std::byte{0xa7}, std::byte{0xcd},
+    std::byte{0xf},  std::byte{0x0},  std::byte{0xf6}, std::byte{0x1a},
+    std::byte{0x45}, std::byte{0x1a}, std::byte{0xc0}, std::byte{0xe4},
+    std::byte{0xfa}, std::byte{0x4e}, std::byte{0x2},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x8f}, std::byte{0x1},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x80}, std::byte{0x8f},
+    std::byte{0xf},  std::byte{0x4d}, std::byte{0x2},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x1},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0xf4}, std::byte{0xf1},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0xf6}, std::byte{0x1a},
+    std::byte{0x45}, std::byte{0x1a}, std::byte{0x2},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x2},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0xd2}, std::byte{0x5a},
+    std::byte{0x25}, std::byte{0x0},  std::byte{0x2f}, std::byte{0x2},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x1},  std::byte{0x30},
+    std::byte{0x4a}, std::byte{0x0},  std::byte{0x10}, std::byte{0x0},
+    std::byte{0x44}, std::byte{0x4d}, std::byte{0x4},  std::byte{0x0},
+    std::byte{0x89}, std::byte{0xcd}, std::byte{0xf},  std::byte{0x0},
+    std::byte{0xf6}, std::byte{0x1a}, std::byte{0x45}, std::byte{0x1a},
+    std::byte{0x80}, std::byte{0x8f}, std::byte{0xf},  std::byte{0x4d},
+    std::byte{0x2},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x80}, std::byte{0x8f}, std::byte{0xf},  std::byte{0x4d},
+    std::byte{0x2},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x1},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0xf4}, std::byte{0xf1}, std::byte{0x0},  std::byte{0x0},
+    std::byte{0xf6}, std::byte{0x1a}, std::byte{0x45}, std::byte{0x1a},
+    std::byte{0x1},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x4},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0xd2}, std::byte{0x5a}, std::byte{0x25}, std::byte{0x0},
+    std::byte{0x30}, std::byte{0x2},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x2},  std::byte{0x31}, std::byte{0x4a}, std::byte{0x0},
+    std::byte{0x10}, std::byte{0x0},  std::byte{0x44}, std::byte{0x4d},
+    std::byte{0x4},  std::byte{0x0},  std::byte{0xa7}, std::byte{0xcd},
+    std::byte{0xf},  std::byte{0x0},  std::byte{0xf6}, std::byte{0x1a},
+    std::byte{0x45}, std::byte{0x1a}, std::byte{0xc0}, std::byte{0xe4},
+    std::byte{0xfa}, std::byte{0x4e}, std::byte{0x2},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x8a}, std::byte{0x1},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0xc0}, std::byte{0x9c},
+    std::byte{0x12}, std::byte{0x4d}, std::byte{0x2},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x5},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0xf5}, std::byte{0xf1},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0xf6}, std::byte{0x1a},
+    std::byte{0x45}, std::byte{0x1a}, std::byte{0x2},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x2},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0xd2}, std::byte{0x5a},
+    std::byte{0x25}, std::byte{0x0},  std::byte{0x31}, std::byte{0x2},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x1},  std::byte{0x30},
+    std::byte{0x4a}, std::byte{0x0},  std::byte{0x10}, std::byte{0x0},
+    std::byte{0x44}, std::byte{0x4d}, std::byte{0x4},  std::byte{0x0},
+    std::byte{0x5e}, std::byte{0xca}, std::byte{0xf},  std::byte{0x0},
+    std::byte{0xf6}, std::byte{0x1a}, std::byte{0x45}, std::byte{0x1a},
+    std::byte{0xc0}, std::byte{0x9c}, std::byte{0x12}, std::byte{0x4d},
+    std::byte{0x2},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0xc0}, std::byte{0x9c}, std::byte{0x12}, std::byte{0x4d},
+    std::byte{0x2},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x5},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0xf5}, std::byte{0xf1}, std::byte{0x0},  std::byte{0x0},
+    std::byte{0xf6}, std::byte{0x1a}, std::byte{0x45}, std::byte{0x1a},
+    std::byte{0x1},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x4},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0xd2}, std::byte{0x5a}, std::byte{0x25}, std::byte{0x0},
+    std::byte{0x32}, std::byte{0x2},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x2},  std::byte{0x31}, std::byte{0x4a}, std::byte{0x0},
+    std::byte{0x10}, std::byte{0x0},  std::byte{0x44}, std::byte{0x4d},
+    std::byte{0x4},  std::byte{0x0},  std::byte{0xa7}, std::byte{0xcd},
+    std::byte{0xf},  std::byte{0x0},  std::byte{0xf6}, std::byte{0x1a},
+    std::byte{0x45}, std::byte{0x1a}, std::byte{0xc0}, std::byte{0xe4},
+    std::byte{0xfa}, std::byte{0x4e}, std::byte{0x2},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x87}, std::byte{0x1},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x20}, std::byte{0x4b},
+    std::byte{0x1d}, std::byte{0x4d}, std::byte{0x2},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x3},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0xf6}, std::byte{0xf1},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0xf6}, std::byte{0x1a},
+    std::byte{0x45}, std::byte{0x1a}, std::byte{0x2},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x2},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0xd2}, std::byte{0x5a},
+    std::byte{0x25}, std::byte{0x0},  std::byte{0x33}, std::byte{0x2},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x1},  std::byte{0x30},
+    std::byte{0x4a}, std::byte{0x0},  std::byte{0x10}, std::byte{0x0},
+    std::byte{0x44}, std::byte{0x4d}, std::byte{0x4},  std::byte{0x0},
+    std::byte{0xe8}, std::byte{0xc2}, std::byte{0xf},  std::byte{0x0},
+    std::byte{0xf6}, std::byte{0x1a}, std::byte{0x45}, std::byte{0x1a},
+    std::byte{0x20}, std::byte{0x4b}, std::byte{0x1d}, std::byte{0x4d},
+    std::byte{0x2},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x20}, std::byte{0x4b}, std::byte{0x1d}, std::byte{0x4d},
+    std::byte{0x2},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x3},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0xf6}, std::byte{0xf1}, std::byte{0x0},  std::byte{0x0},
+    std::byte{0xf6}, std::byte{0x1a}, std::byte{0x45}, std::byte{0x1a},
+    std::byte{0x1},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x4},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0xd2}, std::byte{0x5a}, std::byte{0x25}, std::byte{0x0},
+    std::byte{0x34}, std::byte{0x2},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x2},  std::byte{0x31}, std::byte{0x4a}, std::byte{0x0},
+    std::byte{0x10}, std::byte{0x0},  std::byte{0x44}, std::byte{0x4d},
+    std::byte{0x4},  std::byte{0x0},  std::byte{0xa7}, std::byte{0xcd},
+    std::byte{0xf},  std::byte{0x0},  std::byte{0xf6}, std::byte{0x1a},
+    std::byte{0x45}, std::byte{0x1a}, std::byte{0xc0}, std::byte{0xe4},
+    std::byte{0xfa}, std::byte{0x4e}, std::byte{0x2},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x82}, std::byte{0x1},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0xc0}, std::byte{0xd1},
+    std::byte{0x1e}, std::byte{0x4d}, std::byte{0x2},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x5},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0xf7}, std::byte{0xf1},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0xf6}, std::byte{0x1a},
+    std::byte{0x45}, std::byte{0x1a}, std::byte{0x2},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x2},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0xd2}, std::byte{0x5a},
+    std::byte{0x25}, std::byte{0x0},  std::byte{0x35}, std::byte{0x2},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x1},  std::byte{0x30},
+    std::byte{0x4a}, std::byte{0x0},  std::byte{0x10}, std::byte{0x0},
+    std::byte{0x44}, std::byte{0x4d}, std::byte{0x4},  std::byte{0x0},
+    std::byte{0x6c}, std::byte{0xc2}, std::byte{0xf},  std::byte{0x0},
+    std::byte{0xf6}, std::byte{0x1a}, std::byte{0x45}, std::byte{0x1a},
+    std::byte{0xc0}, std::byte{0xd1}, std::byte{0x1e}, std::byte{0x4d},
+    std::byte{0x2},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0xc0}, std::byte{0xd1}, std::byte{0x1e}, std::byte{0x4d},
+    std::byte{0x2},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x5},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0xf7}, std::byte{0xf1}, std::byte{0x0},  std::byte{0x0},
+    std::byte{0xf6}, std::byte{0x1a}, std::byte{0x45}, std::byte{0x1a},
+    std::byte{0x1},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x4},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0xd2}, std::byte{0x5a}, std::byte{0x25}, std::byte{0x0},
+    std::byte{0x36}, std::byte{0x2},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x2},  std::byte{0x31}, std::byte{0x4a}, std::byte{0x0},
+    std::byte{0x10}, std::byte{0x0},  std::byte{0x44}, std::byte{0x4d},
+    std::byte{0x4},  std::byte{0x0},  std::byte{0xa7}, std::byte{0xcd},
+    std::byte{0xf},  std::byte{0x0},  std::byte{0xf6}, std::byte{0x1a},
+    std::byte{0x45}, std::byte{0x1a}, std::byte{0xc0}, std::byte{0xe4},
+    std::byte{0xfa}, std::byte{0x4e}, std::byte{0x2},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x81}, std::byte{0x1},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x60}, std::byte{0x58},
+    std::byte{0x20}, std::byte{0x4d}, std::byte{0x2},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x1},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0xf8}, std::byte{0xf1},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0xf6}, std::byte{0x1a},
+    std::byte{0x45}, std::byte{0x1a}, std::byte{0x2},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x2},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0xd2}, std::byte{0x5a},
+    std::byte{0x25}, std::byte{0x0},  std::byte{0x37}, std::byte{0x2},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x1},  std::byte{0x30},
+    std::byte{0x4a}, std::byte{0x0},  std::byte{0x10}, std::byte{0x0},
+    std::byte{0x44}, std::byte{0x4d}, std::byte{0x4},  std::byte{0x0},
+    std::byte{0xdf}, std::byte{0xbd}, std::byte{0xf},  std::byte{0x0},
+    std::byte{0xf6}, std::byte{0x1a}, std::byte{0x45}, std::byte{0x1a},
+    std::byte{0x60}, std::byte{0x58}, std::byte{0x20}, std::byte{0x4d},
+    std::byte{0x2},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x60}, std::byte{0x58}, std::byte{0x20}, std::byte{0x4d},
+    std::byte{0x2},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x1},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0xf8}, std::byte{0xf1}, std::byte{0x0},  std::byte{0x0},
+    std::byte{0xf6}, std::byte{0x1a}, std::byte{0x45}, std::byte{0x1a},
+    std::byte{0x1},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x4},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0xd2}, std::byte{0x5a}, std::byte{0x25}, std::byte{0x0},
+    std::byte{0x38}, std::byte{0x2},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x2},  std::byte{0x31}, std::byte{0x4a}, std::byte{0x0},
+    std::byte{0x10}, std::byte{0x0},  std::byte{0x44}, std::byte{0x4d},
+    std::byte{0x4},  std::byte{0x0},  std::byte{0xa7}, std::byte{0xcd},
+    std::byte{0xf},  std::byte{0x0},  std::byte{0xf6}, std::byte{0x1a},
+    std::byte{0x45}, std::byte{0x1a}, std::byte{0xc0}, std::byte{0xe4},
+    std::byte{0xfa}, std::byte{0x4e}, std::byte{0x2},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x80}, std::byte{0x1},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0xdf},
+    std::byte{0x21}, std::byte{0x4d}, std::byte{0x2},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x1},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0xf9}, std::byte{0xf1},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0xf6}, std::byte{0x1a},
+    std::byte{0x45}, std::byte{0x1a}, std::byte{0x2},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x2},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0xd2}, std::byte{0x5a},
+    std::byte{0x25}, std::byte{0x0},  std::byte{0x39}, std::byte{0x2},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x1},  std::byte{0x30},
+    std::byte{0x4a}, std::byte{0x0},  std::byte{0x10}, std::byte{0x0},
+    std::byte{0x44}, std::byte{0x4d}, std::byte{0x4},  std::byte{0x0},
+    std::byte{0x6},  std::byte{0x9a}, std::byte{0xf},  std::byte{0x0},
+    std::byte{0xf6}, std::byte{0x1a}, std::byte{0x45}, std::byte{0x1a},
+    std::byte{0x0},  std::byte{0xdf}, std::byte{0x21}, std::byte{0x4d},
+    std::byte{0x2},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0xdf}, std::byte{0x21}, std::byte{0x4d},
+    std::byte{0x2},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x1},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0xf9}, std::byte{0xf1}, std::byte{0x0},  std::byte{0x0},
+    std::byte{0xf6}, std::byte{0x1a}, std::byte{0x45}, std::byte{0x1a},
+    std::byte{0x1},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x4},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0xd2}, std::byte{0x5a}, std::byte{0x25}, std::byte{0x0},
+    std::byte{0x3a}, std::byte{0x2},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x2},  std::byte{0x31}, std::byte{0x4a}, std::byte{0x0},
+    std::byte{0x10}, std::byte{0x0},  std::byte{0x44}, std::byte{0x4d},
+    std::byte{0x4},  std::byte{0x0},  std::byte{0xa7}, std::byte{0xcd},
+    std::byte{0xf},  std::byte{0x0},  std::byte{0xf6}, std::byte{0x1a},
+    std::byte{0x45}, std::byte{0x1a}, std::byte{0xc0}, std::byte{0xe4},
+    std::byte{0xfa}, std::byte{0x4e}, std::byte{0x2},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x7f}, std::byte{0x1},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0xdf},
+    std::byte{0x21}, std::byte{0x4d}, std::byte{0x2},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x1},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0xfa}, std::byte{0xf1},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0xf6}, std::byte{0x1a},
+    std::byte{0x45}, std::byte{0x1a}, std::byte{0x2},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x2},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0xd2}, std::byte{0x5a},
+    std::byte{0x25}, std::byte{0x0},  std::byte{0x3b}, std::byte{0x2},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x1},  std::byte{0x30},
+    std::byte{0x4a}, std::byte{0x0},  std::byte{0x10}, std::byte{0x0},
+    std::byte{0x44}, std::byte{0x4d}, std::byte{0x4},  std::byte{0x0},
+    std::byte{0x58}, std::byte{0xac}, std::byte{0xf},  std::byte{0x0},
+    std::byte{0xf6}, std::byte{0x1a}, std::byte{0x45}, std::byte{0x1a},
+    std::byte{0x0},  std::byte{0xdf}, std::byte{0x21}, std::byte{0x4d},
+    std::byte{0x2},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0xdf}, std::byte{0x21}, std::byte{0x4d},
+    std::byte{0x2},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x1},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0xfa}, std::byte{0xf1}, std::byte{0x0},  std::byte{0x0},
+    std::byte{0xf6}, std::byte{0x1a}, std::byte{0x45}, std::byte{0x1a},
+    std::byte{0x1},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x4},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0xd2}, std::byte{0x5a}, std::byte{0x25}, std::byte{0x0},
+    std::byte{0x3c}, std::byte{0x2},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x2},  std::byte{0x31}, std::byte{0x4a}, std::byte{0x0},
+    std::byte{0x10}, std::byte{0x0},  std::byte{0x44}, std::byte{0x4d},
+    std::byte{0x4},  std::byte{0x0},  std::byte{0xa7}, std::byte{0xcd},
+    std::byte{0xf},  std::byte{0x0},  std::byte{0xf6}, std::byte{0x1a},
+    std::byte{0x45}, std::byte{0x1a}, std::byte{0xc0}, std::byte{0xe4},
+    std::byte{0xfa}, std::byte{0x4e}, std::byte{0x2},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x7d}, std::byte{0x1},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0xdf},
+    std::byte{0x21}, std::byte{0x4d}, std::byte{0x2},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x2},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0xfb}, std::byte{0xf1},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0xf6}, std::byte{0x1a},
+    std::byte{0x45}, std::byte{0x1a}, std::byte{0x2},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x2},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0xd2}, std::byte{0x5a},
+    std::byte{0x25}, std::byte{0x0},  std::byte{0x3d}, std::byte{0x2},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x1},  std::byte{0x30},
+    std::byte{0x4a}, std::byte{0x0},  std::byte{0x10}, std::byte{0x0},
+    std::byte{0x44}, std::byte{0x4d}, std::byte{0x4},  std::byte{0x0},
+    std::byte{0x18}, std::byte{0xad}, std::byte{0xf},  std::byte{0x0},
+    std::byte{0xf6}, std::byte{0x1a}, std::byte{0x45}, std::byte{0x1a},
+    std::byte{0x0},  std::byte{0xdf}, std::byte{0x21}, std::byte{0x4d},
+    std::byte{0x2},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0xdf}, std::byte{0x21}, std::byte{0x4d},
+    std::byte{0x2},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x2},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0xfb}, std::byte{0xf1}, std::byte{0x0},  std::byte{0x0},
+    std::byte{0xf6}, std::byte{0x1a}, std::byte{0x45}, std::byte{0x1a},
+    std::byte{0x1},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x4},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x0},  std::byte{0x0},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0xd2}, std::byte{0x5a}, std::byte{0x25}, std::byte{0x0},
+    std::byte{0x3e}, std::byte{0x2},  std::byte{0x0},  std::byte{0x0},
+    std::byte{0x2},  std::byte{0x31},
+};
+
+// Wraps a UDP payload into an Ethernet II / IPv4 / UDP frame. Checksums are
+// left to zero, which the decoder does not verify.
+inline std::vector<std::byte> make_udp_frame(
+    const std::vector<std::byte> &udp_payload, uint16_t destination_port = 0) {
+  constexpr size_t ETH_HEADER_SIZE = 14, IP_HEADER_SIZE = 20,
+                   UDP_HEADER_SIZE = 8;
+  std::vector<std::byte> frame(
+      ETH_HEADER_SIZE + IP_HEADER_SIZE + UDP_HEADER_SIZE, std::byte{0});
+  const auto put_u16 = [&frame](size_t offset, size_t value) {
+    frame[offset] = std::byte(value >> 8);
+    frame[offset + 1] = std::byte(value & 0xFF);
+  };
+  put_u16(12, 0x0800);  // ethertype IPv4
+  frame[ETH_HEADER_SIZE] = std::byte{0x45};
+  put_u16(ETH_HEADER_SIZE + 2,
+          IP_HEADER_SIZE + UDP_HEADER_SIZE + udp_payload.size());
+  frame[ETH_HEADER_SIZE + 8] = std::byte{64};    // TTL
+  frame[ETH_HEADER_SIZE + 9] = std::byte{0x11};  // UDP
+  const size_t udp_offset = ETH_HEADER_SIZE + IP_HEADER_SIZE;
+  put_u16(udp_offset + 2, destination_port);
+  put_u16(udp_offset + 4, UDP_HEADER_SIZE + udp_payload.size());
+  frame.insert(frame.end(), udp_payload.begin(), udp_payload.end());
+  return frame;
+}
+
+// Fills the IPv4 header and UDP checksums of an unfragmented frame built by
+// make_udp_frame, with a plain RFC 1071 loop
+inline std::vector<std::byte> add_checksums(std::vector<std::byte> frame) {
+  constexpr size_t ETH_HEADER_SIZE = 14, IP_HEADER_SIZE = 20;
+  const auto word = [&frame](size_t offset) {
+    const size_t high = std::to_integer<size_t>(frame[offset]);
+    const size_t low = offset + 1 < frame.size()
+                           ? std::to_integer<size_t>(frame[offset + 1])
+                           : 0;
+    return (high << 8) | low;
+  };
+  const auto complement = [](size_t sum) {
+    while (sum > 0xFFFF) {
+      sum = (sum & 0xFFFF) + (sum >> 16);
+    }
+    return ~sum & 0xFFFF;
+  };
+  const auto put_u16 = [&frame](size_t offset, size_t value) {
+    frame[offset] = std::byte(value >> 8);
+    frame[offset + 1] = std::byte(value & 0xFF);
+  };
+
+  size_t ip_sum = 0;
+  for (size_t offset = ETH_HEADER_SIZE;
+       offset < ETH_HEADER_SIZE + IP_HEADER_SIZE; offset += 2) {
+    ip_sum += word(offset);
+  }
+  put_u16(ETH_HEADER_SIZE + 10, complement(ip_sum));
+
+  const size_t udp_offset = ETH_HEADER_SIZE + IP_HEADER_SIZE;
+  // pseudo header: addresses, protocol, UDP length
+  size_t udp_sum = 0x11 + word(udp_offset + 4);
+  for (size_t offset = ETH_HEADER_SIZE + 12; offset < udp_offset; offset += 2) {
+    udp_sum += word(offset);
+  }
+  for (size_t offset = udp_offset; offset < frame.size(); offset += 2) {
+    udp_sum += word(offset);
+  }
+  const size_t udp_checksum = complement(udp_sum);
+  // a computed zero is sent as all ones, zero meaning no checksum
+  put_u16(udp_offset + 6, udp_checksum == 0 ? 0xFFFF : udp_checksum);
+  return frame;
+}
+
+// Inserts one VLAN tag per TPID (outermost first) after the MAC addresses of
+// an Ethernet frame
+inline std::vector<std::byte> add_vlan_tags(std::vector<std::byte> frame,
+                                            const std::vector<uint16_t> &tpids) {
+  constexpr size_t ETHERTYPE_OFFSET = 12;
+  size_t offset = ETHERTYPE_OFFSET;
+  for (const uint16_t tpid : tpids) {
+    const std::byte tag[] = {std::byte(tpid >> 8), std::byte(tpid & 0xFF),
+                             std::byte{0x00}, std::byte{0x64}};  // VLAN 100
+    frame.insert(frame.begin() + offset, std::begin(tag), std::end(tag));
+    offset += sizeof(tag);
+  }
+  return frame;
+}
+
+// Replaces the Ethernet header (MACs and ethertype) of a frame with a Linux
+// cooked capture header, version 1 (16 bytes) or 2 (20 bytes)
+inline std::vector<std::byte> to_linux_cooked_frame(
+    const std::vector<std::byte> &ethernet_frame, int version) {
+  constexpr size_t ETHERTYPE_OFFSET = 12;
+  const std::byte ethertype[] = {ethernet_frame[ETHERTYPE_OFFSET],
+                                 ethernet_frame[ETHERTYPE_OFFSET + 1]};
+  std::vector<std::byte> frame(version == 1 ? 16 : 20, std::byte{0x00});
+  const size_t protocol_offset = version == 1 ? 14 : 0;
+  frame[protocol_offset] = ethertype[0];
+  frame[protocol_offset + 1] = ethertype[1];
+  frame.insert(frame.end(), ethernet_frame.begin() + ETHERTYPE_OFFSET + 2,
+               ethernet_frame.end());
+  return frame;
+}
+
+// Splits an Ethernet / IPv4 frame into IPv4 fragments carrying at most
+// fragment_size bytes (a multiple of 8) of the IP payload each
+inline std::vector<std::vector<std::byte>> fragment_frame(
+    const std::vector<std::byte> &frame, size_t fragment_size,
+    uint16_t identification = 0x1234) {
+  constexpr size_t ETH_HEADER_SIZE = 14, IP_HEADER_SIZE = 20;
+  const size_t payload_size = frame.size() - ETH_HEADER_SIZE - IP_HEADER_SIZE;
+  std::vector<std::vector<std::byte>> fragments;
+  for (size_t offset = 0; offset < payload_size; offset += fragment_size) {
+    const size_t size = std::min(fragment_size, payload_size - offset);
+    std::vector<std::byte> fragment(frame.begin(),
+                                    frame.begin() + ETH_HEADER_SIZE +
+                                        IP_HEADER_SIZE);
+    const auto put_u16 = [&fragment](size_t at, size_t value) {
+      fragment[at] = std::byte(value >> 8);
+      fragment[at + 1] = std::byte(value & 0xFF);
+    };
+    put_u16(ETH_HEADER_SIZE + 2, IP_HEADER_SIZE + size);
+    put_u16(ETH_HEADER_SIZE + 4, identification);
+    const bool more_fragments = offset + size < payload_size;
+    put_u16(ETH_HEADER_SIZE + 6, (more_fragments ? 0x2000 : 0) | offset / 8);
+    const auto payload = frame.begin() + ETH_HEADER_SIZE + IP_HEADER_SIZE;
+    fragment.insert(fragment.end(), payload + offset, payload + offset + size);
+    fragments.push_back(std::move(fragment));
+  }
+  return fragments;
+}
+
+// Builds an in-memory PCAP file (magic 0xA1B23C4D) with one record per
+// frame, timestamps spaced by one millisecond from first_timestamp_ns.
+inline std::vector<std::byte> make_pcap_file(
+    const std::vector<std::vector<std::byte>> &frames,
+    uint32_t link_type = 1, uint32_t first_timestamp_ns = 0) {
+  std::vector<std::byte> file(sizeof(pcap::types::pcap_hdr_t));
+  pcap::types::pcap_hdr_t header{0xa1b23c4d, 2, 4, 0, 0, 65535, link_type};
+  std::memcpy(file.data(), &header, sizeof(header));
+
+  uint32_t timestamp_ns{first_timestamp_ns};
+  for (const auto &frame : frames) {
+    pcap::types::pcaprec_hdr_s record{1696923540, timestamp_ns,
+                                      static_cast<uint32_t>(frame.size()),
+                                      static_cast<uint32_t>(frame.size())};
+    timestamp_ns += 1000000;
+    const size_t offset = file.size();
+    file.resize(offset + sizeof(record));
+    std::memcpy(file.data() + offset, &record, sizeof(record));
+    file.insert(file.end(), frame.begin(), frame.end());
+  }
+  return file;
+}
+
+// A shared memory segment name unique to the test and the process
+inline std::string segment_name(std::string_view test) {
+  return "/task_" + std::string(test) + "_" + std::to_string(::getpid());
+}
+
+// An order book update of the given instrument and order
+inline simba::types::OrderUpdate make_order(
+    int32_t security_id, int64_t id, simba::types::MDUpdateAction action,
+    simba::types::MDEntryType side, int64_t price, int64_t volume) {
+  simba::types::OrderUpdate update;
+  update.md_entry_id = id;
+  update.md_entry_px = simba::types::Decimal5::from_units(price);
+  update.md_entry_size = volume;
+  update.security_id = security_id;
+  update.md_update_action = action;
+  update.md_entry_type = side;
+  return update;
+}
+
+}  // namespace task::tests